@@ -0,0 +1,257 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Benchmark.hh"
+
+#include <getopt.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <vector>
+
+namespace orc {
+
+  BenchmarkState::BenchmarkState(uint64_t iterations)
+      : iterations_(iterations),
+        remaining_(iterations),
+        running_(false),
+        elapsed_(0),
+        bytesPerIteration_(0),
+        itemsPerIteration_(0) {}
+
+  void BenchmarkState::pauseTiming() {
+    if (running_) {
+      elapsed_ += std::chrono::steady_clock::now() - start_;
+      running_ = false;
+    }
+  }
+
+  void BenchmarkState::resumeTiming() {
+    if (!running_) {
+      start_ = std::chrono::steady_clock::now();
+      running_ = true;
+    }
+  }
+
+  struct Benchmark {
+    std::string name;
+    BenchmarkFunction function;
+  };
+
+  static std::vector<Benchmark>& getBenchmarks() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+  }
+
+  void addBenchmark(const std::string& name, BenchmarkFunction function) {
+    getBenchmarks().push_back({name, std::move(function)});
+  }
+
+  struct BenchmarkResult {
+    uint64_t iterations = 0;
+    uint64_t bytesPerIteration = 0;
+    uint64_t itemsPerIteration = 0;
+    // the time per iteration of each repetition in ascending order
+    std::vector<double> nanos;
+    std::string skipReason;
+  };
+
+  static const uint64_t MAX_ITERATIONS = 1000000000;
+
+  // Grows the number of iterations until a run takes at least minSeconds,
+  // which also warms up the caches, then times repetitions runs of that
+  // many iterations.
+  static BenchmarkResult runBenchmark(const Benchmark& benchmark, double minSeconds,
+                                      uint64_t repetitions) {
+    BenchmarkResult result;
+    uint64_t iterations = 1;
+    while (true) {
+      BenchmarkState state(iterations);
+      benchmark.function(state);
+      if (!state.getSkipReason().empty()) {
+        result.skipReason = state.getSkipReason();
+        return result;
+      }
+      double seconds = std::chrono::duration<double>(state.getElapsed()).count();
+      if (seconds >= minSeconds || iterations >= MAX_ITERATIONS) {
+        break;
+      }
+      // aim past the minimum so that the next run is likely the last one
+      double factor = seconds > 0 ? minSeconds * 1.4 / seconds : 10;
+      iterations = static_cast<uint64_t>(static_cast<double>(iterations) *
+                                         std::min(std::max(factor, 2.0), 10.0));
+    }
+    result.iterations = iterations;
+    for (uint64_t i = 0; i < repetitions; ++i) {
+      BenchmarkState state(iterations);
+      benchmark.function(state);
+      result.nanos.push_back(static_cast<double>(state.getElapsed().count()) /
+                             static_cast<double>(iterations));
+      result.bytesPerIteration = state.getBytesPerIteration();
+      result.itemsPerIteration = state.getItemsPerIteration();
+    }
+    std::sort(result.nanos.begin(), result.nanos.end());
+    return result;
+  }
+
+  static double getMedian(const std::vector<double>& sorted) {
+    size_t middle = sorted.size() / 2;
+    return sorted.size() % 2 == 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+  }
+
+  // the rate of a quantity per iteration in millions per second
+  static double getRate(uint64_t perIteration, double nanos) {
+    return nanos > 0 ? static_cast<double>(perIteration) * 1000 / nanos : 0;
+  }
+
+  static void printResult(std::ostream& out, const std::string& name,
+                          const BenchmarkResult& result, bool csv) {
+    if (!result.skipReason.empty()) {
+      if (!csv) {
+        out << std::left << std::setw(48) << name << " skipped: " << result.skipReason << "\n";
+      }
+      return;
+    }
+    double median = getMedian(result.nanos);
+    double bytesRate = getRate(result.bytesPerIteration, median);
+    double itemsRate = getRate(result.itemsPerIteration, median);
+    if (csv) {
+      out << name << "," << result.iterations << "," << median << "," << result.nanos.front()
+          << "," << result.nanos.back() << "," << bytesRate << "," << itemsRate << "\n";
+    } else {
+      out << std::left << std::setw(48) << name << std::right << std::setw(12)
+          << result.iterations << std::fixed << std::setprecision(1) << std::setw(14) << median
+          << std::setw(14) << result.nanos.front() << std::setw(14) << result.nanos.back()
+          << std::setw(11) << bytesRate << std::setw(11) << itemsRate << "\n";
+    }
+    out.flush();
+  }
+
+}  // namespace orc
+
+static void usage() {
+  std::cerr << "Usage: orc-microbench [options]\n"
+            << "Options:\n"
+            << "\t-h --help\n"
+            << "\t-f --filter\t\tRegular expression that selects the benchmarks to run\n"
+            << "\t-t --min-time\t\tMinimum seconds that each timed run takes (default 0.2)\n"
+            << "\t-r --repetitions\tNumber of timed runs of each benchmark (default 5)\n"
+            << "\t-l --list\t\tList the benchmarks instead of running them\n"
+            << "\t-c --csv\t\tPrint the results as comma separated values\n"
+            << "Runs the micro benchmarks of the ORC library. The table shows the time per\n"
+            << "iteration in nanoseconds of the median, fastest and slowest run, and the\n"
+            << "MB/s and millions of values per second of the median run.\n";
+}
+
+int main(int argc, char* argv[]) {
+  static struct option longOptions[] = {{"help", no_argument, nullptr, 'h'},
+                                        {"filter", required_argument, nullptr, 'f'},
+                                        {"min-time", required_argument, nullptr, 't'},
+                                        {"repetitions", required_argument, nullptr, 'r'},
+                                        {"list", no_argument, nullptr, 'l'},
+                                        {"csv", no_argument, nullptr, 'c'},
+                                        {nullptr, 0, nullptr, 0}};
+  std::string filter = ".*";
+  double minSeconds = 0.2;
+  uint64_t repetitions = 5;
+  bool list = false;
+  bool csv = false;
+  int opt;
+  char* tail;
+  do {
+    opt = getopt_long(argc, argv, "hf:t:r:lc", longOptions, nullptr);
+    switch (opt) {
+      case '?':
+      case 'h':
+        usage();
+        return 1;
+      case 'f':
+        filter = optarg;
+        break;
+      case 't':
+        minSeconds = strtod(optarg, &tail);
+        if (*tail != '\0' || minSeconds < 0) {
+          std::cerr << "The --min-time parameter requires a non-negative number.\n";
+          return 1;
+        }
+        break;
+      case 'r':
+        repetitions = strtoul(optarg, &tail, 10);
+        if (*tail != '\0' || repetitions == 0) {
+          std::cerr << "The --repetitions parameter requires a positive integer.\n";
+          return 1;
+        }
+        break;
+      case 'l':
+        list = true;
+        break;
+      case 'c':
+        csv = true;
+        break;
+      default:
+        break;
+    }
+  } while (opt != -1);
+  if (optind != argc) {
+    usage();
+    return 1;
+  }
+
+  orc::registerBloomFilterBenchmarks();
+  orc::registerCompressionBenchmarks();
+  orc::registerDictionaryBenchmarks();
+  orc::registerRleBenchmarks();
+  orc::registerTimezoneBenchmarks();
+
+  std::regex pattern;
+  try {
+    pattern = std::regex(filter);
+  } catch (std::regex_error& ex) {
+    std::cerr << "Bad --filter " << filter << ": " << ex.what() << "\n";
+    return 1;
+  }
+  if (csv && !list) {
+    std::cout << "name,iterations,median_ns,min_ns,max_ns,mb_per_second,mitems_per_second\n";
+  } else if (!list) {
+    std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(12)
+              << "Iterations" << std::setw(14) << "Median ns" << std::setw(14) << "Min ns"
+              << std::setw(14) << "Max ns" << std::setw(11) << "MB/s" << std::setw(11)
+              << "Mitems/s"
+              << "\n";
+  }
+  int status = 0;
+  for (const orc::Benchmark& benchmark : orc::getBenchmarks()) {
+    if (!std::regex_search(benchmark.name, pattern)) {
+      continue;
+    }
+    if (list) {
+      std::cout << benchmark.name << "\n";
+      continue;
+    }
+    try {
+      orc::printResult(std::cout, benchmark.name,
+                       orc::runBenchmark(benchmark, minSeconds, repetitions), csv);
+    } catch (std::exception& ex) {
+      std::cerr << "Caught exception in " << benchmark.name << ": " << ex.what() << "\n";
+      status = 1;
+    }
+  }
+  return status;
+}
@@ -0,0 +1,165 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_BENCHMARK_HH
+#define ORC_BENCHMARK_HH
+
+#include "orc/OrcFile.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace orc {
+
+  /**
+   * The state of one run of a benchmark. A benchmark prepares its input,
+   * then runs its body in a while (state.keepRunning()) loop, which only
+   * times the iterations that the harness asks for.
+   */
+  class BenchmarkState {
+   public:
+    explicit BenchmarkState(uint64_t iterations);
+
+    // starts the clock on the first call and stops it after the last iteration
+    bool keepRunning() {
+      if (remaining_ == 0) {
+        pauseTiming();
+        return false;
+      }
+      if (remaining_-- == iterations_) {
+        resumeTiming();
+      }
+      return true;
+    }
+
+    // exclude the work between these calls, such as resetting the input
+    void pauseTiming();
+    void resumeTiming();
+
+    // the bytes or values that one iteration processes, for the rates
+    void setBytesPerIteration(uint64_t bytes) {
+      bytesPerIteration_ = bytes;
+    }
+    void setItemsPerIteration(uint64_t items) {
+      itemsPerIteration_ = items;
+    }
+
+    // marks the benchmark as not runnable here, the caller has to return
+    void skip(const std::string& reason) {
+      skipReason_ = reason;
+    }
+
+    uint64_t getIterations() const {
+      return iterations_;
+    }
+    uint64_t getBytesPerIteration() const {
+      return bytesPerIteration_;
+    }
+    uint64_t getItemsPerIteration() const {
+      return itemsPerIteration_;
+    }
+    const std::string& getSkipReason() const {
+      return skipReason_;
+    }
+    std::chrono::nanoseconds getElapsed() const {
+      return elapsed_;
+    }
+
+   private:
+    const uint64_t iterations_;
+    uint64_t remaining_;
+    bool running_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::nanoseconds elapsed_;
+    uint64_t bytesPerIteration_;
+    uint64_t itemsPerIteration_;
+    std::string skipReason_;
+  };
+
+  using BenchmarkFunction = std::function<void(BenchmarkState&)>;
+
+  /**
+   * Register a benchmark under a name of the form Component/operation/case,
+   * which --filter matches against.
+   */
+  void addBenchmark(const std::string& name, BenchmarkFunction function);
+
+  // the benchmarks of each source file, registered by main
+  void registerBloomFilterBenchmarks();
+  void registerCompressionBenchmarks();
+  void registerDictionaryBenchmarks();
+  void registerRleBenchmarks();
+  void registerTimezoneBenchmarks();
+
+  /**
+   * Keep the compiler from optimizing away the computation of a value.
+   */
+  template <typename T>
+  inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+  }
+
+  /**
+   * An OutputStream that keeps the written bytes in memory and can be
+   * reused between iterations without reallocating.
+   */
+  class StringOutputStream : public OutputStream {
+   public:
+    StringOutputStream() : name_("StringOutputStream") {}
+
+    uint64_t getLength() const override {
+      return data_.size();
+    }
+
+    uint64_t getNaturalWriteSize() const override {
+      return 128 * 1024;
+    }
+
+    void write(const void* buf, size_t length) override {
+      data_.append(static_cast<const char*>(buf), length);
+    }
+
+    const std::string& getName() const override {
+      return name_;
+    }
+
+    void close() override {}
+
+    void clear() {
+      data_.clear();
+    }
+
+    const std::string& getData() const {
+      return data_;
+    }
+
+   private:
+    std::string name_;
+    std::string data_;
+  };
+
+}  // namespace orc
+
+#endif  // ORC_BENCHMARK_HH
@@ -0,0 +1,108 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Benchmark.hh"
+
+#include "BloomFilter.hh"
+
+#include <random>
+#include <vector>
+
+namespace orc {
+
+  static const uint64_t NUM_VALUES = 64 * 1024;
+  // the row index stride, which is the expected number of entries per filter
+  static const uint64_t EXPECTED_ENTRIES = 10000;
+
+  static std::vector<int64_t> makeLongs() {
+    std::mt19937_64 random(42);
+    std::vector<int64_t> values(NUM_VALUES);
+    for (int64_t& value : values) {
+      value = static_cast<int64_t>(random());
+    }
+    return values;
+  }
+
+  static std::vector<std::string> makeStrings() {
+    std::mt19937_64 random(42);
+    std::vector<std::string> values(NUM_VALUES);
+    for (std::string& value : values) {
+      value = "key-" + std::to_string(random() % 1000000000);
+    }
+    return values;
+  }
+
+  void registerBloomFilterBenchmarks() {
+    addBenchmark("BloomFilter/addLong", [](BenchmarkState& state) {
+      const std::vector<int64_t> values = makeLongs();
+      BloomFilterImpl filter(EXPECTED_ENTRIES);
+      while (state.keepRunning()) {
+        filter.reset();
+        for (int64_t value : values) {
+          filter.addLong(value);
+        }
+        doNotOptimize(filter);
+      }
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+    addBenchmark("BloomFilter/testLong", [](BenchmarkState& state) {
+      const std::vector<int64_t> values = makeLongs();
+      BloomFilterImpl filter(EXPECTED_ENTRIES);
+      // half of the tested values are in the filter
+      for (uint64_t i = 0; i < EXPECTED_ENTRIES; ++i) {
+        filter.addLong(values[2 * i]);
+      }
+      uint64_t found = 0;
+      while (state.keepRunning()) {
+        for (int64_t value : values) {
+          found += filter.testLong(value);
+        }
+      }
+      doNotOptimize(found);
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+    addBenchmark("BloomFilter/addBytes", [](BenchmarkState& state) {
+      const std::vector<std::string> values = makeStrings();
+      BloomFilterImpl filter(EXPECTED_ENTRIES);
+      while (state.keepRunning()) {
+        filter.reset();
+        for (const std::string& value : values) {
+          filter.addBytes(value.data(), static_cast<int64_t>(value.size()));
+        }
+        doNotOptimize(filter);
+      }
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+    addBenchmark("BloomFilter/testBytes", [](BenchmarkState& state) {
+      const std::vector<std::string> values = makeStrings();
+      BloomFilterImpl filter(EXPECTED_ENTRIES);
+      for (uint64_t i = 0; i < EXPECTED_ENTRIES; ++i) {
+        filter.addBytes(values[2 * i].data(), static_cast<int64_t>(values[2 * i].size()));
+      }
+      uint64_t found = 0;
+      while (state.keepRunning()) {
+        for (const std::string& value : values) {
+          found += filter.testBytes(value.data(), static_cast<int64_t>(value.size()));
+        }
+      }
+      doNotOptimize(found);
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+  }
+
+}  // namespace orc
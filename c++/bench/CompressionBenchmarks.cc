@@ -0,0 +1,128 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Benchmark.hh"
+
+#include "Compression.hh"
+#include "io/InputStream.hh"
+
+#include <cstring>
+#include <random>
+
+namespace orc {
+
+  static const uint64_t DATA_SIZE = 4 * 1024 * 1024;
+  static const uint64_t BLOCK_SIZE = 256 * 1024;
+
+  // text that compresses about as well as typical string columns
+  static std::string makeCompressibleData() {
+    static const char* const WORDS[] = {"orc",     "stripe", "column",  "footer", "index",
+                                        "stream",  "row",    "decimal", "string", "2024-01-",
+                                        "timestamp", "NULL", "value",   "batch",  "reader"};
+    std::mt19937_64 random(42);
+    std::string data;
+    data.reserve(DATA_SIZE + 32);
+    while (data.size() < DATA_SIZE) {
+      data += WORDS[random() % (sizeof(WORDS) / sizeof(WORDS[0]))];
+      data += std::to_string(random() % 1000);
+      data += random() % 8 == 0 ? '\n' : ',';
+    }
+    data.resize(DATA_SIZE);
+    return data;
+  }
+
+  static void compress(StringOutputStream& output, CompressionKind kind,
+                       CompressionStrategy strategy, const std::string& data) {
+    std::unique_ptr<BufferedOutputStream> stream = createCompressor(
+        kind, &output, strategy, BLOCK_SIZE, BLOCK_SIZE, BLOCK_SIZE, *getDefaultPool(), nullptr);
+    size_t pos = 0;
+    while (pos < data.size()) {
+      void* buffer;
+      int size;
+      if (!stream->Next(&buffer, &size)) {
+        throw std::logic_error("the compression stream is full");
+      }
+      size_t length = std::min(static_cast<size_t>(size), data.size() - pos);
+      memcpy(buffer, data.data() + pos, length);
+      stream->BackUp(size - static_cast<int>(length));
+      pos += length;
+    }
+    stream->flush();
+  }
+
+  // returns the number of decompressed bytes and compares them with data
+  static uint64_t decompress(CompressionKind kind, const std::string& compressed,
+                             const std::string* data) {
+    std::unique_ptr<SeekableInputStream> stream = createDecompressor(
+        kind, std::make_unique<SeekableArrayInputStream>(compressed.data(), compressed.size()),
+        BLOCK_SIZE, *getDefaultPool(), nullptr);
+    const void* buffer;
+    int size;
+    uint64_t total = 0;
+    while (stream->Next(&buffer, &size)) {
+      if (data != nullptr && data->compare(total, static_cast<size_t>(size),
+                                           static_cast<const char*>(buffer),
+                                           static_cast<size_t>(size)) != 0) {
+        throw std::logic_error("the decompressed data does not match the input");
+      }
+      total += static_cast<uint64_t>(size);
+    }
+    return total;
+  }
+
+  // the strategy is part of the name as it picks the level of zlib, zstd and lz4
+  static void addCompressionBenchmarks(const std::string& name, CompressionKind kind,
+                                       CompressionStrategy strategy) {
+    addBenchmark("Compression/compress/" + name, [kind, strategy](BenchmarkState& state) {
+      const std::string data = makeCompressibleData();
+      StringOutputStream output;
+      while (state.keepRunning()) {
+        output.clear();
+        compress(output, kind, strategy, data);
+        doNotOptimize(output.getData().data());
+      }
+      state.setBytesPerIteration(data.size());
+    });
+    addBenchmark("Compression/decompress/" + name, [kind, strategy](BenchmarkState& state) {
+      const std::string data = makeCompressibleData();
+      StringOutputStream output;
+      compress(output, kind, strategy, data);
+      if (decompress(kind, output.getData(), &data) != data.size()) {
+        throw std::logic_error("the decompressed data is truncated");
+      }
+      while (state.keepRunning()) {
+        doNotOptimize(decompress(kind, output.getData(), nullptr));
+      }
+      state.setBytesPerIteration(data.size());
+    });
+  }
+
+  void registerCompressionBenchmarks() {
+    addCompressionBenchmarks("zlib/speed", CompressionKind_ZLIB, CompressionStrategy_SPEED);
+    addCompressionBenchmarks("zlib/compression", CompressionKind_ZLIB,
+                             CompressionStrategy_COMPRESSION);
+    addCompressionBenchmarks("snappy", CompressionKind_SNAPPY, CompressionStrategy_SPEED);
+    addCompressionBenchmarks("lz4/speed", CompressionKind_LZ4, CompressionStrategy_SPEED);
+    addCompressionBenchmarks("lz4/compression", CompressionKind_LZ4,
+                             CompressionStrategy_COMPRESSION);
+    addCompressionBenchmarks("zstd/speed", CompressionKind_ZSTD, CompressionStrategy_SPEED);
+    addCompressionBenchmarks("zstd/compression", CompressionKind_ZSTD,
+                             CompressionStrategy_COMPRESSION);
+  }
+
+}  // namespace orc
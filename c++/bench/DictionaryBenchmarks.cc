@@ -0,0 +1,98 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Benchmark.hh"
+
+#include "Dictionary.hh"
+#include "io/OutputStream.hh"
+
+#include <random>
+#include <vector>
+
+namespace orc {
+
+  static const uint64_t NUM_VALUES = 64 * 1024;
+
+  // NUM_VALUES keys drawn from cardinality distinct strings of 8 to 24 bytes
+  static std::vector<std::string> makeKeys(uint64_t cardinality) {
+    std::mt19937_64 random(42);
+    std::vector<std::string> distinct(cardinality);
+    for (std::string& key : distinct) {
+      key.resize(8 + random() % 17);
+      for (char& c : key) {
+        c = static_cast<char>('a' + random() % 26);
+      }
+    }
+    std::vector<std::string> keys(NUM_VALUES);
+    for (std::string& key : keys) {
+      key = distinct[random() % cardinality];
+    }
+    return keys;
+  }
+
+  static void insertKeys(SortedStringDictionary& dictionary, const std::vector<std::string>& keys) {
+    for (const std::string& key : keys) {
+      doNotOptimize(dictionary.insert(key.data(), key.size()));
+    }
+  }
+
+  static void addDictionaryBenchmarks(uint64_t cardinality) {
+    const std::string name = std::to_string(cardinality);
+    addBenchmark("SortedStringDictionary/insert/" + name, [cardinality](BenchmarkState& state) {
+      const std::vector<std::string> keys = makeKeys(cardinality);
+      while (state.keepRunning()) {
+        SortedStringDictionary dictionary(*getDefaultPool());
+        insertKeys(dictionary, keys);
+      }
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+    // sorts the distinct keys and writes them like the string column writers
+    addBenchmark("SortedStringDictionary/flush/" + name, [cardinality](BenchmarkState& state) {
+      const std::vector<std::string> keys = makeKeys(cardinality);
+      MemoryPool& pool = *getDefaultPool();
+      StringOutputStream data;
+      StringOutputStream lengths;
+      uint64_t size = 0;
+      while (state.keepRunning()) {
+        state.pauseTiming();
+        SortedStringDictionary dictionary(pool);
+        insertKeys(dictionary, keys);
+        data.clear();
+        lengths.clear();
+        AppendOnlyBufferedStream dataStream(
+            std::make_unique<BufferedOutputStream>(pool, &data, 1024 * 1024, 64 * 1024, nullptr));
+        std::unique_ptr<RleEncoder> lengthEncoder = createRleEncoder(
+            std::make_unique<BufferedOutputStream>(pool, &lengths, 1024 * 1024, 64 * 1024, nullptr),
+            false, RleVersion_2, pool, true);
+        state.resumeTiming();
+        dictionary.flush(&dataStream, lengthEncoder.get());
+        dataStream.flush();
+        lengthEncoder->flush();
+        size = dictionary.size();
+      }
+      state.setItemsPerIteration(size);
+    });
+  }
+
+  void registerDictionaryBenchmarks() {
+    for (uint64_t cardinality : {100, 10000, 65536}) {
+      addDictionaryBenchmarks(cardinality);
+    }
+  }
+
+}  // namespace orc
@@ -0,0 +1,215 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Benchmark.hh"
+
+#include "BpackingDefault.hh"
+#include "ByteRLE.hh"
+#include "RLEv2.hh"
+#include "io/InputStream.hh"
+#include "io/OutputStream.hh"
+
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+#include "BpackingAvx512.hh"
+#include "CpuInfoUtil.hh"
+#endif
+
+#include <random>
+#include <vector>
+
+namespace orc {
+
+  static const uint64_t NUM_VALUES = 64 * 1024;
+  // the largest number of values that RleDecoderV2 unpacks at once
+  static const uint64_t UNPACK_BATCH = 512;
+
+  // values that the RLEv2 encoder writes with the encoding of the name
+  static std::vector<int64_t> makeRleValues(const std::string& shape, uint32_t bitWidth) {
+    std::mt19937_64 random(42);
+    std::vector<int64_t> values(NUM_VALUES);
+    const uint64_t mask = bitWidth == 64 ? ~0ULL : (1ULL << bitWidth) - 1;
+    for (uint64_t i = 0; i < NUM_VALUES; ++i) {
+      if (shape == "shortRepeat") {
+        // runs of 5 equal values
+        values[i] = i % 5 == 0 ? static_cast<int64_t>(random() & 0xffff) : values[i - 1];
+      } else if (shape == "delta") {
+        values[i] = 1000000 + 7 * static_cast<int64_t>(i);
+      } else if (shape == "patchedBase") {
+        // small values with a few outliers that would widen all of them
+        values[i] = static_cast<int64_t>(random() % 100 == 0 ? random() & 0xffffffffff
+                                                             : random() & 0xff);
+      } else {
+        values[i] = static_cast<int64_t>(random() & mask);
+      }
+    }
+    return values;
+  }
+
+  static std::unique_ptr<RleEncoder> createEncoder(StringOutputStream& output, RleVersion version) {
+    MemoryPool& pool = *getDefaultPool();
+    return createRleEncoder(
+        std::make_unique<BufferedOutputStream>(pool, &output, 1024 * 1024, 64 * 1024, nullptr),
+        false, version, pool, true);
+  }
+
+  static std::string encode(const std::vector<int64_t>& values) {
+    StringOutputStream output;
+    std::unique_ptr<RleEncoder> encoder = createEncoder(output, RleVersion_2);
+    encoder->add(values.data(), values.size(), nullptr);
+    encoder->flush();
+    return output.getData();
+  }
+
+  static void addRleV2Benchmarks(const std::string& shape, uint32_t bitWidth) {
+    const std::string name = bitWidth == 0 ? shape : shape + "/" + std::to_string(bitWidth);
+    addBenchmark("RleV2/decode/" + name, [shape, bitWidth](BenchmarkState& state) {
+      const std::vector<int64_t> values = makeRleValues(shape, bitWidth);
+      const std::string encoded = encode(values);
+      std::vector<int64_t> decoded(NUM_VALUES);
+      while (state.keepRunning()) {
+        std::unique_ptr<RleDecoder> decoder =
+            createRleDecoder(std::make_unique<SeekableArrayInputStream>(encoded.data(),
+                                                                        encoded.size()),
+                             false, RleVersion_2, *getDefaultPool(), nullptr);
+        decoder->next(decoded.data(), NUM_VALUES, nullptr);
+        doNotOptimize(decoded.data());
+      }
+      if (decoded != values) {
+        throw std::logic_error("RLEv2 decoding does not match the input");
+      }
+      state.setBytesPerIteration(NUM_VALUES * sizeof(int64_t));
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+    addBenchmark("RleV2/encode/" + name, [shape, bitWidth](BenchmarkState& state) {
+      const std::vector<int64_t> values = makeRleValues(shape, bitWidth);
+      StringOutputStream output;
+      while (state.keepRunning()) {
+        output.clear();
+        std::unique_ptr<RleEncoder> encoder = createEncoder(output, RleVersion_2);
+        encoder->add(values.data(), values.size(), nullptr);
+        encoder->flush();
+        doNotOptimize(output.getData().data());
+      }
+      state.setBytesPerIteration(NUM_VALUES * sizeof(int64_t));
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+  }
+
+  using ReadLongs = void (*)(RleDecoderV2*, int64_t*, uint64_t, uint64_t, uint64_t);
+
+  // unpacks bitWidth wide values in the batches that the decoder uses
+  static void unpack(BenchmarkState& state, ReadLongs readLongs, uint32_t bitWidth) {
+    std::mt19937_64 random(42);
+    std::string packed(NUM_VALUES * bitWidth / 8, '\0');
+    for (char& byte : packed) {
+      byte = static_cast<char>(random());
+    }
+    std::vector<int64_t> values(UNPACK_BATCH);
+    while (state.keepRunning()) {
+      RleDecoderV2 decoder(std::make_unique<SeekableArrayInputStream>(packed.data(), packed.size()),
+                           false, *getDefaultPool(), nullptr);
+      for (uint64_t done = 0; done < NUM_VALUES; done += UNPACK_BATCH) {
+        readLongs(&decoder, values.data(), 0, UNPACK_BATCH, bitWidth);
+        doNotOptimize(values.data());
+      }
+    }
+    state.setBytesPerIteration(packed.size());
+    state.setItemsPerIteration(NUM_VALUES);
+  }
+
+  static void addBitUnpackBenchmarks(uint32_t bitWidth) {
+    addBenchmark("BitUnpack/default/" + std::to_string(bitWidth),
+                 [bitWidth](BenchmarkState& state) {
+                   unpack(state, BitUnpackDefault::readLongs, bitWidth);
+                 });
+    addBenchmark("BitUnpack/avx512/" + std::to_string(bitWidth),
+                 [bitWidth](BenchmarkState& state) {
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+                   if (CpuInfo::getInstance()->isSupported(CpuInfo::AVX512)) {
+                     unpack(state, BitUnpackAVX512::readLongs, bitWidth);
+                   } else {
+                     state.skip("the CPU does not support AVX512");
+                   }
+#else
+                   (void)bitWidth;
+                   state.skip("built without BUILD_ENABLE_AVX512");
+#endif
+                 });
+  }
+
+  // runs of one byte when runs is set, random bytes otherwise
+  static std::string encodeBytes(std::vector<char>& bytes, bool runs, bool boolean) {
+    std::mt19937_64 random(42);
+    for (uint64_t i = 0; i < bytes.size(); ++i) {
+      if (runs) {
+        bytes[i] = i % 100 == 0 ? static_cast<char>(random()) : bytes[i - 1];
+      } else {
+        bytes[i] = static_cast<char>(random());
+      }
+      if (boolean) {
+        bytes[i] = static_cast<char>(bytes[i] & 1);
+      }
+    }
+    StringOutputStream output;
+    std::unique_ptr<BufferedOutputStream> stream = std::make_unique<BufferedOutputStream>(
+        *getDefaultPool(), &output, 1024 * 1024, 64 * 1024, nullptr);
+    std::unique_ptr<ByteRleEncoder> encoder = boolean ? createBooleanRleEncoder(std::move(stream))
+                                                      : createByteRleEncoder(std::move(stream));
+    encoder->add(bytes.data(), bytes.size(), nullptr);
+    encoder->flush();
+    return output.getData();
+  }
+
+  static void addByteRleBenchmark(const std::string& name, bool runs, bool boolean) {
+    addBenchmark(name, [runs, boolean](BenchmarkState& state) {
+      std::vector<char> bytes(NUM_VALUES);
+      const std::string encoded = encodeBytes(bytes, runs, boolean);
+      std::vector<char> decoded(NUM_VALUES);
+      while (state.keepRunning()) {
+        auto input = std::make_unique<SeekableArrayInputStream>(encoded.data(), encoded.size());
+        std::unique_ptr<ByteRleDecoder> decoder =
+            boolean ? createBooleanRleDecoder(std::move(input), nullptr)
+                    : createByteRleDecoder(std::move(input), nullptr);
+        decoder->next(decoded.data(), NUM_VALUES, nullptr);
+        doNotOptimize(decoded.data());
+      }
+      if (decoded != bytes) {
+        throw std::logic_error("byte RLE decoding does not match the input");
+      }
+      state.setBytesPerIteration(NUM_VALUES);
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+  }
+
+  void registerRleBenchmarks() {
+    addRleV2Benchmarks("shortRepeat", 0);
+    addRleV2Benchmarks("delta", 0);
+    addRleV2Benchmarks("patchedBase", 0);
+    for (uint32_t bitWidth : {1, 2, 4, 8, 11, 16, 24, 32, 48, 64}) {
+      addRleV2Benchmarks("direct", bitWidth);
+    }
+    for (uint32_t bitWidth : {1, 2, 3, 4, 7, 8, 12, 16, 20, 24, 32, 40, 48, 56, 64}) {
+      addBitUnpackBenchmarks(bitWidth);
+    }
+    addByteRleBenchmark("ByteRle/decode/runs", true, false);
+    addByteRleBenchmark("ByteRle/decode/literals", false, false);
+    addByteRleBenchmark("BooleanRle/decode/runs", true, true);
+    addByteRleBenchmark("BooleanRle/decode/literals", false, true);
+  }
+
+}  // namespace orc
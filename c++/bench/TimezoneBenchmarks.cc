@@ -0,0 +1,101 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Benchmark.hh"
+
+#include "Timezone.hh"
+
+#include <random>
+#include <vector>
+
+namespace orc {
+
+  static const uint64_t NUM_VALUES = 64 * 1024;
+
+  // seconds between 1900 and 2100, which covers both the transitions of the
+  // zone and the rule for the years after them
+  static std::vector<int64_t> makeSeconds() {
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<int64_t> seconds(-2208988800, 4102444800);
+    std::vector<int64_t> values(NUM_VALUES);
+    for (int64_t& value : values) {
+      value = seconds(random);
+    }
+    return values;
+  }
+
+  // the zone or nullptr after skipping the benchmark when it is not available
+  static const Timezone* findZone(BenchmarkState& state, const std::string& zone) {
+    try {
+      return &getTimezoneByName(zone);
+    } catch (std::exception& ex) {
+      state.skip(ex.what());
+      return nullptr;
+    }
+  }
+
+  static void addTimezoneBenchmarks(const std::string& zone) {
+    addBenchmark("Timezone/convertToUTC/" + zone, [zone](BenchmarkState& state) {
+      const Timezone* timezone = findZone(state, zone);
+      if (timezone == nullptr) {
+        return;
+      }
+      const std::vector<int64_t> values = makeSeconds();
+      while (state.keepRunning()) {
+        for (int64_t value : values) {
+          doNotOptimize(timezone->convertToUTC(value));
+        }
+      }
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+    addBenchmark("Timezone/convertFromUTC/" + zone, [zone](BenchmarkState& state) {
+      const Timezone* timezone = findZone(state, zone);
+      if (timezone == nullptr) {
+        return;
+      }
+      const std::vector<int64_t> values = makeSeconds();
+      while (state.keepRunning()) {
+        for (int64_t value : values) {
+          doNotOptimize(timezone->convertFromUTC(value));
+        }
+      }
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+    // the lookup of the offset that is in effect at a time
+    addBenchmark("Timezone/getVariant/" + zone, [zone](BenchmarkState& state) {
+      const Timezone* timezone = findZone(state, zone);
+      if (timezone == nullptr) {
+        return;
+      }
+      const std::vector<int64_t> values = makeSeconds();
+      while (state.keepRunning()) {
+        for (int64_t value : values) {
+          doNotOptimize(timezone->getVariant(value).gmtOffset);
+        }
+      }
+      state.setItemsPerIteration(NUM_VALUES);
+    });
+  }
+
+  void registerTimezoneBenchmarks() {
+    addTimezoneBenchmarks("UTC");
+    addTimezoneBenchmarks("America/Los_Angeles");
+    addTimezoneBenchmarks("Europe/Paris");
+  }
+
+}  // namespace orc
@@ -0,0 +1,139 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_ARROW_CDATA_HH
+#define ORC_ARROW_CDATA_HH
+
+#include "orc/Type.hh"
+#include "orc/Vector.hh"
+
+#include <cstdint>
+
+// The structures of the Arrow C data interface, copied verbatim from
+// https://arrow.apache.org/docs/format/CDataInterface.html. The guard lets
+// this header coexist with Arrow's own abi.h or any other copy of it.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace orc {
+
+  /**
+   * Describe an ORC type as an Arrow schema.
+   *
+   * Integers, floating point, strings, binaries, dates, structs and maps
+   * map to their Arrow counterparts. Timestamps become nanosecond
+   * timestamps (UTC for timestamp with local time zone), decimals become
+   * decimal128, lists become large lists and unions become dense unions.
+   * String columns are described with their plain layout; use
+   * exportArrowBatch to get the dictionary layout of an encoded batch.
+   * @param type the ORC type to describe
+   * @param schema the structure to fill; the caller must release it
+   */
+  void exportArrowSchema(const Type& type, ArrowSchema* schema);
+
+  /**
+   * Export a row batch through the Arrow C data interface.
+   *
+   * Buffers whose layout already matches Arrow are handed out without a
+   * copy: 64-bit integers and doubles, every integer width and float when
+   * the batch was created with setUseTightNumericVector, list offsets, union
+   * type ids, and the dictionary and indexes of an EncodedStringVectorBatch,
+   * which is exported as an Arrow dictionary array. All other buffers,
+   * including the validity bitmaps, are converted in a single pass.
+   *
+   * The exported array may reference memory of the batch, so the batch must
+   * be neither modified nor destroyed until the array is released.
+   *
+   * Nanosecond timestamps only reach from 1677 to 2262, so a batch with a
+   * timestamp outside of these years throws std::range_error.
+   * @param type the type of the batch
+   * @param batch the batch to export
+   * @param schema the structure to fill with the schema of this batch
+   * @param array the structure to fill with the data of this batch
+   */
+  void exportArrowBatch(const Type& type, const ColumnVectorBatch& batch, ArrowSchema* schema,
+                        ArrowArray* array);
+
+  /**
+   * Import an array received through the Arrow C data interface into a row
+   * batch of the given type, resizing the batch as needed.
+   *
+   * Every Arrow layout that exportArrowBatch produces is accepted, as well
+   * as 32- and 64-bit offsets for strings and lists, any integer width for
+   * integer columns and any time unit for timestamps. Dictionary arrays fill
+   * an EncodedStringVectorBatch with a copy of their dictionary and the
+   * indexes, so that Writer::add can map dictionary entries instead of
+   * hashing every row. Sparse unions and dense unions whose offsets are not
+   * consecutive for each child are rejected. The child rows that null list
+   * or map entries cover are dropped. Integers that do not fit the column
+   * throw std::range_error and decimals that do not fit its precision throw
+   * ParseError.
+   *
+   * Strings of plain arrays are not copied: the batch points into the
+   * buffers of the array, which must stay valid while the batch is used.
+   * The array is not released.
+   * @param type the type of the batch
+   * @param schema the schema of the array
+   * @param array the array to import
+   * @param batch the batch to fill, created by type.createRowBatch
+   */
+  void importArrowBatch(const Type& type, const ArrowSchema& schema, const ArrowArray& array,
+                        ColumnVectorBatch& batch);
+
+}  // namespace orc
+
+#endif
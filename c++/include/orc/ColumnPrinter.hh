@@ -41,6 +41,8 @@ namespace orc {
     virtual void printRow(uint64_t rowId) = 0;
     // should be called once at the start of each batch of rows
     virtual void reset(const ColumnVectorBatch& batch);
+    // appends every row of the batch to the buffer, each followed by a newline
+    void printBatch(const ColumnVectorBatch& batch);
     struct Param {
       bool printDecimalAsString = false;
       bool printDecimalTrimTrailingZeros = false;
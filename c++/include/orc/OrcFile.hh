@@ -19,6 +19,7 @@
 #ifndef ORC_FILE_HH
 #define ORC_FILE_HH
 
+#include <chrono>
 #include <future>
 #include <string>
 
@@ -143,6 +144,29 @@ namespace orc {
   [[deprecated("readHdfsFile is deprecated in 2.0.1")]] std::unique_ptr<InputStream> readHdfsFile(
       const std::string& path, ReaderMetrics* metrics = nullptr);
 
+  /**
+   * The behavior of the remote storage that simulateRemoteStorage imitates.
+   */
+  struct RemoteStorageOptions {
+    // the time from sending a request until its first byte arrives
+    std::chrono::microseconds latency{0};
+    // the transfer rate of each request in bytes per second, 0 for no limit
+    uint64_t bytesPerSecond = 0;
+  };
+
+  /**
+   * Wrap a stream so that every read takes as long as a request to remote
+   * storage, for example to tune the CacheOptions of preBuffer on a local
+   * file. Each read waits for the latency and for its bytes to transfer at
+   * the given rate before it reads from the wrapped stream. Asynchronous
+   * reads wait concurrently, so requests in flight at the same time take
+   * about as long as the slowest of them.
+   * @param stream the stream to wrap
+   * @param options the latency and bandwidth of each request
+   */
+  std::unique_ptr<InputStream> simulateRemoteStorage(std::unique_ptr<InputStream> stream,
+                                                     const RemoteStorageOptions& options);
+
   /**
    * Create a reader to read the ORC file.
    * @param stream the stream to read
@@ -164,6 +188,67 @@ namespace orc {
    */
   std::unique_ptr<Writer> createWriter(const Type& type, OutputStream* stream,
                                        const WriterOptions& options);
+
+  /**
+   * Merge ORC files into one by copying their stripes byte for byte instead
+   * of decoding and re-encoding the rows. The files must have the same schema,
+   * file version, writer version, compression kind, compression block size and
+   * row index stride. Stripe statistics are kept and file statistics are
+   * merged. User metadata of all files is kept; for duplicate keys the value
+   * from the first file wins.
+   * @param readers the files to merge, in the order their stripes are written
+   * @param stream the stream to write the merged file to; closed on success
+   * @param options the memory pool, output buffer capacity, compression
+   *   strategy and writer metrics are used
+   */
+  void mergeFiles(const std::vector<const Reader*>& readers, OutputStream* stream,
+                  const WriterOptions& options = WriterOptions());
+
+  /**
+   * Write a copy of a file that only contains the given top-level columns.
+   * The compressed streams of the selected columns are copied byte for byte;
+   * only the stripe footers, the type tree and the statistics are rebuilt.
+   * The columns keep their order in the original schema.
+   * @param reader the file to copy
+   * @param columns the names of the top-level columns to keep
+   * @param stream the stream to write the new file to; closed on success
+   * @param options the memory pool, output buffer capacity, compression
+   *   strategy and writer metrics are used
+   */
+  void projectColumns(const Reader* reader, const std::list<std::string>& columns,
+                      OutputStream* stream, const WriterOptions& options = WriterOptions());
+
+  /**
+   * The result of aggregateColumn.
+   */
+  struct ColumnAggregate {
+    // the number of matching rows, i.e. COUNT(*)
+    uint64_t numberOfRows = 0;
+    // the statistics of the column over the matching rows: getNumberOfValues()
+    // is COUNT(column) and the type specific statistics hold MIN, MAX and SUM
+    std::unique_ptr<ColumnStatistics> statistics;
+    // the number of row groups that were read because their statistics
+    // could not decide the search argument
+    uint64_t decodedRowGroups = 0;
+  };
+
+  /**
+   * Compute COUNT(*), COUNT, MIN, MAX and SUM of a column over the rows that
+   * match a search argument, using the file, stripe and row group statistics
+   * wherever they decide the search argument for all of their rows. Only the
+   * row groups whose statistics answer "maybe" are read, and the search
+   * argument is evaluated on each of their rows. Without a search argument
+   * the file statistics are returned.
+   *
+   * Reading rows requires the column and the columns of the search argument
+   * to be reachable from the root through struct fields only, and is not
+   * supported for timestamps; NotImplementedYet is thrown otherwise.
+   * @param reader the file to aggregate
+   * @param columnId the id of the column to aggregate
+   * @param searchArgument the rows to aggregate, or nullptr for all rows
+   */
+  ColumnAggregate aggregateColumn(const Reader* reader, uint64_t columnId,
+                                  const SearchArgument* searchArgument = nullptr);
 }  // namespace orc
 
 #endif
@@ -22,6 +22,7 @@
 #include "orc/BloomFilter.hh"
 #include "orc/Common.hh"
 #include "orc/Statistics.hh"
+#include "orc/Trace.hh"
 #include "orc/Type.hh"
 #include "orc/Vector.hh"
 #include "orc/orc-config.hh"
@@ -30,6 +31,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -75,6 +77,64 @@ namespace orc {
   };
   ReaderMetrics* getDefaultReaderMetrics();
 
+  /**
+   * The reader metrics of a single stream of a column.
+   */
+  struct StreamReaderMetrics {
+    // the length in the file of the stream of each stripe that was opened
+    std::atomic<uint64_t> BytesRead{0};
+    std::atomic<uint64_t> DecompressionCall{0};
+    // the bytes that the compressed chunks of the stream decompress to
+    std::atomic<uint64_t> BytesDecompressed{0};
+    std::atomic<uint64_t> DecompressionLatencyUs{0};
+    std::atomic<uint64_t> DecodingCall{0};
+    // the values that the RLE decoder of the stream returned
+    std::atomic<uint64_t> ValuesDecoded{0};
+    // DecodingLatencyUs excludes the time of reading and decompressing
+    // the stream.
+    std::atomic<uint64_t> DecodingLatencyUs{0};
+  };
+
+  /**
+   * The reader metrics of a single column.
+   */
+  struct ColumnReaderMetrics {
+    std::atomic<uint64_t> ReaderCall{0};
+    std::atomic<uint64_t> RowsRead{0};
+    std::map<StreamKind, StreamReaderMetrics> streams;
+  };
+
+  /**
+   * The reader metrics broken down by column id and stream kind, to find
+   * out which columns are expensive to read.
+   *
+   * Unlike ReaderMetrics, these metrics don't depend on the build. The
+   * clock is only read when a table is set on the ReaderOptions. Readers
+   * may share a table, but the columns should only be read once the
+   * readers are done.
+   */
+  class ColumnMetricsTable {
+   public:
+    /**
+     * Get the metrics of a column, adding them if they are missing.
+     */
+    ColumnReaderMetrics& getColumn(uint64_t columnId);
+
+    /**
+     * Get the metrics of a stream of a column, adding them if they are
+     * missing.
+     */
+    StreamReaderMetrics& getStream(uint64_t columnId, StreamKind kind);
+
+    const std::map<uint64_t, ColumnReaderMetrics>& getColumns() const {
+      return columns_;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::map<uint64_t, ColumnReaderMetrics> columns_;
+  };
+
   // Row group index of a single column in a stripe.
   struct RowGroupIndex {
     // Positions are represented as a two-dimensional array where the first
@@ -129,6 +189,22 @@ namespace orc {
      */
     ReaderOptions& setReaderMetrics(ReaderMetrics* metrics);
 
+    /**
+     * Set the recorder of the spans of reading, such as loading stripe
+     * footers and indexes, decoding columns, decompressing and waiting for
+     * prebuffered ranges.
+     *
+     * Defaults to nullptr, which records nothing.
+     */
+    ReaderOptions& setTraceRecorder(TraceRecorder* recorder);
+
+    /**
+     * Set the table of the reader metrics of each column.
+     *
+     * Defaults to nullptr, which collects no metrics per column.
+     */
+    ReaderOptions& setColumnMetricsTable(ColumnMetricsTable* table);
+
     /**
      * Set the cache options.
      */
@@ -166,6 +242,18 @@ namespace orc {
      */
     ReaderMetrics* getReaderMetrics() const;
 
+    /**
+     * Get the trace recorder.
+     * @return if not set, return nullptr.
+     */
+    TraceRecorder* getTraceRecorder() const;
+
+    /**
+     * Get the table of the reader metrics of each column.
+     * @return if not set, return nullptr.
+     */
+    ColumnMetricsTable* getColumnMetricsTable() const;
+
     /**
      * Set the cache options.
      */
@@ -388,10 +476,51 @@ namespace orc {
      * Whether reader throws or returns null when value overflows for schema evolution.
      */
     bool getThrowOnSchemaEvolutionOverflow() const;
+
+    /**
+     * Set the positions of deleted rows, as row numbers within the file in
+     * ascending order. The row reader drops these rows from the batches it
+     * returns. It skips stripes and row groups whose rows are all deleted,
+     * and skips over the values of other deleted rows instead of decoding
+     * them.
+     */
+    RowReaderOptions& setDeletedRows(std::vector<uint64_t> rows);
+
+    /**
+     * Get the positions of deleted rows.
+     * @return if not set, return nullptr
+     */
+    std::shared_ptr<const std::vector<uint64_t>> getDeletedRows() const;
   };
 
   class RowReader;
 
+  /**
+   * A stripe that a scan needs to read, see Reader::planScan.
+   */
+  struct ScanStripe {
+    // the index of the stripe in the file
+    uint64_t index;
+    // the offset and total length of the stripe in the file
+    uint64_t offset;
+    uint64_t length;
+    uint64_t numberOfRows;
+    // the length of the streams of the selected columns in the stripe
+    uint64_t selectedBytes;
+  };
+
+  /**
+   * A group of consecutive stripes that one task of a scan reads.
+   */
+  struct ScanSplit {
+    std::vector<ScanStripe> stripes;
+    // the sum of the selected bytes of the stripes
+    uint64_t selectedBytes;
+    // the byte range to pass to RowReaderOptions::range to read the split
+    uint64_t offset;
+    uint64_t length;
+  };
+
   /**
    * The interface for reading ORC file meta-data and constructing RowReaders.
    * This is an an abstract class that will be subclassed as necessary.
@@ -666,6 +795,27 @@ namespace orc {
      * @param boundary the boundary value to release cache entries
      */
     virtual void releaseBuffer(uint64_t boundary) = 0;
+
+    /**
+     * Plan a scan by dividing the stripes that it needs to read into
+     * splits of similar size. The size of a stripe is the length of the
+     * streams of the columns selected by the options rather than the size of
+     * the whole stripe, so projections of wide tables are balanced too.
+     * Stripes outside of the range of the options, and stripes whose
+     * statistics or the file statistics rule out the search argument, are
+     * dropped. Each split holds consecutive stripes, and the largest split is
+     * as small as possible.
+     *
+     * Readers other than the one createReader returns throw
+     * NotImplementedYet unless they override this.
+     * @param options the column selection, search argument and range of the
+     *   scan; the other options are ignored
+     * @param numSplits the maximum number of splits to return; fewer are
+     *   returned when there are fewer stripes
+     * @return the splits in file order
+     */
+    virtual std::vector<ScanSplit> planScan(const RowReaderOptions& options,
+                                            uint64_t numSplits) const;
   };
 
   /**
@@ -718,6 +868,40 @@ namespace orc {
      * @param rowNumber the next row the reader should return
      */
     virtual void seekToRow(uint64_t rowNumber) = 0;
+
+    /**
+     * Read the rows with the given row numbers into a batch.
+     *
+     * The rows are grouped by stripe and row group: the reader seeks once to
+     * each row group that contains a requested row, using the row index, and
+     * skips the rows between the requested ones. Runs of consecutive row
+     * numbers are decoded together. Neither search arguments nor deleted
+     * rows filter the requested rows, and string columns are always
+     * decoded, even if encoded blocks were requested.
+     *
+     * Afterwards the reader is positioned at the row after the last
+     * requested one, as if seekToRow had been called with it.
+     *
+     * Row readers other than the ones createRowReader returns throw
+     * NotImplementedYet unless they override this.
+     * @param rowIds the row numbers to read, in ascending order without
+     *   duplicates; each must be within the range of this reader
+     * @param data the batch to read into, created by createRowBatch. It is
+     *   resized to hold all rows and numElements is set to rowIds.size().
+     */
+    virtual void readRows(const std::vector<uint64_t>& rowIds, ColumnVectorBatch& data);
+
+    /**
+     * Whether every row of the batch returned by the last call to next()
+     * matches the search argument, because the statistics of its row group
+     * say so. Callers can skip their own evaluation of the predicate for
+     * such batches. A batch never mixes row groups that match entirely with
+     * ones that may not. Deleted rows are removed before this applies.
+     * @return false without a search argument, after readRows, when the
+     *   row groups may contain rows that do not match and for row readers
+     *   that do not override this
+     */
+    virtual bool allRowsMatch() const;
   };
 }  // namespace orc
 
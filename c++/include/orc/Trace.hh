@@ -0,0 +1,99 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_TRACE_HH
+#define ORC_TRACE_HH
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * A span of work that a reader or a writer did.
+   */
+  struct TraceSpan {
+    // what was done, such as "stripe footer" or "decompress"
+    const char* name;
+    // the part of the library, such as "read", "decode" or "write"
+    const char* category;
+    // microseconds since the recorder was created
+    uint64_t startUs;
+    uint64_t durationUs;
+    // the thread in the order that threads recorded their first span
+    uint64_t thread;
+    // the stripe, column or byte counts that the span is about
+    std::vector<std::pair<const char*, uint64_t>> args;
+  };
+
+  /**
+   * Records the spans of the work that readers and writers do, such as
+   * loading a stripe footer, decoding a column or flushing a stripe, and
+   * writes them in the Chrome trace event format that chrome://tracing and
+   * Perfetto open. Pass it to ReaderOptions::setTraceRecorder or
+   * WriterOptions::setTraceRecorder; without a recorder the spans cost a
+   * pointer comparison. It is thread safe.
+   */
+  class TraceRecorder {
+   public:
+    TraceRecorder();
+
+    /**
+     * Get the time that spans are measured in.
+     * @return the microseconds since the recorder was created
+     */
+    uint64_t now() const;
+
+    /**
+     * Record a span that started at startUs and ends now.
+     */
+    void addSpan(const char* name, const char* category, uint64_t startUs,
+                 std::vector<std::pair<const char*, uint64_t>> args = {});
+
+    /**
+     * Get a copy of the spans recorded so far in the order they ended.
+     */
+    std::vector<TraceSpan> getSpans() const;
+
+    /**
+     * Drop the spans recorded so far.
+     */
+    void clear();
+
+    /**
+     * Write the spans as a JSON object with a traceEvents array of complete
+     * ("X") events, with times in microseconds.
+     */
+    void writeChromeTrace(std::ostream& out) const;
+
+   private:
+    const std::chrono::steady_clock::time_point start_;
+    mutable std::mutex mutex_;
+    std::vector<TraceSpan> spans_;
+    std::map<std::thread::id, uint64_t> threads_;
+  };
+
+}  // namespace orc
+
+#endif
@@ -20,6 +20,7 @@
 #define ORC_WRITER_HH
 
 #include "orc/Common.hh"
+#include "orc/Trace.hh"
 #include "orc/Type.hh"
 #include "orc/Vector.hh"
 #include "orc/orc-config.hh"
@@ -30,6 +31,9 @@
 #include <string>
 #include <vector>
 
+struct ArrowArray;
+struct ArrowSchema;
+
 namespace orc {
 
   // classes that hold data members so we can maintain binary compatibility
@@ -49,6 +53,15 @@ namespace orc {
     std::atomic<uint64_t> IOCount{0};
     // Record the lantency of IO blocking
     std::atomic<uint64_t> IOBlockingLatencyUs{0};
+    // Record the number of string columns that decided whether to keep
+    // dictionary encoding, and how many of them fell back to direct encoding
+    std::atomic<uint64_t> DictionaryCheckCount{0};
+    std::atomic<uint64_t> DictionaryAbandonedCount{0};
+    // Record the number of values and distinct keys seen when those decisions
+    // were made; DictionarySampledKeys / DictionarySampledValues is the
+    // observed key ratio that is compared with the dictionary key size threshold
+    std::atomic<uint64_t> DictionarySampledValues{0};
+    std::atomic<uint64_t> DictionarySampledKeys{0};
   };
   /**
    * Options for creating a Writer.
@@ -112,6 +125,24 @@ namespace orc {
      */
     double getDictionaryKeySizeThreshold() const;
 
+    /**
+     * Set the number of non-null values a string column buffers in its
+     * dictionary before deciding whether to keep dictionary encoding. Once the
+     * ratio of distinct keys to values exceeds the dictionary key size
+     * threshold, the column switches to direct encoding for the rest of the
+     * file without hashing further values.
+     * 0 to decide at the first row group, or at the end of the first stripe
+     * if the row index is disabled. The decision never happens later than the
+     * first row group.
+     */
+    WriterOptions& setDictionarySampleSize(uint64_t size);
+
+    /**
+     * Get the number of values sampled before the dictionary check.
+     * @return if not set, return default value which is 0.
+     */
+    uint64_t getDictionarySampleSize() const;
+
     /**
      * Set Orc file version
      */
@@ -254,6 +285,18 @@ namespace orc {
      */
     WriterMetrics* getWriterMetrics() const;
 
+    /**
+     * Set the recorder of the spans of writing, such as flushing stripes.
+     * Defaults to nullptr, which records nothing.
+     */
+    WriterOptions& setTraceRecorder(TraceRecorder* recorder);
+
+    /**
+     * Get the trace recorder.
+     * @return if not set, return nullptr.
+     */
+    TraceRecorder* getTraceRecorder() const;
+
     /**
      * Set use tight numeric vectorBatch or not.
      */
@@ -303,6 +346,24 @@ namespace orc {
      * @return if not set, return default value which is false.
      */
     bool getAlignBlockBoundToRowGroup() const;
+
+    /**
+     * Set whether finished stripes are written to the output stream on a
+     * background thread. When enabled, the encoded streams of a stripe are
+     * staged in memory and written while the next stripe is being encoded,
+     * which hides the latency of the output stream behind encoding. Up to two
+     * stripes are buffered at a time and their buffers are allocated from the
+     * writer's memory pool on the caller's thread only, so the pool does not
+     * need to be thread-safe. The output stream must tolerate being written
+     * from a thread other than the caller's.
+     */
+    WriterOptions& setAsyncStripeFlush(bool asyncStripeFlush);
+
+    /**
+     * Get whether finished stripes are written on a background thread.
+     * @return if not set, return default value which is false.
+     */
+    bool getAsyncStripeFlush() const;
   };
 
   class Writer {
@@ -318,10 +379,27 @@ namespace orc {
 
     /**
      * Add a row batch into current writer.
+     * String, char and varchar columns may be passed as EncodedStringVectorBatch
+     * (as returned by a reader with lazy decoding enabled); their dictionary
+     * indexes are then remapped without hashing each value again.
      * @param rowsToAdd the row batch data to write.
      */
     virtual void add(ColumnVectorBatch& rowsToAdd) = 0;
 
+    /**
+     * Add rows received through the Arrow C data interface. The array is
+     * imported with importArrowBatch (see orc/ArrowCData.hh) into a batch
+     * owned by the writer, so Arrow dictionary arrays feed the string
+     * dictionaries the same way an EncodedStringVectorBatch does. The array
+     * is not released.
+     *
+     * Writers other than the one createWriter returns throw
+     * NotImplementedYet unless they override this.
+     * @param schema the schema of the array, which must match the file type
+     * @param array the rows to write
+     */
+    virtual void add(const ArrowSchema& schema, const ArrowArray& array);
+
     /**
      * Close the writer and flush any pending data to the output stream.
      */
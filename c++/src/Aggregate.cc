@@ -0,0 +1,372 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/Exceptions.hh"
+#include "orc/OrcFile.hh"
+
+#include "Reader.hh"
+#include "Statistics.hh"
+#include "sargs/SargsApplier.hh"
+
+#include <algorithm>
+#include <set>
+#include <typeinfo>
+
+namespace orc {
+
+  // rows read at once from the row groups that statistics cannot decide
+  static const uint64_t AGGREGATE_BATCH_SIZE = 1024;
+
+  static const ReaderImpl& toReaderImpl(const Reader* reader) {
+    const ReaderImpl* impl = dynamic_cast<const ReaderImpl*>(reader);
+    if (impl == nullptr) {
+      throw InvalidArgument("Aggregates can only be computed on readers created by createReader");
+    }
+    return *impl;
+  }
+
+  // whether the statistics have the minimum and maximum of their values, if
+  // the type has them at all
+  static bool hasBounds(const ColumnStatistics& stats) {
+    if (auto intStats = dynamic_cast<const IntegerColumnStatistics*>(&stats)) {
+      return intStats->hasMinimum();
+    } else if (auto doubleStats = dynamic_cast<const DoubleColumnStatistics*>(&stats)) {
+      return doubleStats->hasMinimum();
+    } else if (auto stringStats = dynamic_cast<const StringColumnStatistics*>(&stats)) {
+      return stringStats->hasMinimum();
+    } else if (auto dateStats = dynamic_cast<const DateColumnStatistics*>(&stats)) {
+      return dateStats->hasMinimum();
+    } else if (auto decimalStats = dynamic_cast<const DecimalColumnStatistics*>(&stats)) {
+      return decimalStats->hasMinimum();
+    } else if (auto timestampStats = dynamic_cast<const TimestampColumnStatistics*>(&stats)) {
+      return timestampStats->hasMinimum();
+    } else if (auto boolStats = dynamic_cast<const BooleanColumnStatistics*>(&stats)) {
+      return boolStats->hasCount();
+    }
+    return true;
+  }
+
+  /**
+   * Merge statistics read from the file into stats. Statistics that have
+   * values but lack their minimum and maximum, e.g. string statistics of old
+   * writers, are not merged.
+   * @return whether the statistics were merged
+   */
+  static bool mergeStatistics(const proto::ColumnStatistics& pbStats, const Type& type,
+                              const StatContext& statContext, MutableColumnStatistics& stats) {
+    std::unique_ptr<ColumnStatistics> converted(convertColumnStatistics(pbStats, statContext));
+    auto& other = dynamic_cast<MutableColumnStatistics&>(*converted);
+    if (typeid(other) == typeid(stats) && hasBounds(*converted)) {
+      stats.merge(other);
+    } else if (converted->getNumberOfValues() == 0) {
+      // no type specific statistics are written without values
+      std::unique_ptr<MutableColumnStatistics> counts = createColumnStatistics(type);
+      counts->setHasNull(converted->hasNull());
+      stats.merge(*counts);
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // Find the batch of a column in a batch of the selected type. Only columns
+  // reached from the root through struct fields have a value in each row.
+  static const ColumnVectorBatch* findColumnBatch(const Type& fileType, const Type& selectedType,
+                                                  const ColumnVectorBatch& batch,
+                                                  uint64_t columnId) {
+    if (fileType.getColumnId() == columnId) {
+      return &batch;
+    }
+    for (uint64_t i = 0; i < fileType.getSubtypeCount(); ++i) {
+      const Type& child = *fileType.getSubtype(i);
+      if (columnId < child.getColumnId() || columnId > child.getMaximumColumnId()) {
+        continue;
+      }
+      if (fileType.getKind() != STRUCT) {
+        throw NotImplementedYet("Cannot aggregate rows of column " + std::to_string(columnId) +
+                                " that is nested in a " + fileType.toString());
+      }
+      const auto& structBatch = dynamic_cast<const StructVectorBatch&>(batch);
+      for (uint64_t field = 0; field < selectedType.getSubtypeCount(); ++field) {
+        if (selectedType.getFieldName(field) == fileType.getFieldName(i)) {
+          return findColumnBatch(child, *selectedType.getSubtype(field), *structBatch.fields[field],
+                                 columnId);
+        }
+      }
+    }
+    throw InvalidArgument("Column " + std::to_string(columnId) + " is not selected");
+  }
+
+  // add a value of a batch to the statistics the way the column writers do
+  static void updateStatistics(MutableColumnStatistics& stats, const Type& type,
+                               const ColumnVectorBatch& batch, uint64_t row) {
+    if (batch.hasNulls && !batch.notNull[row]) {
+      stats.setHasNull(true);
+      return;
+    }
+    stats.increase(1);
+    switch (static_cast<int>(type.getKind())) {
+      case BYTE:
+      case SHORT:
+      case INT:
+      case LONG:
+        dynamic_cast<IntegerColumnStatisticsImpl&>(stats).update(
+            dynamic_cast<const LongVectorBatch&>(batch).data[row], 1);
+        break;
+      case BOOLEAN:
+        dynamic_cast<BooleanColumnStatisticsImpl&>(stats).update(
+            dynamic_cast<const LongVectorBatch&>(batch).data[row] != 0, 1);
+        break;
+      case FLOAT:
+      case DOUBLE:
+        dynamic_cast<DoubleColumnStatisticsImpl&>(stats).update(
+            dynamic_cast<const DoubleVectorBatch&>(batch).data[row]);
+        break;
+      case STRING:
+      case CHAR:
+      case VARCHAR: {
+        const auto& strings = dynamic_cast<const StringVectorBatch&>(batch);
+        dynamic_cast<StringColumnStatisticsImpl&>(stats).update(
+            strings.data[row], static_cast<size_t>(strings.length[row]));
+        break;
+      }
+      case BINARY:
+        dynamic_cast<BinaryColumnStatisticsImpl&>(stats).update(
+            static_cast<size_t>(dynamic_cast<const StringVectorBatch&>(batch).length[row]));
+        break;
+      case DATE:
+        dynamic_cast<DateColumnStatisticsImpl&>(stats).update(
+            static_cast<int32_t>(dynamic_cast<const LongVectorBatch&>(batch).data[row]));
+        break;
+      case DECIMAL: {
+        auto& decimalStats = dynamic_cast<DecimalColumnStatisticsImpl&>(stats);
+        if (auto decimals = dynamic_cast<const Decimal64VectorBatch*>(&batch)) {
+          decimalStats.update(Decimal(Int128(decimals->values[row]), decimals->scale));
+        } else {
+          const auto& decimals128 = dynamic_cast<const Decimal128VectorBatch&>(batch);
+          decimalStats.update(Decimal(decimals128.values[row], decimals128.scale));
+        }
+        break;
+      }
+      default:
+        // compound types only count their values
+        break;
+    }
+  }
+
+  namespace {
+
+    // Reads the rows whose row groups statistics cannot decide and aggregates
+    // the ones that match the search argument.
+    class RowAggregator {
+     public:
+      RowAggregator(const Reader& reader, const Type& type, const SearchArgument* searchArgument,
+                    const std::vector<uint64_t>& filterColumns)
+          : type_(type), searchArgument_(searchArgument) {
+        if (type.getKind() == TIMESTAMP || type.getKind() == TIMESTAMP_INSTANT) {
+          throw NotImplementedYet("Cannot aggregate rows of timestamp column " +
+                                  std::to_string(type.getColumnId()));
+        }
+        std::list<uint64_t> columns = {type.getColumnId()};
+        for (uint64_t column : filterColumns) {
+          if (column != INVALID_COLUMN_ID) {
+            columns.push_back(column);
+          }
+        }
+        RowReaderOptions options;
+        options.includeTypes(columns);
+        rowReader_ = reader.createRowReader(options);
+        batch_ = rowReader_->createRowBatch(AGGREGATE_BATCH_SIZE);
+
+        const Type& fileType = reader.getType();
+        const Type& selectedType = rowReader_->getSelectedType();
+        column_ = findColumnBatch(fileType, selectedType, *batch_, type.getColumnId());
+        for (uint64_t column : filterColumns) {
+          leafColumns_.push_back(column == INVALID_COLUMN_ID
+                                     ? nullptr
+                                     : findColumnBatch(fileType, selectedType, *batch_, column));
+        }
+        if (searchArgument_ != nullptr) {
+          leaves_ = &dynamic_cast<const SearchArgumentImpl*>(searchArgument_)->getLeaves();
+        }
+      }
+
+      void aggregate(uint64_t firstRow, uint64_t numRows, MutableColumnStatistics& stats,
+                     uint64_t& numberOfRows) {
+        std::vector<TruthValue> leafValues(leafColumns_.size());
+        rowReader_->seekToRow(firstRow);
+        while (numRows > 0 && rowReader_->next(*batch_)) {
+          uint64_t rows = std::min(batch_->numElements, numRows);
+          for (uint64_t row = 0; row < rows; ++row) {
+            if (searchArgument_ != nullptr) {
+              for (size_t leaf = 0; leaf < leafValues.size(); ++leaf) {
+                leafValues[leaf] = (*leaves_)[leaf].evaluate(leafColumns_[leaf], row);
+              }
+              if (searchArgument_->evaluate(leafValues) != TruthValue::YES) {
+                continue;
+              }
+            }
+            ++numberOfRows;
+            updateStatistics(stats, type_, *column_, row);
+          }
+          numRows -= rows;
+        }
+      }
+
+     private:
+      const Type& type_;
+      const SearchArgument* searchArgument_;
+      const std::vector<PredicateLeaf>* leaves_ = nullptr;
+      std::unique_ptr<RowReader> rowReader_;
+      std::unique_ptr<ColumnVectorBatch> batch_;
+      const ColumnVectorBatch* column_;
+      std::vector<const ColumnVectorBatch*> leafColumns_;
+    };
+
+  }  // namespace
+
+  ColumnAggregate aggregateColumn(const Reader* input, uint64_t columnId,
+                                  const SearchArgument* searchArgument) {
+    const ReaderImpl& reader = toReaderImpl(input);
+    const Type& schema = reader.getType();
+    if (columnId > schema.getMaximumColumnId()) {
+      throw InvalidArgument("Column id " + std::to_string(columnId) + " is out of range");
+    }
+    const Type& type = *schema.getTypeByColumnId(columnId);
+    const proto::Footer& footer = *reader.getFooter();
+    StatContext statContext(reader.hasCorrectStatistics());
+    std::unique_ptr<MutableColumnStatistics> stats = createColumnStatistics(type);
+    ColumnAggregate result;
+
+    std::unique_ptr<SargsApplier> sargsApplier;
+    std::vector<uint64_t> filterColumns;
+    TruthValue fileTruth = TruthValue::YES;
+    if (searchArgument != nullptr) {
+      sargsApplier = std::make_unique<SargsApplier>(
+          schema, searchArgument, reader.getRowIndexStride(), reader.getWriterVersion(), nullptr);
+      filterColumns = sargsApplier->getFilterColumns();
+      if (footer.statistics_size() > 0) {
+        fileTruth = sargsApplier->evaluateStatistics(footer.statistics());
+      } else {
+        fileTruth = TruthValue::YES_NO_NULL;
+      }
+    }
+
+    if (fileTruth == TruthValue::YES && static_cast<int>(columnId) < footer.statistics_size() &&
+        mergeStatistics(footer.statistics(static_cast<int>(columnId)), type, statContext,
+                        *stats)) {
+      result.numberOfRows = footer.number_of_rows();
+    } else if (isNeeded(fileTruth)) {
+      std::set<uint32_t> indexColumns = {static_cast<uint32_t>(columnId)};
+      std::set<uint32_t> bloomFilterColumns;
+      for (uint64_t column : filterColumns) {
+        if (column != INVALID_COLUMN_ID) {
+          indexColumns.insert(static_cast<uint32_t>(column));
+          bloomFilterColumns.insert(static_cast<uint32_t>(column));
+        }
+      }
+
+      // adjacent row groups that must be read are read in one go
+      std::unique_ptr<RowAggregator> rowAggregator;
+      uint64_t readStart = 0;
+      uint64_t readEnd = 0;
+      auto flushRows = [&]() {
+        if (readEnd > readStart) {
+          if (rowAggregator == nullptr) {
+            rowAggregator = std::make_unique<RowAggregator>(reader, type, searchArgument,
+                                                            filterColumns);
+          }
+          rowAggregator->aggregate(readStart, readEnd - readStart, *stats, result.numberOfRows);
+        }
+        readStart = readEnd;
+      };
+      auto readRows = [&](uint64_t firstRow, uint64_t numRows) {
+        if (firstRow != readEnd) {
+          flushRows();
+          readStart = firstRow;
+        }
+        readEnd = firstRow + numRows;
+        ++result.decodedRowGroups;
+      };
+
+      const proto::Metadata* metadata = reader.getMetadata();
+      uint64_t stride = reader.getRowIndexStride();
+      uint64_t stripeStart = 0;
+      for (int i = 0; i < footer.stripes_size(); ++i) {
+        uint64_t stripeRows = footer.stripes(i).number_of_rows();
+        bool hasStripeStats = metadata != nullptr && i < metadata->stripe_stats_size() &&
+                              metadata->stripe_stats(i).col_stats_size() > 0;
+        TruthValue stripeTruth = fileTruth;
+        if (stripeTruth != TruthValue::YES) {
+          stripeTruth = TruthValue::YES_NO_NULL;
+          if (hasStripeStats) {
+            stripeTruth = sargsApplier->evaluateStatistics(metadata->stripe_stats(i).col_stats());
+          }
+        }
+
+        if (!isNeeded(stripeTruth)) {
+          // no row of the stripe matches
+        } else if (stripeTruth == TruthValue::YES && hasStripeStats &&
+                   static_cast<int>(columnId) < metadata->stripe_stats(i).col_stats_size() &&
+                   mergeStatistics(metadata->stripe_stats(i).col_stats(static_cast<int>(columnId)),
+                                   type, statContext, *stats)) {
+          result.numberOfRows += stripeRows;
+        } else {
+          uint32_t stripeIndex = static_cast<uint32_t>(i);
+          std::unordered_map<uint64_t, proto::RowIndex> rowIndexes;
+          std::map<uint32_t, BloomFilterIndex> bloomFilters;
+          if (stride > 0) {
+            rowIndexes = reader.getRowIndexes(stripeIndex, indexColumns);
+            if (stripeTruth != TruthValue::YES && !bloomFilterColumns.empty()) {
+              bloomFilters = reader.getBloomFilters(stripeIndex, bloomFilterColumns);
+            }
+          }
+          auto columnIndex = rowIndexes.find(columnId);
+          if (rowIndexes.empty()) {
+            readRows(stripeStart, stripeRows);
+          } else {
+            for (uint64_t rowGroup = 0; rowGroup * stride < stripeRows; ++rowGroup) {
+              uint64_t groupStart = rowGroup * stride;
+              uint64_t groupRows = std::min(stride, stripeRows - groupStart);
+              TruthValue groupTruth = stripeTruth;
+              if (groupTruth != TruthValue::YES) {
+                groupTruth = sargsApplier->evaluateRowGroup(rowGroup, rowIndexes, bloomFilters);
+              }
+              if (!isNeeded(groupTruth)) {
+                continue;
+              } else if (groupTruth == TruthValue::YES && columnIndex != rowIndexes.end() &&
+                         mergeStatistics(
+                             columnIndex->second.entry(static_cast<int>(rowGroup)).statistics(),
+                             type, statContext, *stats)) {
+                result.numberOfRows += groupRows;
+              } else {
+                readRows(stripeStart + groupStart, groupRows);
+              }
+            }
+          }
+        }
+        stripeStart += stripeRows;
+      }
+      flushRows();
+    }
+
+    result.statistics.reset(dynamic_cast<ColumnStatistics*>(stats.release()));
+    return result;
+  }
+
+}  // namespace orc
@@ -0,0 +1,1289 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/ArrowCData.hh"
+#include "orc/Exceptions.hh"
+
+#include "Adaptor.hh"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * Everything an exported ArrowSchema points to. The children live here so
+   * that a consumer may move any of them out before releasing the parent.
+   */
+  struct ArrowSchemaPrivate {
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema*> childPointers;
+    ArrowSchema dictionary{};
+  };
+
+  /**
+   * Everything an exported ArrowArray points to: the buffer table, the
+   * children, the buffers that had to be converted and a reference to the
+   * string dictionary that is handed out without a copy.
+   */
+  struct ArrowArrayPrivate {
+    std::vector<const void*> buffers;
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> childPointers;
+    ArrowArray dictionary{};
+    std::vector<DataBuffer<char>> ownedBuffers;
+    std::shared_ptr<StringDictionary> stringDictionary;
+  };
+
+  static void releaseArrowSchema(ArrowSchema* schema) {
+    auto* priv = static_cast<ArrowSchemaPrivate*>(schema->private_data);
+    for (auto& child : priv->children) {
+      if (child.release != nullptr) {
+        child.release(&child);
+      }
+    }
+    if (priv->dictionary.release != nullptr) {
+      priv->dictionary.release(&priv->dictionary);
+    }
+    delete priv;
+    schema->release = nullptr;
+  }
+
+  static void releaseArrowArray(ArrowArray* array) {
+    auto* priv = static_cast<ArrowArrayPrivate*>(array->private_data);
+    for (auto& child : priv->children) {
+      if (child.release != nullptr) {
+        child.release(&child);
+      }
+    }
+    if (priv->dictionary.release != nullptr) {
+      priv->dictionary.release(&priv->dictionary);
+    }
+    delete priv;
+    array->release = nullptr;
+  }
+
+  static ArrowSchemaPrivate* initArrowSchema(ArrowSchema* schema, const std::string& format,
+                                             const std::string& name, int64_t flags,
+                                             uint64_t numChildren) {
+    auto* priv = new ArrowSchemaPrivate();
+    priv->format = format;
+    priv->name = name;
+    priv->children.resize(numChildren);
+    for (auto& child : priv->children) {
+      priv->childPointers.push_back(&child);
+    }
+    schema->format = priv->format.c_str();
+    schema->name = priv->name.c_str();
+    schema->metadata = nullptr;
+    schema->flags = flags;
+    schema->n_children = static_cast<int64_t>(numChildren);
+    schema->children = numChildren == 0 ? nullptr : priv->childPointers.data();
+    schema->dictionary = nullptr;
+    schema->release = releaseArrowSchema;
+    schema->private_data = priv;
+    return priv;
+  }
+
+  static ArrowArrayPrivate* initArrowArray(ArrowArray* array, uint64_t length, uint64_t numBuffers,
+                                           uint64_t numChildren) {
+    auto* priv = new ArrowArrayPrivate();
+    priv->buffers.resize(numBuffers, nullptr);
+    priv->children.resize(numChildren);
+    for (auto& child : priv->children) {
+      priv->childPointers.push_back(&child);
+    }
+    array->length = static_cast<int64_t>(length);
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = static_cast<int64_t>(numBuffers);
+    array->n_children = static_cast<int64_t>(numChildren);
+    array->buffers = priv->buffers.data();
+    array->children = numChildren == 0 ? nullptr : priv->childPointers.data();
+    array->dictionary = nullptr;
+    array->release = releaseArrowArray;
+    array->private_data = priv;
+    return priv;
+  }
+
+  template <typename T>
+  static T* allocateBuffer(ArrowArrayPrivate& priv, MemoryPool& pool, uint64_t count) {
+    priv.ownedBuffers.emplace_back(pool, count * sizeof(T));
+    return reinterpret_cast<T*>(priv.ownedBuffers.back().data());
+  }
+
+  template <typename T>
+  static const T& castBatch(const ColumnVectorBatch& batch, const Type& type) {
+    const T* result = dynamic_cast<const T*>(&batch);
+    if (result == nullptr) {
+      throw InvalidArgument("Batch " + batch.toString() + " does not match type " +
+                            type.toString());
+    }
+    return *result;
+  }
+
+  /**
+   * The batch whose dictionary should be exported as an Arrow dictionary
+   * array, or nullptr if the column is exported with its plain layout.
+   */
+  static const EncodedStringVectorBatch* getEncodedBatch(const Type& type,
+                                                         const ColumnVectorBatch* batch) {
+    TypeKind kind = type.getKind();
+    if (batch == nullptr || !batch->isEncoded ||
+        (kind != STRING && kind != VARCHAR && kind != CHAR)) {
+      return nullptr;
+    }
+    auto encoded = dynamic_cast<const EncodedStringVectorBatch*>(batch);
+    return encoded != nullptr && encoded->dictionary != nullptr ? encoded : nullptr;
+  }
+
+  static std::string getArrowFormat(const Type& type) {
+    switch (static_cast<int64_t>(type.getKind())) {
+      case BOOLEAN:
+        return "b";
+      case BYTE:
+        return "c";
+      case SHORT:
+        return "s";
+      case INT:
+        return "i";
+      case LONG:
+        return "l";
+      case FLOAT:
+        return "f";
+      case DOUBLE:
+        return "g";
+      case STRING:
+      case VARCHAR:
+      case CHAR:
+        return "u";
+      case BINARY:
+      case GEOMETRY:
+      case GEOGRAPHY:
+        return "z";
+      case TIMESTAMP:
+        return "tsn:";
+      case TIMESTAMP_INSTANT:
+        return "tsn:UTC";
+      case DATE:
+        return "tdD";
+      case DECIMAL: {
+        // decimals without a precision come from Hive 0.11 files
+        uint64_t precision = type.getPrecision() == 0 ? 38 : type.getPrecision();
+        return "d:" + std::to_string(precision) + "," + std::to_string(type.getScale());
+      }
+      case LIST:
+        return "+L";
+      case MAP:
+        return "+m";
+      case STRUCT:
+        return "+s";
+      case UNION: {
+        std::string format = "+ud:";
+        for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+          format += (i == 0 ? "" : ",") + std::to_string(i);
+        }
+        return format;
+      }
+      default:
+        throw NotImplementedYet("Arrow export of type " + type.toString());
+    }
+  }
+
+  static void exportSchemaNode(const Type& type, const ColumnVectorBatch* batch,
+                               const std::string& name, int64_t flags, ArrowSchema* schema) {
+    if (getEncodedBatch(type, batch) != nullptr) {
+      ArrowSchemaPrivate* priv = initArrowSchema(schema, "l", name, flags, 0);
+      initArrowSchema(&priv->dictionary, "U", "", ARROW_FLAG_NULLABLE, 0);
+      schema->dictionary = &priv->dictionary;
+      return;
+    }
+    switch (static_cast<int64_t>(type.getKind())) {
+      case STRUCT: {
+        auto structBatch = dynamic_cast<const StructVectorBatch*>(batch);
+        ArrowSchemaPrivate* priv =
+            initArrowSchema(schema, "+s", name, flags, type.getSubtypeCount());
+        for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+          exportSchemaNode(*type.getSubtype(i), structBatch ? structBatch->fields[i] : nullptr,
+                           type.getFieldName(i), ARROW_FLAG_NULLABLE, &priv->children[i]);
+        }
+        break;
+      }
+      case LIST: {
+        auto listBatch = dynamic_cast<const ListVectorBatch*>(batch);
+        ArrowSchemaPrivate* priv = initArrowSchema(schema, "+L", name, flags, 1);
+        exportSchemaNode(*type.getSubtype(0), listBatch ? listBatch->elements.get() : nullptr,
+                         "item", ARROW_FLAG_NULLABLE, &priv->children[0]);
+        break;
+      }
+      case MAP: {
+        auto mapBatch = dynamic_cast<const MapVectorBatch*>(batch);
+        ArrowSchemaPrivate* priv = initArrowSchema(schema, "+m", name, flags, 1);
+        ArrowSchemaPrivate* entries = initArrowSchema(&priv->children[0], "+s", "entries", 0, 2);
+        exportSchemaNode(*type.getSubtype(0), mapBatch ? mapBatch->keys.get() : nullptr, "key", 0,
+                         &entries->children[0]);
+        exportSchemaNode(*type.getSubtype(1), mapBatch ? mapBatch->elements.get() : nullptr,
+                         "value", ARROW_FLAG_NULLABLE, &entries->children[1]);
+        break;
+      }
+      case UNION: {
+        auto unionBatch = dynamic_cast<const UnionVectorBatch*>(batch);
+        ArrowSchemaPrivate* priv =
+            initArrowSchema(schema, getArrowFormat(type), name, flags, type.getSubtypeCount());
+        for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+          exportSchemaNode(*type.getSubtype(i), unionBatch ? unionBatch->children[i] : nullptr,
+                           "_union_" + std::to_string(i), ARROW_FLAG_NULLABLE,
+                           &priv->children[i]);
+        }
+        break;
+      }
+      default:
+        initArrowSchema(schema, getArrowFormat(type), name, flags, 0);
+        break;
+    }
+  }
+
+  /**
+   * Pack one byte per row into an Arrow bitmap, eight rows per step. Any
+   * non-zero byte sets its bit. Returns the number of bits set.
+   */
+  static uint64_t packBytes(const char* bytes, uint64_t numValues, uint8_t* bits) {
+    uint64_t setBits = 0;
+    uint64_t i = 0;
+    for (; i + 8 <= numValues; i += 8) {
+      uint64_t word;
+      memcpy(&word, bytes + i, sizeof(word));
+      // fold each byte onto its lowest bit, then gather the eight low bits
+      // into the top byte of the product
+      word |= word >> 4;
+      word |= word >> 2;
+      word |= word >> 1;
+      word &= 0x0101010101010101ULL;
+      setBits += std::bitset<64>(word).count();
+      bits[i / 8] = static_cast<uint8_t>((word * 0x0102040810204080ULL) >> 56);
+    }
+    if (i < numValues) {
+      uint8_t last = 0;
+      for (uint64_t j = i; j < numValues; ++j) {
+        if (bytes[j]) {
+          last = static_cast<uint8_t>(last | (1 << (j - i)));
+          ++setBits;
+        }
+      }
+      bits[i / 8] = last;
+    }
+    return setBits;
+  }
+
+  static const void* exportValidity(const ColumnVectorBatch& batch, ArrowArrayPrivate& priv,
+                                    ArrowArray* array) {
+    if (!batch.hasNulls) {
+      return nullptr;
+    }
+    auto bits = allocateBuffer<uint8_t>(priv, batch.memoryPool, (batch.numElements + 7) / 8);
+    uint64_t valid = packBytes(batch.notNull.data(), batch.numElements, bits);
+    array->null_count = static_cast<int64_t>(batch.numElements - valid);
+    return bits;
+  }
+
+  /**
+   * Export the values of a numeric batch as T. A batch of type Tight already
+   * stores T and is handed out as is; a batch of type Wide is converted.
+   */
+  template <typename T, typename Tight, typename Wide>
+  static const void* exportNumbers(const Type& type, const ColumnVectorBatch& batch,
+                                   ArrowArrayPrivate& priv) {
+    if (auto tight = dynamic_cast<const Tight*>(&batch)) {
+      return tight->data.data();
+    }
+    const auto* values = castBatch<Wide>(batch, type).data.data();
+    T* result = allocateBuffer<T>(priv, batch.memoryPool, batch.numElements);
+    for (uint64_t i = 0; i < batch.numElements; ++i) {
+      result[i] = static_cast<T>(values[i]);
+    }
+    return result;
+  }
+
+  static const void* exportBooleans(const Type& type, const ColumnVectorBatch& batch,
+                                    ArrowArrayPrivate& priv) {
+    auto bits = allocateBuffer<uint8_t>(priv, batch.memoryPool, (batch.numElements + 7) / 8);
+    if (auto tight = dynamic_cast<const ByteVectorBatch*>(&batch)) {
+      packBytes(reinterpret_cast<const char*>(tight->data.data()), batch.numElements, bits);
+      return bits;
+    }
+    const int64_t* values = castBatch<LongVectorBatch>(batch, type).data.data();
+    memset(bits, 0, (batch.numElements + 7) / 8);
+    for (uint64_t i = 0; i < batch.numElements; ++i) {
+      bits[i / 8] = static_cast<uint8_t>(bits[i / 8] | ((values[i] != 0) << (i % 8)));
+    }
+    return bits;
+  }
+
+  static void exportStrings(const Type& type, const ColumnVectorBatch& batch,
+                            ArrowArrayPrivate& priv) {
+    const auto& strings = castBatch<StringVectorBatch>(batch, type);
+    const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+    auto offsets = allocateBuffer<int32_t>(priv, batch.memoryPool, batch.numElements + 1);
+    int64_t total = 0;
+    offsets[0] = 0;
+    for (uint64_t i = 0; i < batch.numElements; ++i) {
+      if (notNull == nullptr || notNull[i]) {
+        total += strings.length[i];
+        if (total > std::numeric_limits<int32_t>::max()) {
+          throw InvalidArgument("Batch " + batch.toString() +
+                                " holds more than 2GB of string data");
+        }
+      }
+      offsets[i + 1] = static_cast<int32_t>(total);
+    }
+    auto data = allocateBuffer<char>(priv, batch.memoryPool, static_cast<uint64_t>(total));
+    for (uint64_t i = 0; i < batch.numElements; ++i) {
+      int32_t length = offsets[i + 1] - offsets[i];
+      if (length > 0) {
+        memcpy(data + offsets[i], strings.data[i], static_cast<size_t>(length));
+      }
+    }
+    priv.buffers[1] = offsets;
+    priv.buffers[2] = data;
+  }
+
+  static void exportDictionary(const EncodedStringVectorBatch& batch, ArrowArrayPrivate& priv,
+                               ArrowArray* array) {
+    priv.buffers[1] = batch.index.data();
+    priv.stringDictionary = batch.dictionary;
+    const StringDictionary& dictionary = *batch.dictionary;
+    uint64_t entries = dictionary.dictionaryOffset.size();
+    ArrowArrayPrivate* values =
+        initArrowArray(&priv.dictionary, entries == 0 ? 0 : entries - 1, 3, 0);
+    if (entries == 0) {
+      auto offsets = allocateBuffer<int64_t>(*values, batch.memoryPool, 1);
+      offsets[0] = 0;
+      values->buffers[1] = offsets;
+    } else {
+      values->buffers[1] = dictionary.dictionaryOffset.data();
+    }
+    values->buffers[2] = dictionary.dictionaryBlob.data();
+    array->dictionary = &priv.dictionary;
+  }
+
+  static const void* exportTimestamps(const Type& type, const ColumnVectorBatch& batch,
+                                      ArrowArrayPrivate& priv) {
+    const auto& timestamps = castBatch<TimestampVectorBatch>(batch, type);
+    const int64_t* seconds = timestamps.data.data();
+    const int64_t* nanos = timestamps.nanoseconds.data();
+    const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+    auto result = allocateBuffer<int64_t>(priv, batch.memoryPool, batch.numElements);
+    for (uint64_t i = 0; i < batch.numElements; ++i) {
+      if (notNull && !notNull[i]) {
+        result[i] = 0;
+        continue;
+      }
+      // nanoseconds since the epoch only cover the years 1677 to 2262
+      int64_t scaled;
+      if (!multiplyExact(seconds[i], 1000000000, &scaled) ||
+          !addExact(scaled, nanos[i], &result[i])) {
+        throw std::range_error("Timestamp " + std::to_string(seconds[i]) + "." +
+                               std::to_string(nanos[i]) + " of " + batch.toString() +
+                               " does not fit in Arrow nanoseconds");
+      }
+    }
+    return result;
+  }
+
+  static const void* exportDecimals(const Type& type, const ColumnVectorBatch& batch,
+                                    ArrowArrayPrivate& priv) {
+    // decimal128 values are two little-endian words, the low one first
+    auto result = allocateBuffer<uint64_t>(priv, batch.memoryPool, 2 * batch.numElements);
+    if (auto decimals = dynamic_cast<const Decimal64VectorBatch*>(&batch)) {
+      const int64_t* values = decimals->values.data();
+      for (uint64_t i = 0; i < batch.numElements; ++i) {
+        result[2 * i] = static_cast<uint64_t>(values[i]);
+        result[2 * i + 1] = values[i] < 0 ? ~0ULL : 0;
+      }
+      return result;
+    }
+    const Int128* values = castBatch<Decimal128VectorBatch>(batch, type).values.data();
+    for (uint64_t i = 0; i < batch.numElements; ++i) {
+      result[2 * i] = values[i].getLowBits();
+      result[2 * i + 1] = static_cast<uint64_t>(values[i].getHighBits());
+    }
+    return result;
+  }
+
+  static void exportArrayNode(const Type& type, const ColumnVectorBatch& batch,
+                              ArrowArray* array) {
+    if (auto encoded = getEncodedBatch(type, &batch)) {
+      ArrowArrayPrivate* priv = initArrowArray(array, batch.numElements, 2, 0);
+      priv->buffers[0] = exportValidity(batch, *priv, array);
+      exportDictionary(*encoded, *priv, array);
+      return;
+    }
+    switch (static_cast<int64_t>(type.getKind())) {
+      case BOOLEAN:
+      case BYTE:
+      case SHORT:
+      case INT:
+      case LONG:
+      case FLOAT:
+      case DOUBLE:
+      case DATE:
+      case TIMESTAMP:
+      case TIMESTAMP_INSTANT:
+      case DECIMAL: {
+        ArrowArrayPrivate* priv = initArrowArray(array, batch.numElements, 2, 0);
+        priv->buffers[0] = exportValidity(batch, *priv, array);
+        const void*& values = priv->buffers[1];
+        switch (static_cast<int64_t>(type.getKind())) {
+          case BOOLEAN:
+            values = exportBooleans(type, batch, *priv);
+            break;
+          case BYTE:
+            values = exportNumbers<int8_t, ByteVectorBatch, LongVectorBatch>(type, batch, *priv);
+            break;
+          case SHORT:
+            values = exportNumbers<int16_t, ShortVectorBatch, LongVectorBatch>(type, batch, *priv);
+            break;
+          case INT:
+          case DATE:
+            values = exportNumbers<int32_t, IntVectorBatch, LongVectorBatch>(type, batch, *priv);
+            break;
+          case LONG:
+            values = exportNumbers<int64_t, LongVectorBatch, LongVectorBatch>(type, batch, *priv);
+            break;
+          case FLOAT:
+            values = exportNumbers<float, FloatVectorBatch, DoubleVectorBatch>(type, batch, *priv);
+            break;
+          case DOUBLE:
+            values =
+                exportNumbers<double, DoubleVectorBatch, DoubleVectorBatch>(type, batch, *priv);
+            break;
+          case DECIMAL:
+            values = exportDecimals(type, batch, *priv);
+            break;
+          default:
+            values = exportTimestamps(type, batch, *priv);
+            break;
+        }
+        break;
+      }
+      case STRING:
+      case VARCHAR:
+      case CHAR:
+      case BINARY:
+      case GEOMETRY:
+      case GEOGRAPHY: {
+        ArrowArrayPrivate* priv = initArrowArray(array, batch.numElements, 3, 0);
+        priv->buffers[0] = exportValidity(batch, *priv, array);
+        exportStrings(type, batch, *priv);
+        break;
+      }
+      case STRUCT: {
+        const auto& structBatch = castBatch<StructVectorBatch>(batch, type);
+        ArrowArrayPrivate* priv =
+            initArrowArray(array, batch.numElements, 1, type.getSubtypeCount());
+        priv->buffers[0] = exportValidity(batch, *priv, array);
+        for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+          exportArrayNode(*type.getSubtype(i), *structBatch.fields[i], &priv->children[i]);
+        }
+        break;
+      }
+      case LIST: {
+        const auto& listBatch = castBatch<ListVectorBatch>(batch, type);
+        ArrowArrayPrivate* priv = initArrowArray(array, batch.numElements, 2, 1);
+        priv->buffers[0] = exportValidity(batch, *priv, array);
+        priv->buffers[1] = listBatch.offsets.data();
+        exportArrayNode(*type.getSubtype(0), *listBatch.elements, &priv->children[0]);
+        break;
+      }
+      case MAP: {
+        // Arrow maps only come with 32-bit offsets
+        const auto& mapBatch = castBatch<MapVectorBatch>(batch, type);
+        ArrowArrayPrivate* priv = initArrowArray(array, batch.numElements, 2, 1);
+        priv->buffers[0] = exportValidity(batch, *priv, array);
+        const int64_t* offsets = mapBatch.offsets.data();
+        if (offsets[batch.numElements] > std::numeric_limits<int32_t>::max()) {
+          throw InvalidArgument("Batch " + batch.toString() + " holds more than 2^31 entries");
+        }
+        auto narrowOffsets =
+            allocateBuffer<int32_t>(*priv, batch.memoryPool, batch.numElements + 1);
+        for (uint64_t i = 0; i <= batch.numElements; ++i) {
+          narrowOffsets[i] = static_cast<int32_t>(offsets[i]);
+        }
+        priv->buffers[1] = narrowOffsets;
+        ArrowArrayPrivate* entries =
+            initArrowArray(&priv->children[0], mapBatch.keys->numElements, 1, 2);
+        exportArrayNode(*type.getSubtype(0), *mapBatch.keys, &entries->children[0]);
+        exportArrayNode(*type.getSubtype(1), *mapBatch.elements, &entries->children[1]);
+        break;
+      }
+      case UNION: {
+        // Arrow unions have no validity bitmap of their own
+        const auto& unionBatch = castBatch<UnionVectorBatch>(batch, type);
+        if (batch.hasNulls &&
+            memchr(batch.notNull.data(), 0, static_cast<size_t>(batch.numElements)) != nullptr) {
+          throw NotImplementedYet("Arrow export of a union with null values");
+        }
+        ArrowArrayPrivate* priv =
+            initArrowArray(array, batch.numElements, 2, type.getSubtypeCount());
+        priv->buffers[0] = unionBatch.tags.data();
+        const uint64_t* offsets = unionBatch.offsets.data();
+        auto narrowOffsets = allocateBuffer<int32_t>(*priv, batch.memoryPool, batch.numElements);
+        for (uint64_t i = 0; i < batch.numElements; ++i) {
+          narrowOffsets[i] = static_cast<int32_t>(offsets[i]);
+        }
+        priv->buffers[1] = narrowOffsets;
+        for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+          exportArrayNode(*type.getSubtype(i), *unionBatch.children[i], &priv->children[i]);
+        }
+        break;
+      }
+      default:
+        throw NotImplementedYet("Arrow export of type " + type.toString());
+    }
+  }
+
+  void exportArrowSchema(const Type& type, ArrowSchema* schema) {
+    schema->release = nullptr;
+    try {
+      exportSchemaNode(type, nullptr, "", ARROW_FLAG_NULLABLE, schema);
+    } catch (...) {
+      if (schema->release != nullptr) {
+        schema->release(schema);
+      }
+      throw;
+    }
+  }
+
+  void exportArrowBatch(const Type& type, const ColumnVectorBatch& batch, ArrowSchema* schema,
+                        ArrowArray* array) {
+    schema->release = nullptr;
+    array->release = nullptr;
+    try {
+      exportSchemaNode(type, &batch, "", ARROW_FLAG_NULLABLE, schema);
+      exportArrayNode(type, batch, array);
+    } catch (...) {
+      if (array->release != nullptr) {
+        array->release(array);
+      }
+      if (schema->release != nullptr) {
+        schema->release(schema);
+      }
+      throw;
+    }
+  }
+
+  template <typename T>
+  static T& castMutableBatch(ColumnVectorBatch& batch, const Type& type) {
+    T* result = dynamic_cast<T*>(&batch);
+    if (result == nullptr) {
+      throw InvalidArgument("Batch " + batch.toString() + " does not match type " +
+                            type.toString());
+    }
+    return *result;
+  }
+
+  static InvalidArgument formatMismatch(const Type& type, const ArrowSchema& schema) {
+    return InvalidArgument("Arrow format '" + std::string(schema.format) +
+                           "' does not match type " + type.toString());
+  }
+
+  static const void* getArrowBuffer(const ArrowArray& array, int64_t i) {
+    return i < array.n_buffers ? array.buffers[i] : nullptr;
+  }
+
+  static void importValidity(const ArrowArray& array, uint64_t base, uint64_t length,
+                             ColumnVectorBatch& batch) {
+    auto bits = static_cast<const uint8_t*>(getArrowBuffer(array, 0));
+    batch.hasNulls = false;
+    if (bits == nullptr || array.null_count == 0) {
+      return;
+    }
+    char* notNull = batch.notNull.data();
+    for (uint64_t i = 0; i < length; ++i) {
+      uint64_t bit = base + i;
+      notNull[i] = static_cast<char>((bits[bit / 8] >> (bit % 8)) & 1);
+    }
+    batch.hasNulls = memchr(notNull, 0, static_cast<size_t>(length)) != nullptr;
+  }
+
+  template <typename From, typename To>
+  static void convertValues(const void* buffer, uint64_t base, uint64_t length, To* out) {
+    const From* values = static_cast<const From*>(buffer) + base;
+    if (std::is_same<From, To>::value) {
+      memcpy(out, values, static_cast<size_t>(length) * sizeof(To));
+    } else {
+      for (uint64_t i = 0; i < length; ++i) {
+        out[i] = static_cast<To>(values[i]);
+      }
+    }
+  }
+
+  /**
+   * Convert Arrow integers to To, checking that the values that are not
+   * null lie within [minValue, maxValue].
+   */
+  template <typename From, typename To>
+  static void convertIntegers(const void* buffer, uint64_t base, uint64_t length,
+                              const char* notNull, int64_t minValue, int64_t maxValue, To* out) {
+    const From* values = static_cast<const From*>(buffer) + base;
+    // unsigned values are compared as uint64_t, which minValue <= 0 can't limit
+    const bool checked =
+        static_cast<int64_t>(std::numeric_limits<From>::min()) < minValue ||
+        static_cast<uint64_t>(std::numeric_limits<From>::max()) > static_cast<uint64_t>(maxValue);
+    if (checked) {
+      for (uint64_t i = 0; i < length; ++i) {
+        const From value = values[i];
+        const bool fits = std::is_signed<From>::value
+                              ? static_cast<int64_t>(value) >= minValue &&
+                                    static_cast<int64_t>(value) <= maxValue
+                              : static_cast<uint64_t>(value) <= static_cast<uint64_t>(maxValue);
+        if (!fits && (notNull == nullptr || notNull[i])) {
+          throw std::range_error("Arrow integer " + std::to_string(value) + " is outside of [" +
+                                 std::to_string(minValue) + ", " + std::to_string(maxValue) +
+                                 "]");
+        }
+      }
+    }
+    convertValues<From>(buffer, base, length, out);
+  }
+
+  /**
+   * Convert Arrow integers of any width, given by their format character,
+   * to T. Returns false if the format is not an integer.
+   */
+  template <typename T>
+  static bool importIntegers(const char* format, const void* buffer, uint64_t base,
+                             uint64_t length, const char* notNull, int64_t minValue,
+                             int64_t maxValue, T* out) {
+    if (format[0] == '\0' || format[1] != '\0') {
+      return false;
+    }
+    switch (format[0]) {
+      case 'c':
+        convertIntegers<int8_t>(buffer, base, length, notNull, minValue, maxValue, out);
+        return true;
+      case 'C':
+        convertIntegers<uint8_t>(buffer, base, length, notNull, minValue, maxValue, out);
+        return true;
+      case 's':
+        convertIntegers<int16_t>(buffer, base, length, notNull, minValue, maxValue, out);
+        return true;
+      case 'S':
+        convertIntegers<uint16_t>(buffer, base, length, notNull, minValue, maxValue, out);
+        return true;
+      case 'i':
+        convertIntegers<int32_t>(buffer, base, length, notNull, minValue, maxValue, out);
+        return true;
+      case 'I':
+        convertIntegers<uint32_t>(buffer, base, length, notNull, minValue, maxValue, out);
+        return true;
+      case 'l':
+        convertIntegers<int64_t>(buffer, base, length, notNull, minValue, maxValue, out);
+        return true;
+      case 'L':
+        convertIntegers<uint64_t>(buffer, base, length, notNull, minValue, maxValue, out);
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  template <typename BatchType>
+  static bool importIntegerBatch(const Type& type, const ArrowSchema& schema, const void* buffer,
+                                 uint64_t base, uint64_t length, ColumnVectorBatch& batch) {
+    auto result = dynamic_cast<BatchType*>(&batch);
+    if (result == nullptr) {
+      return false;
+    }
+    int64_t maxValue;
+    switch (static_cast<int64_t>(type.getKind())) {
+      case BYTE:
+        maxValue = std::numeric_limits<int8_t>::max();
+        break;
+      case SHORT:
+        maxValue = std::numeric_limits<int16_t>::max();
+        break;
+      case INT:
+        maxValue = std::numeric_limits<int32_t>::max();
+        break;
+      default:
+        maxValue = std::numeric_limits<int64_t>::max();
+        break;
+    }
+    return importIntegers(schema.format, buffer, base, length,
+                          batch.hasNulls ? batch.notNull.data() : nullptr, -maxValue - 1,
+                          maxValue, result->data.data());
+  }
+
+  template <typename T>
+  static void importFloats(const std::string& format, const void* buffer, uint64_t base,
+                           uint64_t length, T* out) {
+    if (format == "f") {
+      convertValues<float>(buffer, base, length, out);
+    } else {
+      convertValues<double>(buffer, base, length, out);
+    }
+  }
+
+  static void importBooleans(const Type& type, const ArrowArray& array, uint64_t base,
+                             uint64_t length, ColumnVectorBatch& batch) {
+    auto bits = static_cast<const uint8_t*>(getArrowBuffer(array, 1));
+    auto store = [&](auto* out) {
+      for (uint64_t i = 0; i < length; ++i) {
+        uint64_t bit = base + i;
+        out[i] = (bits[bit / 8] >> (bit % 8)) & 1;
+      }
+    };
+    if (auto tight = dynamic_cast<ByteVectorBatch*>(&batch)) {
+      store(tight->data.data());
+    } else {
+      store(castMutableBatch<LongVectorBatch>(batch, type).data.data());
+    }
+  }
+
+  static void importTimestamps(const Type& type, const ArrowSchema& schema,
+                               const ArrowArray& array, uint64_t base, uint64_t length,
+                               ColumnVectorBatch& batch) {
+    const char* format = schema.format;
+    if (strncmp(format, "ts", 2) != 0 || format[2] == '\0' || format[3] != ':') {
+      throw formatMismatch(type, schema);
+    }
+    int64_t unitsPerSecond;
+    switch (format[2]) {
+      case 's':
+        unitsPerSecond = 1;
+        break;
+      case 'm':
+        unitsPerSecond = 1000;
+        break;
+      case 'u':
+        unitsPerSecond = 1000000;
+        break;
+      case 'n':
+        unitsPerSecond = 1000000000;
+        break;
+      default:
+        throw formatMismatch(type, schema);
+    }
+    auto& timestamps = castMutableBatch<TimestampVectorBatch>(batch, type);
+    const int64_t* values = static_cast<const int64_t*>(getArrowBuffer(array, 1)) + base;
+    int64_t* seconds = timestamps.data.data();
+    int64_t* nanos = timestamps.nanoseconds.data();
+    for (uint64_t i = 0; i < length; ++i) {
+      int64_t second = values[i] / unitsPerSecond;
+      int64_t fraction = values[i] % unitsPerSecond;
+      if (fraction < 0) {
+        fraction += unitsPerSecond;
+        second -= 1;
+      }
+      seconds[i] = second;
+      nanos[i] = fraction * (1000000000 / unitsPerSecond);
+    }
+  }
+
+  // the value of a decimal number in an Arrow format, or -1 if it is not one
+  static int64_t parseFormatNumber(const std::string& text) {
+    if (text.empty() || text.size() > 9 ||
+        text.find_first_not_of("0123456789") != std::string::npos) {
+      return -1;
+    }
+    return std::strtoll(text.c_str(), nullptr, 10);
+  }
+
+  static void importDecimals(const Type& type, const ArrowSchema& schema,
+                             const ArrowArray& array, uint64_t base, uint64_t length,
+                             ColumnVectorBatch& batch) {
+    // d:precision,scale with an optional bit width that must be 128
+    std::string format(schema.format);
+    size_t comma = format.find(',');
+    if (format.compare(0, 2, "d:") != 0 || comma == std::string::npos ||
+        parseFormatNumber(format.substr(2, comma - 2)) < 0) {
+      throw formatMismatch(type, schema);
+    }
+    size_t widthComma = format.find(',', comma + 1);
+    int64_t scale = parseFormatNumber(format.substr(comma + 1, widthComma - comma - 1));
+    if (scale < 0 || static_cast<uint64_t>(scale) != type.getScale() ||
+        (widthComma != std::string::npos && format.substr(widthComma + 1) != "128")) {
+      throw formatMismatch(type, schema);
+    }
+    // the values that are not null must fit the precision of the column
+    bool overflow = false;
+    const Int128 limit =
+        scaleUpInt128ByPowerOfTen(Int128(1), static_cast<int32_t>(type.getPrecision()), overflow);
+    Int128 negativeLimit = limit;
+    negativeLimit.negate();
+    const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+    const uint64_t* words = static_cast<const uint64_t*>(getArrowBuffer(array, 1)) + 2 * base;
+    auto checkValue = [&](uint64_t i) {
+      Int128 value(static_cast<int64_t>(words[2 * i + 1]), words[2 * i]);
+      if ((notNull == nullptr || notNull[i]) && (value >= limit || value <= negativeLimit)) {
+        throw ParseError("Arrow decimal " +
+                         value.toDecimalString(static_cast<int32_t>(type.getScale())) +
+                         " does not fit " + type.toString());
+      }
+    };
+    if (auto decimals = dynamic_cast<Decimal64VectorBatch*>(&batch)) {
+      for (uint64_t i = 0; i < length; ++i) {
+        checkValue(i);
+        decimals->values[i] = static_cast<int64_t>(words[2 * i]);
+      }
+      decimals->precision = static_cast<int32_t>(type.getPrecision());
+      decimals->scale = static_cast<int32_t>(type.getScale());
+      return;
+    }
+    auto& decimals = castMutableBatch<Decimal128VectorBatch>(batch, type);
+    for (uint64_t i = 0; i < length; ++i) {
+      checkValue(i);
+      decimals.values[i] = Int128(static_cast<int64_t>(words[2 * i + 1]), words[2 * i]);
+    }
+    decimals.precision = static_cast<int32_t>(type.getPrecision());
+    decimals.scale = static_cast<int32_t>(type.getScale());
+  }
+
+  /**
+   * Point the batch at the strings of an Arrow string or binary array with
+   * offsets of type T, without copying them.
+   */
+  template <typename T>
+  static void importStrings(const ArrowArray& array, uint64_t base, uint64_t length,
+                            StringVectorBatch& batch) {
+    const T* offsets = static_cast<const T*>(getArrowBuffer(array, 1)) + base;
+    const char* data = static_cast<const char*>(getArrowBuffer(array, 2));
+    for (uint64_t i = 0; i < length; ++i) {
+      batch.data[i] = const_cast<char*>(data) + offsets[i];
+      batch.length[i] = static_cast<int64_t>(offsets[i + 1] - offsets[i]);
+    }
+  }
+
+  /**
+   * Copy the strings of an Arrow string array with offsets of type T into a
+   * dictionary.
+   */
+  template <typename T>
+  static void importDictionaryValues(const ArrowArray& array, StringDictionary& dictionary) {
+    uint64_t size = static_cast<uint64_t>(array.length);
+    const T* offsets = static_cast<const T*>(getArrowBuffer(array, 1)) + array.offset;
+    const char* data = static_cast<const char*>(getArrowBuffer(array, 2));
+    dictionary.dictionaryOffset.resize(size + 1);
+    for (uint64_t i = 0; i <= size; ++i) {
+      dictionary.dictionaryOffset[i] = static_cast<int64_t>(offsets[i] - offsets[0]);
+    }
+    dictionary.dictionaryBlob.resize(static_cast<uint64_t>(offsets[size] - offsets[0]));
+    if (dictionary.dictionaryBlob.size() > 0) {
+      memcpy(dictionary.dictionaryBlob.data(), data + offsets[0],
+             dictionary.dictionaryBlob.size());
+    }
+  }
+
+  static void importStringColumn(const Type& type, const ArrowSchema& schema,
+                                 const ArrowArray& array, uint64_t base, uint64_t length,
+                                 ColumnVectorBatch& batch) {
+    auto& strings = castMutableBatch<StringVectorBatch>(batch, type);
+    auto encoded = dynamic_cast<EncodedStringVectorBatch*>(&batch);
+    if (encoded != nullptr) {
+      encoded->isEncoded = false;
+      encoded->dictionaryDecoded = false;
+    }
+
+    if (schema.dictionary == nullptr) {
+      std::string format(schema.format);
+      if (format == "u" || format == "z") {
+        importStrings<int32_t>(array, base, length, strings);
+      } else if (format == "U" || format == "Z") {
+        importStrings<int64_t>(array, base, length, strings);
+      } else {
+        throw formatMismatch(type, schema);
+      }
+      return;
+    }
+
+    if (array.dictionary == nullptr) {
+      throw InvalidArgument("Arrow dictionary array without a dictionary");
+    }
+    auto dictionary = std::make_shared<StringDictionary>(batch.memoryPool);
+    std::string valueFormat(schema.dictionary->format);
+    if (valueFormat == "u" || valueFormat == "z") {
+      importDictionaryValues<int32_t>(*array.dictionary, *dictionary);
+    } else if (valueFormat == "U" || valueFormat == "Z") {
+      importDictionaryValues<int64_t>(*array.dictionary, *dictionary);
+    } else {
+      throw formatMismatch(type, *schema.dictionary);
+    }
+
+    DataBuffer<int64_t> localIndex(batch.memoryPool, encoded ? 0 : length);
+    int64_t* index = encoded ? encoded->index.data() : localIndex.data();
+    if (!importIntegers(schema.format, getArrowBuffer(array, 1), base, length,
+                        batch.hasNulls ? batch.notNull.data() : nullptr,
+                        std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(),
+                        index)) {
+      throw formatMismatch(type, schema);
+    }
+    if (encoded != nullptr) {
+      // the writer maps the dictionary entries instead of the rows
+      encoded->dictionary = dictionary;
+      encoded->isEncoded = true;
+      return;
+    }
+    // a plain batch cannot outlive the dictionary, so the values are copied
+    const int64_t* offsets = dictionary->dictionaryOffset.data();
+    const int64_t size = static_cast<int64_t>(dictionary->dictionaryOffset.size()) - 1;
+    const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < length; ++i) {
+      if (notNull == nullptr || notNull[i]) {
+        if (index[i] < 0 || index[i] >= size) {
+          throw InvalidArgument("Dictionary index out of range");
+        }
+        total += static_cast<uint64_t>(offsets[index[i] + 1] - offsets[index[i]]);
+      }
+    }
+    strings.blob.resize(total);
+    char* blob = strings.blob.data();
+    for (uint64_t i = 0; i < length; ++i) {
+      strings.data[i] = blob;
+      strings.length[i] = 0;
+      if (notNull == nullptr || notNull[i]) {
+        strings.length[i] = offsets[index[i] + 1] - offsets[index[i]];
+        memcpy(blob, dictionary->dictionaryBlob.data() + offsets[index[i]],
+               static_cast<size_t>(strings.length[i]));
+        blob += strings.length[i];
+      }
+    }
+  }
+
+  static void importArrayNode(const Type& type, const ArrowSchema& schema,
+                              const ArrowArray& array, uint64_t start, uint64_t length,
+                              ColumnVectorBatch& batch);
+
+  // move the values at the ascending positions rows to the front
+  template <typename T>
+  static void keepValues(T* values, const std::vector<uint64_t>& rows) {
+    for (size_t i = 0; i < rows.size(); ++i) {
+      values[i] = values[rows[i]];
+    }
+  }
+
+  template <typename BatchType>
+  static bool keepDataRows(ColumnVectorBatch& batch, const std::vector<uint64_t>& rows) {
+    auto result = dynamic_cast<BatchType*>(&batch);
+    if (result != nullptr) {
+      keepValues(result->data.data(), rows);
+    }
+    return result != nullptr;
+  }
+
+  /**
+   * The child rows of the list, map or union entries at the positions rows
+   * of a batch, and their new offsets.
+   */
+  static std::vector<uint64_t> keepChildRows(int64_t* offsets, const std::vector<uint64_t>& rows) {
+    std::vector<uint64_t> childRows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+      int64_t start = offsets[rows[i]];
+      int64_t end = offsets[rows[i] + 1];
+      offsets[i] = static_cast<int64_t>(childRows.size());
+      for (int64_t child = start; child < end; ++child) {
+        childRows.push_back(static_cast<uint64_t>(child));
+      }
+    }
+    offsets[rows.size()] = static_cast<int64_t>(childRows.size());
+    return childRows;
+  }
+
+  /**
+   * Keep only the rows of an imported batch at the ascending positions rows,
+   * moving them to the front.
+   */
+  static void keepRows(ColumnVectorBatch& batch, const std::vector<uint64_t>& rows) {
+    if (batch.hasNulls) {
+      keepValues(batch.notNull.data(), rows);
+      batch.hasNulls = memchr(batch.notNull.data(), 0, rows.size()) != nullptr;
+    }
+    batch.numElements = rows.size();
+    if (keepDataRows<LongVectorBatch>(batch, rows) || keepDataRows<IntVectorBatch>(batch, rows) ||
+        keepDataRows<ShortVectorBatch>(batch, rows) || keepDataRows<ByteVectorBatch>(batch, rows) ||
+        keepDataRows<DoubleVectorBatch>(batch, rows) ||
+        keepDataRows<FloatVectorBatch>(batch, rows)) {
+      return;
+    }
+    if (auto strings = dynamic_cast<StringVectorBatch*>(&batch)) {
+      keepValues(strings->data.data(), rows);
+      keepValues(strings->length.data(), rows);
+      if (auto encoded = dynamic_cast<EncodedStringVectorBatch*>(&batch)) {
+        keepValues(encoded->index.data(), rows);
+      }
+    } else if (auto timestamps = dynamic_cast<TimestampVectorBatch*>(&batch)) {
+      keepValues(timestamps->data.data(), rows);
+      keepValues(timestamps->nanoseconds.data(), rows);
+    } else if (auto decimals = dynamic_cast<Decimal64VectorBatch*>(&batch)) {
+      keepValues(decimals->values.data(), rows);
+    } else if (auto decimals128 = dynamic_cast<Decimal128VectorBatch*>(&batch)) {
+      keepValues(decimals128->values.data(), rows);
+    } else if (auto structs = dynamic_cast<StructVectorBatch*>(&batch)) {
+      for (ColumnVectorBatch* field : structs->fields) {
+        keepRows(*field, rows);
+      }
+    } else if (auto lists = dynamic_cast<ListVectorBatch*>(&batch)) {
+      keepRows(*lists->elements, keepChildRows(lists->offsets.data(), rows));
+    } else if (auto maps = dynamic_cast<MapVectorBatch*>(&batch)) {
+      std::vector<uint64_t> childRows = keepChildRows(maps->offsets.data(), rows);
+      keepRows(*maps->keys, childRows);
+      keepRows(*maps->elements, childRows);
+    } else if (auto unions = dynamic_cast<UnionVectorBatch*>(&batch)) {
+      // the rows of each child are consecutive, see importUnion
+      std::vector<std::vector<uint64_t>> childRows(unions->children.size());
+      for (size_t i = 0; i < rows.size(); ++i) {
+        std::vector<uint64_t>& kept = childRows[unions->tags[rows[i]]];
+        kept.push_back(unions->offsets[rows[i]]);
+        unions->tags[i] = unions->tags[rows[i]];
+        unions->offsets[i] = kept.size() - 1;
+      }
+      for (size_t i = 0; i < childRows.size(); ++i) {
+        keepRows(*unions->children[i], childRows[i]);
+      }
+    } else {
+      throw NotImplementedYet("Arrow import of nulls over the rows of " + batch.toString());
+    }
+  }
+
+  /**
+   * List and map offsets of type T, rebased to start at zero, where null
+   * entries are empty. Returns the range of child rows they cover. A null
+   * entry may cover child rows in Arrow; then keptRows are the positions in
+   * that range of the rows of the entries that are not null.
+   */
+  template <typename T>
+  static std::pair<uint64_t, uint64_t> importOffsets(const ArrowArray& array, uint64_t base,
+                                                     uint64_t length, const char* notNull,
+                                                     int64_t* out, bool& compact,
+                                                     std::vector<uint64_t>& keptRows) {
+    const T* offsets = static_cast<const T*>(getArrowBuffer(array, 1)) + base;
+    compact = false;
+    out[0] = 0;
+    for (uint64_t i = 0; i < length; ++i) {
+      int64_t size = static_cast<int64_t>(offsets[i + 1] - offsets[i]);
+      if (notNull != nullptr && !notNull[i] && size != 0) {
+        compact = true;
+        size = 0;
+      }
+      out[i + 1] = out[i] + size;
+    }
+    keptRows.clear();
+    if (compact) {
+      for (uint64_t i = 0; i < length; ++i) {
+        if (notNull[i]) {
+          for (T child = offsets[i]; child < offsets[i + 1]; ++child) {
+            keptRows.push_back(static_cast<uint64_t>(child - offsets[0]));
+          }
+        }
+      }
+    }
+    return {static_cast<uint64_t>(offsets[0]), static_cast<uint64_t>(offsets[length] - offsets[0])};
+  }
+
+  static void importUnion(const Type& type, const ArrowSchema& schema, const ArrowArray& array,
+                          uint64_t base, uint64_t length, ColumnVectorBatch& batch) {
+    std::string format(schema.format);
+    if (format.compare(0, 4, "+us:") == 0) {
+      throw NotImplementedYet("Arrow import of a sparse union");
+    }
+    if (format.compare(0, 4, "+ud:") != 0 ||
+        static_cast<uint64_t>(schema.n_children) != type.getSubtypeCount()) {
+      throw formatMismatch(type, schema);
+    }
+    // the ORC tag is the position of the Arrow type id in the format
+    std::vector<int> tagOfTypeId(128, -1);
+    size_t pos = 4;
+    for (int tag = 0; pos < format.size(); ++tag) {
+      size_t comma = std::min(format.find(',', pos), format.size());
+      int64_t typeId = parseFormatNumber(format.substr(pos, comma - pos));
+      if (typeId < 0 || typeId >= 128 || tag >= schema.n_children) {
+        throw formatMismatch(type, schema);
+      }
+      tagOfTypeId[static_cast<size_t>(typeId)] = tag;
+      pos = comma + 1;
+    }
+
+    auto& unionBatch = castMutableBatch<UnionVectorBatch>(batch, type);
+    const int8_t* typeIds = static_cast<const int8_t*>(getArrowBuffer(array, 0)) + base;
+    const int32_t* offsets = static_cast<const int32_t*>(getArrowBuffer(array, 1)) + base;
+    std::vector<int64_t> childStart(type.getSubtypeCount(), -1);
+    std::vector<uint64_t> childLength(type.getSubtypeCount(), 0);
+    for (uint64_t i = 0; i < length; ++i) {
+      int tag = typeIds[i] < 0 ? -1 : tagOfTypeId[static_cast<size_t>(typeIds[i])];
+      if (tag < 0) {
+        throw InvalidArgument("Unknown type id in Arrow union");
+      }
+      size_t child = static_cast<size_t>(tag);
+      if (childStart[child] < 0) {
+        childStart[child] = offsets[i];
+      } else if (offsets[i] != childStart[child] + static_cast<int64_t>(childLength[child])) {
+        throw NotImplementedYet("Arrow import of a union whose offsets are not consecutive");
+      }
+      unionBatch.tags[i] = static_cast<unsigned char>(tag);
+      unionBatch.offsets[i] = childLength[child]++;
+    }
+    for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+      importArrayNode(*type.getSubtype(i), *schema.children[i], *array.children[i],
+                      static_cast<uint64_t>(std::max<int64_t>(childStart[i], 0)), childLength[i],
+                      *unionBatch.children[i]);
+    }
+  }
+
+  static void importArrayNode(const Type& type, const ArrowSchema& schema,
+                              const ArrowArray& array, uint64_t start, uint64_t length,
+                              ColumnVectorBatch& batch) {
+    uint64_t base = static_cast<uint64_t>(array.offset) + start;
+    batch.resize(length);
+    batch.numElements = length;
+    if (type.getKind() == UNION) {
+      batch.hasNulls = false;
+      importUnion(type, schema, array, base, length, batch);
+      return;
+    }
+    importValidity(array, base, length, batch);
+
+    std::string format(schema.format);
+    const void* values = getArrowBuffer(array, 1);
+    switch (static_cast<int64_t>(type.getKind())) {
+      case BOOLEAN:
+        if (format != "b") {
+          throw formatMismatch(type, schema);
+        }
+        importBooleans(type, array, base, length, batch);
+        break;
+      case BYTE:
+      case SHORT:
+      case INT:
+      case LONG:
+        if (!importIntegerBatch<LongVectorBatch>(type, schema, values, base, length, batch) &&
+            !importIntegerBatch<IntVectorBatch>(type, schema, values, base, length, batch) &&
+            !importIntegerBatch<ShortVectorBatch>(type, schema, values, base, length, batch) &&
+            !importIntegerBatch<ByteVectorBatch>(type, schema, values, base, length, batch)) {
+          throw formatMismatch(type, schema);
+        }
+        break;
+      case DATE:
+        if (format != "tdD") {
+          throw formatMismatch(type, schema);
+        }
+        convertValues<int32_t>(values, base, length,
+                               castMutableBatch<LongVectorBatch>(batch, type).data.data());
+        break;
+      case FLOAT:
+      case DOUBLE:
+        if (format != "f" && format != "g") {
+          throw formatMismatch(type, schema);
+        }
+        if (auto tight = dynamic_cast<FloatVectorBatch*>(&batch)) {
+          importFloats(format, values, base, length, tight->data.data());
+        } else {
+          importFloats(format, values, base, length,
+                       castMutableBatch<DoubleVectorBatch>(batch, type).data.data());
+        }
+        break;
+      case TIMESTAMP:
+      case TIMESTAMP_INSTANT:
+        importTimestamps(type, schema, array, base, length, batch);
+        break;
+      case DECIMAL:
+        importDecimals(type, schema, array, base, length, batch);
+        break;
+      case STRING:
+      case VARCHAR:
+      case CHAR:
+      case BINARY:
+      case GEOMETRY:
+      case GEOGRAPHY:
+        importStringColumn(type, schema, array, base, length, batch);
+        break;
+      case STRUCT: {
+        if (format != "+s" || static_cast<uint64_t>(schema.n_children) != type.getSubtypeCount()) {
+          throw formatMismatch(type, schema);
+        }
+        auto& structBatch = castMutableBatch<StructVectorBatch>(batch, type);
+        for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+          importArrayNode(*type.getSubtype(i), *schema.children[i], *array.children[i], base,
+                          length, *structBatch.fields[i]);
+        }
+        break;
+      }
+      case LIST: {
+        auto& listBatch = castMutableBatch<ListVectorBatch>(batch, type);
+        const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+        std::pair<uint64_t, uint64_t> children;
+        bool compact;
+        std::vector<uint64_t> keptRows;
+        if (format == "+l") {
+          children = importOffsets<int32_t>(array, base, length, notNull,
+                                            listBatch.offsets.data(), compact, keptRows);
+        } else if (format == "+L") {
+          children = importOffsets<int64_t>(array, base, length, notNull,
+                                            listBatch.offsets.data(), compact, keptRows);
+        } else {
+          throw formatMismatch(type, schema);
+        }
+        importArrayNode(*type.getSubtype(0), *schema.children[0], *array.children[0],
+                        children.first, children.second, *listBatch.elements);
+        if (compact) {
+          keepRows(*listBatch.elements, keptRows);
+        }
+        break;
+      }
+      case MAP: {
+        if (format != "+m" || schema.n_children != 1 || schema.children[0]->n_children != 2) {
+          throw formatMismatch(type, schema);
+        }
+        auto& mapBatch = castMutableBatch<MapVectorBatch>(batch, type);
+        const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+        bool compact;
+        std::vector<uint64_t> keptRows;
+        auto children = importOffsets<int32_t>(array, base, length, notNull,
+                                               mapBatch.offsets.data(), compact, keptRows);
+        const ArrowArray& entries = *array.children[0];
+        uint64_t entryStart = static_cast<uint64_t>(entries.offset) + children.first;
+        importArrayNode(*type.getSubtype(0), *schema.children[0]->children[0],
+                        *entries.children[0], entryStart, children.second, *mapBatch.keys);
+        importArrayNode(*type.getSubtype(1), *schema.children[0]->children[1],
+                        *entries.children[1], entryStart, children.second, *mapBatch.elements);
+        if (compact) {
+          keepRows(*mapBatch.keys, keptRows);
+          keepRows(*mapBatch.elements, keptRows);
+        }
+        break;
+      }
+      default:
+        throw NotImplementedYet("Arrow import of type " + type.toString());
+    }
+  }
+
+  void importArrowBatch(const Type& type, const ArrowSchema& schema, const ArrowArray& array,
+                        ColumnVectorBatch& batch) {
+    importArrayNode(type, schema, array, 0, static_cast<uint64_t>(array.length), batch);
+  }
+
+}  // namespace orc
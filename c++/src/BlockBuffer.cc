@@ -80,15 +80,35 @@ namespace orc {
     }
   }
 
-  void BlockBuffer::writeTo(OutputStream* output, WriterMetrics* metrics) {
-    if (currentSize_ == 0) {
-      return;
-    }
+  uint64_t BlockBuffer::getChunkSize(const OutputStream* output) {
     static uint64_t MAX_CHUNK_SIZE = 1024 * 1024 * 1024;
     uint64_t chunkSize = std::min(output->getNaturalWriteSize(), MAX_CHUNK_SIZE);
     if (chunkSize == 0) {
       throw std::logic_error("Natural write size cannot be zero");
     }
+    return chunkSize;
+  }
+
+  void BlockBuffer::writeTo(OutputStream* output, WriterMetrics* metrics) {
+    if (currentSize_ == 0) {
+      return;
+    }
+    uint64_t chunkSize = getChunkSize(output);
+    // if only exists one block, currentSize is equal to first block size
+    if (getBlockNumber() == 1 && currentSize_ <= chunkSize) {
+      writeTo(output, metrics, nullptr, chunkSize);
+    } else {
+      char* chunk = memoryPool_.malloc(chunkSize);
+      writeTo(output, metrics, chunk, chunkSize);
+      memoryPool_.free(chunk);
+    }
+  }
+
+  void BlockBuffer::writeTo(OutputStream* output, WriterMetrics* metrics, char* chunk,
+                            uint64_t chunkSize) {
+    if (currentSize_ == 0) {
+      return;
+    }
     uint64_t ioCount = 0;
     uint64_t blockNumber = getBlockNumber();
     // if only exists one block, currentSize is equal to first block size
@@ -97,7 +117,6 @@ namespace orc {
       output->write(block.data, block.size);
       ++ioCount;
     } else {
-      char* chunk = memoryPool_.malloc(chunkSize);
       uint64_t chunkOffset = 0;
       for (uint64_t i = 0; i < blockNumber; ++i) {
         Block block = getBlock(i);
@@ -121,7 +140,6 @@ namespace orc {
         output->write(chunk, chunkOffset);
         ++ioCount;
       }
-      memoryPool_.free(chunk);
     }
 
     if (metrics != nullptr) {
@@ -120,6 +120,21 @@ namespace orc {
      * @param metrics the metrics of the writer
      */
     void writeTo(OutputStream* output, WriterMetrics* metrics);
+
+    /**
+     * Write the BlockBuffer content into OutputStream through a chunk that
+     * the caller allocated, so that nothing is taken from the memory pool
+     * @param output the output stream to write to
+     * @param metrics the metrics of the writer
+     * @param chunk the staging memory of at least chunkSize bytes
+     * @param chunkSize the size of the writes, see getChunkSize
+     */
+    void writeTo(OutputStream* output, WriterMetrics* metrics, char* chunk, uint64_t chunkSize);
+
+    /**
+     * Get the size of the writes of writeTo to the given OutputStream
+     */
+    static uint64_t getChunkSize(const OutputStream* output);
   };
 }  // namespace orc
 
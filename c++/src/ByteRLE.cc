@@ -321,7 +321,8 @@ namespace orc {
 
   class ByteRleDecoderImpl : public ByteRleDecoder {
    public:
-    ByteRleDecoderImpl(std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics);
+    ByteRleDecoderImpl(std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics,
+                       StreamReaderMetrics* streamMetrics);
 
     ~ByteRleDecoderImpl() override;
 
@@ -354,10 +355,12 @@ namespace orc {
     const char* bufferEnd;
     bool repeating;
     ReaderMetrics* metrics;
+    StreamReaderMetrics* streamMetrics;
   };
 
   void ByteRleDecoderImpl::nextBuffer() {
     SCOPED_MINUS_STOPWATCH(metrics, ByteDecodingLatencyUs);
+    SCOPED_STREAM_MINUS_STOPWATCH(streamMetrics, DecodingLatencyUs);
     int bufferLength;
     const void* bufferPointer;
     bool result = inputStream->Next(&bufferPointer, &bufferLength);
@@ -396,8 +399,9 @@ namespace orc {
   }
 
   ByteRleDecoderImpl::ByteRleDecoderImpl(std::unique_ptr<SeekableInputStream> input,
-                                         ReaderMetrics* metrics)
-      : metrics(metrics) {
+                                         ReaderMetrics* metrics,
+                                         StreamReaderMetrics* streamMetrics)
+      : metrics(metrics), streamMetrics(streamMetrics) {
     inputStream = std::move(input);
     reset();
   }
@@ -443,6 +447,10 @@ namespace orc {
 
   void ByteRleDecoderImpl::next(char* data, uint64_t numValues, char* notNull) {
     SCOPED_STOPWATCH(metrics, ByteDecodingLatencyUs, ByteDecodingCall);
+    SCOPED_STREAM_STOPWATCH(streamMetrics, DecodingLatencyUs, DecodingCall);
+    if (streamMetrics) {
+      streamMetrics->ValuesDecoded += numValues;
+    }
     nextInternal(data, numValues, notNull);
   }
 
@@ -505,13 +513,15 @@ namespace orc {
   }
 
   std::unique_ptr<ByteRleDecoder> createByteRleDecoder(std::unique_ptr<SeekableInputStream> input,
-                                                       ReaderMetrics* metrics) {
-    return std::make_unique<ByteRleDecoderImpl>(std::move(input), metrics);
+                                                       ReaderMetrics* metrics,
+                                                       StreamReaderMetrics* streamMetrics) {
+    return std::make_unique<ByteRleDecoderImpl>(std::move(input), metrics, streamMetrics);
   }
 
   class BooleanRleDecoderImpl : public ByteRleDecoderImpl {
    public:
-    BooleanRleDecoderImpl(std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics);
+    BooleanRleDecoderImpl(std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics,
+                          StreamReaderMetrics* streamMetrics);
 
     ~BooleanRleDecoderImpl() override;
 
@@ -536,8 +546,9 @@ namespace orc {
   };
 
   BooleanRleDecoderImpl::BooleanRleDecoderImpl(std::unique_ptr<SeekableInputStream> input,
-                                               ReaderMetrics* metrics)
-      : ByteRleDecoderImpl(std::move(input), metrics) {
+                                               ReaderMetrics* metrics,
+                                               StreamReaderMetrics* streamMetrics)
+      : ByteRleDecoderImpl(std::move(input), metrics, streamMetrics) {
     remainingBits = 0;
     lastByte = 0;
   }
@@ -577,6 +588,10 @@ namespace orc {
 
   void BooleanRleDecoderImpl::next(char* data, uint64_t numValues, char* notNull) {
     SCOPED_STOPWATCH(metrics, ByteDecodingLatencyUs, ByteDecodingCall);
+    SCOPED_STREAM_STOPWATCH(streamMetrics, DecodingLatencyUs, DecodingCall);
+    if (streamMetrics) {
+      streamMetrics->ValuesDecoded += numValues;
+    }
     // next spot to fill in
     uint64_t position = 0;
 
@@ -643,7 +658,8 @@ namespace orc {
   }
 
   std::unique_ptr<ByteRleDecoder> createBooleanRleDecoder(
-      std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics) {
-    return std::make_unique<BooleanRleDecoderImpl>(std::move(input), metrics);
+      std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics,
+      StreamReaderMetrics* streamMetrics) {
+    return std::make_unique<BooleanRleDecoderImpl>(std::move(input), metrics, streamMetrics);
   }
 }  // namespace orc
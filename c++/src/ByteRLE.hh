@@ -110,9 +110,11 @@ namespace orc {
    * Create a byte RLE decoder.
    * @param input the input stream to read from
    * @param metrics the metrics of the decoder
+   * @param streamMetrics the metrics of the column stream that is decoded
    */
-  std::unique_ptr<ByteRleDecoder> createByteRleDecoder(std::unique_ptr<SeekableInputStream> input,
-                                                       ReaderMetrics* metrics);
+  std::unique_ptr<ByteRleDecoder> createByteRleDecoder(
+      std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics,
+      StreamReaderMetrics* streamMetrics = nullptr);
 
   /**
    * Create a boolean RLE decoder.
@@ -122,9 +124,11 @@ namespace orc {
    * processing to properly apply multiple masks from nested types.
    * @param input the input stream to read from
    * @param metrics the metrics of the decoder
+   * @param streamMetrics the metrics of the column stream that is decoded
    */
   std::unique_ptr<ByteRleDecoder> createBooleanRleDecoder(
-      std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics);
+      std::unique_ptr<SeekableInputStream> input, ReaderMetrics* metrics,
+      StreamReaderMetrics* streamMetrics = nullptr);
 }  // namespace orc
 
 #endif
@@ -23,6 +23,7 @@
 #include "Adaptor.hh"
 
 #include <time.h>
+#include <charconv>
 #include <limits>
 #include <sstream>
 #include <stdexcept>
@@ -206,6 +207,59 @@ namespace orc {
     file.append(ptr, len);
   }
 
+  // the formatting helpers below avoid iostreams, the locale and temporary strings
+
+  static void writeInteger(std::string& file, int64_t value) {
+    char numBuffer[20];  // enough for INT64_MIN
+    auto result = std::to_chars(numBuffer, numBuffer + sizeof(numBuffer), value);
+    file.append(numBuffer, result.ptr);
+  }
+
+  // same output as printf("%.<precision>g")
+  static void writeDouble(std::string& file, double value, int precision) {
+    char numBuffer[64];
+#if defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(numBuffer, numBuffer + sizeof(numBuffer), value,
+                                std::chars_format::general, precision);
+    file.append(numBuffer, result.ptr);
+#else
+    int length = snprintf(numBuffer, sizeof(numBuffer), "%.*g", precision, value);
+    file.append(numBuffer, static_cast<size_t>(length));
+#endif
+  }
+
+  static char* writeDigits(char* out, int64_t value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+      out[i] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    }
+    return out + width;
+  }
+
+  // Formats the days since the epoch like strftime("%Y-%m-%d") and returns
+  // the end of the output. Years without four digits are left to strftime
+  // and return nullptr.
+  // Algorithm: http://howardhinnant.github.io/date_algorithms.html
+  static char* formatDate(char* out, int64_t days) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t doe = days - era * 146097;                                    // [0, 146096]
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                // [0, 365]
+    const int64_t mp = (5 * doy + 2) / 153;                                     // [0, 11]
+    const int64_t day = doy - (153 * mp + 2) / 5 + 1;                           // [1, 31]
+    const int64_t month = mp < 10 ? mp + 3 : mp - 9;                            // [1, 12]
+    const int64_t year = yoe + era * 400 + (month <= 2);
+    if (year < 1000 || year > 9999) {
+      return nullptr;
+    }
+    out = writeDigits(out, year, 4);
+    *out++ = '-';
+    out = writeDigits(out, month, 2);
+    *out++ = '-';
+    return writeDigits(out, day, 2);
+  }
+
   ColumnPrinter::ColumnPrinter(std::string& buffer) : buffer(buffer) {
     notNull = nullptr;
     hasNulls = false;
@@ -224,6 +278,14 @@ namespace orc {
     }
   }
 
+  void ColumnPrinter::printBatch(const ColumnVectorBatch& batch) {
+    reset(batch);
+    for (uint64_t i = 0; i < batch.numElements; ++i) {
+      printRow(i);
+      writeChar(buffer, '\n');
+    }
+  }
+
   std::unique_ptr<ColumnPrinter> createColumnPrinter(std::string& buffer, const Type* type,
                                                      ColumnPrinter::Param param) {
     std::unique_ptr<ColumnPrinter> result;
@@ -326,8 +388,7 @@ namespace orc {
     if (hasNulls && !notNull[rowId]) {
       writeString(buffer, "null");
     } else {
-      const auto numBuffer = std::to_string(static_cast<int64_t>(data_[rowId]));
-      writeString(buffer, numBuffer.c_str());
+      writeInteger(buffer, data_[rowId]);
     }
   }
 
@@ -346,9 +407,7 @@ namespace orc {
     if (hasNulls && !notNull[rowId]) {
       writeString(buffer, "null");
     } else {
-      char numBuffer[64];
-      snprintf(numBuffer, sizeof(numBuffer), isFloat_ ? "%.7g" : "%.14g", data_[rowId]);
-      writeString(buffer, numBuffer);
+      writeDouble(buffer, data_[rowId], isFloat_ ? 7 : 14);
     }
   }
 
@@ -424,35 +483,42 @@ namespace orc {
       writeString(buffer, "null");
     } else {
       writeChar(buffer, '"');
-      for (int64_t i = 0; i < length_[rowId]; ++i) {
-        char ch = static_cast<char>(start_[rowId][i]);
-        switch (ch) {
+      // copy the runs between escaped characters at once
+      const char* str = start_[rowId];
+      const int64_t length = length_[rowId];
+      int64_t runStart = 0;
+      for (int64_t i = 0; i < length; ++i) {
+        const char* escaped;
+        switch (str[i]) {
           case '\\':
-            writeString(buffer, "\\\\");
+            escaped = "\\\\";
             break;
           case '\b':
-            writeString(buffer, "\\b");
+            escaped = "\\b";
             break;
           case '\f':
-            writeString(buffer, "\\f");
+            escaped = "\\f";
             break;
           case '\n':
-            writeString(buffer, "\\n");
+            escaped = "\\n";
             break;
           case '\r':
-            writeString(buffer, "\\r");
+            escaped = "\\r";
             break;
           case '\t':
-            writeString(buffer, "\\t");
+            escaped = "\\t";
             break;
           case '"':
-            writeString(buffer, "\\\"");
+            escaped = "\\\"";
             break;
           default:
-            writeChar(buffer, ch);
-            break;
+            continue;
         }
+        buffer.append(str + runStart, static_cast<size_t>(i - runStart));
+        writeString(buffer, escaped);
+        runStart = i + 1;
       }
+      buffer.append(str + runStart, static_cast<size_t>(length - runStart));
       writeChar(buffer, '"');
     }
   }
@@ -541,8 +607,7 @@ namespace orc {
       writeString(buffer, "null");
     } else {
       writeString(buffer, "{\"tag\": ");
-      const auto numBuffer = std::to_string(static_cast<int64_t>(tags_[rowId]));
-      writeString(buffer, numBuffer.c_str());
+      writeInteger(buffer, tags_[rowId]);
       writeString(buffer, ", \"value\": ");
       fieldPrinter_[tags_[rowId]]->printRow(offsets_[rowId]);
       writeChar(buffer, '}');
@@ -593,13 +658,17 @@ namespace orc {
     if (hasNulls && !notNull[rowId]) {
       writeString(buffer, "null");
     } else {
-      const time_t timeValue = data_[rowId] * 24 * 60 * 60;
-      struct tm tmValue;
-      gmtime_r(&timeValue, &tmValue);
       char timeBuffer[11];
-      strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d", &tmValue);
       writeChar(buffer, '"');
-      writeString(buffer, timeBuffer);
+      if (char* end = formatDate(timeBuffer, data_[rowId])) {
+        buffer.append(timeBuffer, end);
+      } else {
+        const time_t timeValue = data_[rowId] * 24 * 60 * 60;
+        struct tm tmValue;
+        gmtime_r(&timeValue, &tmValue);
+        strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d", &tmValue);
+        writeString(buffer, timeBuffer);
+      }
       writeChar(buffer, '"');
     }
   }
@@ -641,8 +710,7 @@ namespace orc {
         if (i != 0) {
           writeString(buffer, ", ");
         }
-        const auto numBuffer = std::to_string(static_cast<int>(start_[rowId][i]) & 0xff);
-        writeString(buffer, numBuffer.c_str());
+        writeInteger(buffer, static_cast<int>(start_[rowId][i]) & 0xff);
       }
       writeChar(buffer, ']');
     }
@@ -665,13 +733,30 @@ namespace orc {
       writeString(buffer, "null");
     } else {
       int64_t nanos = nanoseconds_[rowId];
-      time_t secs = static_cast<time_t>(seconds_[rowId]);
-      struct tm tmValue;
-      gmtime_r(&secs, &tmValue);
+      const int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+      int64_t days = seconds_[rowId] / SECONDS_PER_DAY;
+      int64_t secondOfDay = seconds_[rowId] % SECONDS_PER_DAY;
+      if (secondOfDay < 0) {
+        days -= 1;
+        secondOfDay += SECONDS_PER_DAY;
+      }
       char timeBuffer[20];
-      strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", &tmValue);
       writeChar(buffer, '"');
-      writeString(buffer, timeBuffer);
+      if (char* end = formatDate(timeBuffer, days)) {
+        *end++ = ' ';
+        end = writeDigits(end, secondOfDay / 3600, 2);
+        *end++ = ':';
+        end = writeDigits(end, secondOfDay / 60 % 60, 2);
+        *end++ = ':';
+        end = writeDigits(end, secondOfDay % 60, 2);
+        buffer.append(timeBuffer, end);
+      } else {
+        time_t secs = static_cast<time_t>(seconds_[rowId]);
+        struct tm tmValue;
+        gmtime_r(&secs, &tmValue);
+        strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", &tmValue);
+        writeString(buffer, timeBuffer);
+      }
       writeChar(buffer, '.');
       // remove trailing zeros off the back of the nanos value.
       int64_t zeroDigits = 0;
@@ -683,12 +768,13 @@ namespace orc {
           zeroDigits += 1;
         }
       }
-      const auto numBuffer = std::to_string(static_cast<int64_t>(nanos));
-      const int64_t padDigits = NANO_DIGITS - zeroDigits - static_cast<int64_t>(numBuffer.size());
+      char numBuffer[20];
+      auto result = std::to_chars(numBuffer, numBuffer + sizeof(numBuffer), nanos);
+      const int64_t padDigits = NANO_DIGITS - zeroDigits - (result.ptr - numBuffer);
       for (int i = 0; i < padDigits; ++i) {
         writeChar(buffer, '0');
       }
-      writeString(buffer, numBuffer.c_str());
+      buffer.append(numBuffer, result.ptr);
       writeChar(buffer, '"');
     }
   }
@@ -24,6 +24,7 @@
 #include "ConvertColumnReader.hh"
 #include "RLE.hh"
 #include "SchemaEvolution.hh"
+#include "Utils.hh"
 #include "orc/Exceptions.hh"
 
 #include <math.h>
@@ -35,6 +36,15 @@ namespace orc {
     // PASS
   }
 
+  StreamReaderMetrics* StripeStreams::getStreamReaderMetrics(uint64_t columnId,
+                                                             proto::Stream_Kind kind) const {
+    ColumnMetricsTable* table = getColumnMetricsTable();
+    if (table == nullptr) {
+      return nullptr;
+    }
+    return &table->getStream(columnId, static_cast<StreamKind>(kind));
+  }
+
   inline RleVersion convertRleVersion(proto::ColumnEncoding_Kind kind) {
     switch (static_cast<int64_t>(kind)) {
       case proto::ColumnEncoding_Kind_DIRECT:
@@ -51,11 +61,18 @@ namespace orc {
   ColumnReader::ColumnReader(const Type& type, StripeStreams& stripe)
       : columnId(type.getColumnId()),
         memoryPool(stripe.getMemoryPool()),
-        metrics(stripe.getReaderMetrics()) {
+        metrics(stripe.getReaderMetrics()),
+        columnMetrics(nullptr),
+        traceRecorder(stripe.getTraceRecorder()) {
+    if (ColumnMetricsTable* table = stripe.getColumnMetricsTable()) {
+      columnMetrics = &table->getColumn(columnId);
+    }
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_PRESENT, true);
     if (stream.get()) {
-      notNullDecoder = createBooleanRleDecoder(std::move(stream), metrics);
+      notNullDecoder = createBooleanRleDecoder(
+          std::move(stream), metrics,
+          stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_PRESENT));
     }
   }
 
@@ -86,7 +103,23 @@ namespace orc {
     return numValues;
   }
 
+  void ColumnReader::nextChild(ColumnReader& child, ColumnVectorBatch& rowBatch,
+                               uint64_t numValues, char* notNull, bool encoded) {
+    ScopedTrace trace(traceRecorder, "decode", "decode column");
+    trace.addArg("column", child.columnId);
+    trace.addArg("rows", numValues);
+    if (encoded) {
+      child.nextEncoded(rowBatch, numValues, notNull);
+    } else {
+      child.next(rowBatch, numValues, notNull);
+    }
+  }
+
   void ColumnReader::next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* incomingMask) {
+    if (columnMetrics) {
+      columnMetrics->ReaderCall++;
+      columnMetrics->RowsRead += numValues;
+    }
     if (numValues > rowBatch.capacity) {
       rowBatch.resize(numValues);
     }
@@ -157,7 +190,9 @@ namespace orc {
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
     if (stream == nullptr) throw ParseError("DATA stream not found in Boolean column");
-    rle_ = createBooleanRleDecoder(std::move(stream), metrics);
+    rle_ = createBooleanRleDecoder(
+        std::move(stream), metrics,
+        stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_DATA));
   }
 
   template <typename BatchType>
@@ -202,7 +237,8 @@ namespace orc {
       std::unique_ptr<SeekableInputStream> stream =
           stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
       if (stream == nullptr) throw ParseError("DATA stream not found in Byte column");
-      rle_ = createByteRleDecoder(std::move(stream), metrics);
+      rle_ = createByteRleDecoder(std::move(stream), metrics,
+                                  stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_DATA));
     }
 
     ~ByteColumnReader() override = default;
@@ -240,7 +276,8 @@ namespace orc {
       std::unique_ptr<SeekableInputStream> stream =
           stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
       if (stream == nullptr) throw ParseError("DATA stream not found in Integer column");
-      rle = createRleDecoder(std::move(stream), true, vers, memoryPool, metrics);
+      rle = createRleDecoder(std::move(stream), true, vers, memoryPool, metrics,
+                             stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_DATA));
     }
 
     ~IntegerColumnReader() override {
@@ -273,6 +310,10 @@ namespace orc {
     const Timezone* readerTimezone_;
     const int64_t epochOffset_;
     const bool sameTimezone_;
+    // variants of the previous value, reused until a transition is crossed
+    TimezoneVariantCache writerVariants_;
+    TimezoneVariantCache readerVariants_;
+    TimezoneVariantCache adjustedReaderVariants_;
 
    public:
     TimestampColumnReader(const Type& type, StripeStreams& stripe, bool isInstantType);
@@ -291,15 +332,22 @@ namespace orc {
         writerTimezone_(isInstantType ? &getTimezoneByName("GMT") : &stripe.getWriterTimezone()),
         readerTimezone_(isInstantType ? &getTimezoneByName("GMT") : &stripe.getReaderTimezone()),
         epochOffset_(writerTimezone_->getEpoch()),
-        sameTimezone_(writerTimezone_ == readerTimezone_) {
+        sameTimezone_(writerTimezone_ == readerTimezone_),
+        writerVariants_(*writerTimezone_),
+        readerVariants_(*readerTimezone_),
+        adjustedReaderVariants_(*readerTimezone_) {
     RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
     if (stream == nullptr) throw ParseError("DATA stream not found in Timestamp column");
-    secondsRle_ = createRleDecoder(std::move(stream), true, vers, memoryPool, metrics);
+    secondsRle_ = createRleDecoder(
+        std::move(stream), true, vers, memoryPool, metrics,
+        stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_DATA));
     stream = stripe.getStream(columnId, proto::Stream_Kind_SECONDARY, true);
     if (stream == nullptr) throw ParseError("SECONDARY stream not found in Timestamp column");
-    nanoRle_ = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics);
+    nanoRle_ = createRleDecoder(
+        std::move(stream), false, vers, memoryPool, metrics,
+        stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_SECONDARY));
   }
 
   TimestampColumnReader::~TimestampColumnReader() {
@@ -336,13 +384,13 @@ namespace orc {
         if (!sameTimezone_) {
           // adjust timestamp value to same wall clock time if writer and reader
           // time zones have different rules, which is required for Apache Orc.
-          const auto& wv = writerTimezone_->getVariant(writerTime);
-          const auto& rv = readerTimezone_->getVariant(writerTime);
+          const auto& wv = writerVariants_.get(writerTime);
+          const auto& rv = readerVariants_.get(writerTime);
           if (!wv.hasSameTzRule(rv)) {
             // If the timezone adjustment moves the millis across a DST boundary,
             // we need to reevaluate the offsets.
             int64_t adjustedTime = writerTime + wv.gmtOffset - rv.gmtOffset;
-            const auto& adjustedReader = readerTimezone_->getVariant(adjustedTime);
+            const auto& adjustedReader = adjustedReaderVariants_.get(adjustedTime);
             writerTime = writerTime + wv.gmtOffset - adjustedReader.gmtOffset;
           }
         }
@@ -575,13 +623,15 @@ namespace orc {
     if (stream == nullptr) {
       throw ParseError("DATA stream not found in StringDictionaryColumn");
     }
-    rle_ = createRleDecoder(std::move(stream), false, rleVersion, memoryPool, metrics);
+    rle_ = createRleDecoder(std::move(stream), false, rleVersion, memoryPool, metrics,
+                            stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_DATA));
     stream = stripe.getStream(columnId, proto::Stream_Kind_LENGTH, false);
     if (dictSize > 0 && stream == nullptr) {
       throw ParseError("LENGTH stream not found in StringDictionaryColumn");
     }
     std::unique_ptr<RleDecoder> lengthDecoder =
-        createRleDecoder(std::move(stream), false, rleVersion, memoryPool, metrics);
+        createRleDecoder(std::move(stream), false, rleVersion, memoryPool, metrics,
+                         stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_LENGTH));
     dictionary_->dictionaryOffset.resize(dictSize + 1);
     int64_t* lengthArray = dictionary_->dictionaryOffset.data();
     lengthDecoder->next(lengthArray + 1, dictSize, nullptr);
@@ -699,7 +749,9 @@ namespace orc {
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_LENGTH, true);
     if (stream == nullptr) throw ParseError("LENGTH stream not found in StringDirectColumn");
-    lengthRle_ = createRleDecoder(std::move(stream), false, rleVersion, memoryPool, metrics);
+    lengthRle_ = createRleDecoder(
+        std::move(stream), false, rleVersion, memoryPool, metrics,
+        stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_LENGTH));
     blobStream_ = stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
     if (blobStream_ == nullptr) throw ParseError("DATA stream not found in StringDirectColumn");
     lastBuffer_ = nullptr;
@@ -901,12 +953,8 @@ namespace orc {
     uint64_t i = 0;
     notNull = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
     for (auto iter = children_.begin(); iter != children_.end(); ++iter, ++i) {
-      if (encoded) {
-        (*iter)->nextEncoded(*(dynamic_cast<StructVectorBatch&>(rowBatch).fields[i]), numValues,
-                             notNull);
-      } else {
-        (*iter)->next(*(dynamic_cast<StructVectorBatch&>(rowBatch).fields[i]), numValues, notNull);
-      }
+      nextChild(**iter, *(dynamic_cast<StructVectorBatch&>(rowBatch).fields[i]), numValues,
+                notNull, encoded);
     }
   }
 
@@ -952,7 +1000,8 @@ namespace orc {
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_LENGTH, true);
     if (stream == nullptr) throw ParseError("LENGTH stream not found in List column");
-    rle_ = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics);
+    rle_ = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics,
+                            stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_LENGTH));
     const Type& childType = *type.getSubtype(0);
     if (selectedColumns[static_cast<uint64_t>(childType.getColumnId())]) {
       child_ =
@@ -1025,11 +1074,7 @@ namespace orc {
     offsets[numValues] = static_cast<int64_t>(totalChildren);
     ColumnReader* childReader = child_.get();
     if (childReader) {
-      if (encoded) {
-        childReader->nextEncoded(*(listBatch.elements.get()), totalChildren, nullptr);
-      } else {
-        childReader->next(*(listBatch.elements.get()), totalChildren, nullptr);
-      }
+      nextChild(*childReader, *(listBatch.elements.get()), totalChildren, nullptr, encoded);
     }
   }
 
@@ -1074,7 +1119,8 @@ namespace orc {
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_LENGTH, true);
     if (stream == nullptr) throw ParseError("LENGTH stream not found in Map column");
-    rle_ = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics);
+    rle_ = createRleDecoder(std::move(stream), false, vers, memoryPool, metrics,
+                            stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_LENGTH));
     const Type& keyType = *type.getSubtype(0);
     if (selectedColumns[static_cast<uint64_t>(keyType.getColumnId())]) {
       keyReader_ =
@@ -1158,19 +1204,11 @@ namespace orc {
     offsets[numValues] = static_cast<int64_t>(totalChildren);
     ColumnReader* rawKeyReader = keyReader_.get();
     if (rawKeyReader) {
-      if (encoded) {
-        rawKeyReader->nextEncoded(*(mapBatch.keys.get()), totalChildren, nullptr);
-      } else {
-        rawKeyReader->next(*(mapBatch.keys.get()), totalChildren, nullptr);
-      }
+      nextChild(*rawKeyReader, *(mapBatch.keys.get()), totalChildren, nullptr, encoded);
     }
     ColumnReader* rawElementReader = elementReader_.get();
     if (rawElementReader) {
-      if (encoded) {
-        rawElementReader->nextEncoded(*(mapBatch.elements.get()), totalChildren, nullptr);
-      } else {
-        rawElementReader->next(*(mapBatch.elements.get()), totalChildren, nullptr);
-      }
+      nextChild(*rawElementReader, *(mapBatch.elements.get()), totalChildren, nullptr, encoded);
     }
   }
 
@@ -1220,7 +1258,8 @@ namespace orc {
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
     if (stream == nullptr) throw ParseError("LENGTH stream not found in Union column");
-    rle_ = createByteRleDecoder(std::move(stream), metrics);
+    rle_ = createByteRleDecoder(std::move(stream), metrics,
+                                stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_DATA));
     // figure out which types are selected
     const std::vector<bool> selectedColumns = stripe.getSelectedColumns();
     for (unsigned int i = 0; i < numChildren_; ++i) {
@@ -1290,13 +1329,8 @@ namespace orc {
     // read the right number of each child column
     for (size_t i = 0; i < numChildren_; ++i) {
       if (childrenReader_[i] != nullptr) {
-        if (encoded) {
-          childrenReader_[i]->nextEncoded(*(unionBatch.children[i]),
-                                          static_cast<uint64_t>(counts[i]), nullptr);
-        } else {
-          childrenReader_[i]->next(*(unionBatch.children[i]), static_cast<uint64_t>(counts[i]),
-                                   nullptr);
-        }
+        nextChild(*childrenReader_[i], *(unionBatch.children[i]),
+                  static_cast<uint64_t>(counts[i]), nullptr, encoded);
       }
     }
   }
@@ -1421,7 +1455,9 @@ namespace orc {
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_SECONDARY, true);
     if (stream == nullptr) throw ParseError("SECONDARY stream not found in Decimal64Column");
-    scaleDecoder = createRleDecoder(std::move(stream), true, vers, memoryPool, metrics);
+    scaleDecoder = createRleDecoder(
+        std::move(stream), true, vers, memoryPool, metrics,
+        stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_SECONDARY));
   }
 
   Decimal64ColumnReader::~Decimal64ColumnReader() {
@@ -1580,7 +1616,9 @@ namespace orc {
       ss << "DATA stream not found in Decimal64V2 column. ColumnId=" << columnId;
       throw ParseError(ss.str());
     }
-    valueDecoder = createRleDecoder(std::move(stream), true, RleVersion_2, memoryPool, metrics);
+    valueDecoder = createRleDecoder(
+        std::move(stream), true, RleVersion_2, memoryPool, metrics,
+        stripe.getStreamReaderMetrics(columnId, proto::Stream_Kind_DATA));
   }
 
   Decimal64ColumnReaderV2::~Decimal64ColumnReaderV2() {
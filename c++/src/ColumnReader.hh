@@ -69,6 +69,22 @@ namespace orc {
      */
     virtual ReaderMetrics* getReaderMetrics() const = 0;
 
+    /**
+     * Get the trace recorder for this reader.
+     */
+    virtual TraceRecorder* getTraceRecorder() const = 0;
+
+    /**
+     * Get the table of the reader metrics of each column for this reader.
+     */
+    virtual ColumnMetricsTable* getColumnMetricsTable() const = 0;
+
+    /**
+     * Get the metrics of a stream of a column.
+     * @return nullptr if the reader has no table of column metrics
+     */
+    StreamReaderMetrics* getStreamReaderMetrics(uint64_t columnId, proto::Stream_Kind kind) const;
+
     /**
      * Get the writer's timezone, so that we can convert their dates correctly.
      */
@@ -119,6 +135,15 @@ namespace orc {
     uint64_t columnId;
     MemoryPool& memoryPool;
     ReaderMetrics* metrics;
+    ColumnReaderMetrics* columnMetrics;
+    TraceRecorder* traceRecorder;
+
+    /**
+     * Read the next group of values of a child column, which is traced as a
+     * decode column span of its own.
+     */
+    void nextChild(ColumnReader& child, ColumnVectorBatch& rowBatch, uint64_t numValues,
+                   char* notNull, bool encoded);
 
    public:
     ColumnReader(const Type& type, StripeStreams& stipe);
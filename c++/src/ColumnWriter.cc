@@ -961,10 +961,40 @@ namespace orc {
     void fallbackToDirectEncoding();
 
    protected:
+    /**
+     * Decide on the encoding once enough values have been sampled into
+     * the dictionary.
+     * @return true if the writer just switched to direct encoding
+     */
+    bool checkDictionarySample();
+
+    /**
+     * Write the leading rows of a batch that carries dictionary indexes
+     * (EncodedStringVectorBatch) without hashing every value: each entry of
+     * the source dictionary is mapped into this writer's dictionary once. The
+     * values of the rows that cannot be written this way, e.g. after falling
+     * back to direct encoding, are decoded into data and length.
+     * @return the number of rows that were written
+     */
+    uint64_t addEncodedValues(StringVectorBatch& batch, uint64_t offset, uint64_t numValues,
+                              StringColumnStatisticsImpl* strStats);
+
+    /**
+     * Apply the length rules of the type to a value before it is written.
+     * @param data the value
+     * @param length the length of the value; updated to the written length
+     * @return the bytes to write, valid until the next call
+     */
+    virtual const char* adjustValue(const char* data, size_t& length) {
+      (void)length;
+      return data;
+    }
+
     RleVersion rleVersion;
     bool useCompression;
     const StreamsFactory& streamsFactory;
     bool alignedBitPacking;
+    WriterMetrics* metrics;
 
     // direct encoding streams
     std::unique_ptr<RleEncoder> directLengthEncoder;
@@ -985,6 +1015,13 @@ namespace orc {
     bool useDictionary;
     // keys in the dictionary should not exceed this ratio
     double dictSizeThreshold;
+    // number of values after which the dictionary check is done; 0 to wait
+    // for the first row group or the end of the stripe
+    uint64_t dictSampleSize;
+    // source dictionary of the last encoded batch and the index of each of
+    // its entries in this writer's dictionary, -1 if not inserted yet
+    std::shared_ptr<StringDictionary> sourceDictionary;
+    std::vector<int64_t> sourceIndexMap;
 
     // record start row of each row group; null rows are skipped
     mutable std::vector<size_t> startOfRowGroups;
@@ -997,9 +1034,12 @@ namespace orc {
         useCompression(options.getCompression() != CompressionKind_NONE),
         streamsFactory(factory),
         alignedBitPacking(options.getAlignedBitpacking()),
+        metrics(options.getWriterMetrics()),
+        dictionary(*options.getMemoryPool()),
         doneDictionaryCheck(false),
         useDictionary(options.getEnableDictionary()),
-        dictSizeThreshold(options.getDictionaryKeySizeThreshold()) {
+        dictSizeThreshold(options.getDictionaryKeySizeThreshold()),
+        dictSampleSize(options.getDictionarySampleSize()) {
     if (type.getKind() == TypeKind::BINARY) {
       useDictionary = false;
       doneDictionaryCheck = true;
@@ -1019,7 +1059,7 @@ namespace orc {
 
   void StringColumnWriter::add(ColumnVectorBatch& rowBatch, uint64_t offset, uint64_t numValues,
                                const char* incomingMask) {
-    const StringVectorBatch* stringBatch = dynamic_cast<const StringVectorBatch*>(&rowBatch);
+    StringVectorBatch* stringBatch = dynamic_cast<StringVectorBatch*>(&rowBatch);
     if (stringBatch == nullptr) {
       throw InvalidArgument("Failed to cast to StringVectorBatch");
     }
@@ -1032,14 +1072,16 @@ namespace orc {
 
     ColumnWriter::add(rowBatch, offset, numValues, incomingMask);
 
+    uint64_t encodedRows = addEncodedValues(*stringBatch, offset, numValues, strStats);
+    offset += encodedRows;
+    numValues -= encodedRows;
+
     char* const* data = stringBatch->data.data() + offset;
     const int64_t* length = stringBatch->length.data() + offset;
     const char* notNull = stringBatch->hasNulls ? stringBatch->notNull.data() + offset : nullptr;
 
-    if (!useDictionary) {
-      directLengthEncoder->add(length, numValues, notNull);
-    }
-
+    // lengths from this row on are written by the direct length encoder
+    uint64_t directStart = 0;
     uint64_t count = 0;
     for (uint64_t i = 0; i < numValues; ++i) {
       if (!notNull || notNull[i]) {
@@ -1047,6 +1089,9 @@ namespace orc {
         if (useDictionary) {
           size_t index = dictionary.insert(data[i], len);
           dictionary.idxInDictBuffer_.push_back(static_cast<int64_t>(index));
+          if (checkDictionarySample()) {
+            directStart = i + 1;
+          }
         } else {
           directDataStream->write(data[i], len);
         }
@@ -1057,12 +1102,83 @@ namespace orc {
         ++count;
       }
     }
+
+    if (!useDictionary) {
+      directLengthEncoder->add(length + directStart, numValues - directStart,
+                               notNull ? notNull + directStart : nullptr);
+    }
+
     strStats->increase(count);
     if (count < numValues) {
       strStats->setHasNull(true);
     }
   }
 
+  uint64_t StringColumnWriter::addEncodedValues(StringVectorBatch& batch, uint64_t offset,
+                                                uint64_t numValues,
+                                                StringColumnStatisticsImpl* strStats) {
+    auto* encodedBatch = dynamic_cast<EncodedStringVectorBatch*>(&batch);
+    if (!batch.isEncoded || batch.dictionaryDecoded || encodedBatch == nullptr) {
+      return 0;
+    }
+    const StringDictionary& source = *encodedBatch->dictionary;
+    const int64_t sourceSize = static_cast<int64_t>(source.dictionaryOffset.size()) - 1;
+    const int64_t* sourceOffset = source.dictionaryOffset.data();
+    const char* sourceBlob = source.dictionaryBlob.data();
+    const int64_t* index = encodedBatch->index.data() + offset;
+    const char* notNull = batch.hasNulls ? batch.notNull.data() + offset : nullptr;
+
+    uint64_t i = 0;
+    if (useDictionary) {
+      if (sourceDictionary != encodedBatch->dictionary) {
+        sourceDictionary = encodedBatch->dictionary;
+        sourceIndexMap.assign(static_cast<size_t>(sourceSize), -1);
+      }
+
+      uint64_t count = 0;
+      for (; i < numValues && useDictionary; ++i) {
+        if (notNull && !notNull[i]) {
+          continue;
+        }
+        if (index[i] < 0 || index[i] >= sourceSize) {
+          throw InvalidArgument("Dictionary index out of range");
+        }
+        int64_t& mapped = sourceIndexMap[static_cast<size_t>(index[i])];
+        if (mapped < 0) {
+          size_t len = static_cast<size_t>(sourceOffset[index[i] + 1] - sourceOffset[index[i]]);
+          const char* value = adjustValue(sourceBlob + sourceOffset[index[i]], len);
+          mapped = static_cast<int64_t>(dictionary.insert(value, len));
+        }
+        dictionary.idxInDictBuffer_.push_back(mapped);
+
+        const auto& entry = dictionary.getEntry(static_cast<size_t>(mapped));
+        if (enableBloomFilter) {
+          bloomFilter->addBytes(entry.data, static_cast<int64_t>(entry.length));
+        }
+        strStats->update(entry.data, entry.length);
+        ++count;
+        checkDictionarySample();
+      }
+
+      strStats->increase(count);
+      if (count < i) {
+        strStats->setHasNull(true);
+      }
+    }
+
+    // the remaining rows go through the regular path
+    for (uint64_t j = i; j < numValues; ++j) {
+      if (!notNull || notNull[j]) {
+        if (index[j] < 0 || index[j] >= sourceSize) {
+          throw InvalidArgument("Dictionary index out of range");
+        }
+        batch.data[offset + j] = const_cast<char*>(sourceBlob) + sourceOffset[index[j]];
+        batch.length[offset + j] = sourceOffset[index[j] + 1] - sourceOffset[index[j]];
+      }
+    }
+    return i;
+  }
+
   void StringColumnWriter::flush(std::vector<proto::Stream>& streams) {
     ColumnWriter::flush(streams);
 
@@ -1157,11 +1273,32 @@ namespace orc {
                       static_cast<size_t>(static_cast<double>(dictionary.idxInDictBuffer_.size()) *
                                           dictSizeThreshold);
       doneDictionaryCheck = true;
+
+      if (metrics != nullptr) {
+        metrics->DictionaryCheckCount.fetch_add(1);
+        metrics->DictionarySampledValues.fetch_add(dictionary.idxInDictBuffer_.size());
+        metrics->DictionarySampledKeys.fetch_add(dictionary.size());
+        if (!useDictionary) {
+          metrics->DictionaryAbandonedCount.fetch_add(1);
+        }
+      }
     }
 
     return useDictionary;
   }
 
+  bool StringColumnWriter::checkDictionarySample() {
+    if (doneDictionaryCheck || dictSampleSize == 0 ||
+        dictionary.idxInDictBuffer_.size() < dictSampleSize) {
+      return false;
+    }
+    if (!checkDictionaryKeyRatio()) {
+      fallbackToDirectEncoding();
+      return true;
+    }
+    return false;
+  }
+
   void StringColumnWriter::createRowIndexEntry() {
     if (useDictionary && !doneDictionaryCheck) {
       if (!checkDictionaryKeyRatio()) {
@@ -1176,6 +1313,8 @@ namespace orc {
 
     dictionary.clear();
     dictionary.idxInDictBuffer_.resize(0);
+    sourceDictionary.reset();
+    sourceIndexMap.clear();
     startOfRowGroups.clear();
     startOfRowGroups.push_back(0);
   }
@@ -1209,6 +1348,8 @@ namespace orc {
 
     dictionary.clear();
     dictionary.idxInDictBuffer_.clear();
+    sourceDictionary.reset();
+    sourceIndexMap.clear();
     startOfRowGroups.clear();
   }
 
@@ -1270,16 +1411,13 @@ namespace orc {
       directLengthEncoder->recordPosition(&recorder);
     }
 
-    // get dictionary entries in insertion order
-    std::vector<const SortedStringDictionary::DictEntry*> entries;
-    dictionary.getEntriesInInsertionOrder(entries);
-
     // store each length of the data into a vector
     for (uint64_t i = 0; i != dictionary.idxInDictBuffer_.size(); ++i) {
       // write one row data in direct encoding
-      const auto& dictEntry = entries[static_cast<size_t>(dictionary.idxInDictBuffer_[i])];
-      directDataStream->write(dictEntry->data->data(), dictEntry->data->size());
-      directLengthEncoder->write(static_cast<int64_t>(dictEntry->data->size()));
+      const auto& dictEntry =
+          dictionary.getEntry(static_cast<size_t>(dictionary.idxInDictBuffer_[i]));
+      directDataStream->write(dictEntry.data, dictEntry.length);
+      directLengthEncoder->write(static_cast<int64_t>(dictEntry.length));
     }
 
     deleteDictStreams();
@@ -1298,11 +1436,28 @@ namespace orc {
     virtual void add(ColumnVectorBatch& rowBatch, uint64_t offset, uint64_t numValues,
                      const char* incomingMask) override;
 
+   protected:
+    virtual const char* adjustValue(const char* data, size_t& length) override;
+
    private:
     uint64_t maxLength_;
     DataBuffer<char> padBuffer_;
   };
 
+  const char* CharColumnWriter::adjustValue(const char* data, size_t& length) {
+    uint64_t originLength = length;
+    uint64_t charLength = Utf8Utils::charLength(data, originLength);
+    if (charLength >= maxLength_) {
+      length = static_cast<size_t>(Utf8Utils::truncateBytesTo(maxLength_, data, originLength));
+      return data;
+    }
+    // the padding is exactly 1 byte per char
+    length = static_cast<size_t>(originLength + maxLength_ - charLength);
+    memcpy(padBuffer_.data(), data, originLength);
+    memset(padBuffer_.data() + originLength, ' ', length - originLength);
+    return padBuffer_.data();
+  }
+
   void CharColumnWriter::add(ColumnVectorBatch& rowBatch, uint64_t offset, uint64_t numValues,
                              const char* incomingMask) {
     StringVectorBatch* charsBatch = dynamic_cast<StringVectorBatch*>(&rowBatch);
@@ -1318,32 +1473,28 @@ namespace orc {
 
     ColumnWriter::add(rowBatch, offset, numValues, incomingMask);
 
+    uint64_t encodedRows = addEncodedValues(*charsBatch, offset, numValues, strStats);
+    offset += encodedRows;
+    numValues -= encodedRows;
+
     char** data = charsBatch->data.data() + offset;
     int64_t* length = charsBatch->length.data() + offset;
     const char* notNull = charsBatch->hasNulls ? charsBatch->notNull.data() + offset : nullptr;
 
+    uint64_t directStart = 0;
     uint64_t count = 0;
     for (uint64_t i = 0; i < numValues; ++i) {
       if (!notNull || notNull[i]) {
-        const char* charData = nullptr;
-        uint64_t originLength = static_cast<uint64_t>(length[i]);
-        uint64_t charLength = Utf8Utils::charLength(data[i], originLength);
-        if (charLength >= maxLength_) {
-          charData = data[i];
-          length[i] =
-              static_cast<int64_t>(Utf8Utils::truncateBytesTo(maxLength_, data[i], originLength));
-        } else {
-          charData = padBuffer_.data();
-          // the padding is exactly 1 byte per char
-          length[i] = length[i] + static_cast<int64_t>(maxLength_ - charLength);
-          memcpy(padBuffer_.data(), data[i], originLength);
-          memset(padBuffer_.data() + originLength, ' ',
-                 static_cast<size_t>(length[i]) - originLength);
-        }
+        size_t charLength = static_cast<size_t>(length[i]);
+        const char* charData = adjustValue(data[i], charLength);
+        length[i] = static_cast<int64_t>(charLength);
 
         if (useDictionary) {
           size_t index = dictionary.insert(charData, static_cast<size_t>(length[i]));
           dictionary.idxInDictBuffer_.push_back(static_cast<int64_t>(index));
+          if (checkDictionarySample()) {
+            directStart = i + 1;
+          }
         } else {
           directDataStream->write(charData, static_cast<size_t>(length[i]));
         }
@@ -1357,7 +1508,8 @@ namespace orc {
     }
 
     if (!useDictionary) {
-      directLengthEncoder->add(length, numValues, notNull);
+      directLengthEncoder->add(length + directStart, numValues - directStart,
+                               notNull ? notNull + directStart : nullptr);
     }
 
     strStats->increase(count);
@@ -1377,6 +1529,12 @@ namespace orc {
     virtual void add(ColumnVectorBatch& rowBatch, uint64_t offset, uint64_t numValues,
                      const char* incomingMask) override;
 
+   protected:
+    virtual const char* adjustValue(const char* data, size_t& length) override {
+      length = static_cast<size_t>(Utf8Utils::truncateBytesTo(maxLength_, data, length));
+      return data;
+    }
+
    private:
     uint64_t maxLength_;
   };
@@ -1396,20 +1554,28 @@ namespace orc {
 
     ColumnWriter::add(rowBatch, offset, numValues, incomingMask);
 
+    uint64_t encodedRows = addEncodedValues(*charsBatch, offset, numValues, strStats);
+    offset += encodedRows;
+    numValues -= encodedRows;
+
     char* const* data = charsBatch->data.data() + offset;
     int64_t* length = charsBatch->length.data() + offset;
     const char* notNull = charsBatch->hasNulls ? charsBatch->notNull.data() + offset : nullptr;
 
+    uint64_t directStart = 0;
     uint64_t count = 0;
     for (uint64_t i = 0; i < numValues; ++i) {
       if (!notNull || notNull[i]) {
-        uint64_t itemLength =
-            Utf8Utils::truncateBytesTo(maxLength_, data[i], static_cast<uint64_t>(length[i]));
+        size_t itemLength = static_cast<size_t>(length[i]);
+        adjustValue(data[i], itemLength);
         length[i] = static_cast<int64_t>(itemLength);
 
         if (useDictionary) {
           size_t index = dictionary.insert(data[i], static_cast<size_t>(length[i]));
           dictionary.idxInDictBuffer_.push_back(static_cast<int64_t>(index));
+          if (checkDictionarySample()) {
+            directStart = i + 1;
+          }
         } else {
           directDataStream->write(data[i], static_cast<size_t>(length[i]));
         }
@@ -1423,7 +1589,8 @@ namespace orc {
     }
 
     if (!useDictionary) {
-      directLengthEncoder->add(length, numValues, notNull);
+      directLengthEncoder->add(length + directStart, numValues - directStart,
+                               notNull ? notNull + directStart : nullptr);
     }
 
     strStats->increase(count);
@@ -1508,6 +1675,8 @@ namespace orc {
     RleVersion rleVersion_;
     const Timezone* timezone_;
     const bool isUTC_;
+    // the values of a batch converted to UTC for statistics and bloom filters
+    DataBuffer<int64_t> utcSeconds_;
   };
 
   TimestampColumnWriter::TimestampColumnWriter(const Type& type, const StreamsFactory& factory,
@@ -1515,7 +1684,8 @@ namespace orc {
       : ColumnWriter(type, factory, options),
         rleVersion_(options.getRleVersion()),
         timezone_(isInstantType ? &getTimezoneByName("GMT") : &options.getTimezone()),
-        isUTC_(isInstantType || options.getTimezoneName() == "GMT") {
+        isUTC_(isInstantType || options.getTimezoneName() == "GMT"),
+        utcSeconds_(memPool) {
     std::unique_ptr<BufferedOutputStream> dataStream =
         factory.createStream(proto::Stream_Kind_DATA);
     std::unique_ptr<BufferedOutputStream> secondaryStream =
@@ -1570,14 +1740,20 @@ namespace orc {
     int64_t* secs = tsBatch->data.data() + offset;
     int64_t* nanos = tsBatch->nanoseconds.data() + offset;
 
+    // TimestampVectorBatch already stores data in UTC
+    const int64_t* utcSecs = secs;
+    if (!isUTC_) {
+      utcSeconds_.resize(numValues);
+      memcpy(utcSeconds_.data(), secs, numValues * sizeof(int64_t));
+      timezone_->convertToUTC(utcSeconds_.data(), numValues, notNull);
+      utcSecs = utcSeconds_.data();
+    }
+    const int64_t epoch = timezone_->getEpoch();
+
     uint64_t count = 0;
     for (uint64_t i = 0; i < numValues; ++i) {
       if (notNull == nullptr || notNull[i]) {
-        // TimestampVectorBatch already stores data in UTC
-        int64_t millsUTC = secs[i] * 1000 + nanos[i] / 1000000;
-        if (!isUTC_) {
-          millsUTC = timezone_->convertToUTC(secs[i]) * 1000 + nanos[i] / 1000000;
-        }
+        int64_t millsUTC = utcSecs[i] * 1000 + nanos[i] / 1000000;
         ++count;
         if (enableBloomFilter) {
           bloomFilter->addLong(millsUTC);
@@ -1588,7 +1764,7 @@ namespace orc {
           secs[i] += 1;
         }
 
-        secs[i] -= timezone_->getEpoch();
+        secs[i] -= epoch;
         nanos[i] = formatNano(nanos[i]);
       }
     }
@@ -408,6 +408,14 @@ namespace orc {
     virtual void seek(PositionProvider& position) override;
     virtual std::string getName() const override = 0;
 
+    void setTraceRecorder(TraceRecorder* recorder) {
+      traceRecorder = recorder;
+    }
+
+    void setStreamMetrics(StreamReaderMetrics* metrics) {
+      streamMetrics = metrics;
+    }
+
    protected:
     virtual void NextDecompress(const void** data, int* size, size_t availableSize) = 0;
 
@@ -453,6 +461,8 @@ namespace orc {
     off_t bytesReturned;
 
     ReaderMetrics* metrics;
+    TraceRecorder* traceRecorder = nullptr;
+    StreamReaderMetrics* streamMetrics = nullptr;
   };
 
   DecompressionStream::DecompressionStream(std::unique_ptr<SeekableInputStream> inStream,
@@ -481,6 +491,7 @@ namespace orc {
 
   void DecompressionStream::readBuffer(bool failOnEof) {
     SCOPED_MINUS_STOPWATCH(metrics, DecompressionLatencyUs);
+    SCOPED_STREAM_MINUS_STOPWATCH(streamMetrics, DecompressionLatencyUs);
     int length;
     if (!input->Next(reinterpret_cast<const void**>(&inputBuffer), &length)) {
       if (failOnEof) {
@@ -525,6 +536,7 @@ namespace orc {
 
   bool DecompressionStream::Next(const void** data, int* size) {
     SCOPED_STOPWATCH(metrics, DecompressionLatencyUs, DecompressionCall);
+    SCOPED_STREAM_STOPWATCH(streamMetrics, DecompressionLatencyUs, DecompressionCall);
     // If we are starting a new header, we will have to store its positions
     // after decompressing.
     bool saveBufferPositions = false;
@@ -560,7 +572,13 @@ namespace orc {
       inputBuffer += availableSize;
       remainingLength -= availableSize;
     } else if (state == DECOMPRESS_START) {
+      ScopedTrace trace(traceRecorder, "read", "decompress");
+      trace.addArg("compressed", remainingLength);
       NextDecompress(data, size, availableSize);
+      trace.addArg("bytes", static_cast<uint64_t>(*size));
+      if (streamMetrics) {
+        streamMetrics->BytesDecompressed += static_cast<uint64_t>(*size);
+      }
     } else {
       throw CompressionError(
           "Unknown compression state in "
@@ -1276,29 +1294,41 @@ namespace orc {
 
   std::unique_ptr<SeekableInputStream> createDecompressor(
       CompressionKind kind, std::unique_ptr<SeekableInputStream> input, uint64_t blockSize,
-      MemoryPool& pool, ReaderMetrics* metrics) {
+      MemoryPool& pool, ReaderMetrics* metrics, TraceRecorder* traceRecorder,
+      StreamReaderMetrics* streamMetrics) {
+    std::unique_ptr<DecompressionStream> result;
     switch (static_cast<int64_t>(kind)) {
       case CompressionKind_NONE:
         return input;
       case CompressionKind_ZLIB:
-        return std::make_unique<ZlibDecompressionStream>(std::move(input), blockSize, pool,
-                                                         metrics);
-      case CompressionKind_SNAPPY:
-        return std::make_unique<SnappyDecompressionStream>(std::move(input), blockSize, pool,
+        result = std::make_unique<ZlibDecompressionStream>(std::move(input), blockSize, pool,
                                                            metrics);
+        break;
+      case CompressionKind_SNAPPY:
+        result = std::make_unique<SnappyDecompressionStream>(std::move(input), blockSize, pool,
+                                                             metrics);
+        break;
       case CompressionKind_LZO:
-        return std::make_unique<LzoDecompressionStream>(std::move(input), blockSize, pool, metrics);
+        result =
+            std::make_unique<LzoDecompressionStream>(std::move(input), blockSize, pool, metrics);
+        break;
       case CompressionKind_LZ4:
-        return std::make_unique<Lz4DecompressionStream>(std::move(input), blockSize, pool, metrics);
+        result =
+            std::make_unique<Lz4DecompressionStream>(std::move(input), blockSize, pool, metrics);
+        break;
       case CompressionKind_ZSTD:
-        return std::make_unique<ZSTDDecompressionStream>(std::move(input), blockSize, pool,
-                                                         metrics);
+        result = std::make_unique<ZSTDDecompressionStream>(std::move(input), blockSize, pool,
+                                                           metrics);
+        break;
       default: {
         std::ostringstream buffer;
         buffer << "Unknown compression codec " << kind;
         throw NotImplementedYet(buffer.str());
       }
     }
+    result->setTraceRecorder(traceRecorder);
+    result->setStreamMetrics(streamMetrics);
+    return result;
   }
 
 }  // namespace orc
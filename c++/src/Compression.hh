@@ -31,10 +31,13 @@ namespace orc {
    * @param bufferSize the maximum size of the buffer
    * @param pool the memory pool
    * @param metrics the reader metrics
+   * @param traceRecorder the recorder of the decompressed blocks
+   * @param streamMetrics the metrics of the column stream that is decompressed
    */
   std::unique_ptr<SeekableInputStream> createDecompressor(
       CompressionKind kind, std::unique_ptr<SeekableInputStream> input, uint64_t bufferSize,
-      MemoryPool& pool, ReaderMetrics* metrics);
+      MemoryPool& pool, ReaderMetrics* metrics, TraceRecorder* traceRecorder = nullptr,
+      StreamReaderMetrics* streamMetrics = nullptr);
 
   /**
    * Create a compressor for the given compression kind.
@@ -19,7 +19,14 @@
 #include "ConvertColumnReader.hh"
 #include "Utils.hh"
 
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <optional>
+#include <string_view>
 
 namespace orc {
 
@@ -105,6 +112,113 @@ namespace orc {
     return true;
   }
 
+  // Parse a whole string the way std::stoll does, without throwing. Plain
+  // decimal numbers take the std::from_chars path. Anything else (leading
+  // whitespace, a '+' sign, trailing characters) falls back to strtoll.
+  // Returns false if no number can be parsed or it does not fit in int64_t.
+  static bool parseInteger(const char* data, size_t length, int64_t& value) {
+    auto [ptr, ec] = std::from_chars(data, data + length, value);
+    if (ec == std::errc() && ptr == data + length) {
+      return true;
+    }
+    const std::string str(data, length);
+    char* end = nullptr;
+    errno = 0;
+    long long result = std::strtoll(str.c_str(), &end, 10);
+    if (end == str.c_str() || errno == ERANGE) {
+      return false;
+    }
+    value = result;
+    return true;
+  }
+
+  // Parse a whole string the way std::stof and std::stod do, without throwing.
+  // Plain decimal numbers take the std::from_chars path when the standard
+  // library supports floating point, and so do "inf" and "nan". Anything else,
+  // including subnormal results that strtod reports as ERANGE, falls back to
+  // strtof and strtod.
+  template <typename FloatType>
+  static bool parseFloatingPoint(const char* data, size_t length, FloatType& value) {
+#if defined(__cpp_lib_to_chars)
+    auto [ptr, ec] = std::from_chars(data, data + length, value);
+    if (ec == std::errc() && ptr == data + length &&
+        (value == 0 || !(std::abs(value) < std::numeric_limits<FloatType>::min()))) {
+      return true;
+    }
+#endif
+    const std::string str(data, length);
+    char* end = nullptr;
+    errno = 0;
+    FloatType result;
+    if constexpr (std::is_same_v<FloatType, float>) {
+      result = std::strtof(str.c_str(), &end);
+    } else {
+      result = std::strtod(str.c_str(), &end);
+    }
+    if (end == str.c_str() || errno == ERANGE) {
+      return false;
+    }
+    value = result;
+    return true;
+  }
+
+  static inline bool isDigits(std::string_view str) {
+    for (char c : str) {
+      if (c < '0' || c > '9') {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Append decimal digits to value, 18 digits at a time. The caller makes
+  // sure the result has at most 38 digits, so it always fits.
+  static void appendDigits(Int128& value, std::string_view digits) {
+    constexpr size_t DIGITS_PER_CHUNK = 18;
+    while (!digits.empty()) {
+      size_t count = std::min(digits.size(), DIGITS_PER_CHUNK);
+      int64_t chunk = 0;
+      int64_t scale = 1;
+      for (size_t i = 0; i < count; ++i) {
+        chunk = chunk * 10 + (digits[i] - '0');
+        scale *= 10;
+      }
+      value *= scale;
+      value += chunk;
+      digits.remove_prefix(count);
+    }
+  }
+
+  // Behaves like the "%<width>d" conversion of sscanf: skips whitespace, then
+  // reads an optionally signed number of at most width characters.
+  static bool scanInteger(const char*& pos, const char* end, size_t width, int64_t& value) {
+    constexpr int64_t MAX_SCANNED = 1000000000000000000;
+    while (pos != end && std::isspace(static_cast<unsigned char>(*pos))) {
+      ++pos;
+    }
+    const char* limit = static_cast<size_t>(end - pos) > width ? pos + width : end;
+    const char* ptr = pos;
+    bool negative = false;
+    if (ptr != limit && (*ptr == '-' || *ptr == '+')) {
+      negative = *ptr == '-';
+      ++ptr;
+    }
+    const char* digits = ptr;
+    int64_t result = 0;
+    for (; ptr != limit && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+      // out of range values only need to stay out of range
+      if (result < MAX_SCANNED / 10) {
+        result = result * 10 + (*ptr - '0');
+      }
+    }
+    if (ptr == digits) {
+      return false;
+    }
+    value = negative ? -result : result;
+    pos = ptr;
+    return true;
+  }
+
   template <typename DestBatchPtrType>
   static inline DestBatchPtrType SafeCastBatchTo(ColumnVectorBatch* batch) {
     auto result = dynamic_cast<DestBatchPtrType>(batch);
@@ -150,6 +264,55 @@ namespace orc {
     }
   }
 
+  // The batch kernels below are plain loops without branches, so that the
+  // compiler can vectorize them. They also convert the values of null slots,
+  // which hold arbitrary but valid numbers and are never read back.
+
+  // the value type of a numeric vector batch
+  template <typename BatchType>
+  using BatchValueType = std::decay_t<decltype(std::declval<BatchType&>().data[0])>;
+
+  // true if every FileType value converts to ReadType without overflow checks
+  template <typename FileType, typename ReadType>
+  static constexpr bool isLosslessConversion() {
+    if constexpr (std::is_floating_point_v<ReadType>) {
+      // integers always convert to a finite value, floating points are cast
+      return true;
+    } else if constexpr (std::is_floating_point_v<FileType>) {
+      return false;
+    } else {
+      return sizeof(ReadType) >= sizeof(FileType);
+    }
+  }
+
+  template <typename FileType, typename ReadType>
+  static void castValues(const FileType* src, ReadType* dst, uint64_t numValues) {
+    for (uint64_t i = 0; i < numValues; ++i) {
+      dst[i] = static_cast<ReadType>(src[i]);
+    }
+  }
+
+  // true if all values that are not null are in the range of ReadType
+  template <typename ReadType, typename FileType>
+  static bool allValuesInRange(const FileType* src, const char* notNull, uint64_t numValues) {
+    FileType minValue = 0;
+    FileType maxValue = 0;
+    if (notNull) {
+      for (uint64_t i = 0; i < numValues; ++i) {
+        FileType value = notNull[i] ? src[i] : 0;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+      }
+    } else {
+      for (uint64_t i = 0; i < numValues; ++i) {
+        minValue = std::min(minValue, src[i]);
+        maxValue = std::max(maxValue, src[i]);
+      }
+    }
+    return minValue >= std::numeric_limits<ReadType>::min() &&
+           maxValue <= std::numeric_limits<ReadType>::max();
+  }
+
   // { boolean, byte, short, int, long, float, double } ->
   // { byte, short, int, long, float, double }
   template <typename FileTypeBatch, typename ReadTypeBatch, typename ReadType>
@@ -163,6 +326,18 @@ namespace orc {
       ConvertColumnReader::next(rowBatch, numValues, notNull);
       const auto& srcBatch = *SafeCastBatchTo<const FileTypeBatch*>(data.get());
       auto& dstBatch = *SafeCastBatchTo<ReadTypeBatch*>(&rowBatch);
+      using FileType = BatchValueType<FileTypeBatch>;
+      if constexpr (isLosslessConversion<FileType, ReadType>()) {
+        castValues(srcBatch.data.data(), dstBatch.data.data(), rowBatch.numElements);
+        return;
+      } else if constexpr (std::is_integral_v<FileType>) {
+        // narrowing only needs to check value by value if the batch overflows
+        const char* isValid = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
+        if (allValuesInRange<ReadType>(srcBatch.data.data(), isValid, rowBatch.numElements)) {
+          castValues(srcBatch.data.data(), dstBatch.data.data(), rowBatch.numElements);
+          return;
+        }
+      }
       if (rowBatch.hasNulls) {
         for (uint64_t i = 0; i < rowBatch.numElements; ++i) {
           if (rowBatch.notNull[i]) {
@@ -506,6 +681,13 @@ namespace orc {
 
       const auto& srcBatch = *SafeCastBatchTo<const FileTypeBatch*>(data.get());
       auto& dstBatch = *SafeCastBatchTo<ReadTypeBatch*>(&rowBatch);
+      if constexpr (std::is_same_v<FileTypeBatch, Decimal64VectorBatch>) {
+        const char* isValid = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
+        if (convertDecimal64Batch(srcBatch.values.data(), dstBatch.data.data(), isValid,
+                                  numValues)) {
+          return;
+        }
+      }
       for (uint64_t i = 0; i < numValues; ++i) {
         if (!rowBatch.hasNulls || rowBatch.notNull[i]) {
           if constexpr (std::is_floating_point_v<ReadType>) {
@@ -518,6 +700,36 @@ namespace orc {
     }
 
    private:
+    // Decimal64 values and the scaling factor fit in int64_t, so the Int128
+    // arithmetic of the value by value path reduces to one division. Returns
+    // false if some value overflows ReadType and has to go value by value.
+    bool convertDecimal64Batch(const int64_t* src, ReadType* dst, const char* notNull,
+                               uint64_t numValues) {
+      if constexpr (std::is_floating_point_v<ReadType>) {
+        const auto factor = static_cast<ReadType>(factor_);
+        for (uint64_t i = 0; i < numValues; ++i) {
+          dst[i] = static_cast<ReadType>(static_cast<double>(src[i])) / factor;
+        }
+        return true;
+      } else {
+        int64_t minValue = 0;
+        int64_t maxValue = 0;
+        for (uint64_t i = 0; i < numValues; ++i) {
+          int64_t value = !notNull || notNull[i] ? src[i] / factor_ : 0;
+          minValue = std::min(minValue, value);
+          maxValue = std::max(maxValue, value);
+        }
+        if (minValue < std::numeric_limits<ReadType>::min() ||
+            maxValue > std::numeric_limits<ReadType>::max()) {
+          return false;
+        }
+        for (uint64_t i = 0; i < numValues; ++i) {
+          dst[i] = static_cast<ReadType>(src[i] / factor_);
+        }
+        return true;
+      }
+    }
+
     void convertDecimalToInteger(ReadTypeBatch& dstBatch, uint64_t idx,
                                  const FileTypeBatch& srcBatch) {
       using FileType = decltype(srcBatch.values[idx]);
@@ -729,26 +941,33 @@ namespace orc {
 
       const auto& srcBatch = *SafeCastBatchTo<const StringVectorBatch*>(data.get());
       auto& dstBatch = *SafeCastBatchTo<ReadTypeBatch*>(&rowBatch);
+      const char* const* values = srcBatch.data.data();
+      const int64_t* lengths = srcBatch.length.data();
+      const char* isValid = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
       for (uint64_t i = 0; i < numValues; ++i) {
-        if (!rowBatch.hasNulls || rowBatch.notNull[i]) {
-          if constexpr (std::is_floating_point_v<ReadType>) {
-            convertToDouble(dstBatch, srcBatch, i);
-          } else {
-            convertToInteger(dstBatch, srcBatch, i);
+        if (isValid && !isValid[i]) {
+          continue;
+        }
+        const char* value = values[i];
+        const auto length = static_cast<size_t>(lengths[i]);
+        if constexpr (std::is_floating_point_v<ReadType>) {
+          if (!parseFloatingPoint(value, length, dstBatch.data[i])) {
+            handleParseFromStringError(dstBatch, i, throwOnOverflow, typeid(readType).name(),
+                                       std::string(value, length));
           }
+        } else {
+          convertToInteger(dstBatch, i, value, length);
         }
       }
     }
 
    private:
-    void convertToInteger(ReadTypeBatch& dstBatch, const StringVectorBatch& srcBatch,
-                          uint64_t idx) {
+    void convertToInteger(ReadTypeBatch& dstBatch, uint64_t idx, const char* value,
+                          size_t length) {
       int64_t longValue = 0;
-      const std::string longStr(srcBatch.data[idx], srcBatch.length[idx]);
-      try {
-        longValue = std::stoll(longStr);
-      } catch (...) {
-        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Long", longStr);
+      if (!parseInteger(value, length, longValue)) {
+        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Long",
+                                   std::string(value, length));
         return;
       }
       if constexpr (std::is_same_v<ReadType, bool>) {
@@ -759,20 +978,6 @@ namespace orc {
         }
       }
     }
-
-    void convertToDouble(ReadTypeBatch& dstBatch, const StringVectorBatch& srcBatch, uint64_t idx) {
-      const std::string floatValue(srcBatch.data[idx], srcBatch.length[idx]);
-      try {
-        if constexpr (std::is_same_v<ReadType, float>) {
-          dstBatch.data[idx] = std::stof(floatValue);
-        } else {
-          dstBatch.data[idx] = std::stod(floatValue);
-        }
-      } catch (...) {
-        handleParseFromStringError(dstBatch, idx, throwOnOverflow, typeid(readType).name(),
-                                   floatValue);
-      }
-    }
   };
 
   class StringVariantConvertColumnReader : public ConvertToStringVariantColumnReader {
@@ -838,9 +1043,12 @@ namespace orc {
       const auto& srcBatch = *SafeCastBatchTo<const StringVectorBatch*>(data.get());
       auto& dstBatch = *SafeCastBatchTo<TimestampVectorBatch*>(&rowBatch);
 
+      const char* const* values = srcBatch.data.data();
+      const int64_t* lengths = srcBatch.length.data();
+      const char* isValid = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
       for (uint64_t i = 0; i < numValues; ++i) {
-        if (!rowBatch.hasNulls || rowBatch.notNull[i]) {
-          convertToTimestamp(dstBatch, i, std::string(srcBatch.data[i], srcBatch.length[i]));
+        if (!isValid || isValid[i]) {
+          convertToTimestamp(dstBatch, i, {values[i], static_cast<size_t>(lengths[i])});
         }
       }
     }
@@ -857,14 +1065,45 @@ namespace orc {
       return 1ll * era * 146097 + doe - 719468;
     }
 
+    // Parses "%4d-%2d-%2d %2d:%2d:%2d.%d" with the semantics of sscanf, the
+    // fraction of a second being optional
     std::optional<std::pair<int64_t, int64_t>> tryBestToParseFromString(
-        const std::string& timeStr) {
-      int32_t year, month, day, hour, min, sec, nanos = 0;
-      int32_t matched = std::sscanf(timeStr.c_str(), "%4d-%2d-%2d %2d:%2d:%2d.%d", &year, &month,
-                                    &day, &hour, &min, &sec, &nanos);
-      if (matched != 6 && matched != 7) {
+        std::string_view timeStr) {
+      constexpr size_t FIELD_COUNT = 7;
+      constexpr size_t FIELD_WIDTHS[FIELD_COUNT] = {4, 2, 2, 2, 2, 2, SIZE_MAX};
+      // the separator in front of each field but the first one
+      constexpr char SEPARATORS[FIELD_COUNT] = "-- ::.";
+      int64_t fields[FIELD_COUNT] = {0, 0, 0, 0, 0, 0, 0};
+      const char* pos = timeStr.data();
+      const char* end = pos + timeStr.size();
+      size_t matched = 0;
+      for (; matched < FIELD_COUNT; ++matched) {
+        if (matched > 0) {
+          char separator = SEPARATORS[matched - 1];
+          if (separator == ' ') {
+            while (pos != end && std::isspace(static_cast<unsigned char>(*pos))) {
+              ++pos;
+            }
+          } else if (pos == end || *pos != separator) {
+            break;
+          } else {
+            ++pos;
+          }
+        }
+        if (!scanInteger(pos, end, FIELD_WIDTHS[matched], fields[matched])) {
+          break;
+        }
+      }
+      if (matched < FIELD_COUNT - 1) {
         return std::nullopt;
       }
+      auto year = static_cast<int32_t>(fields[0]);
+      auto month = static_cast<int32_t>(fields[1]);
+      auto day = static_cast<int32_t>(fields[2]);
+      int64_t hour = fields[3];
+      int64_t min = fields[4];
+      int64_t sec = fields[5];
+      int64_t nanos = fields[6];
       if (nanos) {
         if (nanos < 0 || nanos >= 1e9) {
           return std::nullopt;
@@ -879,7 +1118,7 @@ namespace orc {
     }
 
     void convertToTimestamp(TimestampVectorBatch& dstBatch, uint64_t idx,
-                            const std::string& timeStr) {
+                            std::string_view timeStr) {
       // Expected timestamp_instant format string : yyyy-mm-dd hh:mm:ss[.xxx] timezone
       // Eg. "2019-07-09 13:11:00 America/Los_Angeles"
       // Expected timestamp format string         : yyyy-mm-dd hh:mm:ss[.xxx]
@@ -889,12 +1128,12 @@ namespace orc {
       auto timestamp = tryBestToParseFromString(timeStr);
       if (!timestamp.has_value()) {
         if (!isInstant) {
-          handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp", timeStr,
-                                     expectedTimestampFormat);
+          handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp",
+                                     std::string(timeStr), expectedTimestampFormat);
           return;
         }
-        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp_Instant", timeStr,
-                                   expectedTimestampInstantFormat);
+        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp_Instant",
+                                   std::string(timeStr), expectedTimestampInstantFormat);
         return;
       }
 
@@ -904,18 +1143,24 @@ namespace orc {
         size_t pos = 0;  // get the name of timezone
         pos = timeStr.find(' ', pos) + 1;
         pos = timeStr.find(' ', pos);
-        if (pos == std::string::npos) {
-          handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp_Instant", timeStr,
-                                     expectedTimestampInstantFormat);
+        if (pos == std::string_view::npos) {
+          handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp_Instant",
+                                     std::string(timeStr), expectedTimestampInstantFormat);
           return;
         }
-        pos += 1;
-        size_t subStrLength = timeStr.length() - pos;
+        const std::string_view zoneName = timeStr.substr(pos + 1);
         try {
-          second = getTimezoneByName(timeStr.substr(pos, subStrLength)).convertFromUTC(second);
+          // values of a column mostly share their time zone, so look it up
+          // only when it changes
+          if (instantZone_ == nullptr || zoneName != instantZoneName_) {
+            instantZone_ = nullptr;
+            instantZoneName_.assign(zoneName.data(), zoneName.size());
+            instantZone_ = &getTimezoneByName(instantZoneName_);
+          }
+          second = instantZone_->convertFromUTC(second);
         } catch (const TimezoneError&) {
-          handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp_Instant", timeStr,
-                                     expectedTimestampInstantFormat);
+          handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp_Instant",
+                                     std::string(timeStr), expectedTimestampInstantFormat);
           return;
         }
       } else {
@@ -926,6 +1171,9 @@ namespace orc {
       dstBatch.data[idx] = second;
       dstBatch.nanoseconds[idx] = nanos;
     }
+
+    std::string instantZoneName_;
+    const Timezone* instantZone_ = nullptr;
   };
 
   template <typename ReadTypeBatch>
@@ -942,66 +1190,65 @@ namespace orc {
 
       const auto& srcBatch = *SafeCastBatchTo<const StringVectorBatch*>(data.get());
       auto& dstBatch = *SafeCastBatchTo<ReadTypeBatch*>(&rowBatch);
+      const char* const* values = srcBatch.data.data();
+      const int64_t* lengths = srcBatch.length.data();
+      const char* isValid = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
       for (uint64_t i = 0; i < numValues; ++i) {
-        if (!rowBatch.hasNulls || rowBatch.notNull[i]) {
-          convertToDecimal(dstBatch, i, std::string(srcBatch.data[i], srcBatch.length[i]));
+        if (!isValid || isValid[i]) {
+          convertToDecimal(dstBatch, i, {values[i], static_cast<size_t>(lengths[i])});
         }
       }
     }
 
    private:
-    void convertToDecimal(ReadTypeBatch& dstBatch, uint64_t idx, const std::string& decimalStr) {
+    void convertToDecimal(ReadTypeBatch& dstBatch, uint64_t idx, std::string_view decimalStr) {
       constexpr int32_t MAX_PRECISION_128 = 38;
       int32_t fromPrecision = 0;
       int32_t fromScale = 0;
-      uint32_t start = 0;
+      size_t start = 0;
       bool negative = false;
       if (decimalStr.empty()) {
-        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Decimal", decimalStr);
+        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Decimal",
+                                   std::string(decimalStr));
         return;
       }
       auto dotPos = decimalStr.find('.');
-      if (dotPos == std::string::npos) {
+      if (dotPos == std::string_view::npos) {
         fromScale = 0;
-        fromPrecision = decimalStr.length();
+        fromPrecision = static_cast<int32_t>(decimalStr.length());
         dotPos = decimalStr.length();
       } else {
         if (dotPos + 1 == decimalStr.length()) {
-          handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Decimal", decimalStr);
+          handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Decimal",
+                                     std::string(decimalStr));
           return;
         }
-        fromPrecision = decimalStr.length() - 1;
-        fromScale = decimalStr.length() - dotPos - 1;
+        fromPrecision = static_cast<int32_t>(decimalStr.length() - 1);
+        fromScale = static_cast<int32_t>(decimalStr.length() - dotPos - 1);
       }
       if (decimalStr.front() == '-') {
         negative = true;
         start++;
         fromPrecision--;
       }
-      const std::string integerPortion = decimalStr.substr(start, dotPos - start);
+      const std::string_view integerPortion = decimalStr.substr(start, dotPos - start);
       if (dotPos == start || fromPrecision > MAX_PRECISION_128 || fromPrecision <= 0 ||
-          !std::all_of(integerPortion.begin(), integerPortion.end(), ::isdigit)) {
-        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Decimal", decimalStr);
+          !isDigits(integerPortion)) {
+        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Decimal",
+                                   std::string(decimalStr));
         return;
       }
 
+      // at most 38 digits, so the unscaled value cannot overflow
       Int128 i128;
-      try {
-        bool overflow = false;
-        i128 = Int128(integerPortion);
-        // overflow won't happen
-        i128 *= scaleUpInt128ByPowerOfTen(Int128(1), fromScale, overflow);
-      } catch (const std::exception& e) {
-        handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Decimal", decimalStr);
-        return;
-      }
+      appendDigits(i128, integerPortion);
       if (dotPos + 1 < decimalStr.length()) {
-        const std::string fractionPortion = decimalStr.substr(dotPos + 1, fromScale);
-        if (!std::all_of(fractionPortion.begin(), fractionPortion.end(), ::isdigit)) {
+        const std::string_view fractionPortion = decimalStr.substr(dotPos + 1);
+        if (!isDigits(fractionPortion)) {
           handleOverflow<std::string, Int128>(dstBatch, idx, throwOnOverflow);
           return;
         }
-        i128 += Int128(fractionPortion);
+        appendDigits(i128, fractionPortion);
       }
 
       auto [overflow, result] = convertDecimal(i128, fromScale, precision_, scale_);
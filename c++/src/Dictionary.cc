@@ -18,33 +18,218 @@
 
 #include "Dictionary.hh"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ORC_DICTIONARY_SSE2
+#endif
+
 namespace orc {
 
+  namespace {
+    // number of control bytes compared by a single probe
+    constexpr size_t GROUP_SIZE = 16;
+    // control byte of a slot that has never been used
+    constexpr int8_t EMPTY = static_cast<int8_t>(0x80);
+    // initial number of slots in the hash table
+    constexpr size_t INITIAL_CAPACITY = 64;
+    // size of the first arena chunk, each further one doubles up to the maximum
+    constexpr size_t MIN_ARENA_CHUNK_SIZE = 1024;
+    constexpr size_t MAX_ARENA_CHUNK_SIZE = 256 * 1024;
+
+    inline int8_t controlByte(size_t hash) {
+      return static_cast<int8_t>(hash & 0x7f);
+    }
+
+    inline size_t groupOf(size_t hash) {
+      return hash >> 7;
+    }
+
+    /**
+     * Match the control bytes of a group against a hash byte and the
+     * EMPTY marker. Bit i of each mask is set when slot i matches.
+     */
+    inline void matchGroup(const int8_t* group, int8_t hashByte, uint32_t& hits,
+                           uint32_t& empties) {
+#ifdef ORC_DICTIONARY_SSE2
+      __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+      hits = static_cast<uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(hashByte))));
+      empties =
+          static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(EMPTY))));
+#else
+      hits = empties = 0;
+      for (uint32_t i = 0; i < GROUP_SIZE; ++i) {
+        hits |= static_cast<uint32_t>(group[i] == hashByte) << i;
+        empties |= static_cast<uint32_t>(group[i] == EMPTY) << i;
+      }
+#endif
+    }
+
+    inline uint32_t lowestBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<uint32_t>(__builtin_ctz(mask));
+#else
+      uint32_t bit = 0;
+      while ((mask & 1) == 0) {
+        mask >>= 1;
+        ++bit;
+      }
+      return bit;
+#endif
+    }
+  }  // namespace
+
+  SortedStringDictionary::SortedStringDictionary(MemoryPool& pool)
+      : memoryPool_(pool),
+        arenaUsed_(0),
+        arenaPos_(nullptr),
+        arenaRemaining_(0),
+        groupMask_(0),
+        sorted_(true),
+        totalLength_(0) {
+    rehash(INITIAL_CAPACITY);
+  }
+
+  SortedStringDictionary::~SortedStringDictionary() {
+    freeArena();
+  }
+
+  const char* SortedStringDictionary::copyToArena(const char* str, size_t len) {
+    if (len > arenaRemaining_) {
+      nextArenaChunk(len);
+    }
+    char* dest = arenaPos_;
+    if (len > 0) {
+      memcpy(dest, str, len);
+    }
+    arenaPos_ += len;
+    arenaRemaining_ -= len;
+    return dest;
+  }
+
+  void SortedStringDictionary::nextArenaChunk(size_t len) {
+    // a kept chunk too small for the key stays for the following ones
+    if (arenaUsed_ == arenaChunks_.size() || arenaChunks_[arenaUsed_].second < len) {
+      size_t chunkSize = MIN_ARENA_CHUNK_SIZE;
+      if (!arenaChunks_.empty()) {
+        chunkSize = std::min(arenaChunks_.back().second * 2, MAX_ARENA_CHUNK_SIZE);
+      }
+      chunkSize = std::max(chunkSize, len);
+      arenaChunks_.insert(arenaChunks_.begin() + static_cast<std::ptrdiff_t>(arenaUsed_),
+                          {memoryPool_.malloc(chunkSize), chunkSize});
+    }
+    arenaPos_ = arenaChunks_[arenaUsed_].first;
+    arenaRemaining_ = arenaChunks_[arenaUsed_].second;
+    ++arenaUsed_;
+  }
+
+  void SortedStringDictionary::freeArena() {
+    for (auto& chunk : arenaChunks_) {
+      memoryPool_.free(chunk.first);
+    }
+    arenaChunks_.clear();
+    arenaUsed_ = 0;
+    arenaPos_ = nullptr;
+    arenaRemaining_ = 0;
+  }
+
+  void SortedStringDictionary::rehash(size_t newCapacity) {
+    control_.assign(newCapacity, EMPTY);
+    slots_.resize(newCapacity);
+    groupMask_ = newCapacity / GROUP_SIZE - 1;
+
+    for (size_t index = 0; index < entries_.size(); ++index) {
+      size_t hash = entryHashes_[index];
+      size_t group = groupOf(hash) & groupMask_;
+      for (size_t step = 1;; ++step) {
+        uint32_t hits, empties;
+        matchGroup(control_.data() + group * GROUP_SIZE, controlByte(hash), hits, empties);
+        if (empties != 0) {
+          size_t slot = group * GROUP_SIZE + lowestBit(empties);
+          control_[slot] = controlByte(hash);
+          slots_[slot] = static_cast<uint32_t>(index);
+          break;
+        }
+        // triangular probing visits every group of a power-of-two table
+        group = (group + step) & groupMask_;
+      }
+    }
+  }
+
   // insert a new string into dictionary, return its insertion order
   size_t SortedStringDictionary::insert(const char* str, size_t len) {
-    size_t index = flatDict_.size();
+    const size_t hash = std::hash<std::string_view>{}(std::string_view{str, len});
+    const int8_t hashByte = controlByte(hash);
+    size_t group = groupOf(hash) & groupMask_;
+
+    for (size_t step = 1;; ++step) {
+      const size_t groupStart = group * GROUP_SIZE;
+      uint32_t hits, empties;
+      matchGroup(control_.data() + groupStart, hashByte, hits, empties);
+      while (hits != 0) {
+        size_t index = slots_[groupStart + lowestBit(hits)];
+        const DictEntry& entry = entries_[index];
+        if (entryHashes_[index] == hash && entry.length == len &&
+            (len == 0 || memcmp(entry.data, str, len) == 0)) {
+          return index;
+        }
+        hits &= hits - 1;
+      }
+      if (empties != 0) {
+        break;
+      }
+      group = (group + step) & groupMask_;
+    }
 
-    auto it = keyToIndex_.find(std::string_view{str, len});
-    if (it != keyToIndex_.end()) {
-      return it->second;
+    size_t index = entries_.size();
+    entries_.emplace_back(copyToArena(str, len), len);
+    entryHashes_.push_back(hash);
+    totalLength_ += len;
+    sorted_ = false;
+
+    // keep the load factor under 7/8 so that every probe ends at an empty slot
+    if ((entries_.size() + 1) * 8 > control_.size() * 7) {
+      rehash(control_.size() * 2);
     } else {
-      flatDict_.emplace_back(str, len, index);
-      totalLength_ += len;
+      // the probe above stopped at the first group with a free slot
+      const size_t groupStart = group * GROUP_SIZE;
+      uint32_t hits, empties;
+      matchGroup(control_.data() + groupStart, hashByte, hits, empties);
+      size_t slot = groupStart + lowestBit(empties);
+      control_[slot] = hashByte;
+      slots_[slot] = static_cast<uint32_t>(index);
+    }
+    return index;
+  }
 
-      const auto& lastEntry = flatDict_.back().entry;
-      keyToIndex_.emplace(std::string_view{lastEntry.data->data(), lastEntry.data->size()}, index);
-      return index;
+  void SortedStringDictionary::sortEntries() const {
+    if (sorted_ && sortedIndexes_.size() == entries_.size()) {
+      return;
+    }
+    sortedIndexes_.resize(entries_.size());
+    for (size_t i = 0; i < sortedIndexes_.size(); ++i) {
+      sortedIndexes_[i] = static_cast<uint32_t>(i);
     }
+    std::sort(sortedIndexes_.begin(), sortedIndexes_.end(), [this](uint32_t l, uint32_t r) {
+      return std::string_view(entries_[l].data, entries_[l].length) <
+             std::string_view(entries_[r].data, entries_[r].length);
+    });
+    sorted_ = true;
   }
 
   // write dictionary data & length to output buffer
   void SortedStringDictionary::flush(AppendOnlyBufferedStream* dataStream,
                                      RleEncoder* lengthEncoder) const {
-    std::sort(flatDict_.begin(), flatDict_.end(), LessThan());
+    sortEntries();
 
-    for (const auto& entryWithIndex : flatDict_) {
-      dataStream->write(entryWithIndex.entry.data->data(), entryWithIndex.entry.data->size());
-      lengthEncoder->write(static_cast<int64_t>(entryWithIndex.entry.data->size()));
+    for (uint32_t index : sortedIndexes_) {
+      const DictEntry& entry = entries_[index];
+      dataStream->write(entry.data, entry.length);
+      lengthEncoder->write(static_cast<int64_t>(entry.length));
     }
   }
 
@@ -59,10 +244,12 @@ namespace orc {
    * output.
    */
   void SortedStringDictionary::reorder(std::vector<int64_t>& idxBuffer) const {
+    sortEntries();
+
     // iterate the dictionary to get mapping from insertion order to value order
-    std::vector<size_t> mapping(flatDict_.size());
-    for (size_t i = 0; i < flatDict_.size(); ++i) {
-      mapping[flatDict_[i].index] = i;
+    std::vector<size_t> mapping(sortedIndexes_.size());
+    for (size_t i = 0; i < sortedIndexes_.size(); ++i) {
+      mapping[sortedIndexes_[i]] = i;
     }
 
     // do the transformation
@@ -71,19 +258,14 @@ namespace orc {
     }
   }
 
-  // get dict entries in insertion order
-  void SortedStringDictionary::getEntriesInInsertionOrder(
-      std::vector<const DictEntry*>& entries) const {
-    /// flatDict_ is sorted in insertion order before [[SortedStringDictionary::flush]] is invoked.
-    entries.resize(flatDict_.size());
-    for (size_t i = 0; i < flatDict_.size(); ++i) {
-      entries[i] = &(flatDict_[i].entry);
-    }
+  // get the dict entry of the given insertion order
+  const SortedStringDictionary::DictEntry& SortedStringDictionary::getEntry(size_t index) const {
+    return entries_[index];
   }
 
   // return count of entries
   size_t SortedStringDictionary::size() const {
-    return flatDict_.size();
+    return entries_.size();
   }
 
   // return total length of strings in the dictioanry
@@ -93,7 +275,14 @@ namespace orc {
 
   void SortedStringDictionary::clear() {
     totalLength_ = 0;
-    keyToIndex_.clear();
-    flatDict_.clear();
+    entries_.clear();
+    entryHashes_.clear();
+    sortedIndexes_.clear();
+    sorted_ = true;
+    // keep the chunks for the next stripe and only rewind the write cursor
+    arenaUsed_ = 0;
+    arenaPos_ = nullptr;
+    arenaRemaining_ = 0;
+    std::fill(control_.begin(), control_.end(), EMPTY);
   }
-}  // namespace orc
\ No newline at end of file
+}  // namespace orc
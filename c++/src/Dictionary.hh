@@ -16,44 +16,41 @@
  * limitations under the License.
  */
 
-#include <cstddef>
-#include <memory>
-#include <string>
+#ifndef ORC_DICTIONARY_HH
+#define ORC_DICTIONARY_HH
 
-#ifdef BUILD_SPARSEHASH
-#include <sparsehash/dense_hash_map>
-#else
-#include <unordered_map>
-#endif
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "RLE.hh"
+#include "orc/MemoryPool.hh"
 
 namespace orc {
   /**
    * Implementation of increasing sorted string dictionary
+   *
+   * Distinct keys are copied into an arena of memory-pool chunks that start
+   * small and grow geometrically, and that are reused across clear(), and
+   * looked up through an open-addressing hash table. The table keeps one
+   * control byte per slot holding 7 bits of the key's hash, so a probe
+   * compares a whole group of slots at once (with SSE2 where available) and
+   * only touches key bytes for candidates whose hash bits match.
    */
   class SortedStringDictionary {
    public:
     struct DictEntry {
-      DictEntry(const char* str, size_t len) : data(std::make_unique<std::string>(str, len)) {}
+      DictEntry(const char* str, size_t len) : data(str), length(len) {}
 
-      std::unique_ptr<std::string> data;
+      const char* data;
+      size_t length;
     };
 
-    struct DictEntryWithIndex {
-      DictEntryWithIndex(const char* str, size_t len, size_t index)
-          : entry(str, len), index(index) {}
-
-      DictEntry entry;
-      size_t index;
-    };
+    explicit SortedStringDictionary(MemoryPool& pool);
 
-    SortedStringDictionary() : totalLength_(0) {
-#ifdef BUILD_SPARSEHASH
-      /// Need to set empty key otherwise dense_hash_map will not work correctly
-      keyToIndex_.set_empty_key(std::string_view{});
-#endif
-    }
+    ~SortedStringDictionary();
 
     // insert a new string into dictionary, return its insertion order
     size_t insert(const char* str, size_t len);
@@ -64,8 +61,8 @@ namespace orc {
     // reorder input index buffer from insertion order to dictionary order
     void reorder(std::vector<int64_t>& idxBuffer) const;
 
-    // get dict entries in insertion order
-    void getEntriesInInsertionOrder(std::vector<const DictEntry*>&) const;
+    // get the dict entry of the given insertion order
+    const DictEntry& getEntry(size_t index) const;
 
     // return count of entries
     size_t size() const;
@@ -76,20 +73,40 @@ namespace orc {
     void clear();
 
    private:
-    struct LessThan {
-      bool operator()(const DictEntryWithIndex& l, const DictEntryWithIndex& r) {
-        return *l.entry.data < *r.entry.data;  // use std::string's operator<
-      }
-    };
+    SortedStringDictionary(const SortedStringDictionary&) = delete;
+    SortedStringDictionary& operator=(const SortedStringDictionary&) = delete;
+
+    // copy a key into the arena and return its stable address
+    const char* copyToArena(const char* str, size_t len);
+    // move the write cursor to a chunk of at least len bytes
+    void nextArenaChunk(size_t len);
+    void freeArena();
+    // grow the hash table and re-insert all entries
+    void rehash(size_t newCapacity);
+    // sort entry indexes by key if not done since the last insertion
+    void sortEntries() const;
+
+    MemoryPool& memoryPool_;
+
+    // arena chunks holding the bytes of the keys, with their sizes
+    std::vector<std::pair<char*, size_t>> arenaChunks_;
+    // number of chunks written since the last clear
+    size_t arenaUsed_;
+    char* arenaPos_;
+    size_t arenaRemaining_;
+
     // store dictionary entries in insertion order
-    mutable std::vector<DictEntryWithIndex> flatDict_;
+    std::vector<DictEntry> entries_;
+    std::vector<size_t> entryHashes_;
 
-#ifdef BUILD_SPARSEHASH
-    // map from string to its insertion order index
-    google::dense_hash_map<std::string_view, size_t> keyToIndex_;
-#else
-    std::unordered_map<std::string_view, size_t> keyToIndex_;
-#endif
+    // control bytes (EMPTY or low 7 bits of the hash) and slots of the table
+    std::vector<int8_t> control_;
+    std::vector<uint32_t> slots_;
+    size_t groupMask_;
+
+    // insertion order indexes sorted by key
+    mutable std::vector<uint32_t> sortedIndexes_;
+    mutable bool sorted_;
 
     uint64_t totalLength_;
 
@@ -102,3 +119,5 @@ namespace orc {
   };
 
 }  // namespace orc
+
+#endif  // ORC_DICTIONARY_HH
@@ -45,6 +45,8 @@ namespace orc {
     MemoryPool* memoryPool;
     std::string serializedTail;
     ReaderMetrics* metrics;
+    TraceRecorder* traceRecorder;
+    ColumnMetricsTable* columnMetricsTable;
     CacheOptions cacheOptions;
 
     ReaderOptionsPrivate() {
@@ -52,6 +54,8 @@ namespace orc {
       errorStream = &std::cerr;
       memoryPool = getDefaultPool();
       metrics = nullptr;
+      traceRecorder = nullptr;
+      columnMetricsTable = nullptr;
     }
   };
 
@@ -98,6 +102,24 @@ namespace orc {
     return privateBits_->metrics;
   }
 
+  ReaderOptions& ReaderOptions::setTraceRecorder(TraceRecorder* recorder) {
+    privateBits_->traceRecorder = recorder;
+    return *this;
+  }
+
+  TraceRecorder* ReaderOptions::getTraceRecorder() const {
+    return privateBits_->traceRecorder;
+  }
+
+  ReaderOptions& ReaderOptions::setColumnMetricsTable(ColumnMetricsTable* table) {
+    privateBits_->columnMetricsTable = table;
+    return *this;
+  }
+
+  ColumnMetricsTable* ReaderOptions::getColumnMetricsTable() const {
+    return privateBits_->columnMetricsTable;
+  }
+
   ReaderOptions& ReaderOptions::setTailLocation(uint64_t offset) {
     privateBits_->tailLocation = offset;
     return *this;
@@ -153,6 +175,7 @@ namespace orc {
     bool useTightNumericVector;
     std::shared_ptr<Type> readType;
     bool throwOnSchemaEvolutionOverflow;
+    std::shared_ptr<const std::vector<uint64_t>> deletedRows;
 
     RowReaderOptionsPrivate() {
       selection = ColumnSelection_NONE;
@@ -281,6 +304,15 @@ namespace orc {
     return privateBits_->throwOnSchemaEvolutionOverflow;
   }
 
+  RowReaderOptions& RowReaderOptions::setDeletedRows(std::vector<uint64_t> rows) {
+    privateBits_->deletedRows = std::make_shared<const std::vector<uint64_t>>(std::move(rows));
+    return *this;
+  }
+
+  std::shared_ptr<const std::vector<uint64_t>> RowReaderOptions::getDeletedRows() const {
+    return privateBits_->deletedRows;
+  }
+
   RowReaderOptions& RowReaderOptions::forcedScaleOnHive11Decimal(int32_t forcedScale) {
     privateBits_->forcedScaleOnHive11Decimal = forcedScale;
     return *this;
@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <thread>
 
 #ifdef _MSC_VER
 #include <io.h>
@@ -120,6 +121,46 @@ namespace orc {
     return std::make_unique<FileInputStream>(path, metrics);
   }
 
+  // readAsync keeps the default of a thread per read, so that concurrent
+  // requests wait for the latency at the same time
+  class RemoteStorageInputStream : public InputStream {
+   private:
+    std::unique_ptr<InputStream> stream_;
+    RemoteStorageOptions options_;
+
+   public:
+    RemoteStorageInputStream(std::unique_ptr<InputStream> stream,
+                             const RemoteStorageOptions& options)
+        : stream_(std::move(stream)), options_(options) {}
+
+    uint64_t getLength() const override {
+      return stream_->getLength();
+    }
+
+    uint64_t getNaturalReadSize() const override {
+      return stream_->getNaturalReadSize();
+    }
+
+    void read(void* buf, uint64_t length, uint64_t offset) override {
+      std::chrono::duration<double, std::micro> delay = options_.latency;
+      if (options_.bytesPerSecond != 0) {
+        delay += std::chrono::duration<double>(static_cast<double>(length) /
+                                               static_cast<double>(options_.bytesPerSecond));
+      }
+      std::this_thread::sleep_for(delay);
+      stream_->read(buf, length, offset);
+    }
+
+    const std::string& getName() const override {
+      return stream_->getName();
+    }
+  };
+
+  std::unique_ptr<InputStream> simulateRemoteStorage(std::unique_ptr<InputStream> stream,
+                                                     const RemoteStorageOptions& options) {
+    return std::make_unique<RemoteStorageInputStream>(std::move(stream), options);
+  }
+
   OutputStream::~OutputStream(){
       // PASS
   };
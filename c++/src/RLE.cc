@@ -45,15 +45,21 @@ namespace orc {
 
   std::unique_ptr<RleDecoder> createRleDecoder(std::unique_ptr<SeekableInputStream> input,
                                                bool isSigned, RleVersion version, MemoryPool& pool,
-                                               ReaderMetrics* metrics) {
+                                               ReaderMetrics* metrics,
+                                               StreamReaderMetrics* streamMetrics) {
+    std::unique_ptr<RleDecoder> result;
     switch (static_cast<int64_t>(version)) {
       case RleVersion_1:
-        return std::make_unique<RleDecoderV1>(std::move(input), isSigned, metrics);
+        result = std::make_unique<RleDecoderV1>(std::move(input), isSigned, metrics);
+        break;
       case RleVersion_2:
-        return std::make_unique<RleDecoderV2>(std::move(input), isSigned, pool, metrics);
+        result = std::make_unique<RleDecoderV2>(std::move(input), isSigned, pool, metrics);
+        break;
       default:
         throw NotImplementedYet("Not implemented yet");
     }
+    result->setStreamMetrics(streamMetrics);
+    return result;
   }
 
   template <typename T>
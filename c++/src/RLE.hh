@@ -138,8 +138,13 @@ namespace orc {
 
     virtual void next(int16_t* data, uint64_t numValues, const char* notNull) = 0;
 
+    void setStreamMetrics(StreamReaderMetrics* metrics) {
+      streamMetrics = metrics;
+    }
+
    protected:
     ReaderMetrics* metrics;
+    StreamReaderMetrics* streamMetrics = nullptr;
   };
 
   /**
@@ -159,10 +164,13 @@ namespace orc {
    * @param isSigned true if the number sequence is signed
    * @param version version of RLE decoding to do
    * @param pool memory pool to use for allocation
+   * @param metrics the metrics of the decoder
+   * @param streamMetrics the metrics of the column stream that is decoded
    */
   std::unique_ptr<RleDecoder> createRleDecoder(std::unique_ptr<SeekableInputStream> input,
                                                bool isSigned, RleVersion version, MemoryPool& pool,
-                                               ReaderMetrics* metrics);
+                                               ReaderMetrics* metrics,
+                                               StreamReaderMetrics* streamMetrics = nullptr);
 
 }  // namespace orc
 
@@ -27,9 +27,11 @@
 #include "wrap/coded-stream-wrapper.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <sstream>
 #include <string>
@@ -47,6 +49,16 @@ namespace orc {
     return &internal;
   }
 
+  ColumnReaderMetrics& ColumnMetricsTable::getColumn(uint64_t columnId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return columns_[columnId];
+  }
+
+  StreamReaderMetrics& ColumnMetricsTable::getStream(uint64_t columnId, StreamKind kind) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return columns_[columnId].streams[kind];
+  }
+
   const RowReaderOptions::IdReadIntentMap EMPTY_IDREADINTENTMAP() {
     return {};
   }
@@ -263,6 +275,7 @@ namespace orc {
     currentRowInStripe_ = 0;
     rowsInCurrentStripe_ = 0;
     numRowGroupsInStripeRange_ = 0;
+    allRowsMatch_ = false;
     useTightNumericVector_ = opts.getUseTightNumericVector();
     throwOnSchemaEvolutionOverflow_ = opts.getThrowOnSchemaEvolutionOverflow();
     uint64_t rowTotal = 0;
@@ -310,6 +323,14 @@ namespace orc {
                            getWriterVersionImpl(contents.get()), contents_->readerMetrics));
     }
 
+    deletedRows_ = opts.getDeletedRows();
+    if (deletedRows_ && deletedRows_->empty()) {
+      deletedRows_.reset();
+    }
+    if (deletedRows_ && !std::is_sorted(deletedRows_->begin(), deletedRows_->end())) {
+      throw InvalidArgument("Deleted rows must be in ascending order");
+    }
+
     skipBloomFilters_ = hasBadBloomFilters();
   }
 
@@ -409,11 +430,10 @@ namespace orc {
       }
     } else {
       currentRowInStripe_ = rowNumber - firstRowOfStripe_[currentStripe_];
-      if (sargsApplier_) {
-        // advance to selected row group if predicate pushdown is enabled
-        currentRowInStripe_ =
-            advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
-                                  footer_->row_index_stride(), sargsApplier_->getNextSkippedRows());
+      if (!nextSkippedRows_.empty()) {
+        // advance to selected row group if row groups are skipped
+        currentRowInStripe_ = advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
+                                                    footer_->row_index_stride(), nextSkippedRows_);
       }
     }
 
@@ -435,7 +455,243 @@ namespace orc {
     }
   }
 
+  // Grow a batch geometrically so that appending runs of rows stays linear.
+  static void reserveRows(ColumnVectorBatch& batch, uint64_t rows) {
+    if (batch.capacity < rows) {
+      batch.resize(std::max(rows, 2 * batch.capacity));
+    }
+  }
+
+  template <typename T>
+  static void appendValues(const DataBuffer<T>& from, DataBuffer<T>& to, uint64_t offset,
+                           uint64_t numValues) {
+    std::copy(from.data(), from.data() + numValues, to.data() + offset);
+  }
+
+  template <typename BatchType>
+  static bool appendNumbers(const ColumnVectorBatch& from, ColumnVectorBatch& to,
+                            uint64_t offset) {
+    auto fromBatch = dynamic_cast<const BatchType*>(&from);
+    if (fromBatch == nullptr) {
+      return false;
+    }
+    appendValues(fromBatch->data, dynamic_cast<BatchType&>(to).data, offset, from.numElements);
+    return true;
+  }
+
+  /**
+   * Copy the strings into the blob of the target, which holds the strings
+   * of all rows before offset back to back. Null rows get no bytes.
+   */
+  static void appendStrings(const StringVectorBatch& from, StringVectorBatch& to,
+                            uint64_t offset) {
+    uint64_t used = 0;
+    if (offset > 0) {
+      used = static_cast<uint64_t>(to.data[offset - 1] - to.blob.data() + to.length[offset - 1]);
+    } else {
+      to.blob.resize(0);
+    }
+    uint64_t bytes = 0;
+    for (uint64_t i = 0; i < from.numElements; ++i) {
+      if (!from.hasNulls || from.notNull[i]) {
+        bytes += static_cast<uint64_t>(from.length[i]);
+      }
+    }
+    char* oldBlob = to.blob.data();
+    if (used + bytes > to.blob.capacity()) {
+      to.blob.reserve(std::max(used + bytes, 2 * to.blob.capacity()));
+    }
+    to.blob.resize(used + bytes);
+    if (to.blob.data() != oldBlob) {
+      // the blob moved, so point the earlier rows into the new one
+      uint64_t position = 0;
+      for (uint64_t i = 0; i < offset; ++i) {
+        to.data[i] = to.blob.data() + position;
+        position += static_cast<uint64_t>(to.length[i]);
+      }
+    }
+    for (uint64_t i = 0; i < from.numElements; ++i) {
+      to.data[offset + i] = to.blob.data() + used;
+      if ((!from.hasNulls || from.notNull[i]) && from.length[i] > 0) {
+        to.length[offset + i] = from.length[i];
+        memcpy(to.data[offset + i], from.data[i], static_cast<size_t>(from.length[i]));
+        used += static_cast<uint64_t>(from.length[i]);
+      } else {
+        to.length[offset + i] = 0;
+      }
+    }
+  }
+
+  /**
+   * Append all rows of a batch to another batch of the same type, starting
+   * at the given row of the target. Nested batches are appended after the
+   * rows the target already holds below that row.
+   */
+  static void appendBatch(const ColumnVectorBatch& from, ColumnVectorBatch& to, uint64_t offset) {
+    uint64_t numValues = from.numElements;
+    reserveRows(to, offset + numValues);
+    to.numElements = offset + numValues;
+    to.isEncoded = false;
+    if (from.hasNulls) {
+      memcpy(to.notNull.data() + offset, from.notNull.data(), numValues);
+    } else {
+      memset(to.notNull.data() + offset, 1, numValues);
+    }
+    to.hasNulls = from.hasNulls || (offset > 0 && to.hasNulls);
+
+    if (auto structBatch = dynamic_cast<const StructVectorBatch*>(&from)) {
+      auto& target = dynamic_cast<StructVectorBatch&>(to);
+      for (size_t i = 0; i < structBatch->fields.size(); ++i) {
+        appendBatch(*structBatch->fields[i], *target.fields[i], offset);
+      }
+    } else if (auto listBatch = dynamic_cast<const ListVectorBatch*>(&from)) {
+      auto& target = dynamic_cast<ListVectorBatch&>(to);
+      int64_t start = offset == 0 ? 0 : target.offsets[offset];
+      for (uint64_t i = 0; i <= numValues; ++i) {
+        target.offsets[offset + i] = start + listBatch->offsets[i] - listBatch->offsets[0];
+      }
+      appendBatch(*listBatch->elements, *target.elements, static_cast<uint64_t>(start));
+    } else if (auto mapBatch = dynamic_cast<const MapVectorBatch*>(&from)) {
+      auto& target = dynamic_cast<MapVectorBatch&>(to);
+      int64_t start = offset == 0 ? 0 : target.offsets[offset];
+      for (uint64_t i = 0; i <= numValues; ++i) {
+        target.offsets[offset + i] = start + mapBatch->offsets[i] - mapBatch->offsets[0];
+      }
+      if (mapBatch->keys) {
+        appendBatch(*mapBatch->keys, *target.keys, static_cast<uint64_t>(start));
+      }
+      if (mapBatch->elements) {
+        appendBatch(*mapBatch->elements, *target.elements, static_cast<uint64_t>(start));
+      }
+    } else if (auto unionBatch = dynamic_cast<const UnionVectorBatch*>(&from)) {
+      auto& target = dynamic_cast<UnionVectorBatch&>(to);
+      std::vector<uint64_t> starts(target.children.size(), 0);
+      for (size_t i = 0; i < starts.size() && offset > 0; ++i) {
+        starts[i] = target.children[i]->numElements;
+      }
+      for (uint64_t i = 0; i < numValues; ++i) {
+        unsigned char tag = unionBatch->tags[i];
+        target.tags[offset + i] = tag;
+        target.offsets[offset + i] = starts[tag] + unionBatch->offsets[i];
+      }
+      for (size_t i = 0; i < starts.size(); ++i) {
+        appendBatch(*unionBatch->children[i], *target.children[i], starts[i]);
+      }
+    } else if (auto stringBatch = dynamic_cast<const StringVectorBatch*>(&from)) {
+      appendStrings(*stringBatch, dynamic_cast<StringVectorBatch&>(to), offset);
+    } else if (auto timestampBatch = dynamic_cast<const TimestampVectorBatch*>(&from)) {
+      auto& target = dynamic_cast<TimestampVectorBatch&>(to);
+      appendValues(timestampBatch->data, target.data, offset, numValues);
+      appendValues(timestampBatch->nanoseconds, target.nanoseconds, offset, numValues);
+    } else if (auto decimal64Batch = dynamic_cast<const Decimal64VectorBatch*>(&from)) {
+      auto& target = dynamic_cast<Decimal64VectorBatch&>(to);
+      target.precision = decimal64Batch->precision;
+      target.scale = decimal64Batch->scale;
+      appendValues(decimal64Batch->values, target.values, offset, numValues);
+    } else if (auto decimal128Batch = dynamic_cast<const Decimal128VectorBatch*>(&from)) {
+      auto& target = dynamic_cast<Decimal128VectorBatch&>(to);
+      target.precision = decimal128Batch->precision;
+      target.scale = decimal128Batch->scale;
+      appendValues(decimal128Batch->values, target.values, offset, numValues);
+    } else if (!appendNumbers<LongVectorBatch>(from, to, offset) &&
+               !appendNumbers<IntVectorBatch>(from, to, offset) &&
+               !appendNumbers<ShortVectorBatch>(from, to, offset) &&
+               !appendNumbers<ByteVectorBatch>(from, to, offset) &&
+               !appendNumbers<DoubleVectorBatch>(from, to, offset) &&
+               !appendNumbers<FloatVectorBatch>(from, to, offset)) {
+      throw NotImplementedYet("readRows does not support " + from.toString());
+    }
+  }
+
+  void RowReaderImpl::readRows(const std::vector<uint64_t>& rowIds, ColumnVectorBatch& data) {
+    SCOPED_STOPWATCH(contents_->readerMetrics, ReaderInclusiveLatencyUs, ReaderCall);
+    uint64_t beginRow = 0;
+    uint64_t endRow = 0;
+    if (firstStripe_ < lastStripe_) {
+      beginRow = firstRowOfStripe_[firstStripe_];
+      endRow = firstRowOfStripe_[lastStripe_ - 1] +
+               footer_->stripes(static_cast<int>(lastStripe_ - 1)).number_of_rows();
+    }
+    for (size_t i = 0; i < rowIds.size(); ++i) {
+      if (rowIds[i] < beginRow || rowIds[i] >= endRow) {
+        std::stringstream msg;
+        msg << "Row " << rowIds[i] << " is outside of the rows [" << beginRow << ", " << endRow
+            << ") of this reader";
+        throw InvalidArgument(msg.str());
+      }
+      if (i > 0 && rowIds[i] <= rowIds[i - 1]) {
+        throw InvalidArgument("Row ids must be in ascending order without duplicates");
+      }
+    }
+    data.numElements = 0;
+    if (rowIds.empty()) {
+      return;
+    }
+
+    if (!gatherBatch_) {
+      gatherBatch_ = createRowBatch(std::min(rowIds.size(), static_cast<size_t>(1024)));
+    }
+    uint64_t rowIndexStride = footer_->row_index_stride();
+    // the row groups read here need not be selected by the search argument
+    // and the deleted rows, so let seekToRow reposition the reader afterwards
+    bool ignoredSelection = sargsApplier_ != nullptr || deletedRows_ != nullptr;
+    uint64_t stripe = firstStripe_;
+    size_t done = 0;
+    while (done < rowIds.size()) {
+      while (stripe + 1 < lastStripe_ && firstRowOfStripe_[stripe + 1] <= rowIds[done]) {
+        ++stripe;
+      }
+      uint64_t row = rowIds[done] - firstRowOfStripe_[stripe];
+      bool hasRowIndex = rowIndexStride > 0 && currentStripeInfo_.index_length() > 0;
+      if (!isCurrentStripeInited() || currentStripe_ != stripe || !reader_ ||
+          (row < currentRowInStripe_ && !hasRowIndex)) {
+        openStripe(stripe);
+        hasRowIndex = rowIndexStride > 0 && currentStripeInfo_.index_length() > 0;
+      }
+      // seek once per row group and skip the rows between requested ones
+      if (hasRowIndex && (row < currentRowInStripe_ ||
+                          row / rowIndexStride != currentRowInStripe_ / rowIndexStride)) {
+        if (rowIndexes_.empty()) {
+          loadStripeIndex();
+        }
+        seekToRowGroup(static_cast<uint32_t>(row / rowIndexStride));
+        currentRowInStripe_ = row - row % rowIndexStride;
+      }
+      if (row > currentRowInStripe_) {
+        reader_->skip(row - currentRowInStripe_);
+        currentRowInStripe_ = row;
+      }
+      // decode runs of consecutive rows together
+      uint64_t run = 1;
+      while (done + run < rowIds.size() && rowIds[done + run] == rowIds[done] + run &&
+             row + run < rowsInCurrentStripe_ && run < gatherBatch_->capacity) {
+        ++run;
+      }
+      reader_->next(*gatherBatch_, run, nullptr);
+      appendBatch(*gatherBatch_, data, done);
+      currentRowInStripe_ += run;
+      done += run;
+    }
+
+    if (currentRowInStripe_ >= rowsInCurrentStripe_) {
+      currentStripe_ += 1;
+      currentRowInStripe_ = 0;
+    }
+    if (ignoredSelection) {
+      processingStripe_ = static_cast<uint64_t>(footer_->stripes_size());
+      seekToRow(rowIds.back() + 1);
+    }
+    previousRow_ = rowIds.front();
+    allRowsMatch_ = false;
+  }
+
+  bool RowReaderImpl::allRowsMatch() const {
+    return allRowsMatch_;
+  }
+
   void RowReaderImpl::loadStripeIndex() {
+    ScopedTrace trace(contents_->traceRecorder, "read", "row index");
+    trace.addArg("stripe", currentStripe_);
     // reset all previous row indexes
     rowIndexes_.clear();
     bloomFilterIndex_.clear();
@@ -452,7 +708,8 @@ namespace orc {
             getCompression(),
             std::unique_ptr<SeekableInputStream>(new SeekableFileInputStream(
                 contents_->stream.get(), offset, pbStream.length(), *contents_->pool)),
-            getCompressionSize(), *contents_->pool, contents_->readerMetrics);
+            getCompressionSize(), *contents_->pool, contents_->readerMetrics,
+            contents_->traceRecorder);
 
         if (pbStream.kind() == proto::Stream_Kind_ROW_INDEX) {
           proto::RowIndex rowIndex;
@@ -522,11 +779,14 @@ namespace orc {
                                       const FileContents& contents) {
     uint64_t stripeFooterStart = info.offset() + info.index_length() + info.data_length();
     uint64_t stripeFooterLength = info.footer_length();
+    ScopedTrace trace(contents.traceRecorder, "read", "stripe footer");
+    trace.addArg("offset", stripeFooterStart);
+    trace.addArg("length", stripeFooterLength);
     std::unique_ptr<SeekableInputStream> pbStream = createDecompressor(
         contents.compression,
         std::make_unique<SeekableFileInputStream>(contents.stream.get(), stripeFooterStart,
                                                   stripeFooterLength, *contents.pool),
-        contents.blockSize, *contents.pool, contents.readerMetrics);
+        contents.blockSize, *contents.pool, contents.readerMetrics, contents.traceRecorder);
     proto::StripeFooter result;
     if (!result.ParseFromZeroCopyStream(pbStream.get())) {
       throw ParseError(std::string("bad StripeFooter from ") + pbStream->getName());
@@ -1033,9 +1293,11 @@ namespace orc {
   }
 
   void RowReaderImpl::startNextStripe() {
+    ScopedTrace trace(contents_->traceRecorder, "read", "start stripe");
     reader_.reset();  // ColumnReaders use lots of memory; free old memory first
     rowIndexes_.clear();
     bloomFilterIndex_.clear();
+    nextSkippedRows_.clear();
 
     // evaluate file statistics if it exists
     if (sargsApplier_ &&
@@ -1063,9 +1325,13 @@ namespace orc {
       rowsInCurrentStripe_ = currentStripeInfo_.number_of_rows();
       processingStripe_ = currentStripe_;
 
-      bool isStripeNeeded = true;
+      // skip the stripe when all of its remaining rows are deleted
+      uint64_t stripeStart = firstRowOfStripe_[currentStripe_];
+      bool isStripeNeeded = !deletedRows_ || countDeletedRows(stripeStart + currentRowInStripe_,
+                                                              stripeStart + rowsInCurrentStripe_) <
+                                                 rowsInCurrentStripe_ - currentRowInStripe_;
       // If PPD enabled and stripe stats existed, evaulate it first
-      if (sargsApplier_ && contents_->metadata) {
+      if (isStripeNeeded && sargsApplier_ && contents_->metadata) {
         const auto& currentStripeStats =
             contents_->metadata->stripe_stats(static_cast<int>(currentStripe_));
         // skip this stripe after stats fail to satisfy sargs
@@ -1083,12 +1349,16 @@ namespace orc {
 
           // select row groups to read in the current stripe
           sargsApplier_->pickRowGroups(rowsInCurrentStripe_, rowIndexes_, bloomFilterIndex_);
-          if (sargsApplier_->hasSelectedFrom(currentRowInStripe_)) {
-            // current stripe has at least one row group matching the predicate
-            break;
-          }
-          isStripeNeeded = false;
         }
+        selectRowGroups();
+        if ((!sargsApplier_ && nextSkippedRows_.empty()) ||
+            advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
+                                  footer_->row_index_stride(),
+                                  nextSkippedRows_) < rowsInCurrentStripe_) {
+          // current stripe has at least one selected row group
+          break;
+        }
+        isStripeNeeded = false;
       }
 
       if (!isStripeNeeded) {
@@ -1096,25 +1366,16 @@ namespace orc {
         currentStripe_ += 1;
         currentRowInStripe_ = 0;
       }
-    } while (sargsApplier_ && currentStripe_ < lastStripe_);
+    } while (currentStripe_ < lastStripe_);
 
     if (currentStripe_ < lastStripe_) {
-      // get writer timezone info from stripe footer to help understand timestamp values.
-      const Timezone& writerTimezone =
-          currentStripeFooter_.has_writer_timezone()
-              ? getTimezoneByName(currentStripeFooter_.writer_timezone())
-              : localTimezone_;
-      StripeStreamsImpl stripeStreams(*this, currentStripe_, currentStripeInfo_,
-                                      currentStripeFooter_, currentStripeInfo_.offset(),
-                                      *contents_->stream, writerTimezone, readerTimezone_);
-      reader_ = buildReader(*contents_->schema, stripeStreams, useTightNumericVector_,
-                            throwOnSchemaEvolutionOverflow_, /*convertToReadType=*/true);
-
-      if (sargsApplier_) {
+      trace.addArg("stripe", currentStripe_);
+      createStripeReader();
+
+      if (sargsApplier_ || !nextSkippedRows_.empty()) {
         // move to the 1st selected row group when PPD is enabled.
-        currentRowInStripe_ =
-            advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
-                                  footer_->row_index_stride(), sargsApplier_->getNextSkippedRows());
+        currentRowInStripe_ = advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
+                                                    footer_->row_index_stride(), nextSkippedRows_);
         previousRow_ = firstRowOfStripe_[currentStripe_] + currentRowInStripe_ - 1;
         if (currentRowInStripe_ > 0) {
           seekToRowGroup(static_cast<uint32_t>(currentRowInStripe_ / footer_->row_index_stride()));
@@ -1126,8 +1387,51 @@ namespace orc {
     }
   }
 
+  void RowReaderImpl::createStripeReader() {
+    // get writer timezone info from stripe footer to help understand timestamp values.
+    const Timezone& writerTimezone = currentStripeFooter_.has_writer_timezone()
+                                         ? getTimezoneByName(currentStripeFooter_.writer_timezone())
+                                         : localTimezone_;
+    StripeStreamsImpl stripeStreams(*this, currentStripe_, currentStripeInfo_, currentStripeFooter_,
+                                    currentStripeInfo_.offset(), *contents_->stream,
+                                    writerTimezone, readerTimezone_);
+    reader_ = buildReader(*contents_->schema, stripeStreams, useTightNumericVector_,
+                          throwOnSchemaEvolutionOverflow_, /*convertToReadType=*/true);
+  }
+
+  /**
+   * Open a stripe at its first row without evaluating the search argument.
+   */
+  void RowReaderImpl::openStripe(uint64_t stripeIndex) {
+    ScopedTrace trace(contents_->traceRecorder, "read", "start stripe");
+    trace.addArg("stripe", stripeIndex);
+    reader_.reset();
+    rowIndexes_.clear();
+    bloomFilterIndex_.clear();
+    currentStripe_ = stripeIndex;
+    processingStripe_ = stripeIndex;
+    currentRowInStripe_ = 0;
+    currentStripeInfo_ = footer_->stripes(static_cast<int>(stripeIndex));
+    rowsInCurrentStripe_ = currentStripeInfo_.number_of_rows();
+    currentStripeFooter_ = getStripeFooter(currentStripeInfo_, *contents_.get());
+    nextSkippedRows_.clear();
+    matchedRowGroups_.clear();
+    createStripeReader();
+  }
+
   bool RowReaderImpl::next(ColumnVectorBatch& data) {
     SCOPED_STOPWATCH(contents_->readerMetrics, ReaderInclusiveLatencyUs, ReaderCall);
+    // all rows of a range may be deleted, so continue until rows are left
+    while (nextRange(data)) {
+      if (data.numElements > 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool RowReaderImpl::nextRange(ColumnVectorBatch& data) {
+    allRowsMatch_ = false;
     if (currentStripe_ >= lastStripe_) {
       data.numElements = 0;
       markEndOfFile();
@@ -1138,30 +1442,29 @@ namespace orc {
     }
     uint64_t rowsToRead =
         std::min(static_cast<uint64_t>(data.capacity), rowsInCurrentStripe_ - currentRowInStripe_);
-    if (sargsApplier_ && rowsToRead > 0) {
-      rowsToRead =
-          computeBatchSize(rowsToRead, currentRowInStripe_, rowsInCurrentStripe_,
-                           footer_->row_index_stride(), sargsApplier_->getNextSkippedRows());
+    if (!nextSkippedRows_.empty() && rowsToRead > 0) {
+      rowsToRead = computeBatchSize(rowsToRead, currentRowInStripe_, rowsInCurrentStripe_,
+                                    footer_->row_index_stride(), nextSkippedRows_);
     }
     data.numElements = rowsToRead;
     if (rowsToRead == 0) {
       markEndOfFile();
       return false;
     }
-    if (enableEncodedBlock_) {
-      reader_->nextEncoded(data, rowsToRead, nullptr);
-    } else {
-      reader_->next(data, rowsToRead, nullptr);
+    // ranges are split where row groups start or stop to match, so the row
+    // group of the first row speaks for the whole batch
+    if (!matchedRowGroups_.empty()) {
+      allRowsMatch_ = matchedRowGroups_[currentRowInStripe_ / footer_->row_index_stride()];
     }
+    readStripeRows(data, rowsToRead);
     // update row number
     previousRow_ = firstRowOfStripe_[currentStripe_] + currentRowInStripe_;
     currentRowInStripe_ += rowsToRead;
 
     // check if we need to advance to next selected row group
-    if (sargsApplier_) {
-      uint64_t nextRowToRead =
-          advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
-                                footer_->row_index_stride(), sargsApplier_->getNextSkippedRows());
+    if (!nextSkippedRows_.empty()) {
+      uint64_t nextRowToRead = advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
+                                                     footer_->row_index_stride(), nextSkippedRows_);
       if (currentRowInStripe_ != nextRowToRead) {
         // it is guaranteed to be at start of a row group
         currentRowInStripe_ = nextRowToRead;
@@ -1175,7 +1478,115 @@ namespace orc {
       currentStripe_ += 1;
       currentRowInStripe_ = 0;
     }
-    return rowsToRead != 0;
+    return true;
+  }
+
+  void RowReaderImpl::readStripeRows(ColumnVectorBatch& data, uint64_t numRows) {
+    uint64_t row = firstRowOfStripe_[currentStripe_] + currentRowInStripe_;
+    uint64_t end = row + numRows;
+    std::vector<uint64_t>::const_iterator deleted;
+    if (deletedRows_) {
+      deleted = std::lower_bound(deletedRows_->begin(), deletedRows_->end(), row);
+    }
+    if (!deletedRows_ || deleted == deletedRows_->end() || *deleted >= end) {
+      if (enableEncodedBlock_) {
+        reader_->nextEncoded(data, numRows, nullptr);
+      } else {
+        reader_->next(data, numRows, nullptr);
+      }
+      return;
+    }
+
+    // decode the runs of rows that are left and skip over the deleted ones
+    if (!gatherBatch_) {
+      gatherBatch_ = createRowBatch(data.capacity);
+    }
+    uint64_t selected = 0;
+    while (row < end) {
+      uint64_t runEnd = deleted != deletedRows_->end() ? std::min(*deleted, end) : end;
+      if (row < runEnd) {
+        reader_->next(*gatherBatch_, runEnd - row, nullptr);
+        appendBatch(*gatherBatch_, data, selected);
+        selected += runEnd - row;
+        row = runEnd;
+      }
+      uint64_t skipped = 0;
+      while (row < end && deleted != deletedRows_->end() && *deleted == row) {
+        ++deleted;
+        ++skipped;
+        ++row;
+      }
+      if (skipped > 0) {
+        reader_->skip(skipped);
+      }
+    }
+    data.numElements = selected;
+  }
+
+  uint64_t RowReaderImpl::countDeletedRows(uint64_t begin, uint64_t end) const {
+    if (!deletedRows_) {
+      return 0;
+    }
+    auto first = std::lower_bound(deletedRows_->begin(), deletedRows_->end(), begin);
+    auto last = std::lower_bound(first, deletedRows_->end(), end);
+    return static_cast<uint64_t>(last - first);
+  }
+
+  void RowReaderImpl::selectRowGroups() {
+    nextSkippedRows_.clear();
+    matchedRowGroups_.clear();
+    if (sargsApplier_) {
+      nextSkippedRows_ = sargsApplier_->getNextSkippedRows();
+      matchedRowGroups_ = sargsApplier_->getMatchedRowGroups();
+    }
+    uint64_t rowIndexStride = footer_->row_index_stride();
+    if (rowIndexStride == 0 || currentStripeInfo_.index_length() == 0) {
+      matchedRowGroups_.clear();
+      return;
+    }
+    // drop the row groups whose rows are all deleted
+    uint64_t stripeStart = firstRowOfStripe_[currentStripe_];
+    uint64_t groupsInStripe = (rowsInCurrentStripe_ + rowIndexStride - 1) / rowIndexStride;
+    std::vector<bool> selected(groupsInStripe, true);
+    bool hasDeletedGroup = false;
+    for (uint64_t rg = 0; rg < groupsInStripe; ++rg) {
+      uint64_t begin = rg * rowIndexStride;
+      uint64_t end = std::min(begin + rowIndexStride, rowsInCurrentStripe_);
+      if (!nextSkippedRows_.empty() && nextSkippedRows_[rg] == 0) {
+        selected[rg] = false;
+      } else if (deletedRows_ &&
+                 countDeletedRows(stripeStart + begin, stripeStart + end) == end - begin) {
+        selected[rg] = false;
+        hasDeletedGroup = true;
+      }
+    }
+    bool hasMatchedGroup =
+        std::find(matchedRowGroups_.begin(), matchedRowGroups_.end(), true) !=
+        matchedRowGroups_.end();
+    if (!hasDeletedGroup && !hasMatchedGroup) {
+      matchedRowGroups_.clear();
+      return;
+    }
+    if (rowIndexes_.empty()) {
+      loadStripeIndex();
+    }
+    // a selected range ends at the next skipped row group or where the row
+    // groups start or stop to match entirely
+    auto isMatched = [this](uint64_t rg) {
+      return !matchedRowGroups_.empty() && matchedRowGroups_[rg];
+    };
+    nextSkippedRows_.assign(groupsInStripe, 0);
+    uint64_t nextSkippedRow = rowsInCurrentStripe_;
+    for (uint64_t rg = groupsInStripe; rg-- > 0;) {
+      if (!selected[rg]) {
+        nextSkippedRow = rg * rowIndexStride;
+        continue;
+      }
+      if (rg + 1 < groupsInStripe && selected[rg + 1] && isMatched(rg) != isMatched(rg + 1)) {
+        nextSkippedRow = (rg + 1) * rowIndexStride;
+      }
+      nextSkippedRows_[rg] = nextSkippedRow;
+    }
   }
 
   uint64_t RowReaderImpl::computeBatchSize(uint64_t requestedSize, uint64_t currentRowInStripe,
@@ -1374,6 +1785,8 @@ namespace orc {
     contents->pool = options.getMemoryPool();
     contents->errorStream = options.getErrorStream();
     contents->readerMetrics = options.getReaderMetrics();
+    contents->traceRecorder = options.getTraceRecorder();
+    contents->columnMetricsTable = options.getColumnMetricsTable();
     std::string serializedFooter = options.getSerializedFileTail();
     uint64_t fileLength;
     uint64_t postscriptLength;
@@ -1533,6 +1946,152 @@ namespace orc {
     return ret;
   }
 
+  std::unordered_map<uint64_t, proto::RowIndex> ReaderImpl::getRowIndexes(
+      uint32_t stripeIndex, const std::set<uint32_t>& included) const {
+    std::unordered_map<uint64_t, proto::RowIndex> ret;
+    uint64_t offset;
+    auto currentStripeFooter = loadCurrentStripeFooter(stripeIndex, offset);
+
+    for (int i = 0; i < currentStripeFooter.streams_size(); i++) {
+      const proto::Stream& stream = currentStripeFooter.streams(i);
+      uint32_t column = static_cast<uint32_t>(stream.column());
+      uint64_t length = static_cast<uint64_t>(stream.length());
+      if (stream.kind() == proto::Stream_Kind_ROW_INDEX &&
+          included.find(column) != included.end()) {
+        std::unique_ptr<SeekableInputStream> pbStream =
+            createDecompressor(contents_->compression,
+                               std::make_unique<SeekableFileInputStream>(
+                                   contents_->stream.get(), offset, length, *contents_->pool),
+                               contents_->blockSize, *(contents_->pool), contents_->readerMetrics);
+        if (!ret[column].ParseFromZeroCopyStream(pbStream.get())) {
+          std::stringstream errMsgBuffer;
+          errMsgBuffer << "Failed to parse RowIndex at column " << column << " in stripe "
+                       << stripeIndex;
+          throw ParseError(errMsgBuffer.str());
+        }
+      }
+      offset += length;
+    }
+    return ret;
+  }
+
+  /**
+   * Divide stripes into at most numSplits groups of consecutive stripes so
+   * that the largest group is as small as possible, while using as many
+   * groups as there are stripes for.
+   * @return the index of the first stripe of each group
+   */
+  static std::vector<size_t> partitionStripes(const std::vector<uint64_t>& weights,
+                                              uint64_t numSplits) {
+    // binary search for the smallest capacity that needs no more groups
+    uint64_t low = *std::max_element(weights.begin(), weights.end());
+    uint64_t high = std::accumulate(weights.begin(), weights.end(), uint64_t(0));
+    while (low < high) {
+      uint64_t capacity = low + (high - low) / 2;
+      uint64_t groups = 1;
+      uint64_t sum = 0;
+      for (uint64_t weight : weights) {
+        if (sum + weight > capacity) {
+          ++groups;
+          sum = 0;
+        }
+        sum += weight;
+      }
+      if (groups <= numSplits) {
+        high = capacity;
+      } else {
+        low = capacity + 1;
+      }
+    }
+
+    std::vector<size_t> starts = {0};
+    uint64_t sum = weights[0];
+    for (size_t i = 1; i < weights.size(); ++i) {
+      // start a new group when the capacity is reached or when each of the
+      // remaining stripes can have a group of its own
+      if (sum + weights[i] > low || weights.size() - i <= numSplits - starts.size()) {
+        starts.push_back(i);
+        sum = 0;
+      }
+      sum += weights[i];
+    }
+    return starts;
+  }
+
+  std::vector<ScanSplit> ReaderImpl::planScan(const RowReaderOptions& options,
+                                              uint64_t numSplits) const {
+    if (numSplits == 0) {
+      throw InvalidArgument("The number of splits must be positive");
+    }
+    std::vector<bool> selectedColumns;
+    ColumnSelector columnSelector(contents_.get());
+    columnSelector.updateSelected(selectedColumns, options);
+
+    std::unique_ptr<SargsApplier> sargsApplier;
+    const proto::Metadata* metadata = nullptr;
+    if (options.getSearchArgument()) {
+      sargsApplier = std::make_unique<SargsApplier>(
+          *contents_->schema, options.getSearchArgument().get(), footer_->row_index_stride(),
+          getWriterVersionImpl(contents_.get()), nullptr);
+      if (footer_->statistics_size() > 0 &&
+          !isNeeded(sargsApplier->evaluateStatistics(footer_->statistics()))) {
+        return {};
+      }
+      metadata = getMetadata();
+    }
+
+    std::vector<ScanStripe> stripes;
+    for (int i = 0; i < footer_->stripes_size(); ++i) {
+      const proto::StripeInformation& info = footer_->stripes(i);
+      if (info.offset() < options.getOffset() ||
+          info.offset() >= options.getOffset() + options.getLength()) {
+        continue;
+      }
+      if (metadata != nullptr && i < metadata->stripe_stats_size() &&
+          metadata->stripe_stats(i).col_stats_size() > 0 &&
+          !isNeeded(sargsApplier->evaluateStatistics(metadata->stripe_stats(i).col_stats()))) {
+        continue;
+      }
+      ScanStripe stripe;
+      stripe.index = static_cast<uint64_t>(i);
+      stripe.offset = info.offset();
+      stripe.length = info.index_length() + info.data_length() + info.footer_length();
+      stripe.numberOfRows = info.number_of_rows();
+      stripe.selectedBytes = 0;
+      proto::StripeFooter stripeFooter = getStripeFooter(info, *contents_);
+      for (const auto& stream : stripeFooter.streams()) {
+        if (stream.column() < selectedColumns.size() && selectedColumns[stream.column()]) {
+          stripe.selectedBytes += stream.length();
+        }
+      }
+      stripes.push_back(stripe);
+    }
+
+    std::vector<ScanSplit> splits;
+    if (stripes.empty()) {
+      return splits;
+    }
+    std::vector<uint64_t> weights;
+    for (const auto& stripe : stripes) {
+      weights.push_back(stripe.selectedBytes);
+    }
+    std::vector<size_t> starts = partitionStripes(weights, numSplits);
+    for (size_t i = 0; i < starts.size(); ++i) {
+      size_t end = i + 1 < starts.size() ? starts[i + 1] : stripes.size();
+      ScanSplit split;
+      split.stripes.assign(stripes.begin() + static_cast<std::ptrdiff_t>(starts[i]),
+                           stripes.begin() + static_cast<std::ptrdiff_t>(end));
+      split.selectedBytes = 0;
+      for (const auto& stripe : split.stripes) {
+        split.selectedBytes += stripe.selectedBytes;
+      }
+      split.offset = split.stripes.front().offset;
+      split.length = split.stripes.back().offset + split.stripes.back().length - split.offset;
+      splits.push_back(std::move(split));
+    }
+    return splits;
+  }
+
   void ReaderImpl::releaseBuffer(uint64_t boundary) {
     std::lock_guard<std::mutex> lock(contents_->readCacheMutex);
 
@@ -1614,7 +2173,8 @@ namespace orc {
 
         if (!contents_->readCache) {
           contents_->readCache = std::make_shared<ReadRangeCache>(
-              getStream(), options_.getCacheOptions(), contents_->pool, contents_->readerMetrics);
+              getStream(), options_.getCacheOptions(), contents_->pool, contents_->readerMetrics,
+              contents_->traceRecorder);
         }
         contents_->readCache->cache(std::move(ranges));
       }
@@ -1625,10 +2185,22 @@ namespace orc {
     // PASS
   }
 
+  void RowReader::readRows(const std::vector<uint64_t>&, ColumnVectorBatch&) {
+    throw NotImplementedYet("This row reader does not support readRows");
+  }
+
+  bool RowReader::allRowsMatch() const {
+    return false;
+  }
+
   Reader::~Reader() {
     // PASS
   }
 
+  std::vector<ScanSplit> Reader::planScan(const RowReaderOptions&, uint64_t) const {
+    throw NotImplementedYet("This reader does not support planScan");
+  }
+
   InputStream::~InputStream(){
       // PASS
   };
@@ -72,6 +72,8 @@ namespace orc {
     bool isDecimalAsLong;
     std::unique_ptr<proto::Metadata> metadata;
     ReaderMetrics* readerMetrics;
+    TraceRecorder* traceRecorder;
+    ColumnMetricsTable* columnMetricsTable;
 
     // mutex to protect readCache_ from concurrent access
     std::mutex readCacheMutex;
@@ -167,8 +169,28 @@ namespace orc {
     bool enableEncodedBlock_;
     bool useTightNumericVector_;
     bool throwOnSchemaEvolutionOverflow_;
+    // batch that readRows and deleted rows decode runs of rows into
+    std::unique_ptr<ColumnVectorBatch> gatherBatch_;
+    // sorted positions of the deleted rows in the file or nullptr
+    std::shared_ptr<const std::vector<uint64_t>> deletedRows_;
+    // the row groups of the current stripe to read, in the format of
+    // SargsApplier::getNextSkippedRows; empty if all are read
+    std::vector<uint64_t> nextSkippedRows_;
+    // whether every row of each row group of the current stripe matches the
+    // search argument; empty if unknown
+    std::vector<bool> matchedRowGroups_;
+    // whether every row of the last batch matches the search argument
+    bool allRowsMatch_;
     // internal methods
     void startNextStripe();
+    void openStripe(uint64_t stripeIndex);
+    void createStripeReader();
+    bool nextRange(ColumnVectorBatch& data);
+    void readStripeRows(ColumnVectorBatch& data, uint64_t numRows);
+    uint64_t countDeletedRows(uint64_t begin, uint64_t end) const;
+    // combine the row groups picked by the search argument with the deleted rows
+    // and split the selected ranges where the row groups start or stop to match
+    void selectRowGroups();
     inline void markEndOfFile();
 
     // row index of current stripe with column id as the key
@@ -244,6 +266,10 @@ namespace orc {
 
     void seekToRow(uint64_t rowNumber) override;
 
+    void readRows(const std::vector<uint64_t>& rowIds, ColumnVectorBatch& data) override;
+
+    bool allRowsMatch() const override;
+
     const FileContents& getFileContents() const;
     bool getThrowOnHive11DecimalOverflow() const;
     bool getIsDecimalAsLong() const;
@@ -377,6 +403,14 @@ namespace orc {
       return contents_->stream.get();
     }
 
+    // null if the file has no stripe statistics
+    const proto::Metadata* getMetadata() const {
+      if (!isMetadataLoaded_) {
+        readMetadata();
+      }
+      return contents_->metadata.get();
+    }
+
     uint64_t getMemoryUse(int stripeIx = -1) override;
 
     uint64_t getMemoryUseByFieldId(const std::list<uint64_t>& include, int stripeIx = -1) override;
@@ -394,6 +428,13 @@ namespace orc {
 
     std::map<uint32_t, RowGroupIndex> getRowGroupIndex(
         uint32_t stripeIndex, const std::set<uint32_t>& included) const override;
+
+    std::vector<ScanSplit> planScan(const RowReaderOptions& options,
+                                    uint64_t numSplits) const override;
+
+    // the row indexes of the included columns in a stripe, as SargsApplier expects them
+    std::unordered_map<uint64_t, proto::RowIndex> getRowIndexes(
+        uint32_t stripeIndex, const std::set<uint32_t>& included) const;
   };
 }  // namespace orc
 
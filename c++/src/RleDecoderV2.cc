@@ -32,6 +32,7 @@ namespace orc {
   unsigned char RleDecoderV2::readByte() {
     SCOPED_MINUS_STOPWATCH(metrics, DecodingLatencyUs);
     if (bufferStart_ == bufferEnd_) {
+      SCOPED_STREAM_MINUS_STOPWATCH(streamMetrics, DecodingLatencyUs);
       int bufferLength;
       const void* bufferPointer;
       if (!inputStream_->Next(&bufferPointer, &bufferLength)) {
@@ -132,6 +133,10 @@ namespace orc {
   template <typename T>
   void RleDecoderV2::next(T* const data, const uint64_t numValues, const char* const notNull) {
     SCOPED_STOPWATCH(metrics, DecodingLatencyUs, DecodingCall);
+    SCOPED_STREAM_STOPWATCH(streamMetrics, DecodingLatencyUs, DecodingCall);
+    if (streamMetrics) {
+      streamMetrics->ValuesDecoded += numValues;
+    }
     uint64_t nRead = 0;
 
     while (nRead < numValues) {
@@ -0,0 +1,376 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/Exceptions.hh"
+#include "orc/OrcFile.hh"
+
+#include "Compression.hh"
+#include "io/InputStream.hh"
+#include "Reader.hh"
+#include "Statistics.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <typeinfo>
+
+namespace orc {
+
+  // stripes are copied in chunks of this size
+  static const uint64_t COPY_BUFFER_SIZE = 4 * 1024 * 1024;
+
+  static const char* const MAGIC = "ORC";
+
+  static const ReaderImpl& toReaderImpl(const Reader* reader) {
+    const ReaderImpl* impl = dynamic_cast<const ReaderImpl*>(reader);
+    if (impl == nullptr) {
+      throw InvalidArgument("Stripes can only be copied from readers created by createReader");
+    }
+    return *impl;
+  }
+
+  // the statistics and streams of encrypted columns live in encryption
+  // variants that are not copied
+  static void checkNotEncrypted(const ReaderImpl& reader, const std::string& operation) {
+    if (reader.getFooter()->has_encryption()) {
+      throw NotImplementedYet("Cannot " + operation + " " + reader.getStreamName() +
+                              ": it has encrypted columns");
+    }
+  }
+
+  static void copyBytes(InputStream& input, uint64_t offset, uint64_t length, OutputStream& output,
+                        DataBuffer<char>& buffer, WriterMetrics* metrics) {
+    while (length > 0) {
+      uint64_t chunk = std::min(length, buffer.size());
+      input.read(buffer.data(), chunk, offset);
+      output.write(buffer.data(), chunk);
+      if (metrics) {
+        metrics->IOCount.fetch_add(1);
+      }
+      offset += chunk;
+      length -= chunk;
+    }
+  }
+
+  static void checkMergeable(const ReaderImpl& first, const ReaderImpl& other) {
+    std::string reason;
+    if (other.getType().toString() != first.getType().toString()) {
+      reason = "schema";
+    } else if (other.getFormatVersion() != first.getFormatVersion()) {
+      reason = "file version";
+    } else if (other.getWriterVersion() != first.getWriterVersion()) {
+      reason = "writer version";
+    } else if (other.getCompression() != first.getCompression()) {
+      reason = "compression kind";
+    } else if (other.getCompressionSize() != first.getCompressionSize()) {
+      reason = "compression block size";
+    } else if (other.getRowIndexStride() != first.getRowIndexStride()) {
+      reason = "row index stride";
+    } else {
+      return;
+    }
+    throw InvalidArgument("Cannot merge " + other.getStreamName() + " with " +
+                          first.getStreamName() + ": the " + reason + " differs");
+  }
+
+  // add the file statistics of a column in reader to stats
+  static void mergeFileStatistics(const ReaderImpl& reader, const Type& type,
+                                  MutableColumnStatistics& stats) {
+    const proto::Footer& footer = *reader.getFooter();
+    int columnId = static_cast<int>(type.getColumnId());
+    if (columnId >= footer.statistics_size()) {
+      throw ParseError("Missing file statistics in " + reader.getStreamName());
+    }
+    StatContext statContext(reader.hasCorrectStatistics());
+    std::unique_ptr<ColumnStatistics> converted(
+        convertColumnStatistics(footer.statistics(columnId), statContext));
+    auto& other = dynamic_cast<MutableColumnStatistics&>(*converted);
+    if (typeid(other) == typeid(stats)) {
+      stats.merge(other);
+    } else {
+      // no type specific statistics were written, e.g. for an empty file
+      std::unique_ptr<MutableColumnStatistics> counts = createColumnStatistics(type);
+      counts->increase(converted->getNumberOfValues());
+      counts->setHasNull(converted->hasNull());
+      stats.merge(*counts);
+    }
+  }
+
+  // compression stream for stripe footers, file footer and metadata that
+  // matches the compression of the copied streams
+  static std::unique_ptr<BufferedOutputStream> createFooterCompressor(
+      OutputStream* stream, const ReaderImpl& model, const WriterOptions& options) {
+    uint64_t blockSize = model.getCompressionSize();
+    return createCompressor(model.getCompression(), stream, options.getCompressionStrategy(),
+                            options.getOutputBufferCapacity(), blockSize, blockSize,
+                            *options.getMemoryPool(), options.getWriterMetrics());
+  }
+
+  /**
+   * Write the metadata, footer and postscript that follow the stripes and
+   * close the stream.
+   */
+  static void writeFileTail(OutputStream* stream, BufferedOutputStream* compressionStream,
+                            const ReaderImpl& model, const proto::Metadata& metadata,
+                            const proto::Footer& footer, const WriterOptions& options) {
+    proto::PostScript postScript(*model.getPostscript());
+    if (!metadata.SerializeToZeroCopyStream(compressionStream)) {
+      throw std::logic_error("Failed to write metadata.");
+    }
+    postScript.set_metadata_length(compressionStream->flush());
+    if (!footer.SerializeToZeroCopyStream(compressionStream)) {
+      throw std::logic_error("Failed to write file footer.");
+    }
+    postScript.set_footer_length(compressionStream->flush());
+
+    BufferedOutputStream bufferedStream(*options.getMemoryPool(), stream, 1024,
+                                        model.getCompressionSize(), options.getWriterMetrics());
+    if (!postScript.SerializeToZeroCopyStream(&bufferedStream)) {
+      throw std::logic_error("Failed to write post script.");
+    }
+    unsigned char psLength = static_cast<unsigned char>(bufferedStream.flush());
+    stream->write(&psLength, sizeof(unsigned char));
+    stream->close();
+  }
+
+  void mergeFiles(const std::vector<const Reader*>& readers, OutputStream* stream,
+                  const WriterOptions& options) {
+    if (readers.empty()) {
+      throw InvalidArgument("No files to merge");
+    }
+    const ReaderImpl& first = toReaderImpl(readers[0]);
+    for (const Reader* reader : readers) {
+      checkMergeable(first, toReaderImpl(reader));
+      checkNotEncrypted(toReaderImpl(reader), "merge");
+    }
+
+    const Type& schema = first.getType();
+    std::vector<std::unique_ptr<MutableColumnStatistics>> fileStats;
+    for (uint64_t col = 0; col <= schema.getMaximumColumnId(); ++col) {
+      fileStats.push_back(createColumnStatistics(*schema.getTypeByColumnId(col)));
+    }
+
+    // stripe footers and the type tree stay valid, only the stripe offsets,
+    // sizes, statistics and user metadata change
+    proto::Footer footer(*first.getFooter());
+    footer.clear_stripes();
+    footer.clear_statistics();
+    footer.clear_metadata();
+    proto::Metadata metadata;
+    bool hasStripeStats = true;
+    std::set<std::string> metadataKeys;
+
+    const size_t magicLength = strlen(MAGIC);
+    stream->write(MAGIC, magicLength);
+    uint64_t offset = magicLength;
+    uint64_t numberOfRows = 0;
+    DataBuffer<char> buffer(*options.getMemoryPool(), COPY_BUFFER_SIZE);
+    for (const Reader* r : readers) {
+      const ReaderImpl& reader = toReaderImpl(r);
+      const proto::Footer& inputFooter = *reader.getFooter();
+      const proto::Metadata* inputMetadata = reader.getMetadata();
+      hasStripeStats = hasStripeStats && inputMetadata != nullptr &&
+                       inputMetadata->stripe_stats_size() == inputFooter.stripes_size();
+
+      for (int i = 0; i < inputFooter.stripes_size(); ++i) {
+        proto::StripeInformation stripe = inputFooter.stripes(i);
+        uint64_t length = stripe.index_length() + stripe.data_length() + stripe.footer_length();
+        copyBytes(*reader.getStream(), stripe.offset(), length, *stream, buffer,
+                  options.getWriterMetrics());
+        stripe.set_offset(offset);
+        *footer.add_stripes() = stripe;
+        offset += length;
+        if (hasStripeStats) {
+          *metadata.add_stripe_stats() = inputMetadata->stripe_stats(i);
+        }
+      }
+      numberOfRows += inputFooter.number_of_rows();
+
+      for (uint64_t col = 0; col < fileStats.size(); ++col) {
+        mergeFileStatistics(reader, *schema.getTypeByColumnId(col), *fileStats[col]);
+      }
+      for (int i = 0; i < inputFooter.metadata_size(); ++i) {
+        if (metadataKeys.insert(inputFooter.metadata(i).name()).second) {
+          *footer.add_metadata() = inputFooter.metadata(i);
+        }
+      }
+    }
+
+    if (!hasStripeStats) {
+      metadata.clear_stripe_stats();
+    }
+    footer.set_header_length(magicLength);
+    footer.set_content_length(offset - magicLength);
+    footer.set_number_of_rows(numberOfRows);
+    for (const auto& stats : fileStats) {
+      stats->toProtoBuf(*footer.add_statistics());
+    }
+
+    writeFileTail(stream, createFooterCompressor(stream, first, options).get(), first, metadata,
+                  footer, options);
+  }
+
+  static proto::StripeFooter readStripeFooter(const ReaderImpl& reader,
+                                              const proto::StripeInformation& stripe,
+                                              MemoryPool& pool) {
+    uint64_t offset = stripe.offset() + stripe.index_length() + stripe.data_length();
+    std::unique_ptr<SeekableInputStream> pbStream = createDecompressor(
+        reader.getCompression(),
+        std::make_unique<SeekableFileInputStream>(reader.getStream(), offset,
+                                                  stripe.footer_length(), pool),
+        reader.getCompressionSize(), pool, nullptr);
+    proto::StripeFooter footer;
+    if (!footer.ParseFromZeroCopyStream(pbStream.get())) {
+      throw ParseError("Failed to parse the stripe footer");
+    }
+    return footer;
+  }
+
+  void projectColumns(const Reader* input, const std::list<std::string>& columns,
+                      OutputStream* stream, const WriterOptions& options) {
+    const ReaderImpl& reader = toReaderImpl(input);
+    checkNotEncrypted(reader, "project the columns of");
+    const Type& schema = reader.getType();
+    if (schema.getKind() != STRUCT) {
+      throw InvalidArgument("Columns can only be projected from a struct schema");
+    }
+    std::set<std::string> names(columns.begin(), columns.end());
+    std::vector<uint64_t> fields;
+    for (uint64_t i = 0; i < schema.getSubtypeCount(); ++i) {
+      if (names.erase(schema.getFieldName(i)) > 0) {
+        fields.push_back(i);
+      }
+    }
+    if (!names.empty()) {
+      throw InvalidArgument("Column " + *names.begin() + " not found in " +
+                            reader.getStreamName());
+    }
+
+    // the selected subtrees keep their order and are numbered contiguously
+    const proto::Footer& inputFooter = *reader.getFooter();
+    std::vector<int64_t> newColumnIds(schema.getMaximumColumnId() + 1, -1);
+    std::vector<uint64_t> oldColumnIds = {0};
+    newColumnIds[0] = 0;
+    proto::Footer footer(inputFooter);
+    footer.clear_types();
+    footer.clear_stripes();
+    footer.clear_statistics();
+    proto::Type* root = footer.add_types();
+    *root = inputFooter.types(0);
+    root->clear_subtypes();
+    root->clear_field_names();
+    for (uint64_t field : fields) {
+      const Type& child = *schema.getSubtype(field);
+      root->add_subtypes(static_cast<uint32_t>(oldColumnIds.size()));
+      root->add_field_names(schema.getFieldName(field));
+      for (uint64_t col = child.getColumnId(); col <= child.getMaximumColumnId(); ++col) {
+        newColumnIds[col] = static_cast<int64_t>(oldColumnIds.size());
+        oldColumnIds.push_back(col);
+      }
+    }
+    for (size_t i = 1; i < oldColumnIds.size(); ++i) {
+      proto::Type* type = footer.add_types();
+      *type = inputFooter.types(static_cast<int>(oldColumnIds[i]));
+      for (int j = 0; j < type->subtypes_size(); ++j) {
+        type->set_subtypes(j, static_cast<uint32_t>(newColumnIds[type->subtypes(j)]));
+      }
+    }
+    const int maxColumnId = static_cast<int>(schema.getMaximumColumnId());
+    if (inputFooter.statistics_size() <= maxColumnId) {
+      throw ParseError("Missing file statistics in " + reader.getStreamName());
+    }
+    for (uint64_t col : oldColumnIds) {
+      *footer.add_statistics() = inputFooter.statistics(static_cast<int>(col));
+    }
+
+    proto::Metadata metadata;
+    const proto::Metadata* inputMetadata = reader.getMetadata();
+    if (inputMetadata != nullptr) {
+      for (const auto& inputStats : inputMetadata->stripe_stats()) {
+        if (inputStats.col_stats_size() <= maxColumnId) {
+          throw ParseError("Missing stripe statistics in " + reader.getStreamName());
+        }
+        proto::StripeStatistics* stripeStats = metadata.add_stripe_stats();
+        for (uint64_t col : oldColumnIds) {
+          *stripeStats->add_col_stats() = inputStats.col_stats(static_cast<int>(col));
+        }
+      }
+    }
+
+    const size_t magicLength = strlen(MAGIC);
+    stream->write(MAGIC, magicLength);
+    uint64_t offset = magicLength;
+    std::unique_ptr<BufferedOutputStream> compressionStream =
+        createFooterCompressor(stream, reader, options);
+    DataBuffer<char> buffer(*options.getMemoryPool(), COPY_BUFFER_SIZE);
+    for (const auto& inputStripe : inputFooter.stripes()) {
+      proto::StripeFooter inputStripeFooter =
+          readStripeFooter(reader, inputStripe, *options.getMemoryPool());
+      if (inputStripeFooter.columns_size() <= maxColumnId) {
+        throw ParseError("Missing column encodings in " + reader.getStreamName());
+      }
+      proto::StripeFooter stripeFooter(inputStripeFooter);
+      stripeFooter.clear_streams();
+      stripeFooter.clear_columns();
+      for (uint64_t col : oldColumnIds) {
+        *stripeFooter.add_columns() = inputStripeFooter.columns(static_cast<int>(col));
+      }
+
+      // copy the selected streams, merging adjacent ones into a single read
+      uint64_t streamOffset = inputStripe.offset();
+      uint64_t indexEnd = inputStripe.offset() + inputStripe.index_length();
+      uint64_t indexLength = 0, dataLength = 0;
+      uint64_t runStart = streamOffset, runLength = 0;
+      for (const auto& inputStream : inputStripeFooter.streams()) {
+        uint64_t column = inputStream.column();
+        if (column < newColumnIds.size() && newColumnIds[column] >= 0) {
+          if (runStart + runLength != streamOffset) {
+            copyBytes(*reader.getStream(), runStart, runLength, *stream, buffer,
+                      options.getWriterMetrics());
+            runStart = streamOffset;
+            runLength = 0;
+          }
+          runLength += inputStream.length();
+          (streamOffset < indexEnd ? indexLength : dataLength) += inputStream.length();
+          proto::Stream* outputStream = stripeFooter.add_streams();
+          *outputStream = inputStream;
+          outputStream->set_column(static_cast<uint32_t>(newColumnIds[column]));
+        }
+        streamOffset += inputStream.length();
+      }
+      copyBytes(*reader.getStream(), runStart, runLength, *stream, buffer,
+                options.getWriterMetrics());
+
+      if (!stripeFooter.SerializeToZeroCopyStream(compressionStream.get())) {
+        throw std::logic_error("Failed to write stripe footer.");
+      }
+      proto::StripeInformation* stripe = footer.add_stripes();
+      *stripe = inputStripe;
+      stripe->set_offset(offset);
+      stripe->set_index_length(indexLength);
+      stripe->set_data_length(dataLength);
+      stripe->set_footer_length(compressionStream->flush());
+      offset += indexLength + dataLength + stripe->footer_length();
+    }
+
+    footer.set_header_length(magicLength);
+    footer.set_content_length(offset - magicLength);
+    writeFileTail(stream, compressionStream.get(), reader, metadata, footer, options);
+  }
+
+}  // namespace orc
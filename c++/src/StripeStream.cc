@@ -116,9 +116,14 @@ namespace orc {
           seekableInput = std::make_unique<SeekableFileInputStream>(&input_, offset, streamLength,
                                                                     *pool, myBlock);
         }
+        StreamReaderMetrics* streamMetrics = getStreamReaderMetrics(columnId, kind);
+        if (streamMetrics) {
+          streamMetrics->BytesRead += streamLength;
+        }
         return createDecompressor(reader_.getCompression(), std::move(seekableInput),
                                   reader_.getCompressionSize(), *pool,
-                                  reader_.getFileContents().readerMetrics);
+                                  reader_.getFileContents().readerMetrics,
+                                  reader_.getFileContents().traceRecorder, streamMetrics);
       }
       offset += stream.length();
     }
@@ -133,6 +138,14 @@ namespace orc {
     return reader_.getFileContents().readerMetrics;
   }
 
+  TraceRecorder* StripeStreamsImpl::getTraceRecorder() const {
+    return reader_.getFileContents().traceRecorder;
+  }
+
+  ColumnMetricsTable* StripeStreamsImpl::getColumnMetricsTable() const {
+    return reader_.getFileContents().columnMetricsTable;
+  }
+
   bool StripeStreamsImpl::getThrowOnHive11DecimalOverflow() const {
     return reader_.getThrowOnHive11DecimalOverflow();
   }
@@ -68,6 +68,10 @@ namespace orc {
 
     ReaderMetrics* getReaderMetrics() const override;
 
+    TraceRecorder* getTraceRecorder() const override;
+
+    ColumnMetricsTable* getColumnMetricsTable() const override;
+
     const Timezone& getWriterTimezone() const override;
 
     const Timezone& getReaderTimezone() const override;
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <algorithm>
 #include <atomic>
 #include <map>
 #include <sstream>
@@ -90,6 +91,19 @@ namespace orc {
     }
   }
 
+  /**
+   * Add a delta to a time, clamping at the limits of int64_t.
+   */
+  static int64_t addSaturated(int64_t clk, int64_t delta) {
+    if (delta > 0 && clk > INT64_MAX - delta) {
+      return INT64_MAX;
+    }
+    if (delta < 0 && clk < INT64_MIN - delta) {
+      return INT64_MIN;
+    }
+    return clk + delta;
+  }
+
   struct Transition {
     TransitionKind kind;
     int64_t day;
@@ -233,6 +247,7 @@ namespace orc {
     virtual ~FutureRuleImpl() override;
     bool isDefined() const override;
     const TimezoneVariant& getVariant(int64_t clk) const override;
+    const TimezoneVariant& getVariant(int64_t clk, int64_t& start, int64_t& end) const override;
     void print(std::ostream& out) const override;
 
     friend class FutureRuleParser;
@@ -267,6 +282,30 @@ namespace orc {
     }
   }
 
+  const TimezoneVariant& FutureRuleImpl::getVariant(int64_t clk, int64_t& start,
+                                                    int64_t& end) const {
+    if (!hasDst_) {
+      start = INT64_MIN;
+      end = INT64_MAX;
+      return standard_;
+    }
+    int64_t adjusted = clk % SECONDS_PER_400_YEARS;
+    if (adjusted < 0) {
+      adjusted += SECONDS_PER_400_YEARS;
+    }
+    uint64_t idx = static_cast<uint64_t>(binarySearch(offsets_, adjusted));
+    int64_t next = idx + 1 < offsets_.size() ? offsets_[idx + 1] : SECONDS_PER_400_YEARS;
+    if (offsets_[idx] > adjusted || next <= adjusted) {
+      // transitions out of order in this year; cover just this second
+      start = clk;
+      end = addSaturated(clk, 1);
+    } else {
+      start = addSaturated(clk, offsets_[idx] - adjusted);
+      end = addSaturated(clk, next - adjusted);
+    }
+    return getVariant(clk);
+  }
+
   void FutureRuleImpl::print(std::ostream& out) const {
     if (isDefined()) {
       out << "  Future rule: " << ruleString_ << "\n";
@@ -573,6 +612,8 @@ namespace orc {
      */
     const TimezoneVariant& getVariant(int64_t clk) const override;
 
+    const TimezoneVariant& getVariant(int64_t clk, int64_t& start, int64_t& end) const override;
+
     void print(std::ostream&) const override;
 
     uint64_t getVersion() const override {
@@ -639,6 +680,26 @@ namespace orc {
     // PASS
   }
 
+  void Timezone::convertToUTC(int64_t* clk, uint64_t numValues, const char* notNull) const {
+    TimezoneVariantCache variants(*this);
+    for (uint64_t i = 0; i < numValues; ++i) {
+      if (notNull == nullptr || notNull[i]) {
+        clk[i] += variants.get(clk[i]).gmtOffset;
+      }
+    }
+  }
+
+  void Timezone::convertFromUTC(int64_t* clk, uint64_t numValues, const char* notNull) const {
+    TimezoneVariantCache variants(*this);
+    TimezoneVariantCache adjustedVariants(*this);
+    for (uint64_t i = 0; i < numValues; ++i) {
+      if (notNull == nullptr || notNull[i]) {
+        int64_t adjustedTime = clk[i] - variants.get(clk[i]).gmtOffset;
+        clk[i] -= adjustedVariants.get(adjustedTime).gmtOffset;
+      }
+    }
+  }
+
   TimezoneImpl::TimezoneImpl(const std::string& filename, const std::vector<unsigned char>& buffer)
       : filename_(filename) {
     parseZoneFile(&buffer[0], 0, buffer.size(), Version1Parser());
@@ -694,23 +755,31 @@ namespace orc {
   class LazyTimezone : public Timezone {
    private:
     std::string filename_;
+    const EmbeddedZone* embedded_;
     mutable std::unique_ptr<TimezoneImpl> impl_;
     mutable std::once_flag initialized_;
 
     TimezoneImpl* getImpl() const {
       std::call_once(initialized_, [&]() {
-        auto buffer = loadTZDB(filename_);
+        auto buffer = embedded_ == nullptr
+                          ? loadTZDB(filename_)
+                          : std::vector<unsigned char>(embedded_->data,
+                                                       embedded_->data + embedded_->length);
         impl_ = std::make_unique<TimezoneImpl>(filename_, std::move(buffer));
       });
       return impl_.get();
     }
 
    public:
-    LazyTimezone(const std::string& filename) : filename_(filename) {}
+    LazyTimezone(const std::string& filename) : filename_(filename), embedded_(nullptr) {}
+    LazyTimezone(const EmbeddedZone& embedded) : filename_(embedded.name), embedded_(&embedded) {}
 
     const TimezoneVariant& getVariant(int64_t clk) const override {
       return getImpl()->getVariant(clk);
     }
+    const TimezoneVariant& getVariant(int64_t clk, int64_t& start, int64_t& end) const override {
+      return getImpl()->getVariant(clk, start, end);
+    }
     int64_t getEpoch() const override {
       return getImpl()->getEpoch();
     }
@@ -761,6 +830,19 @@ namespace orc {
    * Results are cached.
    */
   const Timezone& getTimezoneByName(const std::string& zone) {
+    // An explicit TZDIR wins over the embedded database so that a newer
+    // release can be used without rebuilding the library.
+    const EmbeddedZone* embedded = getenv("TZDIR") ? nullptr : findEmbeddedZone(zone);
+    if (embedded != nullptr) {
+      // Cached by zone name, which cannot collide with the absolute paths
+      // used for files.
+      std::lock_guard<std::mutex> timezone_lock(timezone_mutex);
+      std::shared_ptr<Timezone>& result = timezoneCache[embedded->name];
+      if (!result) {
+        result = std::make_shared<LazyTimezone>(*embedded);
+      }
+      return *result;
+    }
     std::string filename(getTimezoneDirectory());
     filename += "/";
     filename += zone;
@@ -920,6 +1002,26 @@ namespace orc {
     }
   }
 
+  const TimezoneVariant& TimezoneImpl::getVariant(int64_t clk, int64_t& start,
+                                                  int64_t& end) const {
+    // the explicit table covers times up to and including lastTransition_
+    int64_t tableEnd = addSaturated(lastTransition_, 1);
+    if (clk > lastTransition_) {
+      const TimezoneVariant& variant = futureRule_->getVariant(clk, start, end);
+      start = std::max(start, tableEnd);
+      return variant;
+    }
+    int64_t transition = binarySearch(transitions_, clk);
+    uint64_t next = static_cast<uint64_t>(transition + 1);
+    start = transition < 0 ? INT64_MIN : transitions_[static_cast<size_t>(transition)];
+    end = std::min(next < transitions_.size() ? transitions_[next] : tableEnd, tableEnd);
+    if (start > clk || end <= clk) {
+      start = clk;
+      end = addSaturated(clk, 1);
+    }
+    return getVariant(clk);
+  }
+
   void TimezoneImpl::print(std::ostream& out) const {
     out << "Timezone file: " << filename_ << "\n";
     out << "  Version: " << version_ << "\n";
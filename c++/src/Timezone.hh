@@ -24,6 +24,7 @@
 #include "Adaptor.hh"
 
 #include <stdint.h>
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -63,6 +64,13 @@ namespace orc {
      */
     virtual const TimezoneVariant& getVariant(int64_t clk) const = 0;
 
+    /**
+     * Get the variant for the given time along with the range [start, end)
+     * of times that share it.
+     */
+    virtual const TimezoneVariant& getVariant(int64_t clk, int64_t& start,
+                                              int64_t& end) const = 0;
+
     /**
      * Get the number of seconds between the ORC epoch in this timezone
      * and Unix epoch.
@@ -90,6 +98,42 @@ namespace orc {
      * Convert UTC timezone to wall clock time of current timezone
      */
     virtual int64_t convertFromUTC(int64_t clk) const = 0;
+
+    /**
+     * Convert wall clock times of current timezone to UTC in place,
+     * skipping the null entries. The transitions are searched only when a
+     * value leaves the range of the previous variant.
+     */
+    void convertToUTC(int64_t* clk, uint64_t numValues, const char* notNull = nullptr) const;
+
+    /**
+     * Convert UTC times to wall clock times of current timezone in place,
+     * skipping the null entries.
+     */
+    void convertFromUTC(int64_t* clk, uint64_t numValues, const char* notNull = nullptr) const;
+  };
+
+  /**
+   * Remembers the last variant of a timezone together with the range of
+   * times it covers, so that runs of nearby times share one lookup.
+   */
+  class TimezoneVariantCache {
+   public:
+    explicit TimezoneVariantCache(const Timezone& timezone)
+        : timezone_(timezone), variant_(nullptr), start_(1), end_(0) {}
+
+    const TimezoneVariant& get(int64_t clk) {
+      if (clk < start_ || clk >= end_) {
+        variant_ = &timezone_.getVariant(clk, start_, end_);
+      }
+      return *variant_;
+    }
+
+   private:
+    const Timezone& timezone_;
+    const TimezoneVariant* variant_;
+    int64_t start_;
+    int64_t end_;
   };
 
   /**
@@ -110,6 +154,23 @@ namespace orc {
   std::unique_ptr<Timezone> getTimezone(const std::string& filename,
                                         const std::vector<unsigned char>& b);
 
+  /**
+   * A TZif file of the time zone database compiled into the library.
+   */
+  struct EmbeddedZone {
+    const char* name;
+    const unsigned char* data;
+    size_t length;
+  };
+
+  /**
+   * Find a zone in the time zone database that was embedded at compile time
+   * with BUILD_EMBEDDED_TZDATA.
+   * @return the zone or nullptr if the zone is unknown or the library was
+   *   built without an embedded database
+   */
+  const EmbeddedZone* findEmbeddedZone(const std::string& zone);
+
   class TimezoneError : public std::runtime_error {
    public:
     explicit TimezoneError(const std::string& what);
@@ -127,6 +188,8 @@ namespace orc {
     virtual ~FutureRule();
     virtual bool isDefined() const = 0;
     virtual const TimezoneVariant& getVariant(int64_t clk) const = 0;
+    virtual const TimezoneVariant& getVariant(int64_t clk, int64_t& start,
+                                              int64_t& end) const = 0;
     virtual void print(std::ostream& out) const = 0;
   };
 
@@ -0,0 +1,50 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Timezone.hh"
+
+#include <string.h>
+#include <algorithm>
+#include <iterator>
+
+#ifdef ORC_EMBEDDED_TZDATA
+// Defines EMBEDDED_ZONES, sorted by name. It is generated at build time by
+// cmake_modules/GenerateTzdata.cmake.
+#include "EmbeddedTzdata.inc"
+#endif
+
+namespace orc {
+
+  const EmbeddedZone* findEmbeddedZone(const std::string& zone) {
+#ifdef ORC_EMBEDDED_TZDATA
+    const EmbeddedZone* begin = std::begin(EMBEDDED_ZONES);
+    const EmbeddedZone* end = std::end(EMBEDDED_ZONES);
+    const EmbeddedZone* itr =
+        std::lower_bound(begin, end, zone.c_str(), [](const EmbeddedZone& entry, const char* key) {
+          return strcmp(entry.name, key) < 0;
+        });
+    if (itr != end && zone == itr->name) {
+      return itr;
+    }
+#else
+    (void)zone;
+#endif
+    return nullptr;
+  }
+
+}  // namespace orc
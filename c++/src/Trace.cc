@@ -0,0 +1,69 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/Trace.hh"
+
+namespace orc {
+
+  TraceRecorder::TraceRecorder() : start_(std::chrono::steady_clock::now()) {}
+
+  uint64_t TraceRecorder::now() const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - start_)
+                                     .count());
+  }
+
+  void TraceRecorder::addSpan(const char* name, const char* category, uint64_t startUs,
+                              std::vector<std::pair<const char*, uint64_t>> args) {
+    uint64_t end = now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto thread = threads_.emplace(std::this_thread::get_id(), threads_.size()).first->second;
+    spans_.push_back({name, category, startUs, end - startUs, thread, std::move(args)});
+  }
+
+  std::vector<TraceSpan> TraceRecorder::getSpans() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spans_;
+  }
+
+  void TraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    spans_.clear();
+  }
+
+  void TraceRecorder::writeChromeTrace(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << "{\"traceEvents\": [";
+    for (size_t i = 0; i < spans_.size(); ++i) {
+      const TraceSpan& span = spans_[i];
+      out << (i == 0 ? "\n" : ",\n") << "  {\"name\": \"" << span.name << "\", \"cat\": \""
+          << span.category << "\", \"ph\": \"X\", \"ts\": " << span.startUs
+          << ", \"dur\": " << span.durationUs << ", \"pid\": 1, \"tid\": " << span.thread;
+      if (!span.args.empty()) {
+        out << ", \"args\": {";
+        for (size_t j = 0; j < span.args.size(); ++j) {
+          out << (j == 0 ? "\"" : ", \"") << span.args[j].first << "\": " << span.args[j].second;
+        }
+        out << "}";
+      }
+      out << "}";
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+  }
+
+}  // namespace orc
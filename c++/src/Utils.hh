@@ -22,6 +22,10 @@
 #include <atomic>
 #include <chrono>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "orc/Trace.hh"
 
 namespace orc {
 
@@ -71,6 +75,48 @@ namespace orc {
 #define SCOPED_MINUS_STOPWATCH(METRICS_PTR, LATENCY_VAR)
 #endif
 
+  // The metrics of a column stream are only set when the reader has a
+  // ColumnMetricsTable, so they are measured in every build.
+#define SCOPED_STREAM_STOPWATCH(METRICS_PTR, LATENCY_VAR, COUNT_VAR)                           \
+  AutoStopwatch measureStream((METRICS_PTR == nullptr ? nullptr : &METRICS_PTR->LATENCY_VAR), \
+                              (METRICS_PTR == nullptr ? nullptr : &METRICS_PTR->COUNT_VAR))
+
+#define SCOPED_STREAM_MINUS_STOPWATCH(METRICS_PTR, LATENCY_VAR)                                \
+  AutoStopwatch measureStream((METRICS_PTR == nullptr ? nullptr : &METRICS_PTR->LATENCY_VAR), \
+                              nullptr, true)
+
+  // records a span from its construction to its destruction when the
+  // recorder is set
+  class ScopedTrace {
+    TraceRecorder* recorder_;
+    const char* category_;
+    const char* name_;
+    uint64_t startUs_;
+    std::vector<std::pair<const char*, uint64_t>> args_;
+
+   public:
+    ScopedTrace(TraceRecorder* recorder, const char* category, const char* name)
+        : recorder_(recorder),
+          category_(category),
+          name_(name),
+          startUs_(recorder == nullptr ? 0 : recorder->now()) {}
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    void addArg(const char* key, uint64_t value) {
+      if (recorder_) {
+        args_.emplace_back(key, value);
+      }
+    }
+
+    ~ScopedTrace() {
+      if (recorder_) {
+        recorder_->addSpan(name_, category_, startUs_, std::move(args_));
+      }
+    }
+  };
+
   struct Utf8Utils {
     /**
      * Counts how many utf-8 chars of the input data
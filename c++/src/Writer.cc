@@ -16,6 +16,7 @@
  * limitations under the License.
  */
 
+#include "orc/ArrowCData.hh"
 #include "orc/Common.hh"
 #include "orc/OrcFile.hh"
 
@@ -39,16 +40,19 @@ namespace orc {
     std::ostream* errorStream;
     FileVersion fileVersion;
     double dictionaryKeySizeThreshold;
+    uint64_t dictionarySampleSize;
     bool enableIndex;
     std::set<uint64_t> columnsUseBloomFilter;
     double bloomFilterFalsePositiveProb;
     BloomFilterVersion bloomFilterVersion;
     std::string timezone;
     WriterMetrics* metrics;
+    TraceRecorder* traceRecorder;
     bool useTightNumericVector;
     uint64_t outputBufferCapacity;
     uint64_t memoryBlockSize;
     bool alignBlockBoundToRowGroup;
+    bool asyncStripeFlush;
 
     WriterOptionsPrivate() : fileVersion(FileVersion::v_0_12()) {  // default to Hive_0_12
       stripeSize = 64 * 1024 * 1024;                               // 64M
@@ -60,6 +64,7 @@ namespace orc {
       paddingTolerance = 0.0;
       errorStream = &std::cerr;
       dictionaryKeySizeThreshold = 0.0;
+      dictionarySampleSize = 0;
       enableIndex = true;
       bloomFilterFalsePositiveProb = 0.01;
       bloomFilterVersion = UTF8;
@@ -68,10 +73,12 @@ namespace orc {
       // Explictly set the writer timezone if the use case depends on it.
       timezone = "GMT";
       metrics = nullptr;
+      traceRecorder = nullptr;
       useTightNumericVector = false;
       outputBufferCapacity = 1024 * 1024;
       memoryBlockSize = 64 * 1024;  // 64K
       alignBlockBoundToRowGroup = false;
+      asyncStripeFlush = false;
     }
   };
 
@@ -149,6 +156,15 @@ namespace orc {
     return privateBits_->dictionaryKeySizeThreshold;
   }
 
+  WriterOptions& WriterOptions::setDictionarySampleSize(uint64_t size) {
+    privateBits_->dictionarySampleSize = size;
+    return *this;
+  }
+
+  uint64_t WriterOptions::getDictionarySampleSize() const {
+    return privateBits_->dictionarySampleSize;
+  }
+
   WriterOptions& WriterOptions::setFileVersion(const FileVersion& version) {
     // Only Hive_0_11 and Hive_0_12 version are supported currently
     if (version.getMajor() == 0 && (version.getMinor() == 11 || version.getMinor() == 12)) {
@@ -274,6 +290,15 @@ namespace orc {
     return *this;
   }
 
+  TraceRecorder* WriterOptions::getTraceRecorder() const {
+    return privateBits_->traceRecorder;
+  }
+
+  WriterOptions& WriterOptions::setTraceRecorder(TraceRecorder* recorder) {
+    privateBits_->traceRecorder = recorder;
+    return *this;
+  }
+
   WriterOptions& WriterOptions::setUseTightNumericVector(bool useTightNumericVector) {
     privateBits_->useTightNumericVector = useTightNumericVector;
     return *this;
@@ -310,12 +335,27 @@ namespace orc {
     return privateBits_->alignBlockBoundToRowGroup;
   }
 
+  WriterOptions& WriterOptions::setAsyncStripeFlush(bool asyncStripeFlush) {
+    privateBits_->asyncStripeFlush = asyncStripeFlush;
+    return *this;
+  }
+
+  bool WriterOptions::getAsyncStripeFlush() const {
+    return privateBits_->asyncStripeFlush;
+  }
+
   Writer::~Writer() {
     // PASS
   }
 
+  void Writer::add(const ArrowSchema&, const ArrowArray&) {
+    throw NotImplementedYet("This writer does not support Arrow arrays");
+  }
+
   class WriterImpl : public Writer {
    private:
+    // declared first so that it outlives every stream writing into it
+    std::unique_ptr<DoubleBufferedOutputStream> asyncStream_;
     std::unique_ptr<ColumnWriter> columnWriter_;
     std::unique_ptr<BufferedOutputStream> compressionStream_;
     std::unique_ptr<BufferedOutputStream> bufferedStream_;
@@ -335,6 +375,8 @@ namespace orc {
     bool useTightNumericVector_;
     int32_t stripesAtLastFlush_;
     uint64_t lastFlushOffset_;
+    // reused by every add of an Arrow array
+    std::unique_ptr<ColumnVectorBatch> arrowBatch_;
 
    public:
     WriterImpl(const Type& type, OutputStream* stream, const WriterOptions& options);
@@ -343,6 +385,8 @@ namespace orc {
 
     void add(ColumnVectorBatch& rowsToAdd) override;
 
+    void add(const ArrowSchema& schema, const ArrowArray& array) override;
+
     void close() override;
 
     void addUserMetadata(const std::string& name, const std::string& value) override;
@@ -366,6 +410,14 @@ namespace orc {
 
   WriterImpl::WriterImpl(const Type& t, OutputStream* stream, const WriterOptions& opts)
       : outStream_(stream), options_(opts), type_(t) {
+    if (options_.getAsyncStripeFlush()) {
+      // every write goes through the staging stream so that the background
+      // flush of a stripe is always ordered before the bytes that follow it
+      asyncStream_ = std::make_unique<DoubleBufferedOutputStream>(
+          *options_.getMemoryPool(), stream, options_.getOutputBufferCapacity(),
+          options_.getWriterMetrics());
+      outStream_ = asyncStream_.get();
+    }
     streamsFactory_ = createStreamsFactory(options_, outStream_);
     columnWriter_ = buildWriter(type_, *streamsFactory_, options_);
     stripeRows_ = totalRows_ = indexRows_ = 0;
@@ -430,10 +482,20 @@ namespace orc {
     }
   }
 
+  void WriterImpl::add(const ArrowSchema& schema, const ArrowArray& array) {
+    if (arrowBatch_ == nullptr) {
+      arrowBatch_ = type_.createRowBatch(static_cast<uint64_t>(array.length),
+                                         *options_.getMemoryPool(), true, useTightNumericVector_);
+    }
+    importArrowBatch(type_, schema, array, *arrowBatch_);
+    add(*arrowBatch_);
+  }
+
   void WriterImpl::close() {
     if (stripeRows_ > 0) {
       writeStripe();
     }
+    ScopedTrace trace(options_.getTraceRecorder(), "write", "write footer");
     writeMetadata();
     writeFileFooter();
     writePostscript();
@@ -510,6 +572,9 @@ namespace orc {
   }
 
   void WriterImpl::writeStripe() {
+    ScopedTrace trace(options_.getTraceRecorder(), "write", "flush stripe");
+    trace.addArg("stripe", static_cast<uint64_t>(fileFooter_.stripes_size()));
+    trace.addArg("rows", stripeRows_);
     if (options_.getEnableIndex() && indexRows_ != 0) {
       columnWriter_->createRowIndexEntry();
       indexRows_ = 0;
@@ -580,9 +645,14 @@ namespace orc {
 
     currentOffset_ = currentOffset_ + indexLength + dataLength + footerLength;
     totalRows_ += stripeRows_;
+    trace.addArg("bytes", indexLength + dataLength + footerLength);
 
     columnWriter_->reset();
 
+    if (asyncStream_) {
+      asyncStream_->handOff();
+    }
+
     initStripe();
   }
 
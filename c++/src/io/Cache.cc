@@ -19,6 +19,7 @@
 #include <cassert>
 
 #include "Cache.hh"
+#include "Utils.hh"
 
 namespace orc {
 
@@ -135,6 +136,9 @@ namespace orc {
     bool hit_cache = false;
     if (it != entries_.end() && it->range.contains(range)) {
       hit_cache = it->future.valid();
+      ScopedTrace trace(traceRecorder_, "io", "cache wait");
+      trace.addArg("offset", range.offset);
+      trace.addArg("length", range.length);
       it->future.get();
       result = BufferSlice{it->buffer, range.offset - it->range.offset, range.length};
     }
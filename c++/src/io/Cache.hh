@@ -88,11 +88,13 @@ namespace orc {
    public:
     /// Construct a read cache with given options
     explicit ReadRangeCache(InputStream* stream, CacheOptions options, MemoryPool* memoryPool,
-                            ReaderMetrics* metrics = nullptr)
+                            ReaderMetrics* metrics = nullptr,
+                            TraceRecorder* traceRecorder = nullptr)
         : stream_(stream),
           options_(std::move(options)),
           memoryPool_(memoryPool),
-          metrics_(metrics) {}
+          metrics_(metrics),
+          traceRecorder_(traceRecorder) {}
 
     ~ReadRangeCache() = default;
 
@@ -117,6 +119,7 @@ namespace orc {
     std::vector<RangeCacheEntry> entries_;
     MemoryPool* memoryPool_;
     ReaderMetrics* metrics_;
+    TraceRecorder* traceRecorder_;
   };
 
 }  // namespace orc
@@ -155,4 +155,87 @@ namespace orc {
     buffer_ = nullptr;
   }
 
+  DoubleBufferedOutputStream::DoubleBufferedOutputStream(MemoryPool& pool, OutputStream* outStream,
+                                                         uint64_t blockSize,
+                                                         WriterMetrics* metrics)
+      : outputStream_(outStream),
+        activeBuffer_(std::make_unique<BlockBuffer>(pool, blockSize)),
+        flushingBuffer_(std::make_unique<BlockBuffer>(pool, blockSize)),
+        chunk_(pool, BlockBuffer::getChunkSize(outStream)),
+        length_(outStream->getLength()),
+        naturalWriteSize_(outStream->getNaturalWriteSize()),
+        metrics_(metrics) {
+    // PASS
+  }
+
+  DoubleBufferedOutputStream::~DoubleBufferedOutputStream() {
+    // the buffer being written must outlive the background task
+    if (pendingFlush_.valid()) {
+      pendingFlush_.wait();
+    }
+  }
+
+  uint64_t DoubleBufferedOutputStream::getLength() const {
+    return length_;
+  }
+
+  uint64_t DoubleBufferedOutputStream::getNaturalWriteSize() const {
+    return naturalWriteSize_;
+  }
+
+  void DoubleBufferedOutputStream::write(const void* buf, size_t length) {
+    const char* data = static_cast<const char*>(buf);
+    while (length > 0) {
+      BlockBuffer::Block block = activeBuffer_->getNextBlock();
+      uint64_t copySize = std::min(block.size, static_cast<uint64_t>(length));
+      memcpy(block.data, data, copySize);
+      // give back the unused tail of the block
+      activeBuffer_->resize(activeBuffer_->size() - (block.size - copySize));
+      data += copySize;
+      length -= copySize;
+      length_ += copySize;
+    }
+  }
+
+  const std::string& DoubleBufferedOutputStream::getName() const {
+    return outputStream_->getName();
+  }
+
+  void DoubleBufferedOutputStream::handOff() {
+    drain();
+    if (activeBuffer_->size() == 0) {
+      return;
+    }
+    std::swap(activeBuffer_, flushingBuffer_);
+    BlockBuffer* buffer = flushingBuffer_.get();
+    OutputStream* output = outputStream_;
+    char* chunk = chunk_.data();
+    uint64_t chunkSize = chunk_.size();
+    // the memory pool is only used on this thread
+    pendingFlush_ = std::async(std::launch::async, [buffer, output, chunk, chunkSize]() {
+      buffer->writeTo(output, nullptr, chunk, chunkSize);
+      buffer->resize(0);
+    });
+  }
+
+  void DoubleBufferedOutputStream::drain() {
+    if (pendingFlush_.valid()) {
+      // time spent here is the I/O latency that could not be hidden
+      SCOPED_STOPWATCH(metrics_, IOBlockingLatencyUs, IOCount);
+      pendingFlush_.get();
+    }
+  }
+
+  void DoubleBufferedOutputStream::flush() {
+    handOff();
+    drain();
+    outputStream_->flush();
+  }
+
+  void DoubleBufferedOutputStream::close() {
+    handOff();
+    drain();
+    outputStream_->close();
+  }
+
 }  // namespace orc
@@ -24,6 +24,8 @@
 #include "orc/OrcFile.hh"
 #include "wrap/zero-copy-stream-wrapper.h"
 
+#include <future>
+
 namespace orc {
 
   /**
@@ -104,6 +106,53 @@ namespace orc {
 
     void recordPosition(PositionRecorder* recorder) const;
   };
+
+  /**
+   * An OutputStream that stages the bytes of a stripe in memory and writes
+   * them to the underlying OutputStream on a background thread once the
+   * stripe is handed off, so that encoding of the next stripe overlaps with
+   * the I/O of the previous one. At most two stripes are buffered at any
+   * time: the one being filled and the one being written. Both buffers and
+   * the staging chunk of the writes are allocated from the writer's memory
+   * pool on the caller's thread, so the pool does not need to be thread-safe.
+   */
+  class DoubleBufferedOutputStream : public OutputStream {
+   private:
+    OutputStream* outputStream_;
+    std::unique_ptr<BlockBuffer> activeBuffer_;
+    std::unique_ptr<BlockBuffer> flushingBuffer_;
+    // the background write copies the blocks through it
+    DataBuffer<char> chunk_;
+    std::future<void> pendingFlush_;
+    // bytes accepted from the caller, whether written out or still buffered
+    uint64_t length_;
+    uint64_t naturalWriteSize_;
+    WriterMetrics* metrics_;
+
+   public:
+    DoubleBufferedOutputStream(MemoryPool& pool, OutputStream* outStream, uint64_t blockSize,
+                               WriterMetrics* metrics);
+    ~DoubleBufferedOutputStream() override;
+
+    uint64_t getLength() const override;
+    uint64_t getNaturalWriteSize() const override;
+    void write(const void* buf, size_t length) override;
+    const std::string& getName() const override;
+    void close() override;
+    void flush() override;
+
+    /**
+     * Hand the bytes staged so far over to the background writer. Blocks
+     * until the previous hand-off has been written, and rethrows any error
+     * raised while writing it.
+     */
+    void handOff();
+
+    /**
+     * Wait for the in-flight background write, if any, to finish.
+     */
+    void drain();
+  };
 }  // namespace orc
 
 #endif  // ORC_OUTPUTSTREAM_HH
@@ -19,7 +19,9 @@
 #include "PredicateLeaf.hh"
 #include "orc/BloomFilter.hh"
 #include "orc/Common.hh"
+#include "orc/Exceptions.hh"
 #include "orc/Type.hh"
+#include "orc/Vector.hh"
 
 #include <algorithm>
 #include <functional>
@@ -724,4 +726,71 @@ namespace orc {
     }
   }
 
+  template <typename BatchType>
+  static const BatchType& castBatch(const ColumnVectorBatch& batch) {
+    const BatchType* result = dynamic_cast<const BatchType*>(&batch);
+    if (result == nullptr) {
+      throw InvalidArgument("Column batch does not match the type of the predicate leaf");
+    }
+    return *result;
+  }
+
+  TruthValue PredicateLeaf::evaluate(const ColumnVectorBatch* batch, uint64_t row) const {
+    bool isNull = batch == nullptr || (batch->hasNulls && !batch->notNull[row]);
+    if (operator_ == Operator::IS_NULL ||
+        ((operator_ == Operator::EQUALS || operator_ == Operator::NULL_SAFE_EQUALS) &&
+         literals_.at(0).isNull())) {
+      return isNull ? TruthValue::YES : TruthValue::NO;
+    } else if (isNull) {
+      return operator_ == Operator::NULL_SAFE_EQUALS ? TruthValue::NO : TruthValue::IS_NULL;
+    }
+
+    // a range that holds a single value has exact answers, except for null
+    // safe equals that never looks at the values
+    Operator op = operator_ == Operator::NULL_SAFE_EQUALS ? Operator::EQUALS : operator_;
+    switch (type_) {
+      case PredicateDataType::LONG: {
+        int64_t value = castBatch<LongVectorBatch>(*batch).data[row];
+        return evaluatePredicateRange(op, literal2Long(literals_), value, value, false);
+      }
+      case PredicateDataType::FLOAT: {
+        double value = castBatch<DoubleVectorBatch>(*batch).data[row];
+        return evaluatePredicateRange(op, literal2Double(literals_), value, value, false);
+      }
+      case PredicateDataType::STRING: {
+        const auto& strings = castBatch<StringVectorBatch>(*batch);
+        std::string value(strings.data[row], static_cast<size_t>(strings.length[row]));
+        return evaluatePredicateRange(op, literal2String(literals_), value, value, false);
+      }
+      case PredicateDataType::DATE: {
+        int32_t value = static_cast<int32_t>(castBatch<LongVectorBatch>(*batch).data[row]);
+        return evaluatePredicateRange(op, literal2Date(literals_), value, value, false);
+      }
+      case PredicateDataType::DECIMAL: {
+        Decimal value;
+        if (auto decimals = dynamic_cast<const Decimal64VectorBatch*>(batch)) {
+          value = Decimal(Int128(decimals->values[row]), decimals->scale);
+        } else {
+          const auto& decimals128 = castBatch<Decimal128VectorBatch>(*batch);
+          value = Decimal(decimals128.values[row], decimals128.scale);
+        }
+        return evaluatePredicateRange(op, literal2Decimal(literals_), value, value, false);
+      }
+      case PredicateDataType::BOOLEAN: {
+        // compare as 0 and 1 since iterating a vector<bool> yields no references
+        int64_t value = castBatch<LongVectorBatch>(*batch).data[row] != 0;
+        std::vector<int64_t> literals;
+        for (const auto& literal : literals_) {
+          if (!literal.isNull()) {
+            literals.push_back(literal.getBool());
+          }
+        }
+        return evaluatePredicateRange(op, literals, value, value, false);
+      }
+      case PredicateDataType::TIMESTAMP:
+      default:
+        throw NotImplementedYet("Timestamp predicates cannot be evaluated on single values");
+    }
+  }
+
 }  // namespace orc
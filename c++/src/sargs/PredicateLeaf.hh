@@ -32,6 +32,7 @@ namespace orc {
   static constexpr uint64_t INVALID_COLUMN_ID = std::numeric_limits<uint64_t>::max();
 
   class BloomFilter;
+  struct ColumnVectorBatch;
 
   /**
    * The primitive predicates that form a SearchArgument.
@@ -122,6 +123,15 @@ namespace orc {
     TruthValue evaluate(const WriterVersion writerVersion, const proto::ColumnStatistics& colStats,
                         const BloomFilter* bloomFilter) const;
 
+    /**
+     * Evaluate current PredicateLeaf on a single value of a batch. The
+     * result is one of YES, NO and IS_NULL. Timestamps are not supported.
+     * @param batch the batch of the column, or nullptr if the column does
+     * not exist and every value is null
+     * @param row the position of the value in the batch
+     */
+    TruthValue evaluate(const ColumnVectorBatch* batch, uint64_t row) const;
+
     std::string toString() const;
 
     bool operator==(const PredicateLeaf& r) const;
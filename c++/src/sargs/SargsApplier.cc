@@ -69,46 +69,23 @@ namespace orc {
     uint64_t groupsInStripe = (rowsInStripe + rowIndexStride_ - 1) / rowIndexStride_;
     nextSkippedRows_.resize(groupsInStripe);
     totalRowsInStripe_ = rowsInStripe;
+    matchedRowGroups_.clear();
 
     // row indexes do not exist, simply read all rows
     if (rowIndexes.empty()) {
       return true;
     }
 
-    const auto& leaves = dynamic_cast<const SearchArgumentImpl*>(searchArgument_)->getLeaves();
-    std::vector<TruthValue> leafValues(leaves.size(), TruthValue::YES_NO_NULL);
+    matchedRowGroups_.assign(groupsInStripe, false);
     hasSelected_ = false;
     hasSkipped_ = false;
     uint64_t nextSkippedRowGroup = groupsInStripe;
     size_t rowGroup = groupsInStripe;
     do {
       --rowGroup;
-      for (size_t pred = 0; pred != leaves.size(); ++pred) {
-        uint64_t columnIdx = filterColumns_[pred];
-        auto rowIndexIter = rowIndexes.find(columnIdx);
-        if (columnIdx == INVALID_COLUMN_ID || rowIndexIter == rowIndexes.cend()) {
-          // this column does not exist in current file
-          leafValues[pred] = TruthValue::YES_NO_NULL;
-        } else if (schemaEvolution_ && !schemaEvolution_->isSafePPDConversion(columnIdx)) {
-          // cannot evaluate predicate when ppd is not safe
-          leafValues[pred] = TruthValue::YES_NO_NULL;
-        } else {
-          // get column statistics
-          const proto::ColumnStatistics& statistics =
-              rowIndexIter->second.entry(static_cast<int>(rowGroup)).statistics();
-
-          // get bloom filter
-          std::shared_ptr<BloomFilter> bloomFilter;
-          auto iter = bloomFilters.find(static_cast<uint32_t>(columnIdx));
-          if (iter != bloomFilters.cend()) {
-            bloomFilter = iter->second.entries.at(rowGroup);
-          }
-
-          leafValues[pred] = leaves[pred].evaluate(writerVersion_, statistics, bloomFilter.get());
-        }
-      }
-
-      bool needed = isNeeded(searchArgument_->evaluate(leafValues));
+      TruthValue result = evaluateRowGroup(rowGroup, rowIndexes, bloomFilters);
+      bool needed = isNeeded(result);
+      matchedRowGroups_[rowGroup] = result == TruthValue::YES;
       if (!needed) {
         nextSkippedRows_[rowGroup] = 0;
         nextSkippedRowGroup = rowGroup;
@@ -133,7 +110,43 @@ namespace orc {
     return hasSelected_;
   }
 
+  TruthValue SargsApplier::evaluateRowGroup(
+      uint64_t rowGroup, const std::unordered_map<uint64_t, proto::RowIndex>& rowIndexes,
+      const std::map<uint32_t, BloomFilterIndex>& bloomFilters) const {
+    const auto& leaves = dynamic_cast<const SearchArgumentImpl*>(searchArgument_)->getLeaves();
+    std::vector<TruthValue> leafValues(leaves.size(), TruthValue::YES_NO_NULL);
+    for (size_t pred = 0; pred != leaves.size(); ++pred) {
+      uint64_t columnIdx = filterColumns_[pred];
+      auto rowIndexIter = rowIndexes.find(columnIdx);
+      if (columnIdx == INVALID_COLUMN_ID || rowIndexIter == rowIndexes.cend()) {
+        // this column does not exist in current file
+        leafValues[pred] = TruthValue::YES_NO_NULL;
+      } else if (schemaEvolution_ && !schemaEvolution_->isSafePPDConversion(columnIdx)) {
+        // cannot evaluate predicate when ppd is not safe
+        leafValues[pred] = TruthValue::YES_NO_NULL;
+      } else {
+        // get column statistics
+        const proto::ColumnStatistics& statistics =
+            rowIndexIter->second.entry(static_cast<int>(rowGroup)).statistics();
+
+        // get bloom filter
+        std::shared_ptr<BloomFilter> bloomFilter;
+        auto iter = bloomFilters.find(static_cast<uint32_t>(columnIdx));
+        if (iter != bloomFilters.cend()) {
+          bloomFilter = iter->second.entries.at(rowGroup);
+        }
+
+        leafValues[pred] = leaves[pred].evaluate(writerVersion_, statistics, bloomFilter.get());
+      }
+    }
+    return searchArgument_->evaluate(leafValues);
+  }
+
   bool SargsApplier::evaluateColumnStatistics(const PbColumnStatistics& colStats) const {
+    return isNeeded(evaluateStatistics(colStats));
+  }
+
+  TruthValue SargsApplier::evaluateStatistics(const PbColumnStatistics& colStats) const {
     const SearchArgumentImpl* sargs = dynamic_cast<const SearchArgumentImpl*>(searchArgument_);
     if (sargs == nullptr) {
       throw InvalidArgument("Failed to cast to SearchArgumentImpl");
@@ -150,7 +163,7 @@ namespace orc {
       }
     }
 
-    return isNeeded(searchArgument_->evaluate(leafValues));
+    return searchArgument_->evaluate(leafValues);
   }
 
   bool SargsApplier::evaluateStripeStatistics(const proto::StripeStatistics& stripeStats,
@@ -166,6 +179,7 @@ namespace orc {
     if (!ret) {
       // reset mNextSkippedRows when the current stripe does not satisfy the PPD
       nextSkippedRows_.clear();
+      matchedRowGroups_.clear();
     }
     return ret;
   }
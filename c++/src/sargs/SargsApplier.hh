@@ -35,6 +35,8 @@ namespace orc {
 
   class SargsApplier {
    public:
+    typedef ::google::protobuf::RepeatedPtrField<proto::ColumnStatistics> PbColumnStatistics;
+
     SargsApplier(const Type& type, const SearchArgument* searchArgument, uint64_t rowIndexStride,
                  WriterVersion writerVersion, ReaderMetrics* metrics,
                  const SchemaEvolution* schemaEvolution = nullptr);
@@ -69,6 +71,31 @@ namespace orc {
                        const std::unordered_map<uint64_t, proto::RowIndex>& rowIndexes,
                        const std::map<uint32_t, BloomFilterIndex>& bloomFilters);
 
+    /**
+     * Evaluate search argument on the statistics of a file or a stripe.
+     * Metrics are not updated.
+     * @return YES if every row matches, NO or NO_NULL if none does
+     */
+    TruthValue evaluateStatistics(const PbColumnStatistics& colStats) const;
+
+    /**
+     * Evaluate search argument on the row index and bloom filters of a row
+     * group. Metrics are not updated.
+     * @return YES if every row of the row group matches, NO or NO_NULL if
+     * none does
+     */
+    TruthValue evaluateRowGroup(uint64_t rowGroup,
+                                const std::unordered_map<uint64_t, proto::RowIndex>& rowIndexes,
+                                const std::map<uint32_t, BloomFilterIndex>& bloomFilters) const;
+
+    /**
+     * Column ids for each predicate leaf in the search argument.
+     * INVALID_COLUMN_ID marks a leaf whose column is not in the file.
+     */
+    const std::vector<uint64_t>& getFilterColumns() const {
+      return filterColumns_;
+    }
+
     /**
      * Return a vector of the next skipped row for each RowGroup. Each value is the row id
      * in stripe. 0 means the current RowGroup is entirely skipped.
@@ -78,6 +105,15 @@ namespace orc {
       return nextSkippedRows_;
     }
 
+    /**
+     * Return whether every row of each RowGroup matches the search argument,
+     * i.e. its statistics evaluate to YES. Only valid after invoking
+     * pickRowGroups(); empty when the stripe has no row indexes.
+     */
+    const std::vector<bool>& getMatchedRowGroups() const {
+      return matchedRowGroups_;
+    }
+
     /**
      * Indicate whether any row group is selected in the last evaluation
      */
@@ -116,7 +152,6 @@ namespace orc {
 
    private:
     // evaluate column statistics in the form of protobuf::RepeatedPtrField
-    typedef ::google::protobuf::RepeatedPtrField<proto::ColumnStatistics> PbColumnStatistics;
     bool evaluateColumnStatistics(const PbColumnStatistics& colStats) const;
 
     friend class TestSargsApplier_findColumnTest_Test;
@@ -137,6 +172,8 @@ namespace orc {
     // locates. If the RowGroup is not selected, set the value to 0.
     // Calculated in pickRowGroups().
     std::vector<uint64_t> nextSkippedRows_;
+    // Whether each RowGroup evaluates to YES. Calculated in pickRowGroups().
+    std::vector<bool> matchedRowGroups_;
     uint64_t totalRowsInStripe_;
     bool hasSelected_;
     bool hasSkipped_;
@@ -27,6 +27,14 @@ namespace orc {
     return getDefaultReaderMetrics();
   }
 
+  TraceRecorder* MockStripeStreams::getTraceRecorder() const {
+    return nullptr;
+  }
+
+  ColumnMetricsTable* MockStripeStreams::getColumnMetricsTable() const {
+    return nullptr;
+  }
+
   const Timezone& MockStripeStreams::getWriterTimezone() const {
     return getTimezoneByName("America/Los_Angeles");
   }
@@ -46,6 +46,10 @@ namespace orc {
 
     ReaderMetrics* getReaderMetrics() const override;
 
+    TraceRecorder* getTraceRecorder() const override;
+
+    ColumnMetricsTable* getColumnMetricsTable() const override;
+
     const Timezone& getWriterTimezone() const override;
 
     const Timezone& getReaderTimezone() const override;
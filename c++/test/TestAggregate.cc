@@ -0,0 +1,195 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MemoryInputStream.hh"
+#include "MemoryOutputStream.hh"
+#include "orc/OrcFile.hh"
+#include "orc/sargs/SearchArgument.hh"
+#include "wrap/gtest-wrapper.h"
+
+#include <functional>
+
+namespace orc {
+
+  static const int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;  // 10M
+  static const uint64_t ROW_COUNT = 10000;
+
+  // id is the row number, val is id % 100 and null for every 50th row, name
+  // is "n" followed by the last digit of id
+  static std::unique_ptr<Reader> createAggregateReader(MemoryOutputStream& memStream) {
+    auto type = Type::buildTypeFromString("struct<id:bigint,val:int,name:string>");
+    WriterOptions options;
+    options.setStripeSize(1024)
+        .setCompressionBlockSize(1024)
+        .setMemoryBlockSize(64)
+        .setCompression(CompressionKind_ZLIB)
+        .setRowIndexStride(1000);
+    auto writer = createWriter(*type, &memStream, options);
+    auto batch = writer->createRowBatch(1000);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& ids = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& vals = dynamic_cast<LongVectorBatch&>(*structBatch.fields[1]);
+    auto& names = dynamic_cast<StringVectorBatch&>(*structBatch.fields[2]);
+    static const char* const NAMES = "n0n1n2n3n4n5n6n7n8n9";
+    for (uint64_t start = 0; start < ROW_COUNT; start += 1000) {
+      vals.hasNulls = true;
+      for (uint64_t i = 0; i < 1000; ++i) {
+        int64_t id = static_cast<int64_t>(start + i);
+        ids.data[i] = id;
+        vals.data[i] = id % 100;
+        vals.notNull[i] = id % 50 != 0;
+        names.data[i] = const_cast<char*>(NAMES + 2 * (id % 10));
+        names.length[i] = 2;
+      }
+      structBatch.numElements = ids.numElements = vals.numElements = names.numElements = 1000;
+      writer->add(*batch);
+    }
+    writer->close();
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    return createReader(std::move(inStream), ReaderOptions());
+  }
+
+  // check the aggregate of val against the rows whose id matches
+  static void checkValAggregate(const ColumnAggregate& aggregate,
+                                const std::function<bool(int64_t)>& matches) {
+    uint64_t rows = 0;
+    uint64_t values = 0;
+    int64_t sum = 0;
+    int64_t minimum = 100;
+    int64_t maximum = -1;
+    for (int64_t id = 0; id < static_cast<int64_t>(ROW_COUNT); ++id) {
+      if (matches(id)) {
+        ++rows;
+        if (id % 50 != 0) {
+          ++values;
+          sum += id % 100;
+          minimum = std::min(minimum, id % 100);
+          maximum = std::max(maximum, id % 100);
+        }
+      }
+    }
+    EXPECT_EQ(rows, aggregate.numberOfRows);
+    auto& stats = dynamic_cast<const IntegerColumnStatistics&>(*aggregate.statistics);
+    EXPECT_EQ(values, stats.getNumberOfValues());
+    EXPECT_EQ(rows != values, stats.hasNull());
+    if (values > 0) {
+      EXPECT_EQ(sum, stats.getSum());
+      EXPECT_EQ(minimum, stats.getMinimum());
+      EXPECT_EQ(maximum, stats.getMaximum());
+    } else {
+      EXPECT_FALSE(stats.hasMinimum());
+    }
+  }
+
+  TEST(TestAggregate, withoutSearchArgument) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    auto reader = createAggregateReader(memStream);
+    ASSERT_GT(reader->getNumberOfStripes(), 1);
+
+    ColumnAggregate aggregate = aggregateColumn(reader.get(), 2);
+    EXPECT_EQ(0, aggregate.decodedRowGroups);
+    checkValAggregate(aggregate, [](int64_t) { return true; });
+
+    aggregate = aggregateColumn(reader.get(), 0);
+    EXPECT_EQ(ROW_COUNT, aggregate.numberOfRows);
+    EXPECT_EQ(ROW_COUNT, aggregate.statistics->getNumberOfValues());
+
+    EXPECT_THROW(aggregateColumn(reader.get(), 4), InvalidArgument);
+  }
+
+  TEST(TestAggregate, rowGroupStatistics) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    auto reader = createAggregateReader(memStream);
+
+    // row groups 0 to 2 match entirely and only row group 3 is read
+    auto sarg = SearchArgumentFactory::newBuilder()
+                    ->lessThan("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(3456)))
+                    .build();
+    ColumnAggregate aggregate = aggregateColumn(reader.get(), 2, sarg.get());
+    EXPECT_EQ(1, aggregate.decodedRowGroups);
+    checkValAggregate(aggregate, [](int64_t id) { return id < 3456; });
+
+    aggregate = aggregateColumn(reader.get(), 3, sarg.get());
+    EXPECT_EQ(3456, aggregate.numberOfRows);
+    auto& names = dynamic_cast<const StringColumnStatistics&>(*aggregate.statistics);
+    EXPECT_EQ(3456, names.getNumberOfValues());
+    EXPECT_EQ("n0", names.getMinimum());
+    EXPECT_EQ("n9", names.getMaximum());
+    EXPECT_EQ(3456 * 2, names.getTotalLength());
+
+    // row group boundaries need no rows at all
+    sarg = SearchArgumentFactory::newBuilder()
+               ->between("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(2000)),
+                         Literal(static_cast<int64_t>(4999)))
+               .build();
+    aggregate = aggregateColumn(reader.get(), 2, sarg.get());
+    EXPECT_EQ(0, aggregate.decodedRowGroups);
+    checkValAggregate(aggregate, [](int64_t id) { return id >= 2000 && id <= 4999; });
+
+    // no row matches
+    sarg = SearchArgumentFactory::newBuilder()
+               ->startNot()
+               .lessThan("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(ROW_COUNT)))
+               .end()
+               .build();
+    aggregate = aggregateColumn(reader.get(), 2, sarg.get());
+    EXPECT_EQ(0, aggregate.decodedRowGroups);
+    checkValAggregate(aggregate, [](int64_t) { return false; });
+  }
+
+  TEST(TestAggregate, rowLevelEvaluation) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    auto reader = createAggregateReader(memStream);
+
+    // statistics cannot decide val = 7, so every row group is read
+    auto sarg = SearchArgumentFactory::newBuilder()
+                    ->startOr()
+                    .equals("val", PredicateDataType::LONG, Literal(static_cast<int64_t>(7)))
+                    .in("name", PredicateDataType::STRING, {Literal("n3", 2), Literal("n5", 2)})
+                    .end()
+                    .build();
+    ColumnAggregate aggregate = aggregateColumn(reader.get(), 2, sarg.get());
+    EXPECT_EQ(ROW_COUNT / 1000, aggregate.decodedRowGroups);
+    checkValAggregate(aggregate,
+                      [](int64_t id) { return id % 100 == 7 || id % 10 == 3 || id % 10 == 5; });
+
+    // null values of val never match, but the rows still count
+    sarg = SearchArgumentFactory::newBuilder()
+               ->startAnd()
+               .lessThan("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(1500)))
+               .startNot()
+               .lessThan("val", PredicateDataType::LONG, Literal(static_cast<int64_t>(60)))
+               .end()
+               .end()
+               .build();
+    aggregate = aggregateColumn(reader.get(), 1, sarg.get());
+    uint64_t expected = 0;
+    for (int64_t id = 0; id < 1500; ++id) {
+      expected += id % 50 != 0 && id % 100 >= 60;
+    }
+    EXPECT_EQ(expected, aggregate.numberOfRows);
+
+    sarg = SearchArgumentFactory::newBuilder()
+               ->isNull("val", PredicateDataType::LONG)
+               .build();
+    aggregate = aggregateColumn(reader.get(), 2, sarg.get());
+    checkValAggregate(aggregate, [](int64_t id) { return id % 50 == 0; });
+  }
+
+}  // namespace orc
@@ -0,0 +1,675 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/ArrowCData.hh"
+#include "orc/OrcFile.hh"
+
+#include "MemoryInputStream.hh"
+#include "MemoryOutputStream.hh"
+
+#include "wrap/gtest-wrapper.h"
+
+#include <cstring>
+
+namespace orc {
+
+  const int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;  // 10M
+
+  static bool isValid(const ArrowArray& array, uint64_t row) {
+    auto bits = static_cast<const uint8_t*>(array.buffers[0]);
+    return bits == nullptr || (bits[row / 8] >> (row % 8)) & 1;
+  }
+
+  static std::string getString(const ArrowArray& array, uint64_t row) {
+    auto offsets = static_cast<const int32_t*>(array.buffers[1]);
+    auto data = static_cast<const char*>(array.buffers[2]);
+    return std::string(data + offsets[row], static_cast<size_t>(offsets[row + 1] - offsets[row]));
+  }
+
+  TEST(ArrowCData, exportSchema) {
+    std::unique_ptr<Type> type(Type::buildTypeFromString(
+        "struct<a:boolean,b:tinyint,c:smallint,d:int,e:bigint,f:float,g:double,h:string,"
+        "i:binary,j:timestamp,k:timestamp with local time zone,l:date,m:decimal(10,2),"
+        "n:array<char(3)>,o:map<varchar(5),decimal(30,4)>,p:uniontype<int,string>>"));
+    ArrowSchema schema;
+    exportArrowSchema(*type, &schema);
+
+    EXPECT_STREQ("+s", schema.format);
+    EXPECT_STREQ("", schema.name);
+    ASSERT_EQ(16, schema.n_children);
+    const char* formats[] = {"b",   "c",       "s",   "i",      "l",  "f",  "g",      "u",
+                             "z",   "tsn:",    "tsn:UTC", "tdD", "d:10,2", "+L", "+m", "+ud:0,1"};
+    for (int64_t i = 0; i < schema.n_children; ++i) {
+      EXPECT_STREQ(formats[i], schema.children[i]->format);
+      EXPECT_EQ(std::string(1, static_cast<char>('a' + i)), schema.children[i]->name);
+      EXPECT_EQ(ARROW_FLAG_NULLABLE, schema.children[i]->flags);
+      EXPECT_EQ(nullptr, schema.children[i]->dictionary);
+    }
+
+    ArrowSchema* list = schema.children[13];
+    ASSERT_EQ(1, list->n_children);
+    EXPECT_STREQ("item", list->children[0]->name);
+    EXPECT_STREQ("u", list->children[0]->format);
+
+    ArrowSchema* entries = schema.children[14]->children[0];
+    EXPECT_STREQ("+s", entries->format);
+    EXPECT_EQ(0, entries->flags);
+    ASSERT_EQ(2, entries->n_children);
+    EXPECT_STREQ("key", entries->children[0]->name);
+    EXPECT_EQ(0, entries->children[0]->flags);
+    EXPECT_STREQ("d:30,4", entries->children[1]->format);
+
+    // a child moved out by the consumer outlives its parent
+    ArrowSchema moved = *schema.children[7];
+    schema.children[7]->release = nullptr;
+    schema.release(&schema);
+    EXPECT_EQ(nullptr, schema.release);
+    EXPECT_STREQ("h", moved.name);
+    moved.release(&moved);
+  }
+
+  TEST(ArrowCData, exportNumbers) {
+    MemoryPool* pool = getDefaultPool();
+    std::unique_ptr<Type> type(
+        Type::buildTypeFromString("struct<a:boolean,b:int,c:bigint,d:float,e:decimal(10,2)>"));
+    const uint64_t rowCount = 21;
+
+    for (bool tight : {false, true}) {
+      auto batch = type->createRowBatch(rowCount, *pool, false, tight);
+      auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+      auto* decimals = dynamic_cast<Decimal64VectorBatch*>(structBatch->fields[4]);
+      for (uint64_t i = 0; i < rowCount; ++i) {
+        int64_t value = static_cast<int64_t>(i) - 10;
+        if (tight) {
+          dynamic_cast<ByteVectorBatch*>(structBatch->fields[0])->data[i] = i % 3 == 0;
+          dynamic_cast<IntVectorBatch*>(structBatch->fields[1])->data[i] =
+              static_cast<int32_t>(value);
+          dynamic_cast<FloatVectorBatch*>(structBatch->fields[3])->data[i] =
+              static_cast<float>(value) / 2;
+        } else {
+          dynamic_cast<LongVectorBatch*>(structBatch->fields[0])->data[i] = i % 3 == 0;
+          dynamic_cast<LongVectorBatch*>(structBatch->fields[1])->data[i] = value;
+          dynamic_cast<DoubleVectorBatch*>(structBatch->fields[3])->data[i] =
+              static_cast<double>(value) / 2;
+        }
+        dynamic_cast<LongVectorBatch*>(structBatch->fields[2])->data[i] = value * 1000000000000;
+        decimals->values[i] = value * 123;
+        structBatch->fields[1]->notNull[i] = i % 5 != 0;
+      }
+      structBatch->fields[1]->hasNulls = true;
+      for (auto* field : structBatch->fields) {
+        field->numElements = rowCount;
+      }
+      structBatch->numElements = rowCount;
+
+      ArrowSchema schema;
+      ArrowArray array;
+      exportArrowBatch(*type, *batch, &schema, &array);
+      ASSERT_EQ(5, array.n_children);
+      EXPECT_EQ(static_cast<int64_t>(rowCount), array.length);
+      EXPECT_EQ(0, array.null_count);
+      EXPECT_EQ(nullptr, array.buffers[0]);
+
+      // 64-bit integers always, narrower numbers only in tight batches
+      auto* longBatch = dynamic_cast<LongVectorBatch*>(structBatch->fields[2]);
+      EXPECT_EQ(longBatch->data.data(), array.children[2]->buffers[1]);
+      auto* intBatch = dynamic_cast<IntVectorBatch*>(structBatch->fields[1]);
+      EXPECT_EQ(tight,
+                intBatch != nullptr && array.children[1]->buffers[1] == intBatch->data.data());
+      EXPECT_EQ(5, array.children[1]->null_count);
+
+      auto booleans = static_cast<const uint8_t*>(array.children[0]->buffers[1]);
+      auto ints = static_cast<const int32_t*>(array.children[1]->buffers[1]);
+      auto longs = static_cast<const int64_t*>(array.children[2]->buffers[1]);
+      auto floats = static_cast<const float*>(array.children[3]->buffers[1]);
+      auto decimalWords = static_cast<const int64_t*>(array.children[4]->buffers[1]);
+      for (uint64_t i = 0; i < rowCount; ++i) {
+        int64_t value = static_cast<int64_t>(i) - 10;
+        EXPECT_EQ(i % 3 == 0, (booleans[i / 8] >> (i % 8)) & 1) << i;
+        EXPECT_EQ(i % 5 != 0, isValid(*array.children[1], i)) << i;
+        if (i % 5 != 0) {
+          EXPECT_EQ(value, ints[i]) << i;
+        }
+        EXPECT_EQ(value * 1000000000000, longs[i]) << i;
+        EXPECT_EQ(static_cast<float>(value) / 2, floats[i]) << i;
+        EXPECT_EQ(value * 123, decimalWords[2 * i]) << i;
+        EXPECT_EQ(value < 0 ? -1 : 0, decimalWords[2 * i + 1]) << i;
+      }
+      array.release(&array);
+      schema.release(&schema);
+      EXPECT_EQ(nullptr, array.release);
+    }
+  }
+
+  TEST(ArrowCData, exportNested) {
+    MemoryPool* pool = getDefaultPool();
+    std::unique_ptr<Type> type(Type::buildTypeFromString(
+        "struct<a:array<string>,b:map<string,timestamp>,c:uniontype<int,string>>"));
+    const uint64_t rowCount = 4;
+    auto batch = type->createRowBatch(16, *pool);
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    auto* list = dynamic_cast<ListVectorBatch*>(structBatch->fields[0]);
+    auto* map = dynamic_cast<MapVectorBatch*>(structBatch->fields[1]);
+    auto* unionBatch = dynamic_cast<UnionVectorBatch*>(structBatch->fields[2]);
+    auto* items = dynamic_cast<StringVectorBatch*>(list->elements.get());
+    auto* keys = dynamic_cast<StringVectorBatch*>(map->keys.get());
+    auto* timestamps = dynamic_cast<TimestampVectorBatch*>(map->elements.get());
+    auto* unionInts = dynamic_cast<LongVectorBatch*>(unionBatch->children[0]);
+    auto* unionStrings = dynamic_cast<StringVectorBatch*>(unionBatch->children[1]);
+
+    std::vector<std::string> words = {"zero", "one", "two", "three", "four", "five", "six"};
+    list->hasNulls = true;
+    map->hasNulls = true;
+    uint64_t item = 0;
+    for (uint64_t row = 0; row < rowCount; ++row) {
+      list->offsets[row] = static_cast<int64_t>(item);
+      map->offsets[row] = static_cast<int64_t>(item);
+      list->notNull[row] = row != 2;
+      map->notNull[row] = row != 2;
+      for (uint64_t j = 0; row != 2 && j <= row; ++j, ++item) {
+        items->data[item] = keys->data[item] = const_cast<char*>(words[item].data());
+        items->length[item] = keys->length[item] = static_cast<int64_t>(words[item].size());
+        timestamps->data[item] = static_cast<int64_t>(item) - 1;
+        timestamps->nanoseconds[item] = 500;
+      }
+      unionBatch->tags[row] = row % 2;
+      unionBatch->offsets[row] = row / 2;
+      if (row % 2 == 0) {
+        unionInts->data[row / 2] = static_cast<int64_t>(row);
+      } else {
+        unionStrings->data[row / 2] = const_cast<char*>(words[row].data());
+        unionStrings->length[row / 2] = static_cast<int64_t>(words[row].size());
+      }
+    }
+    list->offsets[rowCount] = map->offsets[rowCount] = static_cast<int64_t>(item);
+    items->numElements = keys->numElements = timestamps->numElements = item;
+    unionInts->numElements = unionStrings->numElements = rowCount / 2;
+    list->numElements = map->numElements = unionBatch->numElements = rowCount;
+    structBatch->numElements = rowCount;
+
+    ArrowSchema schema;
+    ArrowArray array;
+    exportArrowBatch(*type, *batch, &schema, &array);
+
+    ArrowArray* arrowList = array.children[0];
+    EXPECT_EQ(1, arrowList->null_count);
+    EXPECT_FALSE(isValid(*arrowList, 2));
+    EXPECT_EQ(list->offsets.data(), arrowList->buffers[1]);
+    ASSERT_EQ(static_cast<int64_t>(item), arrowList->children[0]->length);
+    for (uint64_t i = 0; i < item; ++i) {
+      EXPECT_EQ(words[i], getString(*arrowList->children[0], i));
+    }
+
+    ArrowArray* arrowMap = array.children[1];
+    auto mapOffsets = static_cast<const int32_t*>(arrowMap->buffers[1]);
+    for (uint64_t row = 0; row <= rowCount; ++row) {
+      EXPECT_EQ(map->offsets[row], mapOffsets[row]);
+    }
+    ArrowArray* entries = arrowMap->children[0];
+    ASSERT_EQ(2, entries->n_children);
+    auto nanos = static_cast<const int64_t*>(entries->children[1]->buffers[1]);
+    for (uint64_t i = 0; i < item; ++i) {
+      EXPECT_EQ(words[i], getString(*entries->children[0], i));
+      EXPECT_EQ((static_cast<int64_t>(i) - 1) * 1000000000 + 500, nanos[i]);
+    }
+
+    ArrowArray* arrowUnion = array.children[2];
+    EXPECT_EQ(2, arrowUnion->n_buffers);
+    auto typeIds = static_cast<const int8_t*>(arrowUnion->buffers[0]);
+    auto unionOffsets = static_cast<const int32_t*>(arrowUnion->buffers[1]);
+    for (uint64_t row = 0; row < rowCount; ++row) {
+      EXPECT_EQ(static_cast<int8_t>(row % 2), typeIds[row]);
+      EXPECT_EQ(static_cast<int32_t>(row / 2), unionOffsets[row]);
+    }
+    EXPECT_EQ("three", getString(*arrowUnion->children[1], 1));
+    array.release(&array);
+    schema.release(&schema);
+
+    // Arrow unions cannot hold nulls
+    unionBatch->hasNulls = true;
+    unionBatch->notNull[1] = 0;
+    EXPECT_THROW(exportArrowBatch(*type, *batch, &schema, &array), NotImplementedYet);
+    EXPECT_EQ(nullptr, schema.release);
+    EXPECT_EQ(nullptr, array.release);
+  }
+
+  TEST(ArrowCData, exportTimestampRange) {
+    MemoryPool* pool = getDefaultPool();
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<a:timestamp>"));
+    auto batch = type->createRowBatch(2, *pool);
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    auto* timestamps = dynamic_cast<TimestampVectorBatch*>(structBatch->fields[0]);
+    // 3000-01-01 00:00:00 UTC, behind a null that holds the same value
+    timestamps->data[0] = timestamps->data[1] = 32503680000;
+    timestamps->nanoseconds[0] = timestamps->nanoseconds[1] = 0;
+    timestamps->hasNulls = true;
+    timestamps->notNull[0] = 0;
+    timestamps->notNull[1] = 1;
+    timestamps->numElements = structBatch->numElements = 1;
+
+    ArrowSchema schema;
+    ArrowArray array;
+    exportArrowBatch(*type, *batch, &schema, &array);
+    array.release(&array);
+    schema.release(&schema);
+
+    timestamps->numElements = structBatch->numElements = 2;
+    EXPECT_THROW(exportArrowBatch(*type, *batch, &schema, &array), std::range_error);
+  }
+
+  TEST(ArrowCData, exportDictionary) {
+    MemoryPool* pool = getDefaultPool();
+    const uint64_t rowCount = 3000;
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<s:string>"));
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    {
+      WriterOptions options;
+      options.setMemoryPool(pool);
+      options.setDictionaryKeySizeThreshold(1.0);
+      std::unique_ptr<Writer> writer = createWriter(*type, &memStream, options);
+      auto batch = writer->createRowBatch(rowCount);
+      auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+      auto* strings = dynamic_cast<StringVectorBatch*>(structBatch->fields[0]);
+      std::vector<std::string> values(rowCount);
+      strings->hasNulls = true;
+      for (uint64_t i = 0; i < rowCount; ++i) {
+        values[i] = "value-" + std::to_string(i % 7);
+        strings->data[i] = const_cast<char*>(values[i].data());
+        strings->length[i] = static_cast<int64_t>(values[i].size());
+        strings->notNull[i] = i % 10 != 0;
+      }
+      strings->numElements = structBatch->numElements = rowCount;
+      writer->add(*batch);
+      writer->close();
+    }
+
+    std::unique_ptr<InputStream> inStream(
+        new MemoryInputStream(memStream.getData(), memStream.getLength()));
+    ReaderOptions readerOptions;
+    readerOptions.setMemoryPool(*pool);
+    std::unique_ptr<Reader> reader = createReader(std::move(inStream), readerOptions);
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.setEnableLazyDecoding(true);
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader(rowReaderOptions);
+    auto batch = rowReader->createRowBatch(rowCount);
+    ASSERT_TRUE(rowReader->next(*batch));
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    auto* encoded = dynamic_cast<EncodedStringVectorBatch*>(structBatch->fields[0]);
+    ASSERT_TRUE(encoded != nullptr && encoded->isEncoded);
+
+    ArrowSchema schema;
+    ArrowArray array;
+    exportArrowBatch(rowReader->getSelectedType(), *batch, &schema, &array);
+    ArrowSchema* column = schema.children[0];
+    EXPECT_STREQ("l", column->format);
+    ASSERT_NE(nullptr, column->dictionary);
+    EXPECT_STREQ("U", column->dictionary->format);
+
+    ArrowArray* indexes = array.children[0];
+    EXPECT_EQ(encoded->index.data(), indexes->buffers[1]);
+    EXPECT_EQ(static_cast<int64_t>(rowCount / 10), indexes->null_count);
+    ArrowArray* dictionary = indexes->dictionary;
+    ASSERT_NE(nullptr, dictionary);
+    EXPECT_EQ(7, dictionary->length);
+    EXPECT_EQ(encoded->dictionary->dictionaryBlob.data(), dictionary->buffers[2]);
+
+    // the dictionary stays alive with the array even after the batch is gone
+    std::vector<int64_t> index(encoded->index.data(), encoded->index.data() + 8);
+    batch.reset();
+    auto offsets = static_cast<const int64_t*>(dictionary->buffers[1]);
+    auto blob = static_cast<const char*>(dictionary->buffers[2]);
+    for (uint64_t i = 1; i < 8; ++i) {
+      std::string value(blob + offsets[index[i]],
+                        static_cast<size_t>(offsets[index[i] + 1] - offsets[index[i]]));
+      EXPECT_EQ("value-" + std::to_string(i % 7), value);
+    }
+    array.release(&array);
+    schema.release(&schema);
+  }
+
+
+  static std::unique_ptr<Reader> createMemoryReader(MemoryOutputStream& memStream) {
+    std::unique_ptr<InputStream> inStream(
+        new MemoryInputStream(memStream.getData(), memStream.getLength()));
+    ReaderOptions readerOptions;
+    readerOptions.setMemoryPool(*getDefaultPool());
+    return createReader(std::move(inStream), readerOptions);
+  }
+
+  static Int128 bigDecimal(int64_t value) {
+    Int128 result(value);
+    result *= Int128(1000000000000000LL);
+    return result;
+  }
+
+  TEST(ArrowCData, writeArrowArray) {
+    MemoryPool* pool = getDefaultPool();
+    std::unique_ptr<Type> type(Type::buildTypeFromString(
+        "struct<a:int,b:string,c:array<bigint>,d:timestamp,e:decimal(20,3)>"));
+    const uint64_t rowCount = 100;
+    auto batch = type->createRowBatch(rowCount, *pool);
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    auto* ints = dynamic_cast<LongVectorBatch*>(structBatch->fields[0]);
+    auto* strings = dynamic_cast<StringVectorBatch*>(structBatch->fields[1]);
+    auto* lists = dynamic_cast<ListVectorBatch*>(structBatch->fields[2]);
+    auto* elements = dynamic_cast<LongVectorBatch*>(lists->elements.get());
+    auto* timestamps = dynamic_cast<TimestampVectorBatch*>(structBatch->fields[3]);
+    auto* decimals = dynamic_cast<Decimal128VectorBatch*>(structBatch->fields[4]);
+
+    std::vector<std::string> values(rowCount);
+    elements->resize(rowCount * 3);
+    strings->hasNulls = true;
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      int64_t value = static_cast<int64_t>(i);
+      ints->data[i] = value - 50;
+      values[i] = "s" + std::to_string(i);
+      strings->data[i] = const_cast<char*>(values[i].data());
+      strings->length[i] = static_cast<int64_t>(values[i].size());
+      strings->notNull[i] = i % 4 != 0;
+      lists->offsets[i] = static_cast<int64_t>(elements->numElements);
+      for (uint64_t j = 0; j < i % 3; ++j) {
+        elements->data[elements->numElements++] = value * 10 + static_cast<int64_t>(j);
+      }
+      timestamps->data[i] = value - 50;
+      timestamps->nanoseconds[i] = value * 1000;
+      decimals->values[i] = bigDecimal(value - 50);
+    }
+    lists->offsets[rowCount] = static_cast<int64_t>(elements->numElements);
+    for (auto* field : structBatch->fields) {
+      field->numElements = rowCount;
+    }
+    structBatch->numElements = rowCount;
+
+    ArrowSchema schema;
+    ArrowArray array;
+    exportArrowBatch(*type, *batch, &schema, &array);
+
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    {
+      WriterOptions options;
+      options.setMemoryPool(pool);
+      std::unique_ptr<Writer> writer = createWriter(*type, &memStream, options);
+      writer->add(schema, array);
+      // a slice shares the buffers and starts at the offset
+      array.offset = 30;
+      array.length = 20;
+      writer->add(schema, array);
+      writer->close();
+    }
+    array.release(&array);
+    schema.release(&schema);
+
+    std::unique_ptr<Reader> reader = createMemoryReader(memStream);
+    EXPECT_EQ(rowCount + 20, reader->getNumberOfRows());
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader(RowReaderOptions());
+    auto readBatch = rowReader->createRowBatch(rowCount + 20);
+    ASSERT_TRUE(rowReader->next(*readBatch));
+    ASSERT_EQ(rowCount + 20, readBatch->numElements);
+    auto* readStruct = dynamic_cast<StructVectorBatch*>(readBatch.get());
+    auto* readInts = dynamic_cast<LongVectorBatch*>(readStruct->fields[0]);
+    auto* readStrings = dynamic_cast<StringVectorBatch*>(readStruct->fields[1]);
+    auto* readLists = dynamic_cast<ListVectorBatch*>(readStruct->fields[2]);
+    auto* readElements = dynamic_cast<LongVectorBatch*>(readLists->elements.get());
+    auto* readTimestamps = dynamic_cast<TimestampVectorBatch*>(readStruct->fields[3]);
+    auto* readDecimals = dynamic_cast<Decimal128VectorBatch*>(readStruct->fields[4]);
+    for (uint64_t row = 0; row < rowCount + 20; ++row) {
+      uint64_t i = row < rowCount ? row : row - rowCount + 30;
+      int64_t value = static_cast<int64_t>(i);
+      EXPECT_EQ(value - 50, readInts->data[row]) << row;
+      EXPECT_EQ(i % 4 != 0, readStrings->notNull[row] != 0) << row;
+      if (i % 4 != 0) {
+        EXPECT_EQ(values[i], std::string(readStrings->data[row],
+                                         static_cast<size_t>(readStrings->length[row])));
+      }
+      ASSERT_EQ(static_cast<int64_t>(i % 3),
+                readLists->offsets[row + 1] - readLists->offsets[row]);
+      for (uint64_t j = 0; j < i % 3; ++j) {
+        EXPECT_EQ(value * 10 + static_cast<int64_t>(j),
+                  readElements->data[static_cast<uint64_t>(readLists->offsets[row]) + j]);
+      }
+      EXPECT_EQ(value - 50, readTimestamps->data[row]) << row;
+      EXPECT_EQ(value * 1000, readTimestamps->nanoseconds[row]) << row;
+      EXPECT_EQ(bigDecimal(value - 50), readDecimals->values[row]);
+    }
+  }
+
+  TEST(ArrowCData, importArrowLayouts) {
+    // timestamps in milliseconds and strings with 64-bit offsets
+    const int64_t millis[] = {-1500, 0, 2001};
+    const int64_t offsets[] = {0, 3, 3, 8};
+    const char* data = "abcdefgh";
+    const uint8_t validity = 0x5;
+    const void* timestampBuffers[] = {nullptr, millis};
+    const void* stringBuffers[] = {&validity, offsets, data};
+    const void* structBuffers[] = {nullptr};
+    ArrowArray timestampArray = {3, 0, 0, 2, 0, timestampBuffers, nullptr, nullptr, nullptr,
+                                 nullptr};
+    ArrowArray stringArray = {3, 1, 0, 3, 0, stringBuffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray* childArrays[] = {&timestampArray, &stringArray};
+    ArrowArray array = {3, 0, 0, 1, 2, structBuffers, childArrays, nullptr, nullptr, nullptr};
+    ArrowSchema timestampSchema = {"tsm:", "t", nullptr, 2, 0, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema stringSchema = {"U", "s", nullptr, 2, 0, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema* childSchemas[] = {&timestampSchema, &stringSchema};
+    ArrowSchema schema = {"+s", "", nullptr, 0, 2, childSchemas, nullptr, nullptr, nullptr};
+
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<t:timestamp,s:string>"));
+    auto batch = type->createRowBatch(1, *getDefaultPool());
+    importArrowBatch(*type, schema, array, *batch);
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    auto* timestamps = dynamic_cast<TimestampVectorBatch*>(structBatch->fields[0]);
+    auto* strings = dynamic_cast<StringVectorBatch*>(structBatch->fields[1]);
+    ASSERT_EQ(3, batch->numElements);
+    EXPECT_EQ(-2, timestamps->data[0]);
+    EXPECT_EQ(500000000, timestamps->nanoseconds[0]);
+    EXPECT_EQ(0, timestamps->data[1]);
+    EXPECT_EQ(2, timestamps->data[2]);
+    EXPECT_EQ(1000000, timestamps->nanoseconds[2]);
+    EXPECT_TRUE(strings->hasNulls);
+    EXPECT_EQ(0, strings->notNull[1]);
+    EXPECT_EQ("abc", std::string(strings->data[0], static_cast<size_t>(strings->length[0])));
+    EXPECT_EQ("defgh", std::string(strings->data[2], static_cast<size_t>(strings->length[2])));
+
+    stringSchema.format = "g";
+    EXPECT_THROW(importArrowBatch(*type, schema, array, *batch), InvalidArgument);
+  }
+
+  TEST(ArrowCData, importIntegerRanges) {
+    // the second value is null, so only the others must fit
+    const uint64_t values[] = {127, 1ULL << 63, 0};
+    const uint8_t validity = 0x5;
+    const void* valueBuffers[] = {&validity, values};
+    const void* structBuffers[] = {nullptr};
+    ArrowArray valueArray = {3, 1, 0, 2, 0, valueBuffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray* childArrays[] = {&valueArray};
+    ArrowArray array = {3, 0, 0, 1, 1, structBuffers, childArrays, nullptr, nullptr, nullptr};
+    ArrowSchema valueSchema = {"L", "v", nullptr, 2, 0, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema* childSchemas[] = {&valueSchema};
+    ArrowSchema schema = {"+s", "", nullptr, 0, 1, childSchemas, nullptr, nullptr, nullptr};
+
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<v:tinyint>"));
+    auto batch = type->createRowBatch(3, *getDefaultPool());
+    importArrowBatch(*type, schema, array, *batch);
+    auto* bytes =
+        dynamic_cast<LongVectorBatch*>(dynamic_cast<StructVectorBatch&>(*batch).fields[0]);
+    EXPECT_EQ(127, bytes->data[0]);
+    EXPECT_EQ(0, bytes->data[2]);
+
+    // uint64 values above INT64_MAX and values wider than the column
+    valueArray.null_count = 0;
+    valueBuffers[0] = nullptr;
+    type = Type::buildTypeFromString("struct<v:bigint>");
+    batch = type->createRowBatch(3, *getDefaultPool());
+    EXPECT_THROW(importArrowBatch(*type, schema, array, *batch), std::range_error);
+    const int64_t longs[] = {127, 128, -129};
+    valueBuffers[1] = longs;
+    valueSchema.format = "l";
+    type = Type::buildTypeFromString("struct<v:tinyint>");
+    batch = type->createRowBatch(3, *getDefaultPool());
+    EXPECT_THROW(importArrowBatch(*type, schema, array, *batch), std::range_error);
+    type = Type::buildTypeFromString("struct<v:smallint>");
+    batch = type->createRowBatch(3, *getDefaultPool(), false, true);
+    importArrowBatch(*type, schema, array, *batch);
+    auto* shorts =
+        dynamic_cast<ShortVectorBatch*>(dynamic_cast<StructVectorBatch&>(*batch).fields[0]);
+    ASSERT_NE(nullptr, shorts);
+    EXPECT_EQ(-129, shorts->data[2]);
+  }
+
+  TEST(ArrowCData, importNullListEntries) {
+    // the null first list covers the children 3 and 5, which are dropped
+    const int32_t values[] = {3, 5, 7};
+    const int32_t offsets[] = {0, 2, 3};
+    const uint8_t validity = 0x2;
+    const void* valueBuffers[] = {nullptr, values};
+    const void* listBuffers[] = {&validity, offsets};
+    ArrowArray valueArray = {3, 0, 0, 2, 0, valueBuffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray* listChildren[] = {&valueArray};
+    ArrowArray array = {2, 1, 0, 2, 1, listBuffers, listChildren, nullptr, nullptr, nullptr};
+    ArrowSchema valueSchema = {"i", "item", nullptr, 2, 0, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema* listSchemas[] = {&valueSchema};
+    ArrowSchema schema = {"+l", "", nullptr, 2, 1, listSchemas, nullptr, nullptr, nullptr};
+
+    std::unique_ptr<Type> type(Type::buildTypeFromString("array<int>"));
+    auto batch = type->createRowBatch(2, *getDefaultPool());
+    importArrowBatch(*type, schema, array, *batch);
+    auto& lists = dynamic_cast<ListVectorBatch&>(*batch);
+    auto& elements = dynamic_cast<LongVectorBatch&>(*lists.elements);
+    ASSERT_EQ(2, lists.numElements);
+    EXPECT_EQ(0, lists.notNull[0]);
+    EXPECT_EQ(0, lists.offsets[0]);
+    EXPECT_EQ(0, lists.offsets[1]);
+    EXPECT_EQ(1, lists.offsets[2]);
+    ASSERT_EQ(1, elements.numElements);
+    EXPECT_EQ(7, elements.data[0]);
+
+    // the rows read back from a file keep their own children
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    std::unique_ptr<Type> fileType(Type::buildTypeFromString("struct<l:array<int>>"));
+    WriterOptions options;
+    options.setMemoryPool(getDefaultPool());
+    auto writer = createWriter(*fileType, &memStream, options);
+    auto writeBatch = writer->createRowBatch(2);
+    auto& root = dynamic_cast<StructVectorBatch&>(*writeBatch);
+    importArrowBatch(*type, schema, array, *root.fields[0]);
+    root.numElements = 2;
+    writer->add(*writeBatch);
+    writer->close();
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        ReaderOptions());
+    auto rowReader = reader->createRowReader(RowReaderOptions());
+    auto readBatch = rowReader->createRowBatch(2);
+    ASSERT_TRUE(rowReader->next(*readBatch));
+    auto& readLists =
+        dynamic_cast<ListVectorBatch&>(*dynamic_cast<StructVectorBatch&>(*readBatch).fields[0]);
+    EXPECT_EQ(1, readLists.offsets[2] - readLists.offsets[1]);
+    EXPECT_EQ(7, dynamic_cast<LongVectorBatch&>(*readLists.elements).data[readLists.offsets[1]]);
+  }
+
+  TEST(ArrowCData, importDecimalRanges) {
+    // 123.45 and -999.99 fit decimal(5,2), the null third value does not
+    const uint64_t words[] = {12345, 0, static_cast<uint64_t>(-99999), ~0ULL, 100000, 0};
+    const uint8_t validity = 0x3;
+    const void* buffers[] = {&validity, words};
+    ArrowArray array = {3, 1, 0, 2, 0, buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema schema = {"d:5,2", "", nullptr, 2, 0, nullptr, nullptr, nullptr, nullptr};
+
+    std::unique_ptr<Type> type(Type::buildTypeFromString("decimal(5,2)"));
+    auto batch = type->createRowBatch(3, *getDefaultPool());
+    importArrowBatch(*type, schema, array, *batch);
+    auto& decimals = dynamic_cast<Decimal64VectorBatch&>(*batch);
+    EXPECT_EQ(12345, decimals.values[0]);
+    EXPECT_EQ(-99999, decimals.values[1]);
+
+    // a decimal128 value whose high word is lost in a decimal64 column
+    array.null_count = 0;
+    buffers[0] = nullptr;
+    EXPECT_THROW(importArrowBatch(*type, schema, array, *batch), ParseError);
+    const uint64_t wide[] = {1, 1};
+    buffers[1] = wide;
+    array.length = 1;
+    EXPECT_THROW(importArrowBatch(*type, schema, array, *batch), ParseError);
+    type = Type::buildTypeFromString("decimal(38,2)");
+    batch = type->createRowBatch(1, *getDefaultPool());
+    importArrowBatch(*type, schema, array, *batch);
+    EXPECT_EQ(Int128(1, 1), dynamic_cast<Decimal128VectorBatch&>(*batch).values[0]);
+
+    for (const char* format : {"d:10,x", "d:,2", "d:10,99999999999999999999", "d:10"}) {
+      schema.format = format;
+      EXPECT_THROW(importArrowBatch(*type, schema, array, *batch), InvalidArgument) << format;
+    }
+  }
+
+  TEST(ArrowCData, writeArrowDictionary) {
+    MemoryPool* pool = getDefaultPool();
+    const uint64_t rowCount = 3000;
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<s:string>"));
+    auto batch = type->createRowBatch(rowCount, *pool, true);
+    auto* encoded = dynamic_cast<EncodedStringVectorBatch*>(
+        dynamic_cast<StructVectorBatch*>(batch.get())->fields[0]);
+    encoded->dictionary = std::make_shared<StringDictionary>(*pool);
+    std::string blob;
+    encoded->dictionary->dictionaryOffset.resize(6);
+    encoded->dictionary->dictionaryOffset[0] = 0;
+    for (uint64_t i = 0; i < 5; ++i) {
+      blob += "entry-" + std::to_string(i);
+      encoded->dictionary->dictionaryOffset[i + 1] = static_cast<int64_t>(blob.size());
+    }
+    encoded->dictionary->dictionaryBlob.resize(blob.size());
+    memcpy(encoded->dictionary->dictionaryBlob.data(), blob.data(), blob.size());
+    encoded->hasNulls = true;
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      encoded->index[i] = static_cast<int64_t>(i % 5);
+      encoded->notNull[i] = i % 7 != 0;
+    }
+    encoded->isEncoded = true;
+    encoded->numElements = batch->numElements = rowCount;
+
+    ArrowSchema schema;
+    ArrowArray array;
+    exportArrowBatch(*type, *batch, &schema, &array);
+
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    {
+      WriterOptions options;
+      options.setMemoryPool(pool);
+      options.setDictionaryKeySizeThreshold(1.0);
+      std::unique_ptr<Writer> writer = createWriter(*type, &memStream, options);
+      writer->add(schema, array);
+      writer->close();
+    }
+    array.release(&array);
+    schema.release(&schema);
+
+    std::unique_ptr<Reader> reader = createMemoryReader(memStream);
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader(RowReaderOptions());
+    EXPECT_EQ(ColumnEncodingKind_DICTIONARY_V2, reader->getStripe(0)->getColumnEncoding(1));
+    auto readBatch = rowReader->createRowBatch(rowCount);
+    ASSERT_TRUE(rowReader->next(*readBatch));
+    auto* readStruct = dynamic_cast<StructVectorBatch*>(readBatch.get());
+    auto* strings = dynamic_cast<StringVectorBatch*>(readStruct->fields[0]);
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      EXPECT_EQ(i % 7 != 0, strings->notNull[i] != 0) << i;
+      if (i % 7 != 0) {
+        EXPECT_EQ("entry-" + std::to_string(i % 5),
+                  std::string(strings->data[i], static_cast<size_t>(strings->length[i])));
+      }
+    }
+  }
+
+}  // namespace orc
@@ -16,7 +16,11 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
+#include <stdexcept>
 
 #include "MemoryInputStream.hh"
 #include "io/Cache.hh"
@@ -139,4 +143,96 @@ namespace orc {
     slice = cache.read({20, 2});
     assert_slice_equal(slice, "uv");
   }
+
+  static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // counts the reads that reach the wrapped stream; with a barrier each read
+  // waits until that many reads are in flight, so the reads pass it only if
+  // they are issued concurrently
+  class CountingInputStream : public MemoryInputStream {
+   public:
+    CountingInputStream(const char* buffer, size_t size, uint64_t barrier = 0)
+        : MemoryInputStream(buffer, size), barrier_(barrier) {}
+
+    void read(void* buf, uint64_t length, uint64_t offset) override {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        reads_ += 1;
+        bytes_ += length;
+        arrived_.notify_all();
+        if (!arrived_.wait_for(lock, std::chrono::seconds(30),
+                               [this] { return reads_ >= barrier_; })) {
+          throw std::runtime_error("the reads are not concurrent");
+        }
+      }
+      MemoryInputStream::read(buf, length, offset);
+    }
+
+    uint64_t getReads() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return reads_;
+    }
+
+    uint64_t getBytes() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return bytes_;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::condition_variable arrived_;
+    uint64_t barrier_;
+    uint64_t reads_ = 0;
+    uint64_t bytes_ = 0;
+  };
+
+  TEST(TestRemoteStorage, testLatencyAndBandwidth) {
+    std::string data(100000, 'x');
+    data[50000] = 'y';
+    RemoteStorageOptions options;
+    options.latency = std::chrono::milliseconds(20);
+    options.bytesPerSecond = 1000000;
+    auto stream = std::make_unique<CountingInputStream>(data.data(), data.size());
+    CountingInputStream* counter = stream.get();
+    auto file = simulateRemoteStorage(std::move(stream), options);
+    EXPECT_EQ(data.size(), file->getLength());
+
+    // 20ms of latency and 50ms to transfer 50000 bytes, as a single request;
+    // the sleep only bounds the time from below
+    std::string buffer(50000, ' ');
+    auto start = std::chrono::steady_clock::now();
+    file->read(buffer.data(), buffer.size(), 25000);
+    EXPECT_LE(0.07, secondsSince(start));
+    EXPECT_EQ(1, counter->getReads());
+    EXPECT_EQ(50000, counter->getBytes());
+    EXPECT_EQ(data.substr(25000, 50000), buffer);
+  }
+
+  TEST(TestReadRangeCache, testConcurrentRequests) {
+    std::string data = "abcdefghijklmnopqrstuvwxyz";
+    RemoteStorageOptions storageOptions;
+    storageOptions.latency = std::chrono::milliseconds(100);
+    // the holes keep the eight ranges apart, and the reads only get past the
+    // barrier when all eight requests are in flight at the same time
+    auto stream = std::make_unique<CountingInputStream>(data.data(), data.size(), 8);
+    CountingInputStream* counter = stream.get();
+    auto file = simulateRemoteStorage(std::move(stream), storageOptions);
+
+    CacheOptions options;
+    options.holeSizeLimit = 0;
+    ReadRangeCache cache(file.get(), options, getDefaultPool());
+    auto start = std::chrono::steady_clock::now();
+    cache.cache({{0, 2}, {3, 2}, {6, 2}, {9, 2}, {12, 2}, {15, 2}, {18, 2}, {21, 2}});
+    for (uint64_t offset = 0; offset < 24; offset += 3) {
+      BufferSlice slice = cache.read({offset, 2});
+      ASSERT_TRUE(slice.buffer);
+      EXPECT_EQ(data.substr(offset, 2),
+                std::string_view(slice.buffer->data() + slice.offset, slice.length));
+    }
+    EXPECT_LE(0.1, secondsSince(start));
+    EXPECT_EQ(8, counter->getReads());
+    EXPECT_EQ(16, counter->getBytes());
+  }
 }  // namespace orc
@@ -553,4 +553,44 @@ namespace orc {
       }
     }
   }
+
+  TEST(TestColumnPrinter, printBatch) {
+    std::string buffer = "first line\n";
+    std::unique_ptr<Type> type = Type::buildTypeFromString("struct<ts:timestamp,d:date,s:string>");
+    std::unique_ptr<ColumnPrinter> printer = createColumnPrinter(buffer, type.get());
+    StructVectorBatch batch(1024, *getDefaultPool());
+    auto* timestamps = new TimestampVectorBatch(1024, *getDefaultPool());
+    auto* dates = new LongVectorBatch(1024, *getDefaultPool());
+    auto* strings = new StringVectorBatch(1024, *getDefaultPool());
+    batch.fields.push_back(timestamps);
+    batch.fields.push_back(dates);
+    batch.fields.push_back(strings);
+    batch.numElements = timestamps->numElements = dates->numElements = strings->numElements = 3;
+    batch.hasNulls = timestamps->hasNulls = dates->hasNulls = strings->hasNulls = false;
+
+    // before the epoch and the ends of the four digit years
+    timestamps->data[0] = -1;
+    timestamps->nanoseconds[0] = 500000000;
+    timestamps->data[1] = -30610224000;
+    timestamps->nanoseconds[1] = 0;
+    timestamps->data[2] = 253402300799;
+    timestamps->nanoseconds[2] = 999999999;
+    dates->data[0] = -1;
+    dates->data[1] = -354285;
+    dates->data[2] = 2932896;
+    std::string text = "plain\"quoted\"\tend\\";
+    for (uint64_t i = 0; i < 3; ++i) {
+      strings->data[i] = text.data();
+      strings->length[i] = static_cast<int64_t>(i == 0 ? text.size() : i);
+    }
+
+    printer->printBatch(batch);
+    EXPECT_EQ(
+        "first line\n"
+        "{\"ts\": \"1969-12-31 23:59:59.5\", \"d\": \"1969-12-31\", "
+        "\"s\": \"plain\\\"quoted\\\"\\tend\\\\\"}\n"
+        "{\"ts\": \"1000-01-01 00:00:00.0\", \"d\": \"1000-01-01\", \"s\": \"p\"}\n"
+        "{\"ts\": \"9999-12-31 23:59:59.999999999\", \"d\": \"9999-12-31\", \"s\": \"pl\"}\n",
+        buffer);
+  }
 }  // namespace orc
@@ -151,6 +151,78 @@ namespace orc {
     EXPECT_THROW(rowReader->next(*readBatch), SchemaEvolutionError);
   }
 
+  // batches without overflows are converted at once, the others value by value
+  TEST(ConvertColumnReader, narrowingBatches) {
+    constexpr int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;
+    constexpr uint64_t BATCH_SIZE = 4;
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    std::unique_ptr<Type> fileType(
+        Type::buildTypeFromString("struct<t1:bigint,t2:decimal(10,2),t3:decimal(10,2)>"));
+    std::shared_ptr<Type> readType(
+        Type::buildTypeFromString("struct<t1:int,t2:smallint,t3:double>"));
+    WriterOptions options;
+    auto writer = createWriter(*fileType, &memStream, options);
+    auto batch = writer->createRowBatch(2 * BATCH_SIZE);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& c1 = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& c2 = dynamic_cast<Decimal64VectorBatch&>(*structBatch.fields[1]);
+    auto& c3 = dynamic_cast<Decimal64VectorBatch&>(*structBatch.fields[2]);
+
+    std::vector<int64_t> longs{-7, 1LL << 30, 0, -(1LL << 31), 5, 1LL << 31, 0, 9};
+    std::vector<int64_t> decimals{-12345, 99, 0, 3276700, 250, 3276800, 0, -3276900};
+    for (uint64_t i = 0; i < 2 * BATCH_SIZE; ++i) {
+      c1.data[i] = longs[i];
+      c2.values[i] = c3.values[i] = decimals[i];
+      c1.notNull[i] = c2.notNull[i] = c3.notNull[i] = i % BATCH_SIZE != 2;
+    }
+    c1.hasNulls = c2.hasNulls = c3.hasNulls = true;
+    structBatch.numElements = c1.numElements = c2.numElements = c3.numElements = 2 * BATCH_SIZE;
+    writer->add(*batch);
+    writer->close();
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    auto pool = getDefaultPool();
+    auto reader = createReader(*pool, std::move(inStream));
+    RowReaderOptions rowReaderOpts;
+    rowReaderOpts.setReadType(readType);
+    rowReaderOpts.setUseTightNumericVector(true);
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto readBatch = rowReader->createRowBatch(BATCH_SIZE);
+    auto& readStructBatch = dynamic_cast<StructVectorBatch&>(*readBatch);
+    auto& readC1 = dynamic_cast<IntVectorBatch&>(*readStructBatch.fields[0]);
+    auto& readC2 = dynamic_cast<ShortVectorBatch&>(*readStructBatch.fields[1]);
+    auto& readC3 = dynamic_cast<DoubleVectorBatch&>(*readStructBatch.fields[2]);
+
+    ASSERT_TRUE(rowReader->next(*readBatch));
+    for (uint64_t i = 0; i < BATCH_SIZE; ++i) {
+      EXPECT_EQ(i != 2, readC1.notNull[i]) << i;
+      EXPECT_EQ(i != 2, readC2.notNull[i]) << i;
+      EXPECT_EQ(i != 2, readC3.notNull[i]) << i;
+    }
+    EXPECT_EQ(-7, readC1.data[0]);
+    EXPECT_EQ(1 << 30, readC1.data[1]);
+    EXPECT_EQ(std::numeric_limits<int32_t>::min(), readC1.data[3]);
+    EXPECT_EQ(-123, readC2.data[0]);
+    EXPECT_EQ(0, readC2.data[1]);
+    EXPECT_EQ(32767, readC2.data[3]);
+    EXPECT_DOUBLE_EQ(-123.45, readC3.data[0]);
+    EXPECT_DOUBLE_EQ(0.99, readC3.data[1]);
+    EXPECT_DOUBLE_EQ(32767, readC3.data[3]);
+
+    ASSERT_TRUE(rowReader->next(*readBatch));
+    std::vector<bool> notNull{true, false, false, true};
+    for (uint64_t i = 0; i < BATCH_SIZE; ++i) {
+      EXPECT_EQ(notNull[i], readC1.notNull[i]) << i;
+      EXPECT_EQ(i == 0, readC2.notNull[i]) << i;
+      EXPECT_EQ(i != 2, readC3.notNull[i]) << i;
+    }
+    EXPECT_EQ(5, readC1.data[0]);
+    EXPECT_EQ(9, readC1.data[3]);
+    EXPECT_EQ(2, readC2.data[0]);
+    EXPECT_DOUBLE_EQ(32768, readC3.data[1]);
+    EXPECT_DOUBLE_EQ(-32769, readC3.data[3]);
+  }
+
   // Test for converting from boolean to string/char/varchar
   // Create a file with schema struct<t1:boolean,t2:boolean,t3:boolean,t4:boolean,t5:boolean> and
   // write 1024 rows with alternating true and false values. Read the file with schema
@@ -905,6 +977,90 @@ namespace orc {
     EXPECT_FLOAT_EQ(readC3.data[3], -123456789.0123);
   }
 
+  // the conversion accepts what std::stoll, std::stod and std::stof accept
+  TEST(ConvertColumnReader, TestConvertStringVariantToNumericLikeStdlib) {
+    constexpr int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    std::unique_ptr<Type> fileType(
+        Type::buildTypeFromString("struct<c1:string,c2:string,c3:string>"));
+    std::shared_ptr<Type> readType(
+        Type::buildTypeFromString("struct<c1:bigint,c2:double,c3:float>"));
+    std::vector<std::string> raw1{"+5",
+                                  " 7",
+                                  "12abc",
+                                  "9223372036854775807",
+                                  "-9223372036854775808",
+                                  "9223372036854775808",
+                                  "",
+                                  "abc"};
+    std::vector<std::string> raw2{"+1.5", " 2.5", "3.25x", "0x1p3", "1e308", "1e-400", "", "abc"};
+    std::vector<std::string> raw3{"+1.5", " 2.5", "3.25x", "0x1p3", "inf", "1e39", "", "abc"};
+    const size_t testCases = raw1.size();
+
+    WriterOptions options;
+    auto writer = createWriter(*fileType, &memStream, options);
+    auto batch = writer->createRowBatch(testCases);
+    auto structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    auto& c1 = dynamic_cast<StringVectorBatch&>(*structBatch->fields[0]);
+    auto& c2 = dynamic_cast<StringVectorBatch&>(*structBatch->fields[1]);
+    auto& c3 = dynamic_cast<StringVectorBatch&>(*structBatch->fields[2]);
+    for (size_t i = 0; i < testCases; i++) {
+      c1.data[i] = raw1[i].data();
+      c1.length[i] = static_cast<int64_t>(raw1[i].length());
+      c2.data[i] = raw2[i].data();
+      c2.length[i] = static_cast<int64_t>(raw2[i].length());
+      c3.data[i] = raw3[i].data();
+      c3.length[i] = static_cast<int64_t>(raw3[i].length());
+    }
+    structBatch->numElements = c1.numElements = c2.numElements = c3.numElements = testCases;
+    writer->add(*batch);
+    writer->close();
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    auto pool = getDefaultPool();
+    auto reader = createReader(*pool, std::move(inStream));
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.setUseTightNumericVector(true);
+    rowReaderOptions.setReadType(readType);
+    auto rowReader = reader->createRowReader(rowReaderOptions);
+    auto readBatch = rowReader->createRowBatch(testCases);
+    EXPECT_EQ(true, rowReader->next(*readBatch));
+
+    auto& readStructBatch = dynamic_cast<StructVectorBatch&>(*readBatch);
+    auto& readC1 = dynamic_cast<LongVectorBatch&>(*readStructBatch.fields[0]);
+    auto& readC2 = dynamic_cast<DoubleVectorBatch&>(*readStructBatch.fields[1]);
+    auto& readC3 = dynamic_cast<FloatVectorBatch&>(*readStructBatch.fields[2]);
+
+    for (size_t i = 0; i < 5; i++) {
+      EXPECT_TRUE(readC1.notNull[i]) << i;
+      EXPECT_TRUE(readC2.notNull[i]) << i;
+      EXPECT_TRUE(readC3.notNull[i]) << i;
+    }
+    for (size_t i = 5; i < testCases; i++) {
+      EXPECT_FALSE(readC1.notNull[i]) << i;
+      EXPECT_FALSE(readC2.notNull[i]) << i;
+      EXPECT_FALSE(readC3.notNull[i]) << i;
+    }
+
+    EXPECT_EQ(5, readC1.data[0]);
+    EXPECT_EQ(7, readC1.data[1]);
+    EXPECT_EQ(12, readC1.data[2]);
+    EXPECT_EQ(std::numeric_limits<int64_t>::max(), readC1.data[3]);
+    EXPECT_EQ(std::numeric_limits<int64_t>::min(), readC1.data[4]);
+
+    EXPECT_DOUBLE_EQ(1.5, readC2.data[0]);
+    EXPECT_DOUBLE_EQ(2.5, readC2.data[1]);
+    EXPECT_DOUBLE_EQ(3.25, readC2.data[2]);
+    EXPECT_DOUBLE_EQ(8, readC2.data[3]);
+    EXPECT_DOUBLE_EQ(1e308, readC2.data[4]);
+
+    EXPECT_FLOAT_EQ(1.5, readC3.data[0]);
+    EXPECT_FLOAT_EQ(2.5, readC3.data[1]);
+    EXPECT_FLOAT_EQ(3.25, readC3.data[2]);
+    EXPECT_FLOAT_EQ(8, readC3.data[3]);
+    EXPECT_EQ(std::numeric_limits<float>::infinity(), readC3.data[4]);
+  }
+
   TEST(ConvertColumnReader, TestConvertStringVariant) {
     constexpr int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;
     constexpr int TEST_CASES = 4;
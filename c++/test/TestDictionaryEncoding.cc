@@ -18,6 +18,7 @@
 
 #include "orc/OrcFile.hh"
 
+#include "Dictionary.hh"
 #include "MemoryInputStream.hh"
 #include "MemoryOutputStream.hh"
 
@@ -554,4 +555,299 @@ namespace orc {
     }
   }
 
+  TEST(DictionaryEncoding, sortedStringDictionary) {
+    SortedStringDictionary dictionary(*getDefaultPool());
+
+    // enough distinct keys to grow the hash table several times
+    const size_t distinctCount = 20000;
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < distinctCount; ++i) {
+      keys.push_back(std::to_string((i * 7919) % distinctCount));
+    }
+    keys.push_back("");
+
+    for (size_t round = 0; round < 2; ++round) {
+      for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(i, dictionary.insert(keys[i].data(), keys[i].size()));
+      }
+    }
+    EXPECT_EQ(keys.size(), dictionary.size());
+
+    uint64_t totalLength = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const auto& entry = dictionary.getEntry(i);
+      EXPECT_EQ(keys[i], std::string(entry.data, entry.length));
+      totalLength += keys[i].size();
+    }
+    EXPECT_EQ(totalLength, dictionary.length());
+
+    // insertion order indexes are mapped to their rank in sorted order
+    std::vector<int64_t> indexes;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      indexes.push_back(static_cast<int64_t>(i));
+    }
+    dictionary.reorder(indexes);
+    std::vector<std::string> sortedKeys = keys;
+    std::sort(sortedKeys.begin(), sortedKeys.end());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      EXPECT_EQ(keys[i], sortedKeys[static_cast<size_t>(indexes[i])]);
+    }
+
+    dictionary.clear();
+    EXPECT_EQ(0, dictionary.size());
+    EXPECT_EQ(0, dictionary.length());
+    EXPECT_EQ(0, dictionary.insert("b", 1));
+    EXPECT_EQ(1, dictionary.insert("a", 1));
+    EXPECT_EQ(0, dictionary.insert("b", 1));
+  }
+
+  // a memory pool that records the size of every allocation
+  class RecordingPool : public MemoryPool {
+   public:
+    char* malloc(uint64_t size) override {
+      sizes.push_back(size);
+      return getDefaultPool()->malloc(size);
+    }
+
+    void free(char* p) override {
+      getDefaultPool()->free(p);
+    }
+
+    std::vector<uint64_t> sizes;
+  };
+
+  TEST(DictionaryEncoding, sortedStringDictionaryArena) {
+    RecordingPool pool;
+    SortedStringDictionary dictionary(pool);
+
+    // a small dictionary only takes a small chunk, later chunks double
+    dictionary.insert("a", 1);
+    ASSERT_EQ(1, pool.sizes.size());
+    EXPECT_GE(4096, pool.sizes[0]);
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 1000; ++i) {
+      keys.push_back(std::to_string(i * 1000003));
+      dictionary.insert(keys.back().data(), keys.back().size());
+    }
+    ASSERT_LT(1, pool.sizes.size());
+    for (size_t i = 1; i < pool.sizes.size(); ++i) {
+      EXPECT_EQ(2 * pool.sizes[i - 1], pool.sizes[i]);
+    }
+
+    // the chunks are kept across clear, only a longer key takes a new one
+    const size_t chunks = pool.sizes.size();
+    dictionary.clear();
+    for (const std::string& key : keys) {
+      dictionary.insert(key.data(), key.size());
+    }
+    EXPECT_EQ(chunks, pool.sizes.size());
+    const std::string longKey(100000, 'x');
+    EXPECT_EQ(keys.size(), dictionary.insert(longKey.data(), longKey.size()));
+    ASSERT_EQ(chunks + 1, pool.sizes.size());
+    EXPECT_EQ(longKey.size(), pool.sizes.back());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const auto& entry = dictionary.getEntry(i);
+      EXPECT_EQ(keys[i], std::string(entry.data, entry.length));
+    }
+  }
+
+  TEST(DictionaryEncoding, earlyDictionaryCheck) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    MemoryPool* pool = getDefaultPool();
+    std::unique_ptr<Type> type(
+        Type::buildTypeFromString("struct<col1:string,col2:varchar(8),col3:char(8),col4:string>"));
+
+    WriterMetrics metrics;
+    WriterOptions options;
+    options.setStripeSize(16 * 1024 * 1024);
+    options.setMemoryPool(pool);
+    options.setDictionaryKeySizeThreshold(DICT_THRESHOLD);
+    options.setDictionarySampleSize(100);
+    options.setRowIndexStride(0);
+    options.setWriterMetrics(&metrics);
+    std::unique_ptr<Writer> writer = createWriter(*type, &memStream, options);
+
+    // the first three columns have a distinct value per row, the last one repeats;
+    // batches are not aligned with the sample size so the switch happens mid-batch
+    const uint64_t rowCount = 1000, batchSize = 64;
+    std::vector<std::string> unique(rowCount), repeated(rowCount);
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      unique[i] = std::to_string(i * 7);
+      repeated[i] = std::to_string(i % 10);
+    }
+
+    std::unique_ptr<ColumnVectorBatch> batch = writer->createRowBatch(batchSize);
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    for (uint64_t start = 0; start < rowCount; start += batchSize) {
+      uint64_t numRows = std::min(batchSize, rowCount - start);
+      for (size_t col = 0; col < 4; ++col) {
+        auto* strBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[col]);
+        auto& values = col == 3 ? repeated : unique;
+        strBatch->hasNulls = true;
+        for (uint64_t i = 0; i < numRows; ++i) {
+          strBatch->notNull[i] = (start + i) % 13 != 0;
+          strBatch->data[i] = const_cast<char*>(values[start + i].data());
+          strBatch->length[i] = static_cast<int64_t>(values[start + i].size());
+        }
+        strBatch->numElements = numRows;
+      }
+      structBatch->numElements = numRows;
+      writer->add(*batch);
+    }
+    writer->close();
+
+    EXPECT_EQ(4, metrics.DictionaryCheckCount.load());
+    EXPECT_EQ(3, metrics.DictionaryAbandonedCount.load());
+    EXPECT_EQ(400, metrics.DictionarySampledValues.load());
+    EXPECT_EQ(310, metrics.DictionarySampledKeys.load());
+
+    std::unique_ptr<InputStream> inStream(
+        new MemoryInputStream(memStream.getData(), memStream.getLength()));
+    std::unique_ptr<Reader> reader = createReader(pool, std::move(inStream));
+    EXPECT_EQ(1, reader->getNumberOfStripes());
+    std::unique_ptr<StripeInformation> stripe = reader->getStripe(0);
+    for (uint64_t col = 1; col <= 3; ++col) {
+      EXPECT_EQ(ColumnEncodingKind_DIRECT_V2, stripe->getColumnEncoding(col));
+    }
+    EXPECT_EQ(ColumnEncodingKind_DICTIONARY_V2, stripe->getColumnEncoding(4));
+
+    std::unique_ptr<RowReader> rowReader = createRowReader(reader.get());
+    batch = rowReader->createRowBatch(rowCount);
+    EXPECT_TRUE(rowReader->next(*batch));
+    EXPECT_EQ(rowCount, batch->numElements);
+    structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    for (size_t col = 0; col < 4; ++col) {
+      auto* strBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[col]);
+      auto& values = col == 3 ? repeated : unique;
+      for (uint64_t i = 0; i < rowCount; ++i) {
+        if (i % 13 == 0) {
+          EXPECT_FALSE(strBatch->notNull[i]);
+          continue;
+        }
+        EXPECT_TRUE(strBatch->notNull[i]);
+        std::string expected = values[i];
+        if (col == 2) {
+          expected.resize(8, ' ');
+        }
+        EXPECT_EQ(expected,
+                  std::string(strBatch->data[i], static_cast<size_t>(strBatch->length[i])));
+      }
+    }
+    EXPECT_FALSE(rowReader->next(*batch));
+  }
+
+  static std::string rewriteTestValue(uint64_t row, uint64_t distinct) {
+    return "value-" + std::to_string(row % distinct);
+  }
+
+  // rewrite a file through lazily decoded batches and check that the values
+  // survive whether the new writer keeps or abandons dictionary encoding
+  void testRewriteEncodedBatch(double threshold, uint64_t sampleSize, uint64_t distinct,
+                               ColumnEncodingKind expectedEncoding) {
+    MemoryPool* pool = getDefaultPool();
+    const uint64_t rowCount = 30000, batchSize = 4096;
+
+    MemoryOutputStream sourceStream(DEFAULT_MEM_STREAM_SIZE);
+    {
+      std::unique_ptr<Type> type(Type::buildTypeFromString("struct<a:string,b:string,c:string>"));
+      WriterOptions options;
+      options.setStripeSize(1);
+      options.setMemoryPool(pool);
+      options.setDictionaryKeySizeThreshold(1.0);
+      std::unique_ptr<Writer> writer = createWriter(*type, &sourceStream, options);
+
+      std::vector<std::string> values(batchSize);
+      std::unique_ptr<ColumnVectorBatch> batch = writer->createRowBatch(batchSize);
+      auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+      for (uint64_t start = 0; start < rowCount; start += batchSize) {
+        uint64_t numRows = std::min(batchSize, rowCount - start);
+        for (uint64_t i = 0; i < numRows; ++i) {
+          values[i] = rewriteTestValue(start + i, distinct);
+        }
+        for (auto* field : structBatch->fields) {
+          auto* strBatch = dynamic_cast<StringVectorBatch*>(field);
+          strBatch->hasNulls = true;
+          for (uint64_t i = 0; i < numRows; ++i) {
+            strBatch->notNull[i] = (start + i) % 11 != 0;
+            strBatch->data[i] = const_cast<char*>(values[i].data());
+            strBatch->length[i] = static_cast<int64_t>(values[i].size());
+          }
+          strBatch->numElements = numRows;
+        }
+        structBatch->numElements = numRows;
+        writer->add(*batch);
+      }
+      writer->close();
+    }
+
+    std::unique_ptr<InputStream> sourceInput(
+        new MemoryInputStream(sourceStream.getData(), sourceStream.getLength()));
+    std::unique_ptr<Reader> sourceReader = createReader(pool, std::move(sourceInput));
+    EXPECT_LT(1, sourceReader->getNumberOfStripes());
+    std::unique_ptr<RowReader> sourceRows = createRowReader(sourceReader.get(), true);
+
+    MemoryOutputStream targetStream(DEFAULT_MEM_STREAM_SIZE);
+    {
+      std::unique_ptr<Type> type(
+          Type::buildTypeFromString("struct<a:string,b:varchar(9),c:char(10)>"));
+      WriterOptions options;
+      options.setMemoryPool(pool);
+      options.setRowIndexStride(1000);
+      options.setDictionaryKeySizeThreshold(threshold);
+      options.setDictionarySampleSize(sampleSize);
+      std::unique_ptr<Writer> writer = createWriter(*type, &targetStream, options);
+
+      std::unique_ptr<ColumnVectorBatch> batch = sourceRows->createRowBatch(batchSize);
+      while (sourceRows->next(*batch)) {
+        auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+        for (auto* field : structBatch->fields) {
+          EXPECT_TRUE(field->isEncoded);
+        }
+        writer->add(*batch);
+      }
+      writer->close();
+    }
+
+    std::unique_ptr<InputStream> targetInput(
+        new MemoryInputStream(targetStream.getData(), targetStream.getLength()));
+    std::unique_ptr<Reader> reader = createReader(pool, std::move(targetInput));
+    EXPECT_EQ(rowCount, reader->getNumberOfRows());
+    std::unique_ptr<StripeInformation> stripe = reader->getStripe(0);
+    for (uint64_t col = 1; col <= 3; ++col) {
+      EXPECT_EQ(expectedEncoding, stripe->getColumnEncoding(col));
+    }
+
+    std::unique_ptr<RowReader> rowReader = createRowReader(reader.get());
+    std::unique_ptr<ColumnVectorBatch> batch = rowReader->createRowBatch(batchSize);
+    uint64_t row = 0;
+    while (rowReader->next(*batch)) {
+      auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+      for (uint64_t i = 0; i < batch->numElements; ++i, ++row) {
+        std::string value = rewriteTestValue(row, distinct);
+        std::string expected[] = {value, value.substr(0, 9), value};
+        expected[2].resize(10, ' ');
+        for (size_t col = 0; col < 3; ++col) {
+          auto* strBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[col]);
+          if (row % 11 == 0) {
+            EXPECT_FALSE(strBatch->notNull[i]);
+            continue;
+          }
+          ASSERT_TRUE(strBatch->notNull[i]);
+          EXPECT_EQ(expected[col],
+                    std::string(strBatch->data[i], static_cast<size_t>(strBatch->length[i])));
+        }
+      }
+    }
+    EXPECT_EQ(rowCount, row);
+  }
+
+  TEST(DictionaryEncoding, rewriteEncodedBatch) {
+    // dictionary kept: source entries are mapped instead of hashing every row
+    testRewriteEncodedBatch(DICT_THRESHOLD, 0, 50, ColumnEncodingKind_DICTIONARY_V2);
+    // dictionary abandoned in the middle of the first batch
+    testRewriteEncodedBatch(DICT_THRESHOLD, 100, 10000, ColumnEncodingKind_DIRECT_V2);
+    // dictionary disabled: encoded batches are decoded
+    testRewriteEncodedBatch(FALLBACK_THRESHOLD, 0, 50, ColumnEncodingKind_DIRECT_V2);
+  }
+
 }  // namespace orc
@@ -548,4 +548,98 @@ namespace orc {
       TestFirstStripeSelectedWithStripeStats(reader.get(), pos);
     }
   }
+
+  TEST(TestPredicatePushdown, readRowsBetweenBatches) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    createMemTestFile(memStream, 1000);
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    std::unique_ptr<Reader> reader = createReader(std::move(inStream), ReaderOptions());
+
+    // select the first and the last row group: x < 30000 OR x >= 1020000
+    RowReaderOptions rowReaderOpts;
+    rowReaderOpts.searchArgument(
+        SearchArgumentFactory::newBuilder()
+            ->startOr()
+            .lessThan("int1", PredicateDataType::LONG, Literal(static_cast<int64_t>(300 * 100)))
+            .startNot()
+            .lessThan("int1", PredicateDataType::LONG, Literal(static_cast<int64_t>(300 * 3400)))
+            .end()
+            .end()
+            .build());
+    auto rowReader = reader->createRowReader(rowReaderOpts);
+    auto readBatch = rowReader->createRowBatch(500);
+    auto& longBatch =
+        dynamic_cast<LongVectorBatch&>(*dynamic_cast<StructVectorBatch&>(*readBatch).fields[0]);
+
+    EXPECT_TRUE(rowReader->next(*readBatch));
+    EXPECT_EQ(500, readBatch->numElements);
+    EXPECT_EQ(0, rowReader->getRowNumber());
+
+    // a row of a row group that the search argument skips
+    rowReader->readRows({1500}, *readBatch);
+    EXPECT_EQ(1, readBatch->numElements);
+    EXPECT_EQ(300 * 1500, longBatch.data[0]);
+
+    // reading continues with the next selected row group
+    EXPECT_TRUE(rowReader->next(*readBatch));
+    EXPECT_EQ(500, readBatch->numElements);
+    EXPECT_EQ(3000, rowReader->getRowNumber());
+    for (uint64_t i = 0; i < 500; ++i) {
+      EXPECT_EQ(300 * (i + 3000), longBatch.data[i]);
+    }
+    EXPECT_FALSE(rowReader->next(*readBatch));
+    EXPECT_EQ(3500, rowReader->getRowNumber());
+  }
+
+  TEST(TestPredicatePushdown, allRowsMatch) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    createMemTestFile(memStream, 1000);
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    std::unique_ptr<Reader> reader = createReader(std::move(inStream), ReaderOptions());
+
+    // int1 < 450000 holds for all rows of row group 0 and some of row group 1
+    for (bool withDeletes : {false, true}) {
+      RowReaderOptions rowReaderOpts;
+      rowReaderOpts.searchArgument(
+          SearchArgumentFactory::newBuilder()
+              ->lessThan("int1", PredicateDataType::LONG, Literal(static_cast<int64_t>(450000L)))
+              .build());
+      if (withDeletes) {
+        rowReaderOpts.setDeletedRows({5, 10, 1200});
+      }
+      auto rowReader = reader->createRowReader(rowReaderOpts);
+      EXPECT_FALSE(rowReader->allRowsMatch());
+
+      // the batches stop at the row group boundary although they could hold more
+      auto readBatch = rowReader->createRowBatch(5000);
+      EXPECT_TRUE(rowReader->next(*readBatch));
+      EXPECT_EQ(withDeletes ? 998 : 1000, readBatch->numElements);
+      EXPECT_EQ(0, rowReader->getRowNumber());
+      EXPECT_TRUE(rowReader->allRowsMatch());
+
+      EXPECT_TRUE(rowReader->next(*readBatch));
+      EXPECT_EQ(withDeletes ? 999 : 1000, readBatch->numElements);
+      EXPECT_EQ(1000, rowReader->getRowNumber());
+      EXPECT_FALSE(rowReader->allRowsMatch());
+
+      EXPECT_FALSE(rowReader->next(*readBatch));
+      EXPECT_FALSE(rowReader->allRowsMatch());
+
+      // seeking into the middle of a matching row group keeps the flag
+      rowReader->seekToRow(500);
+      EXPECT_TRUE(rowReader->next(*readBatch));
+      EXPECT_EQ(500, readBatch->numElements);
+      EXPECT_TRUE(rowReader->allRowsMatch());
+
+      rowReader->readRows({100, 200}, *readBatch);
+      EXPECT_FALSE(rowReader->allRowsMatch());
+    }
+
+    // without a search argument nothing is known
+    auto rowReader = reader->createRowReader(RowReaderOptions());
+    auto readBatch = rowReader->createRowBatch(5000);
+    EXPECT_TRUE(rowReader->next(*readBatch));
+    EXPECT_EQ(3500, readBatch->numElements);
+    EXPECT_FALSE(rowReader->allRowsMatch());
+  }
 }  // namespace orc
@@ -17,6 +17,7 @@
  */
 
 #include <cstring>
+#include <set>
 
 #include "Reader.hh"
 #include "orc/Reader.hh"
@@ -935,4 +936,287 @@ namespace orc {
       }
     }
   }
+
+  // Write rowCount rows of struct<id:bigint,name:string,items:array<int>> in
+  // several stripes with row groups of 1000 rows. Every 7th name is null and
+  // row r has r % 3 items.
+  std::unique_ptr<Reader> createIdNameListReader(MemoryOutputStream& memStream,
+                                                 uint64_t rowCount) {
+    MemoryPool* pool = getDefaultPool();
+    const uint64_t batchSize = 1000;
+    auto type = std::unique_ptr<Type>(
+        Type::buildTypeFromString("struct<id:bigint,name:string,items:array<int>>"));
+    {
+      WriterOptions options;
+      options.setStripeSize(4 * 1024)
+          .setCompressionBlockSize(1024)
+          .setMemoryBlockSize(64)
+          .setCompression(CompressionKind_ZLIB)
+          .setMemoryPool(pool)
+          .setRowIndexStride(1000);
+      auto writer = createWriter(*type, &memStream, options);
+      auto batch = writer->createRowBatch(batchSize);
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+      auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+      auto& listBatch = dynamic_cast<ListVectorBatch&>(*structBatch.fields[2]);
+      auto& itemBatch = dynamic_cast<LongVectorBatch&>(*listBatch.elements);
+      std::vector<std::string> names(batchSize);
+      for (uint64_t start = 0; start < rowCount; start += batchSize) {
+        uint64_t items = 0;
+        nameBatch.hasNulls = true;
+        for (uint64_t i = 0; i < batchSize; ++i) {
+          uint64_t row = start + i;
+          idBatch.data[i] = static_cast<int64_t>(row);
+          names[i] = "name-" + std::to_string(row);
+          nameBatch.notNull[i] = row % 7 != 0;
+          nameBatch.data[i] = const_cast<char*>(names[i].c_str());
+          nameBatch.length[i] = static_cast<int64_t>(names[i].size());
+          listBatch.offsets[i] = static_cast<int64_t>(items);
+          for (uint64_t j = 0; j < row % 3; ++j) {
+            itemBatch.data[items++] = static_cast<int64_t>(row + j);
+          }
+        }
+        listBatch.offsets[batchSize] = static_cast<int64_t>(items);
+        itemBatch.numElements = items;
+        structBatch.numElements = idBatch.numElements = nameBatch.numElements =
+            listBatch.numElements = batchSize;
+        writer->add(*batch);
+      }
+      writer->close();
+    }
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    ReaderOptions readerOptions;
+    readerOptions.setMemoryPool(*pool);
+    return createReader(std::move(inStream), readerOptions);
+  }
+
+  TEST(TestRowReader, readRows) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t rowCount = 20000;
+    std::unique_ptr<Reader> reader = createIdNameListReader(memStream, rowCount);
+    ASSERT_GT(reader->getNumberOfStripes(), 2);
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader(RowReaderOptions());
+    auto batch = rowReader->createRowBatch(4);
+
+    // runs, gaps inside a row group, gaps over row groups and stripes
+    std::vector<uint64_t> rowIds = {0, 1, 2, 3, 4, 5, 6, 7, 500, 999, 1000, 1001, 7777};
+    for (uint64_t row = 12000; row < 12100; ++row) {
+      rowIds.push_back(row);
+    }
+    rowIds.push_back(rowCount - 1);
+    rowReader->readRows(rowIds, *batch);
+    ASSERT_EQ(rowIds.size(), batch->numElements);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+    auto& listBatch = dynamic_cast<ListVectorBatch&>(*structBatch.fields[2]);
+    auto& itemBatch = dynamic_cast<LongVectorBatch&>(*listBatch.elements);
+    EXPECT_TRUE(nameBatch.hasNulls);
+    for (uint64_t i = 0; i < rowIds.size(); ++i) {
+      uint64_t row = rowIds[i];
+      EXPECT_EQ(row, idBatch.data[i]);
+      ASSERT_EQ(row % 7 != 0, nameBatch.notNull[i] != 0) << row;
+      if (nameBatch.notNull[i]) {
+        EXPECT_EQ("name-" + std::to_string(row),
+                  std::string(nameBatch.data[i], static_cast<size_t>(nameBatch.length[i])));
+      }
+      ASSERT_EQ(row % 3, listBatch.offsets[i + 1] - listBatch.offsets[i]) << row;
+      for (uint64_t j = 0; j < row % 3; ++j) {
+        EXPECT_EQ(row + j, itemBatch.data[static_cast<uint64_t>(listBatch.offsets[i]) + j]);
+      }
+    }
+    EXPECT_EQ(0, rowReader->getRowNumber());
+
+    // reading continues after the last requested row, also across calls
+    rowReader->readRows({10, 11}, *batch);
+    EXPECT_EQ(2, batch->numElements);
+    EXPECT_EQ(11, idBatch.data[1]);
+    EXPECT_TRUE(rowReader->next(*batch));
+    EXPECT_EQ(12, idBatch.data[0]);
+
+    EXPECT_THROW(rowReader->readRows({5, 5}, *batch), InvalidArgument);
+    EXPECT_THROW(rowReader->readRows({rowCount}, *batch), InvalidArgument);
+    rowReader->readRows({}, *batch);
+    EXPECT_EQ(0, batch->numElements);
+  }
+
+  TEST(TestRowReader, columnMetrics) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t rowCount = 20000;
+    createIdNameListReader(memStream, rowCount);
+    ColumnMetricsTable table;
+    ReaderOptions readerOptions;
+    readerOptions.setColumnMetricsTable(&table);
+    std::unique_ptr<Reader> reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.include(std::list<std::string>{"id", "items"});
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader(rowReaderOptions);
+    auto batch = rowReader->createRowBatch(1000);
+    while (rowReader->next(*batch)) {
+    }
+
+    // the name column isn't selected
+    const std::map<uint64_t, ColumnReaderMetrics>& columns = table.getColumns();
+    ASSERT_EQ(4, columns.size());
+    EXPECT_EQ(0, columns.count(2));
+    EXPECT_EQ(rowCount, columns.at(0).RowsRead);
+    EXPECT_EQ(rowCount / 1000, columns.at(0).ReaderCall);
+    EXPECT_EQ(rowCount, columns.at(1).RowsRead);
+    EXPECT_EQ(rowCount, columns.at(3).RowsRead);
+    // every row has row % 3 items
+    EXPECT_EQ(rowCount - 1, columns.at(4).RowsRead);
+
+    const StreamReaderMetrics& ids = columns.at(1).streams.at(StreamKind_DATA);
+    EXPECT_EQ(rowCount, ids.ValuesDecoded);
+    EXPECT_LE(rowCount / 1000, ids.DecodingCall);
+    EXPECT_LT(0, ids.DecompressionCall);
+    EXPECT_LT(ids.BytesRead, ids.BytesDecompressed);
+    EXPECT_EQ(rowCount, columns.at(3).streams.at(StreamKind_LENGTH).ValuesDecoded);
+    EXPECT_EQ(rowCount - 1, columns.at(4).streams.at(StreamKind_DATA).ValuesDecoded);
+    uint64_t bytesRead = 0;
+    for (const auto& column : columns) {
+      for (const auto& stream : column.second.streams) {
+        bytesRead += stream.second.BytesRead;
+      }
+    }
+    EXPECT_LT(0, bytesRead);
+    EXPECT_GT(reader->getFileLength(), bytesRead);
+  }
+
+  TEST(TestRowReader, deletedRows) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t rowCount = 20000;
+    std::unique_ptr<Reader> reader = createIdNameListReader(memStream, rowCount);
+    ASSERT_GT(reader->getNumberOfStripes(), 2);
+    uint64_t secondStripeStart = reader->getStripe(0)->getNumberOfRows();
+    uint64_t thirdStripeStart = secondStripeStart + reader->getStripe(1)->getNumberOfRows();
+
+    // a few rows, a whole row group, every third row of a range and the
+    // whole second stripe
+    ASSERT_GE(secondStripeStart, 2000);
+    std::set<uint64_t> deleted = {0, 1, 2, 999, rowCount - 1};
+    for (uint64_t row = 1000; row < 2000; ++row) {
+      deleted.insert(row);
+    }
+    for (uint64_t row = thirdStripeStart + 100; row < thirdStripeStart + 900; row += 3) {
+      deleted.insert(row);
+    }
+    for (uint64_t row = secondStripeStart; row < thirdStripeStart; ++row) {
+      deleted.insert(row);
+    }
+    RowReaderOptions options;
+    options.setDeletedRows(std::vector<uint64_t>(deleted.begin(), deleted.end()));
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader(options);
+    auto batch = rowReader->createRowBatch(1000);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+    auto& listBatch = dynamic_cast<ListVectorBatch&>(*structBatch.fields[2]);
+    auto& itemBatch = dynamic_cast<LongVectorBatch&>(*listBatch.elements);
+
+    uint64_t expected = 0;
+    while (rowReader->next(*batch)) {
+      for (uint64_t i = 0; i < batch->numElements; ++i) {
+        while (deleted.count(expected) > 0) {
+          ++expected;
+        }
+        ASSERT_EQ(expected, idBatch.data[i]);
+        ASSERT_EQ(expected % 7 != 0, nameBatch.notNull[i] != 0);
+        if (nameBatch.notNull[i]) {
+          EXPECT_EQ("name-" + std::to_string(expected),
+                    std::string(nameBatch.data[i], static_cast<size_t>(nameBatch.length[i])));
+        }
+        ASSERT_EQ(expected % 3, listBatch.offsets[i + 1] - listBatch.offsets[i]);
+        if (expected % 3 > 0) {
+          EXPECT_EQ(expected, itemBatch.data[static_cast<uint64_t>(listBatch.offsets[i])]);
+        }
+        ++expected;
+      }
+    }
+    EXPECT_EQ(rowCount - 1, expected);
+
+    // seeking lands on the next row that is not deleted
+    rowReader->seekToRow(1500);
+    ASSERT_TRUE(rowReader->next(*batch));
+    EXPECT_EQ(2000, idBatch.data[0]);
+    rowReader->seekToRow(secondStripeStart + 10);
+    ASSERT_TRUE(rowReader->next(*batch));
+    EXPECT_EQ(thirdStripeStart, idBatch.data[0]);
+
+    options.setDeletedRows({2, 1});
+    EXPECT_THROW(reader->createRowReader(options), InvalidArgument);
+  }
+
+  TEST(TestReader, planScan) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t rowCount = 20000;
+    std::unique_ptr<Reader> reader = createIdNameListReader(memStream, rowCount);
+    uint64_t numStripes = reader->getNumberOfStripes();
+    ASSERT_GT(numStripes, 4);
+
+    std::vector<ScanSplit> splits = reader->planScan(RowReaderOptions(), 1);
+    ASSERT_EQ(1, splits.size());
+    EXPECT_EQ(numStripes, splits[0].stripes.size());
+    EXPECT_EQ(reader->getStripe(0)->getOffset(), splits[0].offset);
+
+    // only the streams of the name column count
+    RowReaderOptions options;
+    options.include(std::list<std::string>{"name"});
+    splits = reader->planScan(options, 3);
+    ASSERT_EQ(3, splits.size());
+    uint64_t stripeCount = 0;
+    uint64_t totalBytes = 0;
+    uint64_t maxStripeBytes = 0;
+    uint64_t maxSplitBytes = 0;
+    for (const auto& split : splits) {
+      uint64_t splitRows = 0;
+      for (const auto& stripe : split.stripes) {
+        EXPECT_EQ(stripeCount++, stripe.index);
+        EXPECT_GT(stripe.selectedBytes, 0);
+        EXPECT_LT(stripe.selectedBytes, stripe.length);
+        totalBytes += stripe.selectedBytes;
+        maxStripeBytes = std::max(maxStripeBytes, stripe.selectedBytes);
+        splitRows += stripe.numberOfRows;
+      }
+      maxSplitBytes = std::max(maxSplitBytes, split.selectedBytes);
+
+      // the range of a split reads exactly its stripes
+      RowReaderOptions rangeOptions;
+      rangeOptions.include(std::list<std::string>{"name"}).range(split.offset, split.length);
+      auto rowReader = reader->createRowReader(rangeOptions);
+      auto batch = rowReader->createRowBatch(1000);
+      uint64_t rows = 0;
+      while (rowReader->next(*batch)) {
+        rows += batch->numElements;
+      }
+      EXPECT_EQ(splitRows, rows);
+    }
+    EXPECT_EQ(numStripes, stripeCount);
+    EXPECT_LE(maxSplitBytes, totalBytes / 3 + maxStripeBytes);
+
+    EXPECT_EQ(numStripes, reader->planScan(options, 1000).size());
+    EXPECT_THROW(reader->planScan(options, 0), InvalidArgument);
+
+    // stripe statistics drop the stripes before id 15000
+    options.searchArgument(
+        SearchArgumentFactory::newBuilder()
+            ->startNot()
+            .lessThan("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(15000)))
+            .end()
+            .build());
+    splits = reader->planScan(options, 2);
+    ASSERT_EQ(2, splits.size());
+    uint64_t firstStripe = splits[0].stripes.front().index;
+    uint64_t firstRow = 0;
+    for (uint64_t i = 0; i < firstStripe; ++i) {
+      firstRow += reader->getStripe(i)->getNumberOfRows();
+    }
+    EXPECT_LE(firstRow, 15000);
+    EXPECT_GT(firstRow + reader->getStripe(firstStripe)->getNumberOfRows(), 15000);
+    EXPECT_EQ(numStripes - 1, splits[1].stripes.back().index);
+  }
 }  // namespace orc
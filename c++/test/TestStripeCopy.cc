@@ -0,0 +1,291 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/OrcFile.hh"
+
+#include "MemoryInputStream.hh"
+#include "MemoryOutputStream.hh"
+
+#include "wrap/gtest-wrapper.h"
+#include "wrap/orc-proto-wrapper.hh"
+
+#include <cstring>
+#include <functional>
+
+namespace orc {
+
+  const int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;  // 10M
+
+  // write rows of x = row and s = "row-<row>" in several stripes
+  static void writeFile(MemoryOutputStream& stream, uint64_t firstRow, uint64_t rowCount,
+                        CompressionKind compression, const std::string& metadataKey) {
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<x:bigint,s:string>"));
+    WriterOptions options;
+    options.setStripeSize(1024);
+    options.setMemoryBlockSize(64);
+    options.setCompressionBlockSize(1024);
+    options.setCompression(compression);
+    options.setMemoryPool(getDefaultPool());
+    std::unique_ptr<Writer> writer = createWriter(*type, &stream, options);
+    writer->addUserMetadata(metadataKey, std::to_string(firstRow));
+    writer->addUserMetadata("common", std::to_string(firstRow));
+
+    std::unique_ptr<ColumnVectorBatch> batch = writer->createRowBatch(1000);
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    auto* longBatch = dynamic_cast<LongVectorBatch*>(structBatch->fields[0]);
+    auto* strBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[1]);
+    std::vector<std::string> values(1000);
+    for (uint64_t start = 0; start < rowCount; start += 1000) {
+      uint64_t numRows = std::min<uint64_t>(1000, rowCount - start);
+      for (uint64_t i = 0; i < numRows; ++i) {
+        longBatch->data[i] = static_cast<int64_t>(firstRow + start + i);
+        values[i] = "row-" + std::to_string(firstRow + start + i);
+        strBatch->data[i] = const_cast<char*>(values[i].data());
+        strBatch->length[i] = static_cast<int64_t>(values[i].size());
+      }
+      structBatch->numElements = longBatch->numElements = strBatch->numElements = numRows;
+      writer->add(*batch);
+    }
+    writer->close();
+  }
+
+  static std::unique_ptr<Reader> createReader(const MemoryOutputStream& stream) {
+    ReaderOptions options;
+    options.setMemoryPool(*getDefaultPool());
+    return createReader(std::make_unique<MemoryInputStream>(stream.getData(), stream.getLength()),
+                        options);
+  }
+
+  TEST(StripeCopy, mergeFiles) {
+    MemoryOutputStream first(DEFAULT_MEM_STREAM_SIZE), second(DEFAULT_MEM_STREAM_SIZE);
+    writeFile(first, 0, 3000, CompressionKind_ZLIB, "first");
+    writeFile(second, 3000, 2000, CompressionKind_ZLIB, "second");
+    std::unique_ptr<Reader> firstReader = createReader(first);
+    std::unique_ptr<Reader> secondReader = createReader(second);
+
+    MemoryOutputStream merged(DEFAULT_MEM_STREAM_SIZE);
+    mergeFiles({firstReader.get(), secondReader.get()}, &merged);
+
+    std::unique_ptr<Reader> reader = createReader(merged);
+    uint64_t firstStripes = firstReader->getNumberOfStripes();
+    EXPECT_LT(1, firstStripes);
+    EXPECT_EQ(firstStripes + secondReader->getNumberOfStripes(), reader->getNumberOfStripes());
+    EXPECT_EQ(reader->getNumberOfStripes(), reader->getNumberOfStripeStatistics());
+
+    // the stripes are copied as they are, along with their statistics
+    for (uint64_t i = 0; i < secondReader->getNumberOfStripes(); ++i) {
+      std::unique_ptr<StripeInformation> source = secondReader->getStripe(i);
+      std::unique_ptr<StripeInformation> copy = reader->getStripe(firstStripes + i);
+      ASSERT_EQ(source->getLength(), copy->getLength());
+      EXPECT_EQ(0, memcmp(second.getData() + source->getOffset(),
+                          merged.getData() + copy->getOffset(), source->getLength()));
+      EXPECT_EQ(secondReader->getStripeStatistics(i)->getColumnStatistics(1)->toString(),
+                reader->getStripeStatistics(firstStripes + i)->getColumnStatistics(1)->toString());
+    }
+
+    EXPECT_EQ(5000, reader->getNumberOfRows());
+    EXPECT_EQ(CompressionKind_ZLIB, reader->getCompression());
+    EXPECT_EQ("0", reader->getMetadataValue("first"));
+    EXPECT_EQ("3000", reader->getMetadataValue("second"));
+    EXPECT_EQ("0", reader->getMetadataValue("common"));
+
+    std::unique_ptr<ColumnStatistics> colStats = reader->getColumnStatistics(1);
+    auto* intStats = dynamic_cast<const IntegerColumnStatistics*>(colStats.get());
+    ASSERT_NE(nullptr, intStats);
+    EXPECT_EQ(5000, intStats->getNumberOfValues());
+    EXPECT_EQ(0, intStats->getMinimum());
+    EXPECT_EQ(4999, intStats->getMaximum());
+    EXPECT_EQ(4999 * 5000 / 2, intStats->getSum());
+    colStats = reader->getColumnStatistics(2);
+    auto* strStats = dynamic_cast<const StringColumnStatistics*>(colStats.get());
+    ASSERT_NE(nullptr, strStats);
+    EXPECT_EQ("row-0", strStats->getMinimum());
+    EXPECT_EQ("row-999", strStats->getMaximum());
+
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader();
+    std::unique_ptr<ColumnVectorBatch> batch = rowReader->createRowBatch(1024);
+    uint64_t row = 0;
+    while (rowReader->next(*batch)) {
+      auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+      auto* longBatch = dynamic_cast<LongVectorBatch*>(structBatch->fields[0]);
+      auto* strBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[1]);
+      for (uint64_t i = 0; i < batch->numElements; ++i, ++row) {
+        EXPECT_EQ(static_cast<int64_t>(row), longBatch->data[i]);
+        EXPECT_EQ("row-" + std::to_string(row),
+                  std::string(strBatch->data[i], static_cast<size_t>(strBatch->length[i])));
+      }
+    }
+    EXPECT_EQ(5000, row);
+  }
+
+  TEST(StripeCopy, mergeIncompatibleFiles) {
+    MemoryOutputStream first(DEFAULT_MEM_STREAM_SIZE), second(DEFAULT_MEM_STREAM_SIZE);
+    writeFile(first, 0, 1000, CompressionKind_ZLIB, "first");
+    writeFile(second, 1000, 1000, CompressionKind_ZSTD, "second");
+    std::unique_ptr<Reader> firstReader = createReader(first);
+    std::unique_ptr<Reader> secondReader = createReader(second);
+
+    MemoryOutputStream merged(DEFAULT_MEM_STREAM_SIZE);
+    EXPECT_THROW(mergeFiles({firstReader.get(), secondReader.get()}, &merged), InvalidArgument);
+    EXPECT_THROW(mergeFiles({}, &merged), InvalidArgument);
+  }
+
+  // rewrite the footer of an uncompressed file
+  static void rewriteFooter(const MemoryOutputStream& input, MemoryOutputStream& output,
+                            const std::function<void(proto::Footer&)>& change) {
+    const char* data = input.getData();
+    const size_t length = input.getLength();
+    const size_t psLength = static_cast<unsigned char>(data[length - 1]);
+    proto::PostScript postScript;
+    ASSERT_TRUE(
+        postScript.ParseFromArray(data + length - 1 - psLength, static_cast<int>(psLength)));
+    ASSERT_EQ(proto::NONE, postScript.compression());
+    const size_t footerStart = length - 1 - psLength - postScript.footer_length();
+    proto::Footer footer;
+    ASSERT_TRUE(footer.ParseFromArray(data + footerStart,
+                                      static_cast<int>(postScript.footer_length())));
+    change(footer);
+
+    std::string tail = footer.SerializeAsString();
+    postScript.set_footer_length(tail.size());
+    std::string serializedPostScript = postScript.SerializeAsString();
+    tail += serializedPostScript;
+    tail += static_cast<char>(serializedPostScript.size());
+    output.write(data, footerStart);
+    output.write(tail.data(), tail.size());
+  }
+
+  TEST(StripeCopy, truncatedOrEncryptedFiles) {
+    MemoryOutputStream source(DEFAULT_MEM_STREAM_SIZE);
+    writeFile(source, 0, 3000, CompressionKind_NONE, "source");
+
+    // the statistics of column s are missing
+    MemoryOutputStream truncated(DEFAULT_MEM_STREAM_SIZE);
+    rewriteFooter(source, truncated, [](proto::Footer& footer) {
+      footer.mutable_statistics()->RemoveLast();
+    });
+    std::unique_ptr<Reader> truncatedReader = createReader(truncated);
+    MemoryOutputStream output(DEFAULT_MEM_STREAM_SIZE);
+    EXPECT_THROW(projectColumns(truncatedReader.get(), {"s"}, &output), ParseError);
+    EXPECT_THROW(mergeFiles({truncatedReader.get()}, &output), ParseError);
+
+    MemoryOutputStream encrypted(DEFAULT_MEM_STREAM_SIZE);
+    rewriteFooter(source, encrypted, [](proto::Footer& footer) {
+      footer.mutable_encryption()->add_key()->set_key_name("pii");
+    });
+    std::unique_ptr<Reader> encryptedReader = createReader(encrypted);
+    EXPECT_THROW(projectColumns(encryptedReader.get(), {"x"}, &output), NotImplementedYet);
+    EXPECT_THROW(mergeFiles({encryptedReader.get()}, &output), NotImplementedYet);
+  }
+
+  TEST(StripeCopy, projectColumns) {
+    MemoryOutputStream source(DEFAULT_MEM_STREAM_SIZE);
+    std::unique_ptr<Type> type(
+        Type::buildTypeFromString("struct<a:bigint,b:struct<c:string,d:double>,e:string>"));
+    WriterOptions options;
+    options.setStripeSize(1024);
+    options.setMemoryBlockSize(64);
+    options.setCompressionBlockSize(1024);
+    options.setRowIndexStride(500);
+    options.setColumnsUseBloomFilter({5});
+    options.setMemoryPool(getDefaultPool());
+    std::unique_ptr<Writer> writer = createWriter(*type, &source, options);
+
+    const uint64_t rowCount = 3000, batchSize = 500;
+    std::vector<std::string> cValues(rowCount), eValues(rowCount);
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      cValues[i] = "c" + std::to_string(i % 100);
+      eValues[i] = "e" + std::to_string(i);
+    }
+    std::unique_ptr<ColumnVectorBatch> batch = writer->createRowBatch(batchSize);
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    auto* aBatch = dynamic_cast<LongVectorBatch*>(structBatch->fields[0]);
+    auto* bBatch = dynamic_cast<StructVectorBatch*>(structBatch->fields[1]);
+    auto* cBatch = dynamic_cast<StringVectorBatch*>(bBatch->fields[0]);
+    auto* dBatch = dynamic_cast<DoubleVectorBatch*>(bBatch->fields[1]);
+    auto* eBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[2]);
+    eBatch->hasNulls = true;
+    for (uint64_t start = 0; start < rowCount; start += batchSize) {
+      for (uint64_t i = 0; i < batchSize; ++i) {
+        uint64_t row = start + i;
+        aBatch->data[i] = static_cast<int64_t>(row);
+        eBatch->notNull[i] = row % 7 != 0;
+        cBatch->data[i] = const_cast<char*>(cValues[row].data());
+        cBatch->length[i] = static_cast<int64_t>(cValues[row].size());
+        dBatch->data[i] = static_cast<double>(row) / 2;
+        eBatch->data[i] = const_cast<char*>(eValues[row].data());
+        eBatch->length[i] = static_cast<int64_t>(eValues[row].size());
+      }
+      structBatch->numElements = aBatch->numElements = bBatch->numElements = batchSize;
+      cBatch->numElements = dBatch->numElements = eBatch->numElements = batchSize;
+      writer->add(*batch);
+    }
+    writer->close();
+
+    std::unique_ptr<Reader> sourceReader = createReader(source);
+    MemoryOutputStream projected(DEFAULT_MEM_STREAM_SIZE);
+    projectColumns(sourceReader.get(), {"e", "b"}, &projected);
+    EXPECT_THROW(projectColumns(sourceReader.get(), {"a", "x"}, &projected), InvalidArgument);
+
+    std::unique_ptr<Reader> reader = createReader(projected);
+    EXPECT_EQ("struct<b:struct<c:string,d:double>,e:string>", reader->getType().toString());
+    EXPECT_EQ(rowCount, reader->getNumberOfRows());
+    EXPECT_LT(1, reader->getNumberOfStripes());
+    EXPECT_EQ(sourceReader->getNumberOfStripes(), reader->getNumberOfStripes());
+    EXPECT_LT(projected.getLength(), source.getLength());
+
+    // statistics move along with their columns
+    const uint32_t sourceIds[] = {0, 2, 3, 4, 5};
+    for (uint32_t col = 0; col < 5; ++col) {
+      EXPECT_EQ(sourceReader->getColumnStatistics(sourceIds[col])->toString(),
+                reader->getColumnStatistics(col)->toString());
+      std::unique_ptr<StripeStatistics> sourceStats = sourceReader->getStripeStatistics(1);
+      EXPECT_EQ(sourceStats->getColumnStatistics(sourceIds[col])->toString(),
+                reader->getStripeStatistics(1)->getColumnStatistics(col)->toString());
+    }
+    std::map<uint32_t, BloomFilterIndex> bloomFilters = reader->getBloomFilters(0, {4});
+    ASSERT_EQ(1, bloomFilters.count(4));
+    EXPECT_FALSE(bloomFilters[4].entries.empty());
+
+    // seek into a later row group to use the copied row indexes
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader();
+    batch = rowReader->createRowBatch(rowCount);
+    rowReader->seekToRow(1234);
+    ASSERT_TRUE(rowReader->next(*batch));
+    structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    bBatch = dynamic_cast<StructVectorBatch*>(structBatch->fields[0]);
+    cBatch = dynamic_cast<StringVectorBatch*>(bBatch->fields[0]);
+    dBatch = dynamic_cast<DoubleVectorBatch*>(bBatch->fields[1]);
+    eBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[1]);
+    uint64_t row = 1234;
+    do {
+      for (uint64_t i = 0; i < batch->numElements; ++i, ++row) {
+        EXPECT_EQ(cValues[row],
+                  std::string(cBatch->data[i], static_cast<size_t>(cBatch->length[i])));
+        EXPECT_EQ(static_cast<double>(row) / 2, dBatch->data[i]);
+        EXPECT_EQ(row % 7 != 0, eBatch->notNull[i] != 0);
+        if (row % 7 != 0) {
+          EXPECT_EQ(eValues[row],
+                    std::string(eBatch->data[i], static_cast<size_t>(eBatch->length[i])));
+        }
+      }
+    } while (rowReader->next(*batch));
+    EXPECT_EQ(rowCount, row);
+  }
+
+}  // namespace orc
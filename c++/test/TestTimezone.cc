@@ -405,6 +405,62 @@ namespace orc {
     EXPECT_EQ(1699164000 + 8 * 3600, la->convertFromUTC(1699164000));
   }
 
+  // times from 1900 to 2300, both inside the transition table and in the future rule
+  static std::vector<int64_t> getSampleTimes() {
+    std::vector<int64_t> times;
+    uint64_t state = 12345;
+    for (int i = 0; i < 2000; ++i) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      times.push_back(-2208988800LL + static_cast<int64_t>((state >> 16) % 12623040000ULL));
+    }
+    // a sorted run that crosses the 2023 transitions in New York
+    for (int64_t t = 1678586399 - 3600; t < 1699164000 + 3600; t += 1800) {
+      times.push_back(t);
+    }
+    return times;
+  }
+
+  TEST(TestTimezone, testVariantRange) {
+    for (const char* name : {"America/Los_Angeles", "America/New_York", "GMT", "Asia/Shanghai",
+                             "Australia/Sydney"}) {
+      const Timezone& zone = getTimezoneByName(name);
+      for (int64_t clk : getSampleTimes()) {
+        int64_t start = 0, end = 0;
+        const TimezoneVariant& variant = zone.getVariant(clk, start, end);
+        EXPECT_TRUE(variant.hasSameTzRule(zone.getVariant(clk))) << name << " " << clk;
+        ASSERT_LE(start, clk);
+        ASSERT_LT(clk, end);
+        EXPECT_TRUE(variant.hasSameTzRule(zone.getVariant(start))) << name << " " << clk;
+        EXPECT_TRUE(variant.hasSameTzRule(zone.getVariant(end - 1))) << name << " " << clk;
+      }
+    }
+  }
+
+  TEST(TestTimezone, testBatchConversion) {
+    std::vector<int64_t> times = getSampleTimes();
+    std::vector<char> notNull(times.size());
+    for (size_t i = 0; i < times.size(); ++i) {
+      notNull[i] = i % 5 != 0;
+    }
+    for (const char* name : {"America/Los_Angeles", "America/New_York", "Asia/Shanghai",
+                             "Australia/Sydney"}) {
+      const Timezone& zone = getTimezoneByName(name);
+      std::vector<int64_t> toUTC = times;
+      std::vector<int64_t> fromUTC = times;
+      zone.convertToUTC(toUTC.data(), toUTC.size(), notNull.data());
+      zone.convertFromUTC(fromUTC.data(), fromUTC.size(), notNull.data());
+      for (size_t i = 0; i < times.size(); ++i) {
+        EXPECT_EQ(notNull[i] ? zone.convertToUTC(times[i]) : times[i], toUTC[i]) << name;
+        EXPECT_EQ(notNull[i] ? zone.convertFromUTC(times[i]) : times[i], fromUTC[i]) << name;
+      }
+      std::vector<int64_t> all = times;
+      zone.convertToUTC(all.data(), all.size());
+      for (size_t i = 0; i < times.size(); ++i) {
+        EXPECT_EQ(zone.convertToUTC(times[i]), all[i]) << name;
+      }
+    }
+  }
+
   bool setEnv(const char* name, const char* value) {
 #ifdef _MSC_VER
     return _putenv_s(name, value) == 0;
@@ -479,4 +535,41 @@ namespace orc {
     }
   }
 
+  TEST(TestTimezone, testEmbeddedTzdata) {
+    EXPECT_EQ(nullptr, findEmbeddedZone("No/Such_Zone"));
+    const EmbeddedZone* la = findEmbeddedZone("America/Los_Angeles");
+    if (la == nullptr) {
+      GTEST_SKIP() << "built without BUILD_EMBEDDED_TZDATA";
+    }
+    EXPECT_STREQ("America/Los_Angeles", la->name);
+    std::unique_ptr<Timezone> zone =
+        getTimezone(la->name, std::vector<unsigned char>(la->data, la->data + la->length));
+    EXPECT_EQ("PST", getVariantFromZone(*zone, "1974-01-06 09:59:59"));
+    EXPECT_EQ("PDT", getVariantFromZone(*zone, "1974-01-06 10:00:00"));
+
+    // without TZDIR, zones are found even if no database is installed
+    const char* tzDir = std::getenv("TZDIR");
+    std::string tzDirBackup = tzDir != nullptr ? tzDir : "";
+    const char* condaPrefix = std::getenv("CONDA_PREFIX");
+    std::string condaPrefixBackup = condaPrefix != nullptr ? condaPrefix : "";
+    if (tzDir != nullptr) {
+      ASSERT_TRUE(delEnv("TZDIR"));
+    }
+    ASSERT_TRUE(setEnv("CONDA_PREFIX", "/path/to/wrong/conda"));
+    const Timezone* ktm = &getTimezoneByName("Asia/Kathmandu");
+    EXPECT_EQ("+0530", getVariantFromZone(*ktm, "1985-12-31 18:29:59"));
+    EXPECT_EQ("+0545", getVariantFromZone(*ktm, "1985-12-31 18:30:00"));
+    EXPECT_EQ(ktm, &getTimezoneByName("Asia/Kathmandu"));
+
+    // restore state of environment variables
+    if (!condaPrefixBackup.empty()) {
+      ASSERT_TRUE(setEnv("CONDA_PREFIX", condaPrefixBackup.c_str()));
+    } else {
+      ASSERT_TRUE(delEnv("CONDA_PREFIX"));
+    }
+    if (!tzDirBackup.empty()) {
+      ASSERT_TRUE(setEnv("TZDIR", tzDirBackup.c_str()));
+    }
+  }
+
 }  // namespace orc
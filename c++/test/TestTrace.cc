@@ -0,0 +1,190 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "MemoryInputStream.hh"
+#include "MemoryOutputStream.hh"
+#include "orc/OrcFile.hh"
+#include "orc/Trace.hh"
+
+#include "wrap/gmock.h"
+#include "wrap/gtest-wrapper.h"
+
+#include <sstream>
+#include <thread>
+
+namespace orc {
+
+  static const int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;  // 10M
+
+  // the number of spans with the given name
+  static size_t countSpans(const TraceRecorder& recorder, const std::string& name) {
+    size_t count = 0;
+    for (const auto& span : recorder.getSpans()) {
+      count += name == span.name;
+    }
+    return count;
+  }
+
+  TEST(TestTrace, writeChromeTrace) {
+    TraceRecorder recorder;
+    uint64_t start = recorder.now();
+    recorder.addSpan("first", "read", start, {{"stripe", 3}, {"length", 42}});
+    std::thread([&recorder] { recorder.addSpan("second", "write", recorder.now()); }).join();
+
+    std::vector<TraceSpan> spans = recorder.getSpans();
+    ASSERT_EQ(2, spans.size());
+    EXPECT_STREQ("first", spans[0].name);
+    EXPECT_EQ(start, spans[0].startUs);
+    EXPECT_EQ(0, spans[0].thread);
+    EXPECT_EQ(1, spans[1].thread);
+
+    std::ostringstream out;
+    recorder.writeChromeTrace(out);
+    std::string expected = "{\"traceEvents\": [\n";
+    expected += "  {\"name\": \"first\", \"cat\": \"read\", \"ph\": \"X\", \"ts\": " +
+                std::to_string(start) + ", \"dur\": " + std::to_string(spans[0].durationUs) +
+                ", \"pid\": 1, \"tid\": 0, \"args\": {\"stripe\": 3, \"length\": 42}},\n";
+    expected += "  {\"name\": \"second\", \"cat\": \"write\", \"ph\": \"X\", \"ts\": " +
+                std::to_string(spans[1].startUs) + ", \"dur\": " +
+                std::to_string(spans[1].durationUs) + ", \"pid\": 1, \"tid\": 1}\n";
+    expected += "], \"displayTimeUnit\": \"ms\"}\n";
+    EXPECT_EQ(expected, out.str());
+
+    recorder.clear();
+    out.str("");
+    recorder.writeChromeTrace(out);
+    EXPECT_EQ("{\"traceEvents\": [\n], \"displayTimeUnit\": \"ms\"}\n", out.str());
+  }
+
+  TEST(TestTrace, readerAndWriterSpans) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    auto type = Type::buildTypeFromString("struct<id:bigint,name:string>");
+    TraceRecorder writeRecorder;
+    WriterOptions writerOptions;
+    writerOptions.setStripeSize(1024)
+        .setCompressionBlockSize(1024)
+        .setMemoryBlockSize(64)
+        .setCompression(CompressionKind_ZLIB)
+        .setRowIndexStride(1000)
+        .setTraceRecorder(&writeRecorder);
+    auto writer = createWriter(*type, &memStream, writerOptions);
+    auto batch = writer->createRowBatch(1000);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& ids = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& names = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+    std::string name = "name";
+    for (int64_t start = 0; start < 10000; start += 1000) {
+      for (int64_t i = 0; i < 1000; ++i) {
+        // scrambled values so the compressed streams fill several stripes
+        ids.data[i] = (start + i) * 2654435761LL % 1000000007LL;
+        names.data[i] = name.data();
+        names.length[i] = static_cast<int64_t>(name.size());
+      }
+      structBatch.numElements = ids.numElements = names.numElements = 1000;
+      writer->add(*batch);
+    }
+    writer->close();
+
+    ReaderOptions readerOptions;
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    const uint64_t stripes = reader->getNumberOfStripes();
+    ASSERT_GT(stripes, 1);
+    EXPECT_EQ(stripes, countSpans(writeRecorder, "flush stripe"));
+    EXPECT_EQ(1, countSpans(writeRecorder, "write footer"));
+
+    // a search argument loads the row indexes of every stripe
+    TraceRecorder readRecorder;
+    readerOptions.setTraceRecorder(&readRecorder);
+    reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.searchArgument(
+        SearchArgumentFactory::newBuilder()
+            ->lessThan("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(1000000007)))
+            .build());
+    auto rowReader = reader->createRowReader(rowReaderOptions);
+    batch = rowReader->createRowBatch(1000);
+    uint64_t batches = 0;
+    while (rowReader->next(*batch)) {
+      ++batches;
+    }
+    EXPECT_EQ(stripes, countSpans(readRecorder, "start stripe"));
+    EXPECT_EQ(stripes, countSpans(readRecorder, "stripe footer"));
+    EXPECT_EQ(stripes, countSpans(readRecorder, "row index"));
+    EXPECT_EQ(2 * batches, countSpans(readRecorder, "decode column"));
+    EXPECT_LT(0, countSpans(readRecorder, "decompress"));
+    EXPECT_EQ(0, countSpans(readRecorder, "cache wait"));
+    for (const auto& span : readRecorder.getSpans()) {
+      if (std::string("decode column") == span.name) {
+        ASSERT_EQ(2, span.args.size());
+        EXPECT_STREQ("column", span.args[0].first);
+        EXPECT_THAT(span.args[0].second, testing::AnyOf(1, 2));
+      }
+    }
+
+    // the streams of prebuffered stripes come from the cache
+    readRecorder.clear();
+    reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    reader->preBuffer({0}, {1, 2});
+    rowReader = reader->createRowReader(RowReaderOptions());
+    while (rowReader->next(*batch)) {
+    }
+    EXPECT_LT(0, countSpans(readRecorder, "cache wait"));
+  }
+
+  TEST(TestTrace, nestedColumnSpans) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    auto type = Type::buildTypeFromString("struct<l:array<int>,m:map<int,string>>");
+    auto writer = createWriter(*type, &memStream, WriterOptions());
+    auto batch = writer->createRowBatch(10);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& list = dynamic_cast<ListVectorBatch&>(*structBatch.fields[0]);
+    auto& map = dynamic_cast<MapVectorBatch&>(*structBatch.fields[1]);
+    for (int64_t i = 0; i <= 10; ++i) {
+      list.offsets[i] = map.offsets[i] = 0;
+    }
+    structBatch.numElements = list.numElements = map.numElements = 10;
+    writer->add(*batch);
+    writer->close();
+
+    // every column below the root is decoded in a span of its own
+    TraceRecorder recorder;
+    ReaderOptions readerOptions;
+    readerOptions.setTraceRecorder(&recorder);
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    auto rowReader = reader->createRowReader(RowReaderOptions());
+    batch = rowReader->createRowBatch(10);
+    ASSERT_TRUE(rowReader->next(*batch));
+    std::vector<uint64_t> columns;
+    for (const auto& span : recorder.getSpans()) {
+      if (std::string("decode column") == span.name) {
+        columns.push_back(span.args[0].second);
+      }
+    }
+    EXPECT_THAT(columns, testing::UnorderedElementsAre(1, 2, 3, 4, 5));
+  }
+
+}  // namespace orc
@@ -27,10 +27,12 @@
 #include "wrap/gmock.h"
 #include "wrap/gtest-wrapper.h"
 
+#include <atomic>
 #include <cmath>
 #include <ctime>
 #include <memory>
 #include <sstream>
+#include <thread>
 
 #ifdef __clang__
 DIAGNOSTIC_IGNORE("-Wmissing-variable-declarations")
@@ -2266,6 +2268,105 @@ namespace orc {
     EXPECT_FALSE(rowReader->next(*batch));
   }
 
+  // a memory pool that counts the calls made off the thread that created it
+  class SingleThreadPool : public MemoryPool {
+   public:
+    char* malloc(uint64_t size) override {
+      check();
+      return getDefaultPool()->malloc(size);
+    }
+
+    void free(char* p) override {
+      check();
+      getDefaultPool()->free(p);
+    }
+
+    uint64_t getOtherThreadCalls() const {
+      return otherThreadCalls_;
+    }
+
+   private:
+    void check() {
+      if (std::this_thread::get_id() != owner_) {
+        ++otherThreadCalls_;
+      }
+    }
+
+    std::thread::id owner_ = std::this_thread::get_id();
+    std::atomic<uint64_t> otherThreadCalls_{0};
+  };
+
+  TEST_P(WriterTest, writeAsyncStripeFlush) {
+    // the pool is not thread-safe, so the background writes must not use it
+    SingleThreadPool singleThreadPool;
+    MemoryPool* pool = &singleThreadPool;
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<col1:int,col2:string>"));
+
+    auto writeFile = [&](MemoryOutputStream& memStream, bool asyncStripeFlush) {
+      WriterOptions options;
+      options.setStripeSize(1024);
+      options.setCompressionBlockSize(1024);
+      options.setMemoryBlockSize(64);
+      options.setCompression(CompressionKind_ZLIB);
+      options.setMemoryPool(pool);
+      options.setRowIndexStride(1000);
+      options.setFileVersion(fileVersion);
+      options.setAsyncStripeFlush(asyncStripeFlush);
+      std::unique_ptr<Writer> writer = createWriter(*type, &memStream, options);
+
+      std::unique_ptr<ColumnVectorBatch> batch = writer->createRowBatch(65535);
+      auto structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+      auto longBatch = dynamic_cast<LongVectorBatch*>(structBatch->fields[0]);
+      auto strBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[1]);
+      std::string digits = "0123456789";
+      for (uint64_t j = 0; j < 10; ++j) {
+        for (uint64_t i = 0; i < 65535; ++i) {
+          longBatch->data[i] = static_cast<int64_t>(i);
+          strBatch->data[i] = const_cast<char*>(digits.c_str()) + (i % 10);
+          strBatch->length[i] = static_cast<int64_t>(10 - i % 10);
+        }
+        structBatch->numElements = longBatch->numElements = strBatch->numElements = 65535;
+        writer->add(*batch);
+        if (j == 4) {
+          writer->writeIntermediateFooter();
+        }
+      }
+      writer->close();
+    };
+
+    MemoryOutputStream syncStream(DEFAULT_MEM_STREAM_SIZE);
+    MemoryOutputStream asyncStream(DEFAULT_MEM_STREAM_SIZE);
+    writeFile(syncStream, false);
+    writeFile(asyncStream, true);
+
+    // staging stripes in memory must not change a single byte of the file
+    ASSERT_EQ(syncStream.getLength(), asyncStream.getLength());
+    EXPECT_EQ(0, memcmp(syncStream.getData(), asyncStream.getData(), syncStream.getLength()));
+
+    auto inStream =
+        std::make_unique<MemoryInputStream>(asyncStream.getData(), asyncStream.getLength());
+    std::unique_ptr<Reader> reader = createReader(pool, std::move(inStream));
+    std::unique_ptr<RowReader> rowReader = createRowReader(reader.get());
+    EXPECT_EQ(655350, reader->getNumberOfRows());
+    EXPECT_LT(1, reader->getNumberOfStripes());
+
+    auto batch = rowReader->createRowBatch(65535);
+    uint64_t rows = 0;
+    while (rowReader->next(*batch)) {
+      auto structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+      auto longBatch = dynamic_cast<LongVectorBatch*>(structBatch->fields[0]);
+      auto strBatch = dynamic_cast<StringVectorBatch*>(structBatch->fields[1]);
+      for (uint64_t i = 0; i < batch->numElements; ++i) {
+        uint64_t expected = (rows + i) % 65535;
+        EXPECT_EQ(expected, longBatch->data[i]);
+        EXPECT_EQ(10 - expected % 10, strBatch->length[i]);
+      }
+      rows += batch->numElements;
+    }
+    EXPECT_EQ(655350, rows);
+    EXPECT_EQ(0, singleThreadPool.getOtherThreadCalls());
+  }
+
   // first stripe has no null value and second stripe has null value.
   // make sure stripes do not have dirty data in the present streams.
   TEST_P(WriterTest, testSuppressPresentStreamInPreStripe) {
@@ -0,0 +1,90 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+# Script mode: cmake -DTZDATA_DIR=<zoneinfo> -DOUTPUT=<file> -P GenerateTzdata.cmake
+#
+# Writes the TZif files of an IANA time zone database as constexpr byte
+# arrays plus a table of zone names sorted for binary search. The posix/
+# and right/ trees are skipped, as are files that are not TZif (zone.tab,
+# tzdata.zi, ...) and the host specific localtime link. Zones that are
+# links to each other share a single array.
+
+if (NOT TZDATA_DIR OR NOT OUTPUT)
+  message(FATAL_ERROR "Usage: cmake -DTZDATA_DIR=<dir> -DOUTPUT=<file> -P GenerateTzdata.cmake")
+endif ()
+if (NOT IS_DIRECTORY "${TZDATA_DIR}")
+  message(FATAL_ERROR "Time zone database ${TZDATA_DIR} does not exist")
+endif ()
+
+cmake_policy(SET CMP0009 NEW)
+file(GLOB_RECURSE ZONE_FILES RELATIVE "${TZDATA_DIR}" "${TZDATA_DIR}/*")
+list(SORT ZONE_FILES)
+
+# CMake regular expressions have no {n} repetition, so spell out one row
+set(ROW "")
+foreach (I RANGE 1 16)
+  string(APPEND ROW "0x..,")
+endforeach ()
+set(ARRAYS "")
+set(ENTRIES "")
+set(ZONE_COUNT 0)
+set(ARRAY_COUNT 0)
+foreach (ZONE ${ZONE_FILES})
+  if (ZONE MATCHES "^(posix|right)/" OR ZONE STREQUAL "localtime")
+    continue ()
+  endif ()
+  set(ZONE_PATH "${TZDATA_DIR}/${ZONE}")
+  file(READ "${ZONE_PATH}" MAGIC LIMIT 4 HEX)
+  # "TZif"
+  if (NOT MAGIC STREQUAL "545a6966")
+    continue ()
+  endif ()
+  file(SHA256 "${ZONE_PATH}" DIGEST)
+  if (NOT DEFINED ARRAY_${DIGEST})
+    set(ARRAY_${DIGEST} "ZONE_DATA_${ARRAY_COUNT}")
+    math(EXPR ARRAY_COUNT "${ARRAY_COUNT} + 1")
+    file(READ "${ZONE_PATH}" BYTES HEX)
+    string(REGEX REPLACE "(..)" "0x\\1," BYTES "${BYTES}")
+    string(REGEX REPLACE "(${ROW})" "\\1\n      " BYTES "${BYTES}")
+    string(APPEND ARRAYS
+           "  static constexpr unsigned char ${ARRAY_${DIGEST}}[] = {\n      ${BYTES}};\n")
+  endif ()
+  string(APPEND ENTRIES
+         "      {\"${ZONE}\", ${ARRAY_${DIGEST}}, sizeof(${ARRAY_${DIGEST}})},\n")
+  math(EXPR ZONE_COUNT "${ZONE_COUNT} + 1")
+endforeach ()
+
+if (ZONE_COUNT EQUAL 0)
+  message(FATAL_ERROR "No TZif files found in ${TZDATA_DIR}")
+endif ()
+
+file(WRITE "${OUTPUT}.tmp"
+"// Generated by cmake_modules/GenerateTzdata.cmake from ${TZDATA_DIR}; do not edit.
+
+namespace orc {
+
+${ARRAYS}
+  static constexpr EmbeddedZone EMBEDDED_ZONES[] = {
+${ENTRIES}  };
+
+}  // namespace orc
+")
+# configure_file only touches the output when it changes, which avoids
+# recompiling the table on every build
+configure_file("${OUTPUT}.tmp" "${OUTPUT}" COPYONLY)
+file(REMOVE "${OUTPUT}.tmp")
+message(STATUS "Embedded ${ZONE_COUNT} time zones (${ARRAY_COUNT} distinct) from ${TZDATA_DIR}")
@@ -23,26 +23,65 @@
 #include <getopt.h>
 #include <sys/time.h>
 #include <time.h>
-#include <algorithm>
+#include <strings.h>
+#include <charconv>
+#include <deque>
 #include <fstream>
+#include <future>
 #include <iostream>
-#include <list>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 static char gDelimiter = ',';
 
-// extract one column raw text from one line
-std::string extractColumn(std::string s, uint64_t colIndex) {
-  uint64_t col = 0;
-  size_t start = 0;
-  size_t end = s.find(gDelimiter);
-  while (col < colIndex && end != std::string::npos) {
-    start = end + 1;
-    end = s.find(gDelimiter, start);
-    ++col;
+// Input is read in blocks of about this size that end on a line break
+static const size_t CHUNK_SIZE = 4 << 20;  // 4M
+
+// The raw text of one column for the rows of a batch. The fields point into
+// the text that was read, which has to outlive the batch until it is written.
+using ColumnText = std::vector<std::string_view>;
+
+// split the lines into the fields of each column, missing fields are empty
+static void splitColumns(const std::vector<std::string_view>& lines,
+                         std::vector<ColumnText>& columns) {
+  for (auto& column : columns) {
+    column.assign(lines.size(), std::string_view());
+  }
+  for (size_t row = 0; row < lines.size(); ++row) {
+    std::string_view line = lines[row];
+    for (size_t col = 0; col < columns.size(); ++col) {
+      size_t end = line.find(gDelimiter);
+      columns[col][row] = line.substr(0, end);
+      if (end == std::string_view::npos) {
+        break;
+      }
+      line.remove_prefix(end + 1);
+    }
   }
-  return col == colIndex ? s.substr(start, end - start) : "";
+}
+
+// atoll and atof need a terminated copy, which is only made for the values
+// that from_chars does not parse in full
+static int64_t parseLong(std::string_view col) {
+  int64_t value;
+  auto [ptr, ec] = std::from_chars(col.data(), col.data() + col.size(), value);
+  if (ec == std::errc() && ptr == col.data() + col.size()) {
+    return value;
+  }
+  return atoll(std::string(col).c_str());
+}
+
+static double parseDouble(std::string_view col) {
+#if defined(__cpp_lib_to_chars)
+  double value;
+  auto [ptr, ec] = std::from_chars(col.data(), col.data() + col.size(), value);
+  if (ec == std::errc() && ptr == col.data() + col.size()) {
+    return value;
+  }
+#endif
+  return atof(std::string(col).c_str());
 }
 
 static const char* GetDate(void) {
@@ -53,71 +92,53 @@ static const char* GetDate(void) {
   return buf;
 }
 
-void fillLongValues(const std::vector<std::string>& data, orc::ColumnVectorBatch* batch,
-                    uint64_t numValues, uint64_t colIndex) {
+void fillLongValues(const ColumnText& data, orc::ColumnVectorBatch* batch, uint64_t numValues) {
   orc::LongVectorBatch* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
   bool hasNull = false;
   for (uint64_t i = 0; i < numValues; ++i) {
-    std::string col = extractColumn(data[i], colIndex);
+    std::string_view col = data[i];
     if (col.empty()) {
       batch->notNull[i] = 0;
       hasNull = true;
     } else {
       batch->notNull[i] = 1;
-      longBatch->data[i] = atoll(col.c_str());
+      longBatch->data[i] = parseLong(col);
     }
   }
   longBatch->hasNulls = hasNull;
   longBatch->numElements = numValues;
 }
 
-void fillStringValues(const std::vector<std::string>& data, orc::ColumnVectorBatch* batch,
-                      uint64_t numValues, uint64_t colIndex, orc::DataBuffer<char>& buffer) {
-  uint64_t offset = 0;
+// the values point into the text that was read
+void fillStringValues(const ColumnText& data, orc::ColumnVectorBatch* batch, uint64_t numValues) {
   orc::StringVectorBatch* stringBatch = dynamic_cast<orc::StringVectorBatch*>(batch);
   bool hasNull = false;
   for (uint64_t i = 0; i < numValues; ++i) {
-    std::string col = extractColumn(data[i], colIndex);
+    std::string_view col = data[i];
     if (col.empty()) {
       batch->notNull[i] = 0;
       hasNull = true;
     } else {
       batch->notNull[i] = 1;
-      char* oldBufferAddress = buffer.data();
-      // Resize the buffer in case buffer does not have remaining space to store the next string.
-      while (buffer.size() - offset < col.size()) {
-        buffer.resize(buffer.size() * 2);
-      }
-      char* newBufferAddress = buffer.data();
-      // Refill stringBatch->data with the new addresses, if buffer's address has changed.
-      if (newBufferAddress != oldBufferAddress) {
-        for (uint64_t refillIndex = 0; refillIndex < i; ++refillIndex) {
-          stringBatch->data[refillIndex] =
-              stringBatch->data[refillIndex] - oldBufferAddress + newBufferAddress;
-        }
-      }
-      memcpy(buffer.data() + offset, col.c_str(), col.size());
-      stringBatch->data[i] = buffer.data() + offset;
+      stringBatch->data[i] = const_cast<char*>(col.data());
       stringBatch->length[i] = static_cast<int64_t>(col.size());
-      offset += col.size();
     }
   }
   stringBatch->hasNulls = hasNull;
   stringBatch->numElements = numValues;
 }
 
-void fillDoubleValues(const std::vector<std::string>& data, orc::ColumnVectorBatch* batch,
-                      uint64_t numValues, uint64_t colIndex) {
+void fillDoubleValues(const ColumnText& data, orc::ColumnVectorBatch* batch, uint64_t numValues) {
   orc::DoubleVectorBatch* dblBatch = dynamic_cast<orc::DoubleVectorBatch*>(batch);
   bool hasNull = false;
   for (uint64_t i = 0; i < numValues; ++i) {
-    std::string col = extractColumn(data[i], colIndex);
+    std::string_view col = data[i];
     if (col.empty()) {
       batch->notNull[i] = 0;
       hasNull = true;
     } else {
       batch->notNull[i] = 1;
-      dblBatch->data[i] = atof(col.c_str());
+      dblBatch->data[i] = parseDouble(col);
     }
   }
   dblBatch->hasNulls = hasNull;
@@ -125,8 +146,8 @@ void fillDoubleValues(const std::vector<std::string>& data, orc::ColumnVectorBat
 }
 
 // parse fixed point decimal numbers
-void fillDecimalValues(const std::vector<std::string>& data, orc::ColumnVectorBatch* batch,
-                       uint64_t numValues, uint64_t colIndex, size_t scale, size_t precision) {
+void fillDecimalValues(const ColumnText& data, orc::ColumnVectorBatch* batch, uint64_t numValues,
+                       size_t scale, size_t precision) {
   orc::Decimal128VectorBatch* d128Batch = nullptr;
   orc::Decimal64VectorBatch* d64Batch = nullptr;
   if (precision <= 18) {
@@ -138,7 +159,7 @@ void fillDecimalValues(const std::vector<std::string>& data, orc::ColumnVectorBa
   }
   bool hasNull = false;
   for (uint64_t i = 0; i < numValues; ++i) {
-    std::string col = extractColumn(data[i], colIndex);
+    std::string_view col = data[i];
     if (col.empty()) {
       batch->notNull[i] = 0;
       hasNull = true;
@@ -146,10 +167,10 @@ void fillDecimalValues(const std::vector<std::string>& data, orc::ColumnVectorBa
       batch->notNull[i] = 1;
       size_t ptPos = col.find('.');
       size_t curScale = 0;
-      std::string num = col;
-      if (ptPos != std::string::npos) {
+      std::string num(col);
+      if (ptPos != std::string_view::npos) {
         curScale = col.length() - ptPos - 1;
-        num = col.substr(0, ptPos) + col.substr(ptPos + 1);
+        num.erase(ptPos, 1);
       }
       orc::Int128 decimal(num);
       while (curScale != scale) {
@@ -167,19 +188,18 @@ void fillDecimalValues(const std::vector<std::string>& data, orc::ColumnVectorBa
   batch->numElements = numValues;
 }
 
-void fillBoolValues(const std::vector<std::string>& data, orc::ColumnVectorBatch* batch,
-                    uint64_t numValues, uint64_t colIndex) {
+void fillBoolValues(const ColumnText& data, orc::ColumnVectorBatch* batch, uint64_t numValues) {
   orc::LongVectorBatch* boolBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
   bool hasNull = false;
   for (uint64_t i = 0; i < numValues; ++i) {
-    std::string col = extractColumn(data[i], colIndex);
+    std::string_view col = data[i];
     if (col.empty()) {
       batch->notNull[i] = 0;
       hasNull = true;
     } else {
       batch->notNull[i] = 1;
-      std::transform(col.begin(), col.end(), col.begin(), ::tolower);
-      if (col == "true" || col == "t") {
+      if ((col.size() == 4 && strncasecmp(col.data(), "true", 4) == 0) ||
+          (col.size() == 1 && tolower(col[0]) == 't')) {
         boolBatch->data[i] = true;
       } else {
         boolBatch->data[i] = false;
@@ -191,12 +211,11 @@ void fillBoolValues(const std::vector<std::string>& data, orc::ColumnVectorBatch
 }
 
 // parse date string from format YYYY-mm-dd
-void fillDateValues(const std::vector<std::string>& data, orc::ColumnVectorBatch* batch,
-                    uint64_t numValues, uint64_t colIndex) {
+void fillDateValues(const ColumnText& data, orc::ColumnVectorBatch* batch, uint64_t numValues) {
   orc::LongVectorBatch* longBatch = dynamic_cast<orc::LongVectorBatch*>(batch);
   bool hasNull = false;
   for (uint64_t i = 0; i < numValues; ++i) {
-    std::string col = extractColumn(data[i], colIndex);
+    const std::string col(data[i]);
     if (col.empty()) {
       batch->notNull[i] = 0;
       hasNull = true;
@@ -217,13 +236,13 @@ void fillDateValues(const std::vector<std::string>& data, orc::ColumnVectorBatch
 }
 
 // parse timestamp values in seconds
-void fillTimestampValues(const std::vector<std::string>& data, orc::ColumnVectorBatch* batch,
-                         uint64_t numValues, uint64_t colIndex) {
+void fillTimestampValues(const ColumnText& data, orc::ColumnVectorBatch* batch,
+                         uint64_t numValues) {
   struct tm timeStruct;
   orc::TimestampVectorBatch* tsBatch = dynamic_cast<orc::TimestampVectorBatch*>(batch);
   bool hasNull = false;
   for (uint64_t i = 0; i < numValues; ++i) {
-    std::string col = extractColumn(data[i], colIndex);
+    const std::string col(data[i]);
     if (col.empty()) {
       batch->notNull[i] = 0;
       hasNull = true;
@@ -249,6 +268,103 @@ void fillTimestampValues(const std::vector<std::string>& data, orc::ColumnVector
   tsBatch->numElements = numValues;
 }
 
+// fill the struct batch from the text of the columns
+void fillBatch(const std::vector<ColumnText>& columns, uint64_t numValues,
+               const orc::Type& fileType, orc::ColumnVectorBatch* rowBatch) {
+  orc::StructVectorBatch* structBatch = dynamic_cast<orc::StructVectorBatch*>(rowBatch);
+  memset(structBatch->notNull.data(), 1, numValues);
+  structBatch->numElements = numValues;
+
+  for (uint64_t i = 0; i < structBatch->fields.size(); ++i) {
+    const orc::Type* subType = fileType.getSubtype(i);
+    switch (subType->getKind()) {
+      case orc::BYTE:
+      case orc::INT:
+      case orc::SHORT:
+      case orc::LONG:
+        fillLongValues(columns[i], structBatch->fields[i], numValues);
+        break;
+      case orc::STRING:
+      case orc::CHAR:
+      case orc::VARCHAR:
+      case orc::BINARY:
+        fillStringValues(columns[i], structBatch->fields[i], numValues);
+        break;
+      case orc::FLOAT:
+      case orc::DOUBLE:
+        fillDoubleValues(columns[i], structBatch->fields[i], numValues);
+        break;
+      case orc::DECIMAL:
+        fillDecimalValues(columns[i], structBatch->fields[i], numValues, subType->getScale(),
+                          subType->getPrecision());
+        break;
+      case orc::BOOLEAN:
+        fillBoolValues(columns[i], structBatch->fields[i], numValues);
+        break;
+      case orc::DATE:
+        fillDateValues(columns[i], structBatch->fields[i], numValues);
+        break;
+      case orc::TIMESTAMP:
+      case orc::TIMESTAMP_INSTANT:
+        fillTimestampValues(columns[i], structBatch->fields[i], numValues);
+        break;
+      case orc::STRUCT:
+      case orc::LIST:
+      case orc::MAP:
+      case orc::UNION:
+      case orc::GEOMETRY:
+      case orc::GEOGRAPHY:
+        throw std::runtime_error(subType->toString() + " is not supported yet.");
+    }
+  }
+}
+
+// A block of the input and the batches parsed from it, which point into it
+struct Chunk {
+  std::string text;
+  std::vector<std::unique_ptr<orc::ColumnVectorBatch>> batches;
+};
+
+// Read the next block of whole lines, keeping a partial last line for the
+// next call. Returns false at the end of the input.
+static bool readChunk(std::istream& input, std::string& leftover, std::string& text) {
+  text.swap(leftover);
+  leftover.clear();
+  while (input) {
+    size_t size = text.size();
+    text.resize(size + CHUNK_SIZE);
+    input.read(&text[size], static_cast<std::streamsize>(CHUNK_SIZE));
+    text.resize(size + static_cast<size_t>(input.gcount()));
+    size_t lineEnd = text.rfind('\n');
+    if (lineEnd != std::string::npos) {
+      leftover.assign(text, lineEnd + 1);
+      text.resize(lineEnd + 1);
+      break;
+    }
+  }
+  return !text.empty();
+}
+
+// Split a block into lines like std::getline and parse them into batches
+static std::unique_ptr<Chunk> parseChunk(std::unique_ptr<Chunk> chunk, const orc::Type* fileType,
+                                         uint64_t batchSize) {
+  std::vector<std::string_view> lines;
+  std::vector<ColumnText> columns(fileType->getSubtypeCount());
+  std::string_view text = chunk->text;
+  while (!text.empty()) {
+    lines.clear();
+    while (!text.empty() && lines.size() < batchSize) {
+      size_t end = text.find('\n');
+      lines.push_back(text.substr(0, end));
+      text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    }
+    splitColumns(lines, columns);
+    chunk->batches.push_back(fileType->createRowBatch(batchSize, *orc::getDefaultPool()));
+    fillBatch(columns, lines.size(), *fileType, chunk->batches.back().get());
+  }
+  return chunk;
+}
+
 void usage() {
   std::cout << "Usage: csv-import [-h] [--help]\n"
             << "                  [-m] [--metrics]\n"
@@ -257,9 +373,11 @@ void usage() {
             << "                  [-c <size>] [--block=<size>]\n"
             << "                  [-b <size>] [--batch=<size>]\n"
             << "                  [-t <string>] [--timezone=<string>]\n"
+            << "                  [-j <threads>] [--threads=<threads>]\n"
             << "                  <schema> <input> <output>\n"
             << "Import CSV file into an Orc file using the specified schema.\n"
             << "The timezone is writer timezone of timestamp types.\n"
+            << "With several threads the input is parsed in parallel.\n"
             << "Compound types are not yet supported.\n";
 }
 
@@ -271,6 +389,7 @@ int main(int argc, char* argv[]) {
   uint64_t stripeSize = (128 << 20);  // 128M
   uint64_t blockSize = 64 << 10;      // 64K
   uint64_t batchSize = 1024;
+  uint64_t threads = 1;
   orc::CompressionKind compression = orc::CompressionKind_ZLIB;
 
   static struct option longOptions[] = {{"help", no_argument, nullptr, 'h'},
@@ -280,13 +399,14 @@ int main(int argc, char* argv[]) {
                                         {"block", required_argument, nullptr, 'c'},
                                         {"batch", required_argument, nullptr, 'b'},
                                         {"timezone", required_argument, nullptr, 't'},
+                                        {"threads", required_argument, nullptr, 'j'},
                                         {nullptr, 0, nullptr, 0}};
   bool helpFlag = false;
   bool showMetrics = false;
   int opt;
   char* tail;
   do {
-    opt = getopt_long(argc, argv, "d:s:c:b:t:mh", longOptions, nullptr);
+    opt = getopt_long(argc, argv, "d:s:c:b:t:j:mh", longOptions, nullptr);
     switch (opt) {
       case 'h':
         helpFlag = true;
@@ -322,6 +442,13 @@ int main(int argc, char* argv[]) {
       case 't':
         timezoneName = std::string(optarg);
         break;
+      case 'j':
+        threads = strtoul(optarg, &tail, 10);
+        if (*tail != '\0' || threads == 0) {
+          fprintf(stderr, "The --threads parameter requires a positive integer option.\n");
+          return 1;
+        }
+        break;
     }
   } while (opt != -1);
 
@@ -343,9 +470,6 @@ int main(int argc, char* argv[]) {
   double totalElapsedTime = 0.0;
   clock_t totalCPUTime = 0;
 
-  typedef std::list<orc::DataBuffer<char>> DataBufferList;
-  DataBufferList bufferList;
-
   orc::WriterOptions options;
   orc::WriterMetrics metrics;
   options.setStripeSize(stripeSize);
@@ -356,76 +480,32 @@ int main(int argc, char* argv[]) {
 
   std::unique_ptr<orc::OutputStream> outStream = orc::writeLocalFile(output);
   std::unique_ptr<orc::Writer> writer = orc::createWriter(*fileType, outStream.get(), options);
-  std::unique_ptr<orc::ColumnVectorBatch> rowBatch = writer->createRowBatch(batchSize);
 
+  // Blocks of the input are parsed by up to threads tasks at a time, while
+  // this thread hands the batches to the writer in input order. A single
+  // thread parses each block when its batches are needed.
+  const auto policy = threads > 1 ? std::launch::async : std::launch::deferred;
+  std::deque<std::future<std::unique_ptr<Chunk>>> pending;
+  std::ifstream finput(input.c_str(), std::ios::binary);
+  std::string leftover;
   bool eof = false;
-  std::string line;
-  std::vector<std::string> data;  // buffer that holds a batch of rows in raw text
-  std::ifstream finput(input.c_str());
-  while (!eof) {
-    uint64_t numValues = 0;  // num of lines read in a batch
-
-    data.clear();
-    memset(rowBatch->notNull.data(), 1, batchSize);
-
-    // read a batch of lines from the input file
-    for (uint64_t i = 0; i < batchSize; ++i) {
-      if (!std::getline(finput, line)) {
+  while (!eof || !pending.empty()) {
+    while (!eof && pending.size() < threads) {
+      auto chunk = std::make_unique<Chunk>();
+      if (!readChunk(finput, leftover, chunk->text)) {
         eof = true;
         break;
       }
-      data.push_back(line);
-      ++numValues;
+      pending.push_back(
+          std::async(policy, parseChunk, std::move(chunk), fileType.get(), batchSize));
     }
+    if (pending.empty()) {
+      break;
+    }
+    std::unique_ptr<Chunk> chunk = pending.front().get();
+    pending.pop_front();
 
-    if (numValues != 0) {
-      orc::StructVectorBatch* structBatch = dynamic_cast<orc::StructVectorBatch*>(rowBatch.get());
-      structBatch->numElements = numValues;
-
-      for (uint64_t i = 0; i < structBatch->fields.size(); ++i) {
-        const orc::Type* subType = fileType->getSubtype(i);
-        switch (subType->getKind()) {
-          case orc::BYTE:
-          case orc::INT:
-          case orc::SHORT:
-          case orc::LONG:
-            fillLongValues(data, structBatch->fields[i], numValues, i);
-            break;
-          case orc::STRING:
-          case orc::CHAR:
-          case orc::VARCHAR:
-          case orc::BINARY:
-            bufferList.emplace_back(*orc::getDefaultPool(), 1 * 1024 * 1024);
-            fillStringValues(data, structBatch->fields[i], numValues, i, bufferList.back());
-            break;
-          case orc::FLOAT:
-          case orc::DOUBLE:
-            fillDoubleValues(data, structBatch->fields[i], numValues, i);
-            break;
-          case orc::DECIMAL:
-            fillDecimalValues(data, structBatch->fields[i], numValues, i, subType->getScale(),
-                              subType->getPrecision());
-            break;
-          case orc::BOOLEAN:
-            fillBoolValues(data, structBatch->fields[i], numValues, i);
-            break;
-          case orc::DATE:
-            fillDateValues(data, structBatch->fields[i], numValues, i);
-            break;
-          case orc::TIMESTAMP:
-          case orc::TIMESTAMP_INSTANT:
-            fillTimestampValues(data, structBatch->fields[i], numValues, i);
-            break;
-          case orc::STRUCT:
-          case orc::LIST:
-          case orc::MAP:
-          case orc::UNION:
-          case orc::GEOMETRY:
-          case orc::GEOGRAPHY:
-            throw std::runtime_error(subType->toString() + " is not supported yet.");
-        }
-      }
-
+    for (auto& rowBatch : chunk->batches) {
       struct timeval t_start, t_end;
       gettimeofday(&t_start, nullptr);
       clock_t c_start = clock();
@@ -0,0 +1,728 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ToolsHelper.hh"
+#include "orc/OrcFile.hh"
+
+#include <getopt.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// the shape of the synthetic data set
+struct DataOptions {
+  uint64_t rows = 1000000;
+  uint64_t columns = 10;
+  std::vector<std::string> types = {"bigint", "double", "string"};
+  // distinct values per column, 0 for a distinct value per row
+  uint64_t cardinality = 0;
+  double nullRatio = 0;
+  // the share of the rows whose value follows the sorted order
+  double sortedness = 0;
+  uint64_t minStringLength = 8;
+  uint64_t maxStringLength = 32;
+  uint64_t seed = 42;
+};
+
+// what the scans read and how often they run
+struct ScanOptions {
+  uint64_t batchSize = 1024;
+  uint64_t repetitions = 3;
+  // the number of leading columns of the projected scan, 0 for half of them
+  uint64_t projection = 0;
+  // the share of the values that the predicate scan selects
+  double selectivity = 0.1;
+  // reads wait like requests to remote storage when either is set
+  orc::RemoteStorageOptions storage;
+  // whether the selected columns of all stripes are fetched up front
+  bool preBuffer = false;
+  orc::CacheOptions cacheOptions;
+  // records the spans of the scans when set
+  orc::TraceRecorder* traceRecorder = nullptr;
+};
+
+static const uint64_t STRING_KEY_LENGTH = 8;
+
+// Generates the values of one column. A value is derived from an index in
+// [0, cardinality) that either follows the row number or is random, so that
+// the sortedness, cardinality and null ratio are the same for every type.
+class ColumnGenerator {
+ public:
+  ColumnGenerator(const orc::Type& type, const DataOptions& options, uint64_t column)
+      : type_(type),
+        options_(options),
+        random_(options.seed + column),
+        range_(options.cardinality == 0 ? options.rows : options.cardinality) {}
+
+  void fill(orc::ColumnVectorBatch& batch, uint64_t firstRow, uint64_t numRows) {
+    batch.numElements = numRows;
+    batch.hasNulls = false;
+    for (uint64_t i = 0; i < numRows; ++i) {
+      batch.notNull[i] = options_.nullRatio == 0 || unit() >= options_.nullRatio;
+      batch.hasNulls |= !batch.notNull[i];
+    }
+    std::vector<uint64_t> keys(numRows);
+    for (uint64_t i = 0; i < numRows; ++i) {
+      if (options_.sortedness > 0 && unit() < options_.sortedness) {
+        keys[i] = static_cast<uint64_t>(static_cast<double>(firstRow + i) /
+                                        static_cast<double>(options_.rows) *
+                                        static_cast<double>(range_));
+      } else {
+        keys[i] = random_() % range_;
+      }
+    }
+    switch (type_.getKind()) {
+      case orc::BOOLEAN:
+      case orc::BYTE:
+      case orc::SHORT:
+      case orc::INT:
+      case orc::LONG:
+      case orc::DATE: {
+        auto& longs = dynamic_cast<orc::LongVectorBatch&>(batch);
+        const int64_t modulus = getModulus();
+        for (uint64_t i = 0; i < numRows; ++i) {
+          longs.data[i] = static_cast<int64_t>(keys[i]) % modulus;
+        }
+        break;
+      }
+      case orc::FLOAT:
+      case orc::DOUBLE: {
+        auto& doubles = dynamic_cast<orc::DoubleVectorBatch&>(batch);
+        for (uint64_t i = 0; i < numRows; ++i) {
+          doubles.data[i] = static_cast<double>(keys[i]) * 0.25;
+        }
+        break;
+      }
+      case orc::STRING:
+      case orc::BINARY:
+      case orc::VARCHAR:
+      case orc::CHAR: {
+        auto& strings = dynamic_cast<orc::StringVectorBatch&>(batch);
+        const uint64_t maxLength =
+            type_.getKind() == orc::STRING || type_.getKind() == orc::BINARY
+                ? options_.maxStringLength
+                : std::min(options_.maxStringLength, type_.getMaximumLength());
+        buffer_.resize(numRows * maxLength);
+        for (uint64_t i = 0; i < numRows; ++i) {
+          char* value = buffer_.data() + i * maxLength;
+          strings.data[i] = value;
+          strings.length[i] = static_cast<int64_t>(makeString(keys[i], value, maxLength));
+        }
+        break;
+      }
+      case orc::TIMESTAMP:
+      case orc::TIMESTAMP_INSTANT: {
+        auto& timestamps = dynamic_cast<orc::TimestampVectorBatch&>(batch);
+        for (uint64_t i = 0; i < numRows; ++i) {
+          timestamps.data[i] = 1600000000 + static_cast<int64_t>(keys[i]);
+          timestamps.nanoseconds[i] = static_cast<int64_t>(keys[i] % 1000) * 1000000;
+        }
+        break;
+      }
+      case orc::DECIMAL: {
+        if (type_.getPrecision() <= 18) {
+          auto& decimals = dynamic_cast<orc::Decimal64VectorBatch&>(batch);
+          const int64_t modulus = getModulus();
+          for (uint64_t i = 0; i < numRows; ++i) {
+            decimals.values[i] = static_cast<int64_t>(keys[i]) % modulus;
+          }
+        } else {
+          auto& decimals = dynamic_cast<orc::Decimal128VectorBatch&>(batch);
+          for (uint64_t i = 0; i < numRows; ++i) {
+            decimals.values[i] = orc::Int128(static_cast<int64_t>(keys[i]));
+          }
+        }
+        break;
+      }
+      default:
+        throw std::invalid_argument("Unsupported column type " + type_.toString());
+    }
+  }
+
+ private:
+  double unit() {
+    return std::uniform_real_distribution<double>(0, 1)(random_);
+  }
+
+  // keeps the values within the range of narrow types
+  int64_t getModulus() const {
+    switch (type_.getKind()) {
+      case orc::BOOLEAN:
+        return 2;
+      case orc::BYTE:
+        return 128;
+      case orc::SHORT:
+        return 32768;
+      case orc::INT:
+        return 2147483648;
+      case orc::DECIMAL: {
+        int64_t modulus = 1;
+        for (uint64_t i = 0; i < type_.getPrecision(); ++i) {
+          modulus *= 10;
+        }
+        return modulus;
+      }
+      default:
+        return INT64_MAX;
+    }
+  }
+
+  // A base 26 key that sorts like its index, padded with letters that
+  // depend on the index to a length between the minimum and the maximum.
+  uint64_t makeString(uint64_t index, char* value, uint64_t maxLength) const {
+    uint64_t hash = index * 0x9E3779B97F4A7C15ULL;
+    uint64_t minLength = std::min(options_.minStringLength, maxLength);
+    uint64_t length = minLength + (hash >> 32) % (maxLength - minLength + 1);
+    for (uint64_t i = STRING_KEY_LENGTH; i > 0; --i, index /= 26) {
+      if (i - 1 < length) {
+        value[i - 1] = static_cast<char>('a' + index % 26);
+      }
+    }
+    for (uint64_t i = STRING_KEY_LENGTH; i < length; ++i) {
+      value[i] = static_cast<char>('a' + (hash >> (i % 7 * 8)) % 26);
+    }
+    return length;
+  }
+
+  const orc::Type& type_;
+  const DataOptions& options_;
+  std::mt19937_64 random_;
+  const uint64_t range_;
+  std::vector<char> buffer_;
+};
+
+static std::string makeSchema(const DataOptions& options) {
+  std::string schema = "struct<";
+  for (uint64_t i = 0; i < options.columns; ++i) {
+    schema += (i == 0 ? "c" : ",c") + std::to_string(i) + ":" +
+              options.types[i % options.types.size()];
+  }
+  return schema + ">";
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// a rate that stays finite, as JSON has no infinity, when a tiny run measures
+// no time at all
+static double perSecond(uint64_t count, double seconds) {
+  return static_cast<double>(count) / std::max(seconds, 1e-9);
+}
+
+static void printWriterMetrics(std::ostream& out, const orc::WriterMetrics& metrics) {
+  out << "{\"IOCount\": " << metrics.IOCount
+      << ", \"IOBlockingLatencyUs\": " << metrics.IOBlockingLatencyUs
+      << ", \"DictionaryCheckCount\": " << metrics.DictionaryCheckCount
+      << ", \"DictionaryAbandonedCount\": " << metrics.DictionaryAbandonedCount
+      << ", \"DictionarySampledValues\": " << metrics.DictionarySampledValues
+      << ", \"DictionarySampledKeys\": " << metrics.DictionarySampledKeys << "}";
+}
+
+static void printReaderMetricsJson(std::ostream& out, const orc::ReaderMetrics& metrics) {
+  out << "{\"ReaderCall\": " << metrics.ReaderCall
+      << ", \"ReaderInclusiveLatencyUs\": " << metrics.ReaderInclusiveLatencyUs
+      << ", \"DecompressionCall\": " << metrics.DecompressionCall
+      << ", \"DecompressionLatencyUs\": " << metrics.DecompressionLatencyUs
+      << ", \"DecodingCall\": " << metrics.DecodingCall
+      << ", \"DecodingLatencyUs\": " << metrics.DecodingLatencyUs
+      << ", \"ByteDecodingCall\": " << metrics.ByteDecodingCall
+      << ", \"ByteDecodingLatencyUs\": " << metrics.ByteDecodingLatencyUs
+      << ", \"IOCount\": " << metrics.IOCount
+      << ", \"IOBlockingLatencyUs\": " << metrics.IOBlockingLatencyUs
+      << ", \"SelectedRowGroupCount\": " << metrics.SelectedRowGroupCount
+      << ", \"EvaluatedRowGroupCount\": " << metrics.EvaluatedRowGroupCount
+      << ", \"ReadRangeCacheHits\": " << metrics.ReadRangeCacheHits
+      << ", \"ReadRangeCacheMisses\": " << metrics.ReadRangeCacheMisses << "}";
+}
+
+static void printColumnMetrics(std::ostream& out, const orc::ColumnMetricsTable& table) {
+  out << "[";
+  bool firstColumn = true;
+  for (const auto& column : table.getColumns()) {
+    out << (firstColumn ? "" : ", ") << "{\"column\": " << column.first
+        << ", \"ReaderCall\": " << column.second.ReaderCall
+        << ", \"RowsRead\": " << column.second.RowsRead << ", \"streams\": [";
+    bool firstStream = true;
+    for (const auto& stream : column.second.streams) {
+      out << (firstStream ? "" : ", ") << "{\"kind\": \"" << orc::streamKindToString(stream.first)
+          << "\", \"BytesRead\": " << stream.second.BytesRead
+          << ", \"DecompressionCall\": " << stream.second.DecompressionCall
+          << ", \"BytesDecompressed\": " << stream.second.BytesDecompressed
+          << ", \"DecompressionLatencyUs\": " << stream.second.DecompressionLatencyUs
+          << ", \"DecodingCall\": " << stream.second.DecodingCall
+          << ", \"ValuesDecoded\": " << stream.second.ValuesDecoded
+          << ", \"DecodingLatencyUs\": " << stream.second.DecodingLatencyUs << "}";
+      firstStream = false;
+    }
+    out << "]}";
+    firstColumn = false;
+  }
+  out << "]";
+}
+
+static void writeFile(const char* filename, const DataOptions& dataOptions,
+                      orc::WriterOptions& writerOptions, uint64_t batchSize, std::ostream& out) {
+  std::unique_ptr<orc::Type> type = orc::Type::buildTypeFromString(makeSchema(dataOptions));
+  orc::WriterMetrics metrics;
+  writerOptions.setWriterMetrics(&metrics);
+  std::vector<ColumnGenerator> generators;
+  for (uint64_t i = 0; i < type->getSubtypeCount(); ++i) {
+    generators.emplace_back(*type->getSubtype(i), dataOptions, i);
+  }
+
+  std::unique_ptr<orc::OutputStream> stream = orc::writeLocalFile(filename);
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_ptr<orc::Writer> writer = orc::createWriter(*type, stream.get(), writerOptions);
+  std::unique_ptr<orc::ColumnVectorBatch> batch = writer->createRowBatch(batchSize);
+  auto& structBatch = dynamic_cast<orc::StructVectorBatch&>(*batch);
+  double generateSeconds = 0;
+  for (uint64_t row = 0; row < dataOptions.rows; row += batchSize) {
+    const uint64_t numRows = std::min(batchSize, dataOptions.rows - row);
+    const auto generateStart = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < generators.size(); ++i) {
+      generators[i].fill(*structBatch.fields[i], row, numRows);
+    }
+    structBatch.numElements = numRows;
+    generateSeconds += secondsSince(generateStart);
+    writer->add(*batch);
+  }
+  writer->close();
+  const double seconds = secondsSince(start) - generateSeconds;
+
+  std::unique_ptr<orc::Reader> reader =
+      orc::createReader(orc::readLocalFile(filename), orc::ReaderOptions());
+  out << "  \"write\": {\"schema\": \"" << type->toString() << "\", \"rows\": " << dataOptions.rows
+      << ", \"compression\": \"" << orc::compressionKindToString(writerOptions.getCompression())
+      << "\", \"stripeSize\": " << writerOptions.getStripeSize()
+      << ", \"compressionBlockSize\": " << writerOptions.getCompressionBlockSize()
+      << ", \"rowIndexStride\": " << writerOptions.getRowIndexStride()
+      << ", \"dictionaryKeySizeThreshold\": " << writerOptions.getDictionaryKeySizeThreshold()
+      << ", \"fileBytes\": " << reader->getFileLength()
+      << ", \"stripes\": " << reader->getNumberOfStripes() << ", \"seconds\": " << seconds
+      << ", \"generateSeconds\": " << generateSeconds << ", \"rowsPerSecond\": "
+      << perSecond(dataOptions.rows, seconds) << ", \"metrics\": ";
+  printWriterMetrics(out, metrics);
+  out << "},\n";
+}
+
+// runs a scan repetitions times and prints the median run with the metrics of the last one
+static void runScan(const char* filename, const std::string& name,
+                    const orc::RowReaderOptions& rowReaderOptions, const ScanOptions& scanOptions,
+                    bool last, std::ostream& out) {
+  std::vector<double> seconds;
+  uint64_t rows = 0;
+  uint64_t batches = 0;
+  uint64_t bytes = 0;
+  std::unique_ptr<orc::ReaderMetrics> metrics;
+  std::unique_ptr<orc::ColumnMetricsTable> columnMetrics;
+  for (uint64_t repetition = 0; repetition < scanOptions.repetitions; ++repetition) {
+    metrics = std::make_unique<orc::ReaderMetrics>();
+    columnMetrics = std::make_unique<orc::ColumnMetricsTable>();
+    std::atomic<uint64_t> bytesRead{0};
+    orc::ReaderOptions readerOptions;
+    readerOptions.setReaderMetrics(metrics.get())
+        .setCacheOptions(scanOptions.cacheOptions)
+        .setTraceRecorder(scanOptions.traceRecorder)
+        .setColumnMetricsTable(columnMetrics.get());
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<orc::InputStream> stream = std::make_unique<CountingInputStream>(
+        orc::readLocalFile(filename, metrics.get()), bytesRead);
+    if (scanOptions.storage.latency.count() != 0 || scanOptions.storage.bytesPerSecond != 0) {
+      stream = orc::simulateRemoteStorage(std::move(stream), scanOptions.storage);
+    }
+    std::unique_ptr<orc::Reader> reader = orc::createReader(std::move(stream), readerOptions);
+    std::unique_ptr<orc::RowReader> rowReader = reader->createRowReader(rowReaderOptions);
+    if (scanOptions.preBuffer) {
+      std::vector<uint32_t> stripes(reader->getNumberOfStripes());
+      std::iota(stripes.begin(), stripes.end(), 0);
+      std::list<uint64_t> types;
+      // the root would select every column again
+      const std::vector<bool> selected = rowReader->getSelectedColumns();
+      for (uint64_t i = 1; i < selected.size(); ++i) {
+        if (selected[i]) {
+          types.push_back(i);
+        }
+      }
+      reader->preBuffer(stripes, types);
+    }
+    std::unique_ptr<orc::ColumnVectorBatch> batch =
+        rowReader->createRowBatch(scanOptions.batchSize);
+    rows = 0;
+    batches = 0;
+    while (rowReader->next(*batch)) {
+      rows += batch->numElements;
+      batches += 1;
+    }
+    seconds.push_back(secondsSince(start));
+    bytes = bytesRead;
+  }
+  std::sort(seconds.begin(), seconds.end());
+  const double median = seconds[seconds.size() / 2];
+  out << "    {\"name\": \"" << name << "\", \"rows\": " << rows << ", \"batches\": " << batches
+      << ", \"bytesRead\": " << bytes << ", \"repetitions\": " << scanOptions.repetitions
+      << ", \"minSeconds\": " << seconds.front() << ", \"medianSeconds\": " << median
+      << ", \"maxSeconds\": " << seconds.back()
+      << ", \"rowsPerSecond\": " << perSecond(rows, median)
+      << ", \"bytesPerSecond\": " << perSecond(bytes, median) << ", \"metrics\": ";
+  printReaderMetricsJson(out, *metrics);
+  out << ", \"columns\": ";
+  printColumnMetrics(out, *columnMetrics);
+  out << (last ? "}\n" : "},\n");
+}
+
+static void runScans(const char* filename, const DataOptions& dataOptions,
+                     const ScanOptions& scanOptions, std::ostream& out) {
+  std::unique_ptr<orc::Reader> reader =
+      orc::createReader(orc::readLocalFile(filename), orc::ReaderOptions());
+  const orc::Type& type = reader->getType();
+
+  orc::RowReaderOptions projected;
+  std::list<uint64_t> columns;
+  uint64_t projection = scanOptions.projection == 0
+                            ? std::max<uint64_t>(1, type.getSubtypeCount() / 2)
+                            : std::min(scanOptions.projection, type.getSubtypeCount());
+  for (uint64_t i = 0; i < projection; ++i) {
+    columns.push_back(i);
+  }
+  projected.include(columns);
+
+  // the predicate compares the first integer column with the value below
+  // which the share of the keys is the selectivity
+  orc::RowReaderOptions predicate;
+  bool hasPredicate = false;
+  for (uint64_t i = 0; i < type.getSubtypeCount() && !hasPredicate; ++i) {
+    orc::TypeKind kind = type.getSubtype(i)->getKind();
+    if (kind == orc::LONG || (kind == orc::INT && dataOptions.rows <= 2147483648)) {
+      uint64_t range = dataOptions.cardinality == 0 ? dataOptions.rows : dataOptions.cardinality;
+      auto threshold = static_cast<int64_t>(scanOptions.selectivity * static_cast<double>(range));
+      predicate.searchArgument(orc::SearchArgumentFactory::newBuilder()
+                                   ->lessThan(type.getFieldName(i), orc::PredicateDataType::LONG,
+                                              orc::Literal(threshold))
+                                   .build());
+      hasPredicate = true;
+    }
+  }
+
+  out << "  \"read\": {\"latencyUs\": " << scanOptions.storage.latency.count()
+      << ", \"bandwidth\": " << scanOptions.storage.bytesPerSecond
+      << ", \"preBuffer\": " << (scanOptions.preBuffer ? "true" : "false")
+      << ", \"holeSizeLimit\": " << scanOptions.cacheOptions.holeSizeLimit
+      << ", \"rangeSizeLimit\": " << scanOptions.cacheOptions.rangeSizeLimit << "},\n";
+  out << "  \"scans\": [\n";
+  runScan(filename, "full", orc::RowReaderOptions(), scanOptions, false, out);
+  runScan(filename, "projected", projected, scanOptions, !hasPredicate, out);
+  if (hasPredicate) {
+    runScan(filename, "predicate", predicate, scanOptions, true, out);
+  }
+  out << "  ]\n";
+}
+
+static bool parseUnsigned(const char* text, uint64_t& value) {
+  char* tail;
+  value = strtoull(text, &tail, 10);
+  return *text != '\0' && *tail == '\0';
+}
+
+static bool parseRatio(const char* text, double& value) {
+  char* tail;
+  value = strtod(text, &tail);
+  return *text != '\0' && *tail == '\0' && value >= 0 && value <= 1;
+}
+
+static bool parseCompression(const std::string& name, orc::CompressionKind& kind) {
+  static const std::pair<const char*, orc::CompressionKind> KINDS[] = {
+      {"none", orc::CompressionKind_NONE}, {"zlib", orc::CompressionKind_ZLIB},
+      {"snappy", orc::CompressionKind_SNAPPY}, {"lz4", orc::CompressionKind_LZ4},
+      {"zstd", orc::CompressionKind_ZSTD}};
+  for (const auto& entry : KINDS) {
+    if (name == entry.first) {
+      kind = entry.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void usage() {
+  std::cerr
+      << "Usage: orc-bench [options] <filename>\n"
+      << "Options:\n"
+      << "\t-h --help\n"
+      << "\t-r --rows\t\tNumber of rows (default 1000000)\n"
+      << "\t-w --columns\t\tNumber of columns (default 10)\n"
+      << "\t-T --types\t\tComma separated column types that the columns cycle through\n"
+      << "\t\t\t\t(default bigint,double,string)\n"
+      << "\t-k --cardinality\tDistinct values per column, 0 for all distinct (default 0)\n"
+      << "\t-N --null-ratio\t\tShare of null values between 0 and 1 (default 0)\n"
+      << "\t-S --sortedness\t\tShare of values in sorted order between 0 and 1 (default 0)\n"
+      << "\t-l --string-length\tLength or min,max length of strings (default 8,32)\n"
+      << "\t   --seed\t\tSeed of the random values (default 42)\n"
+      << "\t-c --compression\tnone, zlib, snappy, lz4 or zstd (default zstd)\n"
+      << "\t   --strategy\t\tspeed or compression (default speed)\n"
+      << "\t   --stripe-size\tStripe size in bytes\n"
+      << "\t   --block-size\t\tCompression block size in bytes\n"
+      << "\t   --row-index-stride\tRows per row group\n"
+      << "\t   --dictionary-threshold\tDictionary key size threshold\n"
+      << "\t   --bloom-filter\tWrite bloom filters for all columns\n"
+      << "\t-b --batch\t\tBatch size for writing and reading (default 1024)\n"
+      << "\t-p --projection\t\tColumns of the projected scan (default half)\n"
+      << "\t-s --selectivity\tShare of the keys that the predicate scan selects (default 0.1)\n"
+      << "\t-n --repetitions\tNumber of runs of each scan (default 3)\n"
+      << "\t   --latency\t\tMicroseconds that each read waits, like a remote request\n"
+      << "\t   --bandwidth\t\tBytes per second that each read transfers\n"
+      << "\t   --prebuffer\t\tFetch the selected columns of all stripes up front\n"
+      << "\t   --hole-size-limit\tLargest gap between prebuffered ranges that are combined\n"
+      << "\t   --range-size-limit\tLargest combined prebuffered range\n"
+      << "\t   --trace\t\tWrite the spans of the write and the scans to this file as a\n"
+      << "\t\t\t\tChrome trace\n"
+      << "Writes a synthetic data set to the file, scans it fully, projected and with a\n"
+      << "predicate, and prints the timings and metrics as JSON.\n";
+}
+
+int main(int argc, char* argv[]) {
+  enum LongOnlyOption {
+    SEED = 256,
+    STRATEGY,
+    STRIPE_SIZE,
+    BLOCK_SIZE,
+    ROW_INDEX_STRIDE,
+    DICTIONARY_THRESHOLD,
+    BLOOM_FILTER,
+    LATENCY,
+    BANDWIDTH,
+    PRE_BUFFER,
+    HOLE_SIZE_LIMIT,
+    RANGE_SIZE_LIMIT,
+    TRACE
+  };
+  static struct option longOptions[] = {
+      {"help", no_argument, nullptr, 'h'},
+      {"rows", required_argument, nullptr, 'r'},
+      {"columns", required_argument, nullptr, 'w'},
+      {"types", required_argument, nullptr, 'T'},
+      {"cardinality", required_argument, nullptr, 'k'},
+      {"null-ratio", required_argument, nullptr, 'N'},
+      {"sortedness", required_argument, nullptr, 'S'},
+      {"string-length", required_argument, nullptr, 'l'},
+      {"seed", required_argument, nullptr, SEED},
+      {"compression", required_argument, nullptr, 'c'},
+      {"strategy", required_argument, nullptr, STRATEGY},
+      {"stripe-size", required_argument, nullptr, STRIPE_SIZE},
+      {"block-size", required_argument, nullptr, BLOCK_SIZE},
+      {"row-index-stride", required_argument, nullptr, ROW_INDEX_STRIDE},
+      {"dictionary-threshold", required_argument, nullptr, DICTIONARY_THRESHOLD},
+      {"bloom-filter", no_argument, nullptr, BLOOM_FILTER},
+      {"batch", required_argument, nullptr, 'b'},
+      {"projection", required_argument, nullptr, 'p'},
+      {"selectivity", required_argument, nullptr, 's'},
+      {"repetitions", required_argument, nullptr, 'n'},
+      {"latency", required_argument, nullptr, LATENCY},
+      {"bandwidth", required_argument, nullptr, BANDWIDTH},
+      {"prebuffer", no_argument, nullptr, PRE_BUFFER},
+      {"hole-size-limit", required_argument, nullptr, HOLE_SIZE_LIMIT},
+      {"range-size-limit", required_argument, nullptr, RANGE_SIZE_LIMIT},
+      {"trace", required_argument, nullptr, TRACE},
+      {nullptr, 0, nullptr, 0}};
+  DataOptions dataOptions;
+  ScanOptions scanOptions;
+  orc::WriterOptions writerOptions;
+  writerOptions.setCompression(orc::CompressionKind_ZSTD);
+  bool bloomFilter = false;
+  std::string traceFile;
+  bool valid = true;
+  int opt;
+  do {
+    opt = getopt_long(argc, argv, "hr:w:T:k:N:S:l:c:b:p:s:n:", longOptions, nullptr);
+    uint64_t number = 0;
+    double ratio = 0;
+    switch (opt) {
+      case '?':
+      case 'h':
+        usage();
+        return 1;
+      case 'r':
+        valid = parseUnsigned(optarg, dataOptions.rows);
+        break;
+      case 'w':
+        valid = parseUnsigned(optarg, dataOptions.columns) && dataOptions.columns > 0;
+        break;
+      case 'T': {
+        dataOptions.types.clear();
+        // commas inside brackets belong to the type, as in decimal(10,2)
+        std::string types = optarg;
+        size_t start = 0;
+        int depth = 0;
+        for (size_t i = 0; i <= types.size(); ++i) {
+          if (i == types.size() || (types[i] == ',' && depth == 0)) {
+            dataOptions.types.push_back(types.substr(start, i - start));
+            start = i + 1;
+          } else if (types[i] == '(' || types[i] == '<') {
+            ++depth;
+          } else if (types[i] == ')' || types[i] == '>') {
+            --depth;
+          }
+        }
+        break;
+      }
+      case 'k':
+        valid = parseUnsigned(optarg, dataOptions.cardinality);
+        break;
+      case 'N':
+        valid = parseRatio(optarg, dataOptions.nullRatio);
+        break;
+      case 'S':
+        valid = parseRatio(optarg, dataOptions.sortedness);
+        break;
+      case 'l': {
+        std::string lengths = optarg;
+        size_t comma = lengths.find(',');
+        valid = parseUnsigned(lengths.substr(0, comma).c_str(), dataOptions.minStringLength);
+        dataOptions.maxStringLength = dataOptions.minStringLength;
+        if (valid && comma != std::string::npos) {
+          valid = parseUnsigned(lengths.substr(comma + 1).c_str(), dataOptions.maxStringLength) &&
+                  dataOptions.maxStringLength >= dataOptions.minStringLength;
+        }
+        valid = valid && dataOptions.maxStringLength > 0;
+        break;
+      }
+      case SEED:
+        valid = parseUnsigned(optarg, dataOptions.seed);
+        break;
+      case 'c': {
+        orc::CompressionKind kind;
+        valid = parseCompression(optarg, kind);
+        if (valid) {
+          writerOptions.setCompression(kind);
+        }
+        break;
+      }
+      case STRATEGY:
+        valid = std::string(optarg) == "speed" || std::string(optarg) == "compression";
+        writerOptions.setCompressionStrategy(std::string(optarg) == "speed"
+                                                 ? orc::CompressionStrategy_SPEED
+                                                 : orc::CompressionStrategy_COMPRESSION);
+        break;
+      case STRIPE_SIZE:
+        valid = parseUnsigned(optarg, number) && number > 0;
+        writerOptions.setStripeSize(number);
+        break;
+      case BLOCK_SIZE:
+        valid = parseUnsigned(optarg, number) && number > 0;
+        writerOptions.setCompressionBlockSize(number);
+        break;
+      case ROW_INDEX_STRIDE:
+        valid = parseUnsigned(optarg, number);
+        writerOptions.setRowIndexStride(number);
+        break;
+      case DICTIONARY_THRESHOLD:
+        valid = parseRatio(optarg, ratio);
+        writerOptions.setDictionaryKeySizeThreshold(ratio);
+        break;
+      case BLOOM_FILTER:
+        bloomFilter = true;
+        break;
+      case 'b':
+        valid = parseUnsigned(optarg, scanOptions.batchSize) && scanOptions.batchSize > 0;
+        break;
+      case 'p':
+        valid = parseUnsigned(optarg, scanOptions.projection);
+        break;
+      case 's':
+        valid = parseRatio(optarg, scanOptions.selectivity);
+        break;
+      case 'n':
+        valid = parseUnsigned(optarg, scanOptions.repetitions) && scanOptions.repetitions > 0;
+        break;
+      case LATENCY:
+        valid = parseUnsigned(optarg, number);
+        scanOptions.storage.latency = std::chrono::microseconds(number);
+        break;
+      case BANDWIDTH:
+        valid = parseUnsigned(optarg, scanOptions.storage.bytesPerSecond);
+        break;
+      case PRE_BUFFER:
+        scanOptions.preBuffer = true;
+        break;
+      case HOLE_SIZE_LIMIT:
+        valid = parseUnsigned(optarg, scanOptions.cacheOptions.holeSizeLimit);
+        break;
+      case RANGE_SIZE_LIMIT:
+        valid = parseUnsigned(optarg, scanOptions.cacheOptions.rangeSizeLimit) &&
+                scanOptions.cacheOptions.rangeSizeLimit > 0;
+        break;
+      case TRACE:
+        traceFile = optarg;
+        break;
+      default:
+        break;
+    }
+    if (!valid) {
+      std::cerr << "Bad option value: " << optarg << "\n";
+      usage();
+      return 1;
+    }
+  } while (opt != -1);
+  if (argc - optind != 1) {
+    usage();
+    return 1;
+  }
+  const char* filename = argv[optind];
+  if (bloomFilter) {
+    std::set<uint64_t> columns;
+    for (uint64_t i = 1; i <= dataOptions.columns; ++i) {
+      columns.insert(i);
+    }
+    writerOptions.setColumnsUseBloomFilter(columns);
+  }
+  orc::TraceRecorder traceRecorder;
+  if (!traceFile.empty()) {
+    writerOptions.setTraceRecorder(&traceRecorder);
+    scanOptions.traceRecorder = &traceRecorder;
+  }
+
+  try {
+    std::cout << "{\n";
+    writeFile(filename, dataOptions, writerOptions, scanOptions.batchSize, std::cout);
+    runScans(filename, dataOptions, scanOptions, std::cout);
+    std::cout << "}" << std::endl;
+    if (!traceFile.empty()) {
+      std::ofstream trace(traceFile);
+      traceRecorder.writeChromeTrace(trace);
+      if (!trace) {
+        throw std::runtime_error("Can't write the trace to " + traceFile);
+      }
+    }
+  } catch (std::exception& ex) {
+    std::cout.flush();
+    std::cerr << "Caught exception in " << filename << ": " << ex.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -19,35 +19,158 @@
 #include "ToolsHelper.hh"
 #include "orc/ColumnPrinter.hh"
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 
-void printContents(const char* filename, const orc::RowReaderOptions& rowReaderOpts) {
-  orc::ReaderOptions readerOpts;
-  std::unique_ptr<orc::Reader> reader;
-  std::unique_ptr<orc::RowReader> rowReader;
-  reader = orc::createReader(orc::readFile(std::string(filename), readerOpts.getReaderMetrics()),
-                             readerOpts);
-  rowReader = reader->createRowReader(rowReaderOpts);
-
+// prints the selected rows of the file, one line per row, and hands the text
+// of each batch to write, which returns false to stop early
+static void printRows(orc::Reader& reader, const orc::RowReaderOptions& rowReaderOpts,
+                      const std::function<bool(std::string&)>& write) {
+  std::unique_ptr<orc::RowReader> rowReader = reader.createRowReader(rowReaderOpts);
   std::unique_ptr<orc::ColumnVectorBatch> batch = rowReader->createRowBatch(1000);
-  std::string line;
   orc::ColumnPrinter::Param param;
   param.printDecimalAsString = true;
   param.printDecimalTrimTrailingZeros = true;
+  std::string output;
   std::unique_ptr<orc::ColumnPrinter> printer =
-      createColumnPrinter(line, &rowReader->getSelectedType(), param);
+      createColumnPrinter(output, &rowReader->getSelectedType(), param);
 
   while (rowReader->next(*batch)) {
-    printer->reset(*batch);
-    for (unsigned long i = 0; i < batch->numElements; ++i) {
-      line.clear();
-      printer->printRow(i);
-      line += "\n";
-      const char* str = line.c_str();
-      fwrite(str, 1, strlen(str), stdout);
+    printer->printBatch(*batch);
+    if (!write(output)) {
+      return;
+    }
+    output.clear();
+  }
+}
+
+static std::unique_ptr<orc::Reader> openFile(const char* filename) {
+  orc::ReaderOptions readerOpts;
+  return orc::createReader(
+      orc::readFile(std::string(filename), readerOpts.getReaderMetrics()), readerOpts);
+}
+
+// The text that the task of a stripe has printed and the main thread has not
+// written yet. The task blocks while more than MAX_BUFFERED_BYTES are queued,
+// so a stripe never holds more than that plus the text of one batch.
+class StripeOutput {
+ public:
+  static const uint64_t MAX_BUFFERED_BYTES = 4 * 1024 * 1024;
+
+  // called by the task; returns false once the output was cancelled
+  bool push(std::string& text) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return cancelled_ || bytes_ < MAX_BUFFERED_BYTES; });
+    if (cancelled_) {
+      return false;
+    }
+    bytes_ += text.size();
+    chunks_.push_back(std::move(text));
+    changed_.notify_all();
+    return true;
+  }
+
+  // called by the task when it stops, whether it succeeded or not
+  void finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    changed_.notify_all();
+  }
+
+  // called by the main thread; returns false once the task finished and all
+  // of its text was taken
+  bool pop(std::string& text) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this] { return finished_ || !chunks_.empty(); });
+    if (chunks_.empty()) {
+      return false;
+    }
+    text = std::move(chunks_.front());
+    chunks_.pop_front();
+    bytes_ -= text.size();
+    changed_.notify_all();
+    return true;
+  }
+
+  // stops the task at its next batch
+  void cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    changed_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::deque<std::string> chunks_;
+  uint64_t bytes_ = 0;
+  bool finished_ = false;
+  bool cancelled_ = false;
+};
+
+static void printStripe(const char* filename, const orc::RowReaderOptions& rowReaderOpts,
+                        uint64_t offset, uint64_t length, StripeOutput& output) {
+  try {
+    orc::RowReaderOptions stripeOpts(rowReaderOpts);
+    stripeOpts.range(offset, length);
+    printRows(*openFile(filename), stripeOpts,
+              [&output](std::string& text) { return output.push(text); });
+  } catch (...) {
+    output.finish();
+    throw;
+  }
+  output.finish();
+}
+
+void printContents(const char* filename, const orc::RowReaderOptions& rowReaderOpts,
+                   uint64_t threads) {
+  std::unique_ptr<orc::Reader> reader = openFile(filename);
+  const uint64_t stripes = reader->getNumberOfStripes();
+  if (threads <= 1 || stripes <= 1) {
+    printRows(*reader, rowReaderOpts, [](std::string& text) {
+      fwrite(text.data(), 1, text.size(), stdout);
+      return true;
+    });
+    return;
+  }
+
+  // Every stripe is printed by its own task with its own reader. The output
+  // is written in stripe order while the tasks run, and at most threads
+  // stripes are in flight.
+  struct PendingStripe {
+    std::unique_ptr<StripeOutput> output;
+    std::future<void> task;
+  };
+  std::deque<PendingStripe> pending;
+  try {
+    std::string text;
+    for (uint64_t stripe = 0; stripe < stripes || !pending.empty();) {
+      while (stripe < stripes && pending.size() < threads) {
+        std::unique_ptr<orc::StripeInformation> info = reader->getStripe(stripe++);
+        auto output = std::make_unique<StripeOutput>();
+        std::future<void> task =
+            std::async(std::launch::async, printStripe, filename, std::cref(rowReaderOpts),
+                       info->getOffset(), info->getLength(), std::ref(*output));
+        pending.push_back({std::move(output), std::move(task)});
+      }
+      while (pending.front().output->pop(text)) {
+        fwrite(text.data(), 1, text.size(), stdout);
+      }
+      pending.front().task.get();
+      pending.pop_front();
+    }
+  } catch (...) {
+    // unblock the remaining tasks before their futures wait for them
+    for (PendingStripe& stripe : pending) {
+      stripe.output->cancel();
     }
+    throw;
   }
 }
 
@@ -55,17 +178,19 @@ int main(int argc, char* argv[]) {
   uint64_t batchSize;  // not used
   orc::RowReaderOptions rowReaderOptions;
   bool showMetrics = false;
-  bool success = parseOptions(&argc, &argv, &batchSize, &rowReaderOptions, &showMetrics);
+  uint64_t threads = 1;
+  bool success =
+      parseOptions(&argc, &argv, &batchSize, &rowReaderOptions, &showMetrics, &threads);
 
   if (argc < 1 || !success) {
     std::cerr << "Usage: orc-contents [options] <filename>...\n";
-    printOptions(std::cerr);
+    printOptions(std::cerr, true);
     std::cerr << "Print contents of ORC files.\n";
     return 1;
   }
   for (int i = 0; i < argc; ++i) {
     try {
-      printContents(argv[i], rowReaderOptions);
+      printContents(argv[i], rowReaderOptions, threads);
     } catch (std::exception& ex) {
       std::cerr << "Caught exception in " << argv[i] << ": " << ex.what() << "\n";
       return 1;
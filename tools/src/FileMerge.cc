@@ -0,0 +1,69 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/Exceptions.hh"
+#include "orc/OrcFile.hh"
+
+#include <getopt.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+  static struct option longOptions[] = {{"help", no_argument, nullptr, 'h'},
+                                        {nullptr, 0, nullptr, 0}};
+  bool helpFlag = false;
+  int opt;
+  do {
+    opt = getopt_long(argc, argv, "h", longOptions, nullptr);
+    switch (opt) {
+      case '?':
+      case 'h':
+        helpFlag = true;
+        opt = -1;
+        break;
+    }
+  } while (opt != -1);
+  argc -= optind;
+  argv += optind;
+
+  if (argc < 2 || helpFlag) {
+    std::cerr << "Usage: orc-merge [-h] [--help] <output> <input>...\n"
+              << "Merge ORC files with the same schema and compression by copying their"
+              << " stripes without decoding them\n";
+    exit(1);
+  }
+
+  try {
+    orc::ReaderOptions readerOpts;
+    std::vector<std::unique_ptr<orc::Reader>> readers;
+    std::vector<const orc::Reader*> inputs;
+    for (int i = 1; i < argc; ++i) {
+      readers.push_back(orc::createReader(orc::readFile(argv[i]), readerOpts));
+      inputs.push_back(readers.back().get());
+    }
+    std::unique_ptr<orc::OutputStream> output = orc::writeLocalFile(argv[0]);
+    orc::mergeFiles(inputs, output.get());
+  } catch (std::exception& ex) {
+    std::cerr << "Caught exception: " << ex.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -18,50 +18,185 @@
 
 #include "ToolsHelper.hh"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
 
-void scanFile(std::ostream& out, const char* filename, uint64_t batchSize,
-              const orc::RowReaderOptions& rowReaderOpts, bool showMetrics) {
+// a group of stripes of a file that one thread scans
+struct ScanTask {
+  size_t file;
+  orc::RowReaderOptions options;
+  uint64_t rows = 0;
+  uint64_t batches = 0;
+  std::exception_ptr error;
+};
+
+struct ScanFile {
+  const char* filename;
   orc::ReaderOptions readerOpts;
-  if (showMetrics) {
-    readerOpts.setReaderMetrics(orc::getDefaultReaderMetrics());
-  }
-  std::unique_ptr<orc::Reader> reader =
-      orc::createReader(orc::readFile(filename, readerOpts.getReaderMetrics()), readerOpts);
-  std::unique_ptr<orc::RowReader> rowReader = reader->createRowReader(rowReaderOpts);
-  std::unique_ptr<orc::ColumnVectorBatch> batch = rowReader->createRowBatch(batchSize);
+  std::exception_ptr error;
+};
 
-  unsigned long rows = 0;
-  unsigned long batches = 0;
+static std::unique_ptr<orc::Reader> openFile(const ScanFile& file,
+                                             std::atomic<uint64_t>& bytesRead) {
+  return orc::createReader(
+      std::make_unique<CountingInputStream>(
+          orc::readFile(file.filename, file.readerOpts.getReaderMetrics()), bytesRead),
+      file.readerOpts);
+}
+
+static void scanStripes(const ScanFile& file, ScanTask& task, uint64_t batchSize,
+                        std::atomic<uint64_t>& bytesRead) {
+  std::unique_ptr<orc::RowReader> rowReader =
+      openFile(file, bytesRead)->createRowReader(task.options);
+  std::unique_ptr<orc::ColumnVectorBatch> batch = rowReader->createRowBatch(batchSize);
   while (rowReader->next(*batch)) {
-    batches += 1;
-    rows += batch->numElements;
+    task.batches += 1;
+    task.rows += batch->numElements;
   }
-  out << "Rows: " << rows << std::endl;
-  out << "Batches: " << batches << std::endl;
-  if (showMetrics) {
-    printReaderMetrics(out, reader->getReaderMetrics());
+}
+
+// runs the work on up to the given number of threads, each of them takes the
+// next index until all of them are done
+template <typename Work>
+static void runParallel(size_t count, uint64_t threads, Work work) {
+  std::atomic<size_t> next{0};
+  auto takeNext = [&]() {
+    for (size_t i = next++; i < count; i = next++) {
+      work(i);
+    }
+  };
+  std::vector<std::future<void>> workers;
+  for (uint64_t i = 1; i < std::min<uint64_t>(threads, count); ++i) {
+    workers.push_back(std::async(std::launch::async, takeNext));
+  }
+  takeNext();
+  for (auto& worker : workers) {
+    worker.get();
   }
 }
 
+// Splits a file into groups of stripes so that threads tasks can scan them at
+// once. The tasks reopen their file from its serialized tail.
+static std::vector<ScanTask> planFile(size_t index, ScanFile& file,
+                                      const orc::RowReaderOptions& rowReaderOpts,
+                                      const std::string& searchArgument, uint64_t threads,
+                                      std::atomic<uint64_t>& bytesRead) {
+  std::unique_ptr<orc::Reader> reader = openFile(file, bytesRead);
+  file.readerOpts.setSerializedFileTail(reader->getSerializedFileTail());
+  orc::RowReaderOptions fileOpts(rowReaderOpts);
+  if (!searchArgument.empty()) {
+    fileOpts.searchArgument(buildSearchArgument(reader->getType(), searchArgument));
+  }
+  // the copies go through the const overload, the other one takes the options
+  std::vector<ScanTask> tasks;
+  for (const orc::ScanSplit& split : reader->planScan(fileOpts, threads)) {
+    ScanTask task{index, orc::RowReaderOptions(std::as_const(fileOpts)), 0, 0, nullptr};
+    task.options.range(split.offset, split.length);
+    tasks.push_back(std::move(task));
+  }
+  return tasks;
+}
+
+// The files are planned on the threads too, since opening each of them costs
+// a read of its tail. The tasks keep the order of the files.
+static std::vector<ScanTask> planTasks(std::vector<ScanFile>& files,
+                                       const orc::RowReaderOptions& rowReaderOpts,
+                                       const std::string& searchArgument, uint64_t threads,
+                                       orc::ReaderMetrics* metrics,
+                                       std::atomic<uint64_t>& bytesRead) {
+  std::vector<std::vector<ScanTask>> fileTasks(files.size());
+  runParallel(files.size(), threads, [&](size_t i) {
+    try {
+      files[i].readerOpts.setReaderMetrics(metrics);
+      fileTasks[i] = planFile(i, files[i], rowReaderOpts, searchArgument, threads, bytesRead);
+    } catch (...) {
+      files[i].error = std::current_exception();
+    }
+  });
+  std::vector<ScanTask> tasks;
+  for (std::vector<ScanTask>& planned : fileTasks) {
+    std::move(planned.begin(), planned.end(), std::back_inserter(tasks));
+  }
+  return tasks;
+}
+
 int main(int argc, char* argv[]) {
   uint64_t batchSize = 1024;
   bool showMetrics = false;
+  uint64_t threads = 1;
+  std::string searchArgument;
   orc::RowReaderOptions rowReaderOptions;
-  bool success = parseOptions(&argc, &argv, &batchSize, &rowReaderOptions, &showMetrics);
+  bool success = parseOptions(&argc, &argv, &batchSize, &rowReaderOptions, &showMetrics, &threads,
+                              &searchArgument);
   if (argc < 1 || !success) {
     std::cerr << "Usage: orc-scan [options] <filename>...\n";
-    printOptions(std::cerr);
+    printOptions(std::cerr, true, true);
     std::cerr << "Scans and displays the row count of the ORC files.\n";
     return 1;
   }
+
+  const auto start = std::chrono::steady_clock::now();
+  orc::ReaderMetrics metrics;
+  std::atomic<uint64_t> bytesRead{0};
+  std::vector<ScanFile> files;
   for (int i = 0; i < argc; ++i) {
+    files.push_back({argv[i], orc::ReaderOptions(), nullptr});
+  }
+  std::vector<ScanTask> tasks = planTasks(files, rowReaderOptions, searchArgument, threads,
+                                          showMetrics ? &metrics : nullptr, bytesRead);
+
+  runParallel(tasks.size(), threads, [&](size_t i) {
     try {
-      scanFile(std::cout, argv[i], batchSize, rowReaderOptions, showMetrics);
-    } catch (std::exception& ex) {
-      std::cerr << "Caught exception in " << argv[i] << ": " << ex.what() << "\n";
-      return 1;
+      scanStripes(files[tasks[i].file], tasks[i], batchSize, bytesRead);
+    } catch (...) {
+      tasks[i].error = std::current_exception();
+    }
+  });
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  uint64_t totalRows = 0;
+  size_t task = 0;
+  for (size_t i = 0; i < files.size(); ++i) {
+    uint64_t rows = 0;
+    uint64_t batches = 0;
+    std::exception_ptr error = files[i].error;
+    for (; task < tasks.size() && tasks[task].file == i; ++task) {
+      rows += tasks[task].rows;
+      batches += tasks[task].batches;
+      if (!error) {
+        error = tasks[task].error;
+      }
     }
+    if (error) {
+      try {
+        std::rethrow_exception(error);
+      } catch (std::exception& ex) {
+        std::cerr << "Caught exception in " << files[i].filename << ": " << ex.what() << "\n";
+        return 1;
+      }
+    }
+    std::cout << "Rows: " << rows << std::endl;
+    std::cout << "Batches: " << batches << std::endl;
+    totalRows += rows;
+  }
+  if (showMetrics) {
+    const double seconds = elapsed.count();
+    std::cout << "TotalRows: " << totalRows << std::endl;
+    std::cout << "TotalBytesRead: " << bytesRead << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << "ScanSeconds: " << seconds << std::endl;
+    std::cout << std::setprecision(0)
+              << "RowsPerSecond: " << (seconds > 0 ? totalRows / seconds : 0) << std::endl;
+    std::cout << "BytesPerSecond: " << (seconds > 0 ? bytesRead / seconds : 0) << std::endl;
+    printReaderMetrics(std::cout, &metrics);
   }
   return 0;
 }
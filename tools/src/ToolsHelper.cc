@@ -19,8 +19,11 @@
 #include "ToolsHelper.hh"
 
 #include <getopt.h>
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
 
-void printOptions(std::ostream& out) {
+void printOptions(std::ostream& out, bool showThreads, bool showSearchArgument) {
   out << "Options:\n"
       << "\t-h --help\n"
       << "\t-c --columns\t\tComma separated list of top-level column fields\n"
@@ -28,23 +31,32 @@ void printOptions(std::ostream& out) {
       << "\t-n --columnNames\tComma separated list of column names\n"
       << "\t-b --batch\t\tBatch size for reading\n"
       << "\t-m --metrics\t\tShow metrics for reading\n";
+  if (showThreads) {
+    out << "\t-j --threads\t\tNumber of threads reading stripes in parallel\n";
+  }
+  if (showSearchArgument) {
+    out << "\t-s --sarg\t\tComma separated list of column predicates, e.g. x>=10,y=abc\n";
+  }
 }
 
 bool parseOptions(int* argc, char** argv[], uint64_t* batchSize,
-                  orc::RowReaderOptions* rowReaderOpts, bool* showMetrics) {
+                  orc::RowReaderOptions* rowReaderOpts, bool* showMetrics, uint64_t* threads,
+                  std::string* searchArgument) {
   static struct option longOptions[] = {{"help", no_argument, nullptr, 'h'},
                                         {"batch", required_argument, nullptr, 'b'},
                                         {"columns", required_argument, nullptr, 'c'},
                                         {"columnTypeIds", required_argument, nullptr, 't'},
                                         {"columnNames", required_argument, nullptr, 'n'},
                                         {"metrics", no_argument, nullptr, 'm'},
+                                        {"threads", required_argument, nullptr, 'j'},
+                                        {"sarg", required_argument, nullptr, 's'},
                                         {nullptr, 0, nullptr, 0}};
   std::list<uint64_t> cols;
   std::list<std::string> colNames;
   int opt;
   char* tail;
   do {
-    opt = getopt_long(*argc, *argv, "hb:c:t:n:m", longOptions, nullptr);
+    opt = getopt_long(*argc, *argv, "hb:c:t:n:mj:s:", longOptions, nullptr);
     switch (opt) {
       case '?':
       case 'h':
@@ -85,6 +97,24 @@ bool parseOptions(int* argc, char** argv[], uint64_t* batchSize,
         *showMetrics = true;
         break;
       }
+      case 'j':
+        if (threads == nullptr) {
+          fprintf(stderr, "The --threads parameter is not supported.\n");
+          return false;
+        }
+        *threads = strtoul(optarg, &tail, 10);
+        if (*tail != '\0' || *threads == 0) {
+          fprintf(stderr, "The --threads parameter requires a positive integer option.\n");
+          return false;
+        }
+        break;
+      case 's':
+        if (searchArgument == nullptr) {
+          fprintf(stderr, "The --sarg parameter is not supported.\n");
+          return false;
+        }
+        *searchArgument = optarg;
+        break;
       default:
         break;
     }
@@ -94,6 +124,170 @@ bool parseOptions(int* argc, char** argv[], uint64_t* batchSize,
   return true;
 }
 
+// finds a field of a struct anywhere below the type, depth first like the
+// reader resolves the column names of a search argument
+static const orc::Type* findFieldByName(const orc::Type& type, const std::string& name) {
+  for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+    if (type.getKind() == orc::STRUCT && type.getFieldName(i) == name) {
+      return type.getSubtype(i);
+    }
+    if (const orc::Type* found = findFieldByName(*type.getSubtype(i), name)) {
+      return found;
+    }
+  }
+  return nullptr;
+}
+
+// finds the type of a column given by its dotted path from the root, or by
+// the name of a field at any depth
+static const orc::Type* findColumnType(const orc::Type& type, const std::string& column) {
+  const orc::Type* current = &type;
+  size_t start = 0;
+  while (current != nullptr && start <= column.size()) {
+    size_t end = column.find('.', start);
+    if (end == std::string::npos) {
+      end = column.size();
+    }
+    const std::string field = column.substr(start, end - start);
+    const orc::Type* child = nullptr;
+    if (current->getKind() == orc::STRUCT) {
+      for (uint64_t i = 0; i < current->getSubtypeCount(); ++i) {
+        if (current->getFieldName(i) == field) {
+          child = current->getSubtype(i);
+          break;
+        }
+      }
+    }
+    current = child;
+    start = end + 1;
+  }
+  if (current == nullptr && column.find('.') == std::string::npos) {
+    current = findFieldByName(type, column);
+  }
+  if (current == nullptr) {
+    throw std::invalid_argument("Unknown column " + column + " in --sarg");
+  }
+  return current;
+}
+
+static int64_t parseSargLong(const std::string& value) {
+  char* tail;
+  errno = 0;
+  int64_t result = strtoll(value.c_str(), &tail, 10);
+  if (value.empty() || *tail != '\0' || errno == ERANGE) {
+    throw std::invalid_argument("Bad integer " + value + " in --sarg");
+  }
+  return result;
+}
+
+// the number of days since 1970-01-01 of a yyyy-mm-dd date
+static int64_t parseSargDate(const std::string& value) {
+  int year, month, day;
+  char extra;
+  if (sscanf(value.c_str(), "%d-%d-%d%c", &year, &month, &day, &extra) != 3 || month < 1 ||
+      month > 12 || day < 1 || day > 31) {
+    throw std::invalid_argument("Bad date " + value + " in --sarg");
+  }
+  // Howard Hinnant's days_from_civil
+  const int64_t y = year - (month <= 2);
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t yearOfEra = y - era * 400;
+  const int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + dayOfEra - 719468;
+}
+
+// the predicate data type and literal to compare a column of the type with
+static orc::Literal makeSargLiteral(const orc::Type& type, const std::string& value,
+                                    orc::PredicateDataType& dataType) {
+  switch (type.getKind()) {
+    case orc::BOOLEAN:
+      dataType = orc::PredicateDataType::BOOLEAN;
+      if (value != "true" && value != "false") {
+        throw std::invalid_argument("Bad boolean " + value + " in --sarg");
+      }
+      return orc::Literal(value == "true");
+    case orc::BYTE:
+    case orc::SHORT:
+    case orc::INT:
+    case orc::LONG:
+      dataType = orc::PredicateDataType::LONG;
+      return orc::Literal(parseSargLong(value));
+    case orc::FLOAT:
+    case orc::DOUBLE: {
+      dataType = orc::PredicateDataType::FLOAT;
+      char* tail;
+      double result = strtod(value.c_str(), &tail);
+      if (value.empty() || *tail != '\0') {
+        throw std::invalid_argument("Bad number " + value + " in --sarg");
+      }
+      return orc::Literal(result);
+    }
+    case orc::STRING:
+    case orc::VARCHAR:
+    case orc::CHAR:
+      dataType = orc::PredicateDataType::STRING;
+      return orc::Literal(value.data(), value.size());
+    case orc::DATE:
+      dataType = orc::PredicateDataType::DATE;
+      return orc::Literal(orc::PredicateDataType::DATE, parseSargDate(value));
+    case orc::DECIMAL: {
+      dataType = orc::PredicateDataType::DECIMAL;
+      orc::Decimal decimal(value);
+      return orc::Literal(decimal.value, static_cast<int32_t>(type.getPrecision()),
+                          decimal.scale);
+    }
+    default:
+      throw std::invalid_argument("Column type " + type.toString() + " is not supported by --sarg");
+  }
+}
+
+std::unique_ptr<orc::SearchArgument> buildSearchArgument(const orc::Type& type,
+                                                         const std::string& predicates) {
+  std::unique_ptr<orc::SearchArgumentBuilder> builder = orc::SearchArgumentFactory::newBuilder();
+  builder->startAnd();
+  size_t start = 0;
+  while (start <= predicates.size()) {
+    size_t end = predicates.find(',', start);
+    if (end == std::string::npos) {
+      end = predicates.size();
+    }
+    const std::string predicate = predicates.substr(start, end - start);
+    size_t opStart = predicate.find_first_of("=!<>");
+    if (opStart == std::string::npos || opStart == 0) {
+      throw std::invalid_argument("Bad predicate " + predicate + " in --sarg");
+    }
+    size_t opEnd = opStart + 1;
+    if (opEnd < predicate.size() && predicate[opEnd] == '=' && predicate[opStart] != '=') {
+      ++opEnd;
+    }
+    const std::string column = predicate.substr(0, opStart);
+    const std::string op = predicate.substr(opStart, opEnd - opStart);
+    // leaves refer to the column id, since the reader only resolves bare field names
+    const orc::Type* columnType = findColumnType(type, column);
+    const uint64_t columnId = columnType->getColumnId();
+    orc::PredicateDataType dataType;
+    orc::Literal literal = makeSargLiteral(*columnType, predicate.substr(opEnd), dataType);
+    if (op == "=") {
+      builder->equals(columnId, dataType, literal);
+    } else if (op == "!=") {
+      builder->startNot().equals(columnId, dataType, literal).end();
+    } else if (op == "<") {
+      builder->lessThan(columnId, dataType, literal);
+    } else if (op == "<=") {
+      builder->lessThanEquals(columnId, dataType, literal);
+    } else if (op == ">") {
+      builder->startNot().lessThanEquals(columnId, dataType, literal).end();
+    } else if (op == ">=") {
+      builder->startNot().lessThan(columnId, dataType, literal).end();
+    } else {
+      throw std::invalid_argument("Bad predicate " + predicate + " in --sarg");
+    }
+    start = end + 1;
+  }
+  return builder->end().build();
+}
+
 void printReaderMetrics(std::ostream& out, const orc::ReaderMetrics* metrics) {
   if (metrics != nullptr) {
     static const uint64_t US_PER_SECOND = 1000000;
@@ -16,13 +16,60 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <iostream>
 #include "orc/ColumnPrinter.hh"
+#include "orc/OrcFile.hh"
 #include "orc/Reader.hh"
+#include "orc/sargs/SearchArgument.hh"
 
-void printOptions(std::ostream& out);
+void printOptions(std::ostream& out, bool showThreads = false, bool showSearchArgument = false);
 
+// --threads and --sarg are only accepted by the tools that pass threads and
+// searchArgument
 bool parseOptions(int* argc, char** argv[], uint64_t* batchSize,
-                  orc::RowReaderOptions* rowReaderOpts, bool* showMetrics);
+                  orc::RowReaderOptions* rowReaderOpts, bool* showMetrics,
+                  uint64_t* threads = nullptr, std::string* searchArgument = nullptr);
+
+// Builds the search argument of a --sarg option for a file of the given
+// type. The option is a comma separated list of predicates such as x>=10 or
+// name=abc that all have to hold. Throws std::invalid_argument when it is
+// malformed.
+std::unique_ptr<orc::SearchArgument> buildSearchArgument(const orc::Type& type,
+                                                         const std::string& predicates);
 
 void printReaderMetrics(std::ostream& out, const orc::ReaderMetrics* metrics);
+
+// counts the bytes that are read from the wrapped stream
+class CountingInputStream : public orc::InputStream {
+ private:
+  std::unique_ptr<orc::InputStream> stream_;
+  std::atomic<uint64_t>& bytesRead_;
+
+ public:
+  CountingInputStream(std::unique_ptr<orc::InputStream> stream, std::atomic<uint64_t>& bytesRead)
+      : stream_(std::move(stream)), bytesRead_(bytesRead) {}
+
+  uint64_t getLength() const override {
+    return stream_->getLength();
+  }
+
+  uint64_t getNaturalReadSize() const override {
+    return stream_->getNaturalReadSize();
+  }
+
+  void read(void* buf, uint64_t length, uint64_t offset) override {
+    stream_->read(buf, length, offset);
+    bytesRead_ += length;
+  }
+
+  std::future<void> readAsync(void* buf, uint64_t length, uint64_t offset) override {
+    bytesRead_ += length;
+    return stream_->readAsync(buf, length, offset);
+  }
+
+  const std::string& getName() const override {
+    return stream_->getName();
+  }
+};
+
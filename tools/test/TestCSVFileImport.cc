@@ -119,3 +119,43 @@ TEST(TestCSVFileImport, testLongString) {
   EXPECT_EQ(expected, output);
   EXPECT_EQ("", error);
 }
+
+TEST(TestCSVFileImport, testThreads) {
+  const std::string pgm1 = findProgram("tools/src/csv-import");
+  const std::string pgm2 = findProgram("tools/src/orc-contents");
+  const std::string csvFile = "/tmp/test_csv_import_test_threads.csv";
+  const std::string schema = "'struct<_a:bigint,b_:string,c_col:double,d:boolean>'";
+  std::string output;
+  std::string error;
+
+  // several read blocks with missing fields and no final newline
+  std::ofstream csvFileStream(csvFile, std::ios::binary | std::ios::out | std::ios::trunc);
+  if (csvFileStream.is_open()) {
+    for (int i = 0; i < 200000; ++i) {
+      csvFileStream << i << ",str" << (i % 7 == 0 ? "" : std::to_string(i)) << ","
+                    << (i % 11 == 0 ? "" : std::to_string(i) + ".5") << ","
+                    << (i % 3 == 0 ? "TRUE" : "false") << "\n";
+    }
+    csvFileStream << "200000,last";
+    csvFileStream.close();
+  }
+
+  const std::string orcFile = "/tmp/test_csv_import_test_threads.orc";
+  std::string expected;
+  for (const std::string threads : {"--threads=1", "--threads=4"}) {
+    EXPECT_EQ(0, runProgram({pgm1, threads, "--batch=1000", schema, csvFile, orcFile}, output,
+                            error));
+    EXPECT_EQ("", error);
+    EXPECT_EQ(0, runProgram({pgm2, orcFile}, output, error));
+    EXPECT_EQ("", error);
+    if (expected.empty()) {
+      expected = output;
+      EXPECT_EQ("{\"_a\": 200000, \"b_\": \"last\", \"c_col\": null, \"d\": null}\n",
+                expected.substr(expected.rfind('\n', expected.size() - 2) + 1));
+    } else {
+      EXPECT_EQ(expected, output);
+    }
+  }
+  EXPECT_EQ(1, runProgram({pgm1, "--threads=0", schema, csvFile, orcFile}, output, error));
+  EXPECT_NE(std::string::npos, error.find("--threads"));
+}
@@ -0,0 +1,122 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/OrcFile.hh"
+
+#include "ToolTest.hh"
+
+#include "wrap/gmock.h"
+#include "wrap/gtest-wrapper.h"
+
+#include <fstream>
+#include <sstream>
+
+TEST(TestFileBench, testNominal) {
+  const std::string pgm = findProgram("tools/src/orc-bench");
+  const std::string file = "/tmp/test_file_bench_nominal.orc";
+  std::string output;
+  std::string error;
+  EXPECT_EQ(0, runProgram({pgm, "--rows=5000", "--columns=4", "--types=int,string",
+                           "--cardinality=100", "--null-ratio=0.1", "--sortedness=1",
+                           "--string-length=4,12", "--compression=zlib", "--row-index-stride=1000",
+                           "--repetitions=1", "--selectivity=0.5", file},
+                          output, error));
+  EXPECT_EQ("", error);
+  EXPECT_THAT(output,
+              testing::HasSubstr("\"schema\": \"struct<c0:int,c1:string,c2:int,c3:string>\""));
+  EXPECT_THAT(output, testing::HasSubstr("\"compression\": \"zlib\""));
+  EXPECT_THAT(output, testing::HasSubstr("\"name\": \"full\", \"rows\": 5000"));
+  EXPECT_THAT(output, testing::HasSubstr("\"name\": \"projected\", \"rows\": 5000"));
+  // the sorted keys below 50 are in the first three row groups
+  EXPECT_THAT(output, testing::HasSubstr("\"name\": \"predicate\", \"rows\": 3000"));
+  EXPECT_THAT(output, testing::HasSubstr("\"DictionaryCheckCount\": "));
+  EXPECT_THAT(output, testing::HasSubstr("\"SelectedRowGroupCount\": "));
+  EXPECT_THAT(output,
+              testing::HasSubstr("{\"column\": 1, \"ReaderCall\": 5, \"RowsRead\": 5000, "));
+
+  std::unique_ptr<orc::Reader> reader =
+      orc::createReader(orc::readLocalFile(file), orc::ReaderOptions());
+  EXPECT_EQ(5000, reader->getNumberOfRows());
+  EXPECT_EQ(orc::CompressionKind_ZLIB, reader->getCompression());
+  std::unique_ptr<orc::ColumnStatistics> stats = reader->getColumnStatistics(1);
+  EXPECT_TRUE(stats->hasNull());
+  const auto& ints = dynamic_cast<const orc::IntegerColumnStatistics&>(*stats);
+  EXPECT_LE(0, ints.getMinimum());
+  EXPECT_GT(100, ints.getMaximum());
+  stats = reader->getColumnStatistics(2);
+  const auto& strings = dynamic_cast<const orc::StringColumnStatistics&>(*stats);
+  EXPECT_LE(4, strings.getMinimum().size());
+  EXPECT_GE(12, strings.getMaximum().size());
+}
+
+TEST(TestFileBench, testRemoteStorage) {
+  const std::string pgm = findProgram("tools/src/orc-bench");
+  const std::string file = "/tmp/test_file_bench_remote_storage.orc";
+  std::string output;
+  std::string error;
+  EXPECT_EQ(0, runProgram({pgm, "--rows=3000", "--columns=2", "--compression=none",
+                           "--stripe-size=1", "--batch=1000", "--repetitions=1", "--latency=1000",
+                           "--bandwidth=100000000", "--prebuffer", "--hole-size-limit=0", file},
+                          output, error));
+  EXPECT_EQ("", error);
+  EXPECT_THAT(output, testing::HasSubstr("\"stripes\": 3,"));
+  EXPECT_THAT(output,
+              testing::HasSubstr("\"read\": {\"latencyUs\": 1000, \"bandwidth\": 100000000, "
+                                 "\"preBuffer\": true, \"holeSizeLimit\": 0, "));
+  EXPECT_THAT(output, testing::HasSubstr("\"name\": \"full\", \"rows\": 3000, \"batches\": 3"));
+  EXPECT_THAT(output, testing::HasSubstr("\"name\": \"projected\", \"rows\": 3000"));
+}
+
+TEST(TestFileBench, testTrace) {
+  const std::string pgm = findProgram("tools/src/orc-bench");
+  const std::string file = "/tmp/test_file_bench_trace.orc";
+  const std::string traceFile = "/tmp/test_file_bench_trace.json";
+  std::string output;
+  std::string error;
+  EXPECT_EQ(0, runProgram({pgm, "--rows=3000", "--columns=2", "--compression=none",
+                           "--stripe-size=1", "--batch=1000", "--repetitions=1", "--prebuffer",
+                           "--trace=" + traceFile, file},
+                          output, error));
+  EXPECT_EQ("", error);
+  std::ifstream trace(traceFile);
+  std::stringstream contents;
+  contents << trace.rdbuf();
+  EXPECT_THAT(contents.str(), testing::StartsWith("{\"traceEvents\": [\n"));
+  EXPECT_THAT(contents.str(),
+              testing::HasSubstr("{\"name\": \"flush stripe\", \"cat\": \"write\""));
+  EXPECT_THAT(contents.str(),
+              testing::HasSubstr("{\"name\": \"start stripe\", \"cat\": \"read\""));
+  EXPECT_THAT(contents.str(),
+              testing::HasSubstr("{\"name\": \"cache wait\", \"cat\": \"io\""));
+  EXPECT_THAT(contents.str(), testing::EndsWith("], \"displayTimeUnit\": \"ms\"}\n"));
+}
+
+TEST(TestFileBench, testBadOptions) {
+  const std::string pgm = findProgram("tools/src/orc-bench");
+  const std::string file = "/tmp/test_file_bench_bad_options.orc";
+  std::string output;
+  std::string error;
+  EXPECT_EQ(1, runProgram({pgm, "--null-ratio=2", file}, output, error));
+  EXPECT_THAT(error, testing::HasSubstr("Bad option value: 2"));
+  EXPECT_EQ(1, runProgram({pgm, "--compression=gzip", file}, output, error));
+  EXPECT_THAT(error, testing::HasSubstr("Bad option value: gzip"));
+  EXPECT_EQ(1, runProgram({pgm}, output, error));
+  EXPECT_THAT(error, testing::HasSubstr("Usage: orc-bench"));
+  EXPECT_EQ(1, runProgram({pgm, "--rows=10", "'--types=map<int,int>'", file}, output, error));
+  EXPECT_THAT(error, testing::HasSubstr("Unsupported column type map<int,int>"));
+}
@@ -167,3 +167,25 @@ TEST(TestFileContents, testDecimal64V2) {
   EXPECT_EQ(expected, output);
   EXPECT_EQ(error_msg, error);
 }
+
+TEST(TestFileContents, testThreads) {
+  const std::string pgm = findProgram("tools/src/orc-contents");
+  // 8 stripes of timestamps and dates
+  const std::string file = findExample("TestOrcFile.testDate1900.orc");
+
+  std::string expected;
+  std::string output;
+  std::string error;
+
+  EXPECT_EQ(0, runProgram({pgm, file}, expected, error));
+  EXPECT_EQ("", error);
+  EXPECT_EQ(0, runProgram({pgm, "--threads=3", file}, output, error));
+  EXPECT_EQ(expected, output);
+  EXPECT_EQ("", error);
+  EXPECT_EQ(0, runProgram({pgm, "-j", "16", "--columns=1", file}, output, error));
+  EXPECT_EQ(0, runProgram({pgm, "--columns=1", file}, expected, error));
+  EXPECT_EQ(expected, output);
+
+  EXPECT_EQ(1, runProgram({pgm, "--threads=0", file}, output, error));
+  EXPECT_NE(std::string::npos, error.find("--threads parameter requires a positive integer"));
+}
@@ -0,0 +1,64 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/OrcFile.hh"
+
+#include "Adaptor.hh"
+#include "ToolTest.hh"
+
+#include "wrap/gmock.h"
+#include "wrap/gtest-wrapper.h"
+
+TEST(TestFileMerge, mergeTwice) {
+  const std::string pgm = findProgram("tools/src/orc-merge");
+  const std::string contents = findProgram("tools/src/orc-contents");
+  const std::string file = findExample("TestOrcFile.testSeek.orc");
+  const std::string mergedFile = "/tmp/test_file_merge_merge_twice.orc";
+  std::string output;
+  std::string error;
+
+  EXPECT_EQ(0, runProgram({pgm, mergedFile, file, file}, output, error));
+  EXPECT_EQ("", output);
+  EXPECT_EQ("", error);
+
+  std::string expected;
+  EXPECT_EQ(0, runProgram({contents, file}, expected, error));
+  EXPECT_EQ(0, runProgram({contents, mergedFile}, output, error));
+  EXPECT_EQ(expected + expected, output);
+  EXPECT_EQ("", error);
+}
+
+TEST(TestFileMerge, mergeDifferentSchema) {
+  const std::string pgm = findProgram("tools/src/orc-merge");
+  const std::string mergedFile = "/tmp/test_file_merge_different_schema.orc";
+  std::string output;
+  std::string error;
+
+  EXPECT_EQ(1, runProgram({pgm, mergedFile, findExample("TestOrcFile.testSeek.orc"),
+                           findExample("TestOrcFile.test1.orc")},
+                          output, error));
+  EXPECT_NE(std::string::npos, error.find("Cannot merge")) << error;
+}
+
+TEST(TestFileMerge, badUsage) {
+  const std::string pgm = findProgram("tools/src/orc-merge");
+  std::string output;
+  std::string error;
+  EXPECT_EQ(1, runProgram({pgm, "/tmp/test_file_merge_bad_usage.orc"}, output, error));
+  EXPECT_NE(std::string::npos, error.find("Usage: orc-merge")) << error;
+}
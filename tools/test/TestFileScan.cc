@@ -66,6 +66,96 @@ TEST(TestFileScan, testNominal) {
   EXPECT_EQ("", error);
 }
 
+TEST(TestFileScan, testThreads) {
+  const std::string pgm = findProgram("tools/src/orc-scan");
+  const std::string file1 = findExample("TestOrcFile.testSeek.orc");
+  const std::string file2 = findExample("TestOrcFile.testDate1900.orc");
+  const std::string expected = "Rows: 32768\nBatches: 33\nRows: 70000\nBatches: 70\n";
+  std::string output;
+  std::string error;
+  for (const std::string threads : {"-j1", "-j2", "--threads=16"}) {
+    EXPECT_EQ(0, runProgram({pgm, threads, file1, file2}, output, error));
+    EXPECT_EQ(expected, output);
+    EXPECT_EQ("", error);
+  }
+
+  EXPECT_EQ(0, runProgram({pgm, "-m", "-j4", file1, file2}, output, error));
+  EXPECT_EQ(0, output.find(expected + "TotalRows: 102768\nTotalBytesRead: ")) << output;
+  EXPECT_NE(std::string::npos, output.find("\nRowsPerSecond: "));
+  EXPECT_NE(std::string::npos, output.find("\nBytesPerSecond: "));
+  EXPECT_NE(std::string::npos, output.find("\nReaderCall: "));
+  EXPECT_EQ("", error);
+
+  EXPECT_EQ(1, runProgram({pgm, "--threads=0", file1}, output, error));
+  EXPECT_EQ(0, error.find("The --threads parameter requires a positive integer option.\n"));
+}
+
+TEST(TestFileScan, testSearchArgument) {
+  const std::string pgm = findProgram("tools/src/orc-scan");
+  // the predicates are quoted for the shell that runs the program; there is
+  // one stripe of 3500 rows with row groups of 1000 rows, int1 is 300 times
+  // the row number
+  const std::string file = findExample("TestOrcFile.testPredicatePushdown.orc");
+  std::string output;
+  std::string error;
+  EXPECT_EQ(0, runProgram({pgm, file}, output, error));
+  EXPECT_EQ("Rows: 3500\nBatches: 4\n", output);
+
+  EXPECT_EQ(0, runProgram({pgm, "'--sarg=int1<300'", "-b", "100", file}, output, error));
+  EXPECT_EQ("Rows: 1000\nBatches: 10\n", output);
+  EXPECT_EQ("", error);
+
+  EXPECT_EQ(0, runProgram({pgm, "-s", "'int1>=900000,string1!=a'", "-j2", file}, output, error));
+  EXPECT_EQ("Rows: 500\nBatches: 1\n", output);
+  EXPECT_EQ("", error);
+
+  EXPECT_EQ(1, runProgram({pgm, "-s", "missing=1", file}, output, error));
+  EXPECT_EQ("", output);
+  EXPECT_NE(std::string::npos, error.find("Unknown column missing in --sarg")) << error;
+
+  EXPECT_EQ(1, runProgram({pgm, "-s", "'int1<x'", file}, output, error));
+  EXPECT_NE(std::string::npos, error.find("Bad integer x in --sarg")) << error;
+}
+
+TEST(TestFileScan, testNestedSearchArgument) {
+  const std::string pgm = findProgram("tools/src/orc-scan");
+  // one stripe of 3000 rows with row groups of 1000 rows, s.x is the row
+  // number
+  const std::string file = "/tmp/test_file_scan_nested_sarg.orc";
+  {
+    std::unique_ptr<orc::Type> type = orc::Type::buildTypeFromString("struct<s:struct<x:bigint>>");
+    orc::WriterOptions options;
+    options.setRowIndexStride(1000);
+    std::unique_ptr<orc::OutputStream> stream = orc::writeLocalFile(file);
+    std::unique_ptr<orc::Writer> writer = orc::createWriter(*type, stream.get(), options);
+    std::unique_ptr<orc::ColumnVectorBatch> batch = writer->createRowBatch(3000);
+    auto& root = dynamic_cast<orc::StructVectorBatch&>(*batch);
+    auto& nested = dynamic_cast<orc::StructVectorBatch&>(*root.fields[0]);
+    auto& x = dynamic_cast<orc::LongVectorBatch&>(*nested.fields[0]);
+    for (int64_t i = 0; i < 3000; ++i) {
+      x.data[i] = i;
+    }
+    root.numElements = nested.numElements = x.numElements = 3000;
+    writer->add(*batch);
+    writer->close();
+  }
+  std::string output;
+  std::string error;
+  EXPECT_EQ(0, runProgram({pgm, file}, output, error));
+  EXPECT_EQ("Rows: 3000\nBatches: 3\n", output);
+
+  EXPECT_EQ(0, runProgram({pgm, "'--sarg=s.x<1000'", file}, output, error));
+  EXPECT_EQ("Rows: 1000\nBatches: 1\n", output);
+  EXPECT_EQ("", error);
+
+  EXPECT_EQ(0, runProgram({pgm, "'--sarg=x>=2000'", file}, output, error));
+  EXPECT_EQ("Rows: 1000\nBatches: 1\n", output);
+  EXPECT_EQ("", error);
+
+  EXPECT_EQ(1, runProgram({pgm, "-s", "s.y=1", file}, output, error));
+  EXPECT_NE(std::string::npos, error.find("Unknown column s.y in --sarg")) << error;
+}
+
 /**
  * This function locates the goal substring in the input and removes
  * everything before it.
@@ -123,6 +213,8 @@ TEST(TestFileScan, testBadCommand) {
       "\t-n --columnNames\tComma separated list of column names\n"
       "\t-b --batch\t\tBatch size for reading\n"
       "\t-m --metrics\t\tShow metrics for reading\n"
+      "\t-j --threads\t\tNumber of threads reading stripes in parallel\n"
+      "\t-s --sarg\t\tComma separated list of column predicates, e.g. x>=10,y=abc\n"
       "Scans and displays the row count of the ORC files.\n",
       removeChars(stripPrefix(error, "orc-scan: "), "'`"));
 
@@ -138,6 +230,8 @@ TEST(TestFileScan, testBadCommand) {
       "\t-n --columnNames\tComma separated list of column names\n"
       "\t-b --batch\t\tBatch size for reading\n"
       "\t-m --metrics\t\tShow metrics for reading\n"
+      "\t-j --threads\t\tNumber of threads reading stripes in parallel\n"
+      "\t-s --sarg\t\tComma separated list of column predicates, e.g. x>=10,y=abc\n"
       "Scans and displays the row count of the ORC files.\n",
       error);
 
@@ -153,6 +247,8 @@ TEST(TestFileScan, testBadCommand) {
       "\t-n --columnNames\tComma separated list of column names\n"
       "\t-b --batch\t\tBatch size for reading\n"
       "\t-m --metrics\t\tShow metrics for reading\n"
+      "\t-j --threads\t\tNumber of threads reading stripes in parallel\n"
+      "\t-s --sarg\t\tComma separated list of column predicates, e.g. x>=10,y=abc\n"
       "Scans and displays the row count of the ORC files.\n",
       error);
 
@@ -168,6 +264,8 @@ TEST(TestFileScan, testBadCommand) {
       "\t-n --columnNames\tComma separated list of column names\n"
       "\t-b --batch\t\tBatch size for reading\n"
       "\t-m --metrics\t\tShow metrics for reading\n"
+      "\t-j --threads\t\tNumber of threads reading stripes in parallel\n"
+      "\t-s --sarg\t\tComma separated list of column predicates, e.g. x>=10,y=abc\n"
       "Scans and displays the row count of the ORC files.\n",
       removeChars(stripPrefix(error, "orc-scan: "), "'`"));
 
@@ -183,6 +281,8 @@ TEST(TestFileScan, testBadCommand) {
       "\t-n --columnNames\tComma separated list of column names\n"
       "\t-b --batch\t\tBatch size for reading\n"
       "\t-m --metrics\t\tShow metrics for reading\n"
+      "\t-j --threads\t\tNumber of threads reading stripes in parallel\n"
+      "\t-s --sarg\t\tComma separated list of column predicates, e.g. x>=10,y=abc\n"
       "Scans and displays the row count of the ORC files.\n",
       error);
 
@@ -198,6 +298,8 @@ TEST(TestFileScan, testBadCommand) {
       "\t-n --columnNames\tComma separated list of column names\n"
       "\t-b --batch\t\tBatch size for reading\n"
       "\t-m --metrics\t\tShow metrics for reading\n"
+      "\t-j --threads\t\tNumber of threads reading stripes in parallel\n"
+      "\t-s --sarg\t\tComma separated list of column predicates, e.g. x>=10,y=abc\n"
       "Scans and displays the row count of the ORC files.\n",
       error);
 }